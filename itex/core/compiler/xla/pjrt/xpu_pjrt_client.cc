@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <iostream>
 
+#include "absl/strings/str_cat.h"
 #include "itex/core/compiler/c/pjrt_c_api.h"
 #include "itex/core/compiler/c/pjrt_c_api_tpu.h"
 #include "itex/core/compiler/xla/client/xla_computation.h"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "itex/core/compiler/xla/pjrt/se_xpu_pjrt_client.h"
 #include "itex/core/compiler/xla/service/compiler.h"
 #include "itex/core/compiler/xla/service/gpu/gpu_transfer_manager.h"
+#include "itex/core/compiler/xla/service/gpu/persistent_compilation_cache.h"
 #include "itex/core/compiler/xla/service/gpu/spir_compiler.h"
 #include "itex/core/compiler/xla/service/gpu/target_constants.h"
 #include "itex/core/compiler/xla/shape.h"
@@ -164,6 +166,10 @@ PJRT_Error* PJRT_Client_Create(PJRT_Client_Create_Args* args) {
   if (jax_version.compare("0.4.4") < 0)
     PJRT_RETURN_IF_ERROR(itex::errors::Internal(
         "The plugin requires jax version at least 0.4.4"));
+  const itex_version_t* itex_version = GetITEXVersion();
+  itex_xla::gpu::PersistentCompilationCache::SetBuildVersion(absl::StrCat(
+      itex_version->major, ".", itex_version->minor, ".", itex_version->patch,
+      "-", itex_version->hash));
   static PJRT_Client client;
   args->client = new PJRT_Client();
   args->client->client =
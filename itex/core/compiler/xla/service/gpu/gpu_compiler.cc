@@ -20,6 +20,7 @@ limitations under the License.
 #include <level_zero/ze_api.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <iterator>
@@ -31,6 +32,7 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/types/variant.h"
 #include "itex/core/compiler/mlir/hlo/transforms/itex_gpu_passes.h"
 #include "itex/core/compiler/mlir/utils/name_utils.h"
@@ -89,6 +91,7 @@ limitations under the License.
 #include "itex/core/compiler/xla/service/gpu/kernel_thunk.h"
 #include "itex/core/compiler/xla/service/gpu/launch_dimensions.h"
 #include "itex/core/compiler/xla/service/gpu/multi_output_fusion.h"
+#include "itex/core/compiler/xla/service/gpu/persistent_compilation_cache.h"
 #include "itex/core/compiler/xla/service/gpu/reduction_degenerate_dim_remover.h"
 #include "itex/core/compiler/xla/service/gpu/reduction_dimension_grouper.h"
 #include "itex/core/compiler/xla/service/gpu/reduction_layout_normalizer.h"
@@ -143,6 +146,7 @@ limitations under the License.
 #include "itex/core/utils/logging.h"
 #include "itex/core/utils/path.h"
 #include "itex/core/utils/regexp.h"
+#include "itex/core/utils/threadpool.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
@@ -151,6 +155,7 @@ limitations under the License.
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/Transforms/Utils/SplitModule.h"
 #include "mhlo/IR/hlo_ops.h"
 #include "mhlo/transforms/passes.h"
@@ -1070,16 +1075,38 @@ static void NullDiagnosticHandler(const llvm::DiagnosticInfo& diag_info,
   ITEX_VLOG(5) << error_string;
 }
 
+// Parses a module serialized with SerializeModule() into `context`.
+static StatusOr<std::unique_ptr<llvm::Module>> ParseModule(
+    const std::string& bitcode, llvm::LLVMContext* context) {
+  llvm::Expected<std::unique_ptr<llvm::Module>> module =
+      llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode, "shard"),
+                             *context);
+  if (!module) {
+    return InternalError("Failed to parse LLVM module shard: %s",
+                         llvm::toString(module.takeError()));
+  }
+  return std::move(*module);
+}
+
+static std::string SerializeModule(const llvm::Module& module) {
+  std::string bitcode;
+  llvm::raw_string_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(module, os);
+  os.flush();
+  return bitcode;
+}
+
 StatusOr<std::pair<std::string, std::vector<uint8_t>>>
 GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
                                    std::unique_ptr<llvm::Module> llvm_module,
+                                   itex::thread::ThreadPool* thread_pool,
                                    const HloModule* debug_module) {
   using BackendCompileResult = std::pair<std::string, std::vector<uint8_t>>;
 
   const auto compile_single_module =
       [this, &module_config, debug_module](
-          llvm::Module* llvm_module,
-          absl::optional<int> shard_number) -> StatusOr<BackendCompileResult> {
+          llvm::Module* llvm_module, absl::optional<int> shard_number,
+          bool optimized) -> StatusOr<BackendCompileResult> {
     {
       XLA_SCOPED_LOGGING_TIMER(
           "GpuCompiler::RunBackend - Running LLVM verifier");
@@ -1102,7 +1129,8 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
                   : ".");
     }
     StatusOr<std::pair<std::string, std::vector<uint8_t>>> result =
-        CompileTargetBinary(module_config, llvm_module, debug_module);
+        CompileTargetBinary(module_config, llvm_module, debug_module,
+                            optimized);
 
     if (!result.ok()) {
       return result;
@@ -1155,9 +1183,92 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
     return result;
   };
 
-  // TODO(ITEX): add threadpool
-  return compile_single_module(llvm_module.get(),
-                               /*shard_number=*/absl::nullopt);
+  if (thread_pool == nullptr || thread_pool->NumThreads() <= 1) {
+    return compile_single_module(llvm_module.get(),
+                                 /*shard_number=*/absl::nullopt,
+                                 /*optimized=*/false);
+  }
+
+  // Each kernel is an externally visible function, there is nothing to gain
+  // from more shards than kernels.
+  int num_functions = 0;
+  for (const llvm::Function& func : llvm_module->functions()) {
+    if (!func.isDeclaration() &&
+        func.getLinkage() == llvm::GlobalValue::LinkageTypes::ExternalLinkage) {
+      num_functions++;
+    }
+  }
+  const int num_shards = std::min(thread_pool->NumThreads(), num_functions);
+  if (num_shards <= 1) {
+    return compile_single_module(llvm_module.get(),
+                                 /*shard_number=*/absl::nullopt,
+                                 /*optimized=*/false);
+  }
+
+  // LLVMContext is not thread-safe, so every shard is serialized here and
+  // parsed into a private context by the thread optimizing it. Locals stay in
+  // the shard of their users, so shards only reference each other through
+  // external symbols, which are resolved when the shards are linked back.
+  std::vector<std::string> shards;
+  {
+    XLA_SCOPED_LOGGING_TIMER(
+        "GpuCompiler::CompileToTargetBinary - Split module");
+    llvm::SplitModule(
+        *llvm_module, num_shards,
+        [&shards](std::unique_ptr<llvm::Module> shard) {
+          shards.push_back(SerializeModule(*shard));
+        },
+        /*PreserveLocals=*/true);
+  }
+  ITEX_VLOG(1) << "Optimizing LLVM module "
+               << llvm_module->getModuleIdentifier() << " in " << shards.size()
+               << " shards";
+
+  std::vector<Status> shard_status(shards.size());
+  {
+    XLA_SCOPED_LOGGING_TIMER(
+        "GpuCompiler::CompileToTargetBinary - Optimize shards");
+    absl::BlockingCounter counter(shards.size());
+    for (int i = 0; i < shards.size(); ++i) {
+      thread_pool->Schedule([this, i, &module_config, &shards, &shard_status,
+                             &counter]() {
+        shard_status[i] = [&]() -> Status {
+          llvm::LLVMContext context;
+          TF_ASSIGN_OR_RETURN(std::unique_ptr<llvm::Module> shard,
+                              ParseModule(shards[i], &context));
+          TF_RETURN_IF_ERROR(OptimizeLlvmModule(module_config, shard.get()));
+          shards[i] = SerializeModule(*shard);
+          return Status::OK();
+        }();
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  for (const Status& status : shard_status) {
+    TF_RETURN_IF_ERROR(status);
+  }
+
+  // Link in shard order, so the binary doesn't depend on thread scheduling.
+  std::unique_ptr<llvm::Module> linked_module;
+  {
+    XLA_SCOPED_LOGGING_TIMER(
+        "GpuCompiler::CompileToTargetBinary - Link shards");
+    for (int i = 0; i < shards.size(); ++i) {
+      TF_ASSIGN_OR_RETURN(std::unique_ptr<llvm::Module> shard,
+                          ParseModule(shards[i], &llvm_module->getContext()));
+      if (linked_module == nullptr) {
+        linked_module = std::move(shard);
+      } else if (llvm::Linker::linkModules(*linked_module, std::move(shard))) {
+        return InternalError("Failed to link LLVM module shard %d", i);
+      }
+    }
+  }
+  linked_module->setModuleIdentifier(llvm_module->getModuleIdentifier());
+
+  return compile_single_module(linked_module.get(),
+                               /*shard_number=*/absl::nullopt,
+                               /*optimized=*/true);
 }
 
 StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
@@ -1170,6 +1281,17 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
 
   llvm::LLVMContext llvm_context;
 
+  std::unique_ptr<itex::thread::ThreadPool> overriding_thread_pool;
+  const int parallelism =
+      module->config().debug_options().xla_gpu_force_compilation_parallelism();
+  if (parallelism > 0) {
+    overriding_thread_pool = std::make_unique<itex::thread::ThreadPool>(
+        itex::Env::Default(), "xla_gpu_compile", parallelism);
+  }
+  itex::thread::ThreadPool* thread_pool = overriding_thread_pool
+                                              ? overriding_thread_pool.get()
+                                              : options.thread_pool;
+
   GpuDeviceInfo gpu_device_info = GetGpuDeviceInfo();
 
   // if (module->config().hlo_profiling_enabled() || ITEX_VLOG_IS_ON(1)) {
@@ -1206,6 +1328,9 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
   llvm_ir::DumpIrIfEnabled(*module, *compile_module_results.llvm_module,
                            /*optimized=*/false);
 
+  auto buffer_assignment_proto = std::make_unique<BufferAssignmentProto>(
+      compile_module_results.buffer_assignment->ToProto());
+
   using BackendCompileResult = std::pair<std::string, std::vector<uint8_t>>;
   BackendCompileResult backend_result;
   if (EnableGpuMlirLowering() &&
@@ -1219,11 +1344,59 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
     backend_result.second = std::move(compile_module_results.spv_binary_vec[0]);
   } else {
     ITEX_VLOG(1) << "Build kernel via LLVM kernel compilation.";
-    TF_ASSIGN_OR_RETURN(
-        backend_result,
-        CompileToTargetBinary(module->config(),
-                              std::move(compile_module_results.llvm_module),
-                              module.get()));
+    // Thunks and buffer assignment are always re-emitted, only the LLVM
+    // optimization and SPIR-V lowering is skipped on a persistent cache hit.
+    PersistentCompilationCache* cache = PersistentCompilationCache::Get();
+    std::string cache_key;
+    std::string thunk_order;
+    bool cache_hit = false;
+    if (cache != nullptr) {
+      cache_key = PersistentCompilationCache::Key(
+          *module, stream_exec->platform()->Name(), target_triple_,
+          gpu_device_info);
+      if (absl::holds_alternative<OwnedThunkSchedule>(
+              compile_module_results.thunks_or_bef)) {
+        thunk_order =
+            absl::get<OwnedThunkSchedule>(compile_module_results.thunks_or_bef)
+                ->TotalOrder()
+                .ToString(/*indent=*/0, /*get_thunk_annotation=*/nullptr);
+      }
+      CompilationCacheEntryProto entry;
+      if (cache->Lookup(cache_key, &entry)) {
+        // Kernel names and buffer offsets are baked into the binary, so the
+        // entry is only usable if IR emission produced the same ones.
+        if (entry.thunk_schedule() == thunk_order &&
+            protobuf_util::ProtobufEquals(entry.buffer_assignment(),
+                                          *buffer_assignment_proto)) {
+          backend_result.first = entry.module_name();
+          backend_result.second.assign(entry.binary().begin(),
+                                       entry.binary().end());
+          cache_hit = true;
+        } else {
+          cache->Invalidate(cache_key);
+        }
+      }
+    }
+    if (!cache_hit) {
+      TF_ASSIGN_OR_RETURN(
+          backend_result,
+          CompileToTargetBinary(module->config(),
+                                std::move(compile_module_results.llvm_module),
+                                thread_pool, module.get()));
+      if (cache != nullptr) {
+        CompilationCacheEntryProto entry;
+        entry.set_module_name(backend_result.first);
+        entry.set_binary(backend_result.second.data(),
+                         backend_result.second.size());
+        *entry.mutable_buffer_assignment() = *buffer_assignment_proto;
+        entry.set_thunk_schedule(std::move(thunk_order));
+        Status status = cache->Insert(cache_key, std::move(entry));
+        if (!status.ok()) {
+          ITEX_LOG(WARNING) << "Failed to write XLA compilation cache entry: "
+                            << status;
+        }
+      }
+    }
     if (DumpingEnabledForHloModule(*module) &&
         absl::holds_alternative<OwnedThunkSchedule>(
             compile_module_results.thunks_or_bef)) {
@@ -1234,9 +1407,6 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
     }
   }
 
-  auto buffer_assignment_proto = std::make_unique<BufferAssignmentProto>(
-      compile_module_results.buffer_assignment->ToProto());
-
   // Make it shared to be captured in the following lambda.
   std::shared_ptr<const BufferAssignment> buffer_assignment(
       std::move(compile_module_results.buffer_assignment));
@@ -68,9 +68,13 @@ class GpuCompiler : public LLVMCompiler {
     ITEX_LOG(FATAL) << "CompileAheadOfTime is not supported";
   }
 
+  // Compiles `llvm_module` to a device binary. With a multi-threaded
+  // `thread_pool`, the module is split into shards that are optimized
+  // concurrently, then linked back in shard order and lowered.
   StatusOr<std::pair<std::string, std::vector<uint8_t>>> CompileToTargetBinary(
       const HloModuleConfig& module_config,
-      std::unique_ptr<llvm::Module> llvm_module, const HloModule* debug_module);
+      std::unique_ptr<llvm::Module> llvm_module,
+      itex::thread::ThreadPool* thread_pool, const HloModule* debug_module);
 
   se::Platform::Id PlatformId() const override { return platform_id_; }
 
@@ -91,12 +95,19 @@ class GpuCompiler : public LLVMCompiler {
            const ShapeIndex&) -> absl::optional<bool> { return absl::nullopt; };
   }
 
+  // Runs the LLVM optimization pipeline on `llvm_module` in place. Must be
+  // thread-safe for modules in different LLVMContexts.
+  virtual Status OptimizeLlvmModule(const HloModuleConfig& module_config,
+                                    llvm::Module* llvm_module) = 0;
+
   // TODO(timshen): Replace `debug_module` with some portable debug information
   // that accommodates both HLO and MLIR.
+  // `optimized` is true if `llvm_module` was already optimized with
+  // OptimizeLlvmModule().
   virtual StatusOr<std::pair<std::string, std::vector<uint8_t>>>
   CompileTargetBinary(const HloModuleConfig& module_config,
-                      llvm::Module* llvm_module,
-                      const HloModule* debug_module) = 0;
+                      llvm::Module* llvm_module, const HloModule* debug_module,
+                      bool optimized) = 0;
 
   Status PrepareHloModuleForIrEmitting(HloModule* hlo_module);
 
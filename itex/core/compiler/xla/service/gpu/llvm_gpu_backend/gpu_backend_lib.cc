@@ -413,12 +413,31 @@ StatusOr<std::string> EmitModuleToSpir(llvm::Module* module,
 }  // namespace
 
 namespace spir {
-StatusOr<std::string> CompileToSpir(llvm::Module* module,
-                                    const HloModuleConfig& hlo_module_config,
-                                    const std::string& libdevice_dir_path) {
+Status OptimizeModule(llvm::Module* module,
+                      const HloModuleConfig& hlo_module_config) {
   static absl::once_flag backend_init_flag;
   absl::call_once(backend_init_flag, NVPTXBackendInit, hlo_module_config);
 
+  XLA_SCOPED_LOGGING_TIMER("Optimize module " + module->getName().str());
+  bool reuse = true;
+  itex::ReadBoolFromEnvVar("TF_LLVM_OPT", true, &reuse);
+  if (!reuse) return Status::OK();
+
+  // No SPIR target machine?
+  llvm::Triple default_target_triple("spir64-unknown-unknown");
+  // std::unique_ptr<llvm::TargetMachine> target_machine =
+  //     GetTargetMachine(default_target_triple, "generic",
+  //                       hlo_module_config, "+ptx60");
+
+  // Link with libdevice, and optimize the LLVM module.
+  return LinkAndOptimizeModule(module, hlo_module_config, default_target_triple,
+                               nullptr, kDefaultInlineThreshold);
+}
+
+StatusOr<std::string> CompileToSpir(llvm::Module* module,
+                                    const HloModuleConfig& hlo_module_config,
+                                    const std::string& libdevice_dir_path,
+                                    bool optimize) {
   std::string spir;
   {
     // itex::profiler::TraceMe activity(
@@ -434,19 +453,8 @@ StatusOr<std::string> CompileToSpir(llvm::Module* module,
       return std::string();
     }
 
-    // No SPIR target machine?
-    llvm::Triple default_target_triple("spir64-unknown-unknown");
-    // std::unique_ptr<llvm::TargetMachine> target_machine =
-    //     GetTargetMachine(default_target_triple, "generic",
-    //                       hlo_module_config, "+ptx60");
-
-    bool reuse = true;
-    itex::ReadBoolFromEnvVar("TF_LLVM_OPT", true, &reuse);
-    if (reuse) {
-      // Link with libdevice, and optimize the LLVM module.
-      TF_RETURN_IF_ERROR(LinkAndOptimizeModule(module, hlo_module_config,
-                                               default_target_triple, nullptr,
-                                               kDefaultInlineThreshold));
+    if (optimize) {
+      TF_RETURN_IF_ERROR(OptimizeModule(module, hlo_module_config));
     }
 
     DumpStringToFileInDirOrStdout("module_opt.ll",
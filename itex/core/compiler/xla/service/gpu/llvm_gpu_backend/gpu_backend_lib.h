@@ -33,9 +33,17 @@ namespace itex_xla {
 namespace gpu {
 
 namespace spir {
+// Runs the LLVM optimization pipeline on `module` in place. Modules in
+// different LLVMContexts can be optimized concurrently.
+Status OptimizeModule(llvm::Module* module,
+                      const HloModuleConfig& hlo_module_config);
+
+// Lowers `module` to a SPIR-V binary. `optimize` is false if the module was
+// already optimized with OptimizeModule().
 StatusOr<std::string> CompileToSpir(llvm::Module* module,
                                     const HloModuleConfig& hlo_module_config,
-                                    const std::string& libdevice_dir_path);
+                                    const std::string& libdevice_dir_path,
+                                    bool optimize = true);
 }  // namespace spir
 
 }  // namespace gpu
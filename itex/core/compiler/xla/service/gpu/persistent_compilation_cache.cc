@@ -0,0 +1,289 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/compiler/xla/service/gpu/persistent_compilation_cache.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "itex/core/compiler/xla/service/hlo_instruction.h"
+#include "itex/core/compiler/xla/util.h"
+#include "itex/core/utils/coding.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/fingerprint.h"
+#include "itex/core/utils/hash.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/path.h"
+
+namespace itex_xla {
+namespace gpu {
+
+namespace {
+
+// Bump the version whenever codegen or the entry format changes in a way that
+// makes existing entries unusable.
+constexpr char kCacheVersion[] = "itex-xla-gpu-cache-v1";
+
+// Entry file layout: 8 bytes magic, 8 bytes Hash64 of the payload, payload.
+constexpr char kMagic[] = "ITEXXC01";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+constexpr size_t kHeaderSize = kMagicSize + sizeof(uint64_t);
+constexpr char kEntrySuffix[] = ".xlacache";
+
+std::string* BuildVersionString() {
+  static std::string* version = new std::string();
+  return version;
+}
+
+std::string EncodeEntry(const std::string& payload) {
+  std::string data;
+  data.reserve(kHeaderSize + payload.size());
+  data.append(kMagic, kMagicSize);
+  itex::core::PutFixed64(&data, itex::Hash64(payload));
+  data.append(payload);
+  return data;
+}
+
+// Returns false if `data` is not an intact entry.
+bool DecodeEntry(const std::string& data, absl::string_view* payload) {
+  if (data.size() < kHeaderSize ||
+      absl::string_view(data.data(), kMagicSize) != kMagic) {
+    return false;
+  }
+  *payload = absl::string_view(data).substr(kHeaderSize);
+  uint64_t checksum = itex::core::DecodeFixed64(data.data() + kMagicSize);
+  return checksum == itex::Hash64(payload->data(), payload->size());
+}
+
+}  // namespace
+
+/*static*/ PersistentCompilationCache* PersistentCompilationCache::Get() {
+  static PersistentCompilationCache* cache =
+      []() -> PersistentCompilationCache* {
+    std::string dir;
+    TF_ABORT_IF_ERROR(itex::ReadStringFromEnvVar(
+        "ITEX_XLA_PERSISTENT_CACHE_DIR", "", &dir));
+    int64_t max_mb;
+    TF_ABORT_IF_ERROR(itex::ReadInt64FromEnvVar("ITEX_XLA_PERSISTENT_CACHE_MB",
+                                                1024, &max_mb));
+    if (dir.empty() || max_mb <= 0) return nullptr;
+    // Without the ITEX build in the key, entries compiled by another build
+    // would be reused.
+    if (BuildVersionString()->empty()) {
+      ITEX_LOG(WARNING) << "Persistent XLA compilation cache is disabled, "
+                        << "the ITEX version is unknown.";
+      return nullptr;
+    }
+
+    itex::Status status = itex::Env::Default()->RecursivelyCreateDir(dir);
+    if (!status.ok()) {
+      ITEX_LOG(WARNING) << "Persistent XLA compilation cache is disabled, "
+                        << "failed to create " << dir << ": " << status;
+      return nullptr;
+    }
+    auto* cache = new PersistentCompilationCache(
+        std::move(dir), static_cast<uint64_t>(max_mb) << 20);
+    cache->LoadIndex();
+    return cache;
+  }();
+  return cache;
+}
+
+/*static*/ void PersistentCompilationCache::SetBuildVersion(
+    const std::string& version) {
+  *BuildVersionString() = version;
+}
+
+/*static*/ std::string PersistentCompilationCache::Key(
+    const HloModule& module, absl::string_view platform,
+    absl::string_view target_triple, const GpuDeviceInfo& device_info) {
+  // Constants are compiled into the kernels as globals, so unlike the
+  // Fingerprint print options all of their values take part in the key.
+  HloPrintOptions print_options = HloPrintOptions::Fingerprint()
+                                      .set_print_only_essential_constants(false)
+                                      .set_print_large_constants(true);
+  std::string key_string = absl::StrCat(
+      kCacheVersion, "::", *BuildVersionString(), "::", platform, "::",
+      target_triple, "::", module.config().compilation_cache_key(), "::",
+      module.ToString(print_options));
+  absl::StrAppendFormat(
+      &key_string, "::%d,%d,%d,%d,%d,%d,%d,%d",
+      device_info.threads_per_block_limit, device_info.threads_per_warp,
+      device_info.shared_memory_per_block, device_info.threads_per_core_limit,
+      device_info.core_count, device_info.block_dim_limit_x,
+      device_info.block_dim_limit_y, device_info.block_dim_limit_z);
+  itex::Fprint128 fingerprint = itex::Fingerprint128(key_string);
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+PersistentCompilationCache::PersistentCompilationCache(std::string dir,
+                                                       uint64_t max_bytes)
+    : dir_(std::move(dir)), max_bytes_(max_bytes) {}
+
+std::string PersistentCompilationCache::FilePath(const std::string& key) const {
+  return itex::io::JoinPath(dir_, absl::StrCat(key, kEntrySuffix));
+}
+
+void PersistentCompilationCache::LoadIndex() {
+  itex::Env* env = itex::Env::Default();
+  std::vector<std::string> children;
+  if (!env->GetChildren(dir_, &children).ok()) return;
+
+  struct FileInfo {
+    std::string key;
+    uint64_t size;
+    int64_t mtime_nsec;
+  };
+  std::vector<FileInfo> files;
+  for (const std::string& child : children) {
+    if (!absl::EndsWith(child, kEntrySuffix)) continue;
+    itex::FileStatistics stat;
+    if (!env->Stat(itex::io::JoinPath(dir_, child), &stat).ok()) continue;
+    files.push_back(
+        {child.substr(0, child.size() - (sizeof(kEntrySuffix) - 1)),
+         static_cast<uint64_t>(stat.length), stat.mtime_nsec});
+  }
+  // Oldest first, each one is then moved to the front of the LRU list.
+  std::sort(files.begin(), files.end(),
+            [](const FileInfo& a, const FileInfo& b) {
+              return a.mtime_nsec < b.mtime_nsec;
+            });
+
+  absl::MutexLock lock(&mutex_);
+  for (const FileInfo& file : files) TouchLocked(file.key, file.size);
+  EvictLocked();
+  ITEX_VLOG(1) << "Persistent XLA compilation cache " << dir_ << ": "
+               << lru_list_.size() << " entries, " << bytes_ << " bytes";
+}
+
+bool PersistentCompilationCache::Lookup(const std::string& key,
+                                        CompilationCacheEntryProto* entry) {
+  std::string path = FilePath(key);
+  std::string data;
+  // The file is read even if it's not indexed, it may have been written by
+  // another process sharing the directory.
+  if (!itex::ReadFileToString(itex::Env::Default(), path, &data).ok()) {
+    misses_++;
+    ITEX_VLOG(2) << "Persistent XLA compilation cache miss: " << key;
+    return false;
+  }
+
+  absl::string_view payload;
+  if (!DecodeEntry(data, &payload) ||
+      !entry->ParseFromArray(payload.data(), payload.size()) ||
+      entry->key() != key) {
+    corrupted_++;
+    misses_++;
+    ITEX_LOG(WARNING) << "Removing corrupted XLA compilation cache entry "
+                      << path;
+    absl::MutexLock lock(&mutex_);
+    RemoveLocked(key);
+    return false;
+  }
+
+  hits_++;
+  ITEX_VLOG(2) << "Persistent XLA compilation cache hit: " << key;
+  absl::MutexLock lock(&mutex_);
+  TouchLocked(key, data.size());
+  return true;
+}
+
+Status PersistentCompilationCache::Insert(const std::string& key,
+                                          CompilationCacheEntryProto entry) {
+  entry.set_key(key);
+  std::string payload;
+  if (!entry.SerializeToString(&payload)) {
+    return InternalError("Failed to serialize XLA compilation cache entry %s",
+                         key);
+  }
+  std::string data = EncodeEntry(payload);
+
+  // Write to a unique temporary file then rename, so concurrent readers and
+  // writers never observe a partial entry.
+  itex::Env* env = itex::Env::Default();
+  std::string path = FilePath(key);
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return InternalError("Failed to create a temporary file name for %s",
+                         path);
+  }
+  itex::Status status = itex::WriteStringToFile(env, tmp_path, data);
+  if (status.ok()) status = env->RenameFile(tmp_path, path);
+  if (!status.ok()) {
+    env->DeleteFile(tmp_path).IgnoreError();
+    return status;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  TouchLocked(key, data.size());
+  EvictLocked();
+  ITEX_VLOG(2) << "Persistent XLA compilation cache insert: " << key << ", "
+               << data.size() << " bytes";
+  return Status::OK();
+}
+
+void PersistentCompilationCache::Invalidate(const std::string& key) {
+  stale_++;
+  ITEX_VLOG(1) << "Removing stale XLA compilation cache entry " << key;
+  absl::MutexLock lock(&mutex_);
+  RemoveLocked(key);
+}
+
+PersistentCompilationCache::Stats PersistentCompilationCache::stats() const {
+  return {hits_.load(), misses_.load(), stale_.load(), corrupted_.load(),
+          evictions_.load()};
+}
+
+void PersistentCompilationCache::TouchLocked(const std::string& key,
+                                             uint64_t size) {
+  auto iter = index_.find(key);
+  if (iter != index_.end()) {
+    bytes_ -= iter->second->second;
+    iter->second->second = size;
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+  } else {
+    lru_list_.emplace_front(key, size);
+    index_[key] = lru_list_.begin();
+  }
+  bytes_ += size;
+}
+
+void PersistentCompilationCache::RemoveLocked(const std::string& key) {
+  itex::Env::Default()->DeleteFile(FilePath(key)).IgnoreError();
+  auto iter = index_.find(key);
+  if (iter == index_.end()) return;
+  bytes_ -= iter->second->second;
+  lru_list_.erase(iter->second);
+  index_.erase(iter);
+}
+
+void PersistentCompilationCache::EvictLocked() {
+  // The most recently used entry is kept even if it alone exceeds the limit.
+  while (bytes_ > max_bytes_ && lru_list_.size() > 1) {
+    std::string key = lru_list_.back().first;
+    RemoveLocked(key);
+    evictions_++;
+    ITEX_VLOG(2) << "Persistent XLA compilation cache evict: " << key;
+  }
+}
+
+}  // namespace gpu
+}  // namespace itex_xla
@@ -0,0 +1,128 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_COMPILER_XLA_SERVICE_GPU_PERSISTENT_COMPILATION_CACHE_H_
+#define ITEX_CORE_COMPILER_XLA_SERVICE_GPU_PERSISTENT_COMPILATION_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "itex/core/compiler/xla/service/gpu/gpu_device_info.h"
+#include "itex/core/compiler/xla/service/hlo_module.h"
+#include "itex/core/compiler/xla/status.h"
+#include "itex/core/compiler/xla/types.h"
+#include "protos/gpu_compilation_cache.pb.h"
+
+namespace itex_xla {
+namespace gpu {
+
+// On-disk cache of XLA:GPU backend compilation results, shared by all
+// processes pointing at the same directory. Entries are content addressed: the
+// key is a fingerprint of the optimized HLO module, its compilation config and
+// debug options, and the target device, so the same module is lowered to
+// SPIR-V only once across runs.
+//
+// Each entry is one file holding a header with a checksum followed by a
+// serialized CompilationCacheEntryProto. Files are written to a temporary name
+// and renamed into place, so readers never see a partial entry. Entries that
+// fail the checksum or don't parse are deleted and treated as misses.
+//
+// The cache is enabled by `ITEX_XLA_PERSISTENT_CACHE_DIR`. The total size of
+// the entries is limited by `ITEX_XLA_PERSISTENT_CACHE_MB`, least recently
+// used entries are evicted first.
+class PersistentCompilationCache {
+ public:
+  struct Stats {
+    int64_t hits;
+    int64_t misses;
+    int64_t stale;
+    int64_t corrupted;
+    int64_t evictions;
+  };
+
+  // Returns the process-wide cache, or nullptr if it is disabled. The cache
+  // stays disabled unless the build version is set before the first call.
+  static PersistentCompilationCache* Get();
+
+  // Sets the ITEX version and git hash, which are part of every key, so
+  // entries written by another ITEX build are never reused.
+  static void SetBuildVersion(const std::string& version);
+
+  // Builds the cache key of `module` compiled for the given target.
+  static std::string Key(const HloModule& module, absl::string_view platform,
+                         absl::string_view target_triple,
+                         const GpuDeviceInfo& device_info);
+
+  // Reads the entry stored for `key`. Returns false on miss, including when
+  // the entry is corrupted.
+  bool Lookup(const std::string& key, CompilationCacheEntryProto* entry);
+
+  // Stores `entry` for `key`, replacing any existing entry, then evicts least
+  // recently used entries until the cache fits in its size limit.
+  Status Insert(const std::string& key, CompilationCacheEntryProto entry);
+
+  // Removes the entry for `key`. Called when a looked up entry doesn't match
+  // the module being compiled.
+  void Invalidate(const std::string& key);
+
+  Stats stats() const;
+
+ private:
+  // Pairs of key and file size, most recently used first.
+  using LRUList = std::list<std::pair<std::string, uint64_t>>;
+
+  PersistentCompilationCache(std::string dir, uint64_t max_bytes);
+
+  std::string FilePath(const std::string& key) const;
+
+  // Indexes the entries already in the cache directory.
+  void LoadIndex();
+
+  // Moves `key` to the front of the LRU list, adding it if it's not indexed.
+  void TouchLocked(const std::string& key, uint64_t size)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void RemoveLocked(const std::string& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void EvictLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::string dir_;
+  const uint64_t max_bytes_;
+
+  absl::Mutex mutex_;
+  uint64_t bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  LRUList lru_list_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, LRUList::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+  std::atomic<int64_t> stale_{0};
+  std::atomic<int64_t> corrupted_{0};
+  std::atomic<int64_t> evictions_{0};
+
+  PersistentCompilationCache(const PersistentCompilationCache&) = delete;
+  PersistentCompilationCache& operator=(const PersistentCompilationCache&) =
+      delete;
+};
+
+}  // namespace gpu
+}  // namespace itex_xla
+
+#endif  // ITEX_CORE_COMPILER_XLA_SERVICE_GPU_PERSISTENT_COMPILATION_CACHE_H_
@@ -235,10 +235,16 @@ HloDataflowAnalysis::CanShareBuffer SPIRCompiler::GetCanShareBuffer() {
   return &CanShareBufferHint;
 }
 
+Status SPIRCompiler::OptimizeLlvmModule(const HloModuleConfig& module_config,
+                                        llvm::Module* llvm_module) {
+  return spir::OptimizeModule(llvm_module, module_config);
+}
+
 StatusOr<std::pair<std::string, std::vector<uint8_t>>>
 SPIRCompiler::CompileTargetBinary(const HloModuleConfig& module_config,
                                   llvm::Module* llvm_module,
-                                  const HloModule* debug_module) {
+                                  const HloModule* debug_module,
+                                  bool optimized) {
   std::string libdevice_dir;
   ITEX_VLOG(2) << "Libdevice dir = " << libdevice_dir << "\n";
   std::unique_ptr<llvm::Module> loaded_module =
@@ -250,12 +256,15 @@ SPIRCompiler::CompileTargetBinary(const HloModuleConfig& module_config,
     selected_module = llvm_module;
   }
 
+  // A module loaded from file is not optimized yet.
+  const bool optimize = loaded_module != nullptr || !optimized;
+
   std::string spir;
   if (debug_module) {
     XLA_SCOPED_LOGGING_TIMER("CompileTargetBinary - CompileToSpir");
-    TF_ASSIGN_OR_RETURN(
-        spir,
-        spir::CompileToSpir(selected_module, module_config, libdevice_dir));
+    TF_ASSIGN_OR_RETURN(spir, spir::CompileToSpir(selected_module,
+                                                  module_config, libdevice_dir,
+                                                  optimize));
   }
   DumpStringToFileInDirOrStdout("module.spv", spir,
                                 module_config.debug_options());
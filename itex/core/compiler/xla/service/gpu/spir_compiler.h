@@ -43,9 +43,12 @@ class SPIRCompiler : public GpuCompiler {
 
   // GpuVersion GetGpuVersion(se::StreamExecutor* stream_exec) override;
 
+  Status OptimizeLlvmModule(const HloModuleConfig& module_config,
+                            llvm::Module* llvm_module) override;
+
   StatusOr<std::pair<std::string, std::vector<uint8_t>>> CompileTargetBinary(
       const HloModuleConfig& module_config, llvm::Module* llvm_module,
-      const HloModule* debug_module) override;
+      const HloModule* debug_module, bool optimized) override;
 
   static SPIRCompiler* CreateSPIRCompiler();
 
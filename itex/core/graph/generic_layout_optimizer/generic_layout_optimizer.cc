@@ -226,15 +226,17 @@ inline Status EraseCancellableIdenityNodes(GenericLayoutContext* context) {
   return mutation->Apply();
 }
 
-Status GenericLayoutContext::InitializeContext(bool assume_valid_feeds,
+Status GenericLayoutContext::InitializeContext(OptimizerContext* opt_ctx,
+                                               bool assume_valid_feeds,
                                                const GrapplerItem& item,
                                                const GraphDef& graph_def,
                                                GenericLayoutContext* context) {
   // DCHECK(context != nullptr);
   context->graph = graph_def;
-  context->graph_properties = std::make_unique<GraphProperties>(item);
-  TF_RETURN_IF_ERROR(
-      context->graph_properties->InferStatically(assume_valid_feeds));
+  TF_RETURN_IF_ERROR(opt_ctx->GetGraphProperties(
+      item, assume_valid_feeds, /*aggressive_shape_inference=*/false,
+      /*include_input_tensor_values=*/true,
+      /*include_output_tensor_values=*/true, &context->graph_properties));
   Status status;
   context->graph_view =
       std::make_unique<utils::MutableGraphView>(&context->graph, &status);
@@ -253,7 +255,7 @@ Status GenericLayoutOptimizer::Optimize(OptimizerContext* opt_ctx,
   GenericLayoutContext context;
   // needs to be checked
   TF_RETURN_IF_ERROR(GenericLayoutContext::InitializeContext(
-      /*assume_valid_feeds=*/false, item, graph_def, &context));
+      opt_ctx, /*assume_valid_feeds=*/false, item, graph_def, &context));
 
   ITEX_VLOG(3) << "Start to run GenericLayoutOptimizer pass";
   utils::MutableGraphView* graph_view = context.graph_view.get();
@@ -43,20 +43,23 @@ struct GenericLayoutContext {
   // Initializes GenericLayoutContext with given GrapplerItem. Because
   // initializing FrameMap and GraphProperties may return error, we initialize
   // GenericLayoutContext outside constructor.
-  static Status InitializeContext(bool assume_valid_feeds,
+  static Status InitializeContext(OptimizerContext* opt_ctx,
+                                  bool assume_valid_feeds,
                                   const GrapplerItem& item,
                                   const GraphDef& graph_def,
                                   GenericLayoutContext* context);
 
-  static Status InitializeContext(const GrapplerItem& item,
+  static Status InitializeContext(OptimizerContext* opt_ctx,
+                                  const GrapplerItem& item,
                                   const GraphDef& graph_def,
                                   GenericLayoutContext* context) {
-    return InitializeContext(false, item, graph_def, context);
+    return InitializeContext(opt_ctx, false, item, graph_def, context);
   }
 
   GraphDef graph;
   absl::flat_hash_set<string> nodes_to_preserve;
-  std::unique_ptr<GraphProperties> graph_properties;
+  // Owned by OptimizerContext and shared with other passes.
+  GraphProperties* graph_properties = nullptr;
   std::unique_ptr<utils::MutableGraphView> graph_view;
 };
 
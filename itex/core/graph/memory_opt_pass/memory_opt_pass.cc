@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -48,8 +49,6 @@ const auto add_inplace_rule = gtl::FlatSet<string>{
 const auto onednngraph_inplace_rule =
     gtl::FlatSet<string>{"_OneDnnGraph", "OneDnnGraph"};
 
-static constexpr int MAX_LLGA_SEARCH_NODES = 50;
-
 std::vector<int> GetCandidateForwardPort(const MutableNodeView* node_view) {
   const auto* node_def = node_view->node();
 
@@ -118,72 +117,148 @@ int GetStaticRefCount(const MutableNodeView* node_view,
   return tgt_node_view->GetRegularFanout(out_port).size();
 }
 
-// Suppose that the current node must have Add Fusion.
-bool IsSafeForwarding(const MutableNodeView* node_view,
-                      const int forward_port) {
-  if (forward_port < 0) return false;
-
-  const auto* tgt_node_view =
-      node_view->GetRegularFanin(forward_port).node_view();
-
-  int out_port = GetOutPort(node_view, tgt_node_view);
-
-  const auto& out_port_node_vec = tgt_node_view->GetRegularFanout(out_port);
-
-  // Forwarding is safe due to AddInput with only one fanout.
-  if (out_port_node_vec.size() == 1) return true;
-
-  // AddInput with more than two fanouts is not supported in this work-around.
-  if (out_port_node_vec.size() > 2) return false;
-
-  // Get the other consumer of the buffer to be forwarded.
-  const auto* ref_node_view = (out_port_node_vec[0].node_view() != node_view)
-                                  ? out_port_node_vec[0].node_view()
-                                  : out_port_node_vec[1].node_view();
-
-  // Prevent forwarding when AddInput is the same as the input to the fused op.
-  //      AddInput
-  //        /  |
-  //       /   |
-  //    Conv   |
-  //       \   |
-  //        \  |
-  //         Add
-  if (ref_node_view == node_view) return false;
-
-  // For safe forwarding, contraction should have a larger topological index
-  // than precursors.
-  if (node_view->node_index() < ref_node_view->node_index()) return false;
-
-  // To simplify this work-around, BFS is regulated by the number of nodes
-  // `remain` to be searched rather than depth. `remain = 10` is enough for
-  // ResNet50.
-  int remain = 10;
-  std::queue<const utils::MutableNodeView*> queue;
-
-  if (IsAnyOneDnnGraph(*node_view->node())) {
-    // LLGA op forward tensor can from any input tensor
-    remain = MAX_LLGA_SEARCH_NODES;
-    for (int i = 0; i < node_view->NumRegularFanins(); ++i) {
-      queue.push(node_view->GetRegularFanin(i).node_view());
+// Upper bound of nodes visited by one MustRunBefore search. Graphs have up to
+// hundreds of thousands of nodes and the search runs for every consumer of a
+// candidate buffer, so an unbounded search would make the pass quadratic.
+constexpr size_t kMaxMustRunBeforeVisits = 4096;
+
+// Returns true if `ancestor` must finish before `node_view` starts in every
+// schedule, i.e. there is a path of data or control edges from `ancestor` to
+// `node_view`. Nodes are sorted topologically, so only the nodes between both
+// are searched. Returns false, which disables forwarding, if the search visits
+// more than kMaxMustRunBeforeVisits nodes.
+bool MustRunBefore(const MutableNodeView* ancestor,
+                   const MutableNodeView* node_view) {
+  const int ancestor_index = ancestor->node_index();
+  if (node_view->node_index() <= ancestor_index) return false;
+
+  std::vector<const MutableNodeView*> stack = {node_view};
+  std::unordered_set<int> visited = {node_view->node_index()};
+  bool found = false;
+  auto visit = [&](const MutableNodeView* fanin) {
+    const int fanin_index = fanin->node_index();
+    if (fanin_index == ancestor_index) {
+      found = true;
+    } else if (fanin_index > ancestor_index &&
+               visited.insert(fanin_index).second) {
+      stack.push_back(fanin);
     }
-  } else {
-    // Start BFS from input:0 due to the hypothesis of add fusion.
-    queue.push(node_view->GetRegularFanin(0).node_view());
+  };
+
+  while (!stack.empty() && !found) {
+    if (visited.size() > kMaxMustRunBeforeVisits) return false;
+    const auto* node = stack.back();
+    stack.pop_back();
+    for (const auto& fanin : node->GetRegularFanins()) visit(fanin.node_view());
+    for (const auto& fanin : node->GetControllingFanins())
+      visit(fanin.node_view());
   }
 
-  while (!queue.empty() && remain) {
-    --remain;
-    const auto* node = queue.front();
-    queue.pop();
+  return found;
+}
 
-    if (node == ref_node_view) return true;
+// Ops whose outputs may share the buffer of their data inputs instead of
+// owning a new one.
+const auto aliasing_ops = gtl::FlatSet<string>{
+    "Identity",    "IdentityN",       "Snapshot",      "Reshape",
+    "ExpandDims",  "Squeeze",         "Bitcast",       "StopGradient",
+    "EnsureShape", "PreventGradient", "CheckNumerics", "Switch",
+    "RefSwitch"};
+
+// Control flow ops that move tensors between while loop frames. Their
+// outputs may be read by every iteration, e.g. a loop invariant passed
+// through a constant Enter, so a buffer reaching one of them is never
+// forwarded.
+const auto frame_ops = gtl::FlatSet<string>{
+    "Enter",         "RefEnter",         "Exit",  "RefExit",
+    "NextIteration", "RefNextIteration", "Merge", "RefMerge"};
+
+// Ops whose output buffer outlives the graph run and must never be
+// overwritten.
+const auto persistent_buffer_ops =
+    gtl::FlatSet<string>{"ReadVariableOp", "VariableV2", "Variable"};
+
+// Returns true if input `port` of aliasing op `node` may be forwarded to its
+// outputs.
+bool IsAliasedInput(const NodeDef& node, const int port) {
+  if (!aliasing_ops.count(node.op())) return false;
+  return port == 0 || node.op() == "IdentityN";
+}
 
-    for (const auto& in_node : node->GetRegularFanins())
-      queue.push(in_node.node_view());
+// Returns true if the current node is the last use of the buffer it reads from
+// `forward_port`, so the buffer is dead afterwards and may be reused for the
+// output. The buffer may be shared with other tensors through aliasing ops
+// such as Identity or Reshape, upward through the producers of the tensor and
+// downward through its consumers. This holds if every other consumer of every
+// such tensor must finish before the current node, whatever order the
+// executor picks for independent nodes.
+bool IsSafeForwarding(const MemoryOptContext* ctx,
+                      const MutableNodeView* node_view,
+                      const int forward_port) {
+  if (forward_port < 0) return false;
+
+  // Tensors sharing the buffer, as (producer, output port) pairs.
+  const auto& fanin = node_view->GetRegularFanin(forward_port);
+  std::vector<std::pair<const MutableNodeView*, int>> stack = {
+      {fanin.node_view(), fanin.index()}};
+  std::set<std::pair<int, int>> visited = {
+      {fanin.node_view()->node_index(), fanin.index()}};
+  auto visit = [&](const MutableNodeView* producer, int port) {
+    if (visited.insert({producer->node_index(), port}).second)
+      stack.push_back({producer, port});
+  };
+
+  int uses_by_node = 0;
+  while (!stack.empty()) {
+    const auto* producer = stack.back().first;
+    const int port = stack.back().second;
+    stack.pop_back();
+
+    // Constants, variables and fetched tensors are still alive after the
+    // current node, and tensors of other loop frames may be read again.
+    const auto* producer_def = producer->node();
+    if (IsInPreserveSet(ctx, producer_def) || IsAnyConst(*producer_def) ||
+        persistent_buffer_ops.count(producer_def->op()) ||
+        frame_ops.count(producer_def->op()))
+      return false;
+
+    // Upward: the tensor may be a view of the data inputs of its producer.
+    if (aliasing_ops.count(producer_def->op())) {
+      const auto& fanins = producer->GetRegularFanins();
+      for (int i = 0; i < fanins.size(); ++i) {
+        if (IsAliasedInput(*producer_def, i))
+          visit(fanins[i].node_view(), fanins[i].index());
+      }
+    }
+
+    for (const auto& consumer : producer->GetRegularFanout(port)) {
+      const auto* consumer_view = consumer.node_view();
+      // Prevent forwarding when the buffer is also read from another port of
+      // the current node, e.g. AddInput being the input of the fused op.
+      //      AddInput
+      //        /  |
+      //       /   |
+      //    Conv   |
+      //       \   |
+      //        \  |
+      //         Add
+      if (consumer_view == node_view) {
+        if (++uses_by_node > 1) return false;
+        continue;
+      }
+      if (frame_ops.count(consumer_view->node()->op()) ||
+          !MustRunBefore(consumer_view, node_view))
+        return false;
+
+      // Downward: the outputs of an aliasing consumer are views of the tensor.
+      if (IsAliasedInput(*consumer_view->node(), consumer.index())) {
+        for (int i = 0; i < consumer_view->GetRegularFanouts().size(); ++i)
+          visit(consumer_view, i);
+      }
+    }
   }
 
-  return false;
+  return true;
 }
 
 void CheckDependence(MemoryOptContext* ctx, const MutableNodeView* node_view,
@@ -205,7 +280,7 @@ void CheckDependence(MemoryOptContext* ctx, const MutableNodeView* node_view,
 
   // TODO(yifeng): Remove this work-around after binary add is ready.
   if (add_inplace_rule.count(node_view->node()->op())) {
-    if (IsSafeForwarding(node_view, forward_port)) {
+    if (IsSafeForwarding(ctx, node_view, forward_port)) {
       auto* new_attr = node_view->node()->mutable_attr();
 
       SetAttrValue(true, &(*new_attr)["inplace_sum"]);
@@ -215,7 +290,7 @@ void CheckDependence(MemoryOptContext* ctx, const MutableNodeView* node_view,
   }
 
   if (onednngraph_inplace_rule.count(node_view->node()->op())) {
-    if (IsSafeForwarding(node_view, forward_port)) {
+    if (IsSafeForwarding(ctx, node_view, forward_port)) {
       auto* new_attr = node_view->node()->mutable_attr();
       bool has_contraction_node = false;
 
@@ -254,7 +329,7 @@ void CheckDependence(MemoryOptContext* ctx, const MutableNodeView* node_view,
   if (ref_count < 1) return;
 
   // Safe forwarding
-  if (ref_count == 1) {
+  if (IsSafeForwarding(ctx, node_view, forward_port)) {
     sinfo[node_index].is_inplace = true;
     auto* new_attr = node_view->node()->mutable_attr();
     SetAttrValue(true, &(*new_attr)["is_inplace"]);
@@ -262,14 +337,7 @@ void CheckDependence(MemoryOptContext* ctx, const MutableNodeView* node_view,
   }
 
   // Unsafe forwarding
-  // TODO(yifeng): Count controlled fanins
-  // and adjust condition for block format.
-  if (node_view->NumRegularFanins() <= 1) {
-    sinfo[node_index].is_inplace = false;
-    return;
-  }
-
-  // TODO(yifeng): Create queries for ref_count > 1 && in_degree > 1
+  sinfo[node_index].is_inplace = false;
 }
 
 void DetectUnvisitedNode(MemoryOptContext* ctx,
@@ -332,12 +400,7 @@ void StaticInplaceOpt(MemoryOptContext* ctx, const char* device_name) {
   // Skip nodes that were invalidated
   int num_nodes = ctx->graph_view.graph()->node_size();
 
-  sinfo.reserve(num_nodes);
-  for (int node_index = 0; node_index < num_nodes; ++node_index) {
-    sinfo[node_index].is_inplace = false;
-    sinfo[node_index].is_visited = false;
-    sinfo[node_index].is_instack = false;
-  }
+  sinfo.assign(num_nodes, SearchInfo{false, false, false});
 
   ITEX_VLOG(1) << "MemoryOptPass: Start to rewrite nodes.";
 
@@ -353,6 +416,11 @@ void StaticInplaceOpt(MemoryOptContext* ctx, const char* device_name) {
 
     InplaceInference(ctx, node_view);
   }
+
+  int num_inplace_nodes = 0;
+  for (const auto& info : sinfo) num_inplace_nodes += info.is_inplace;
+  ITEX_VLOG(1) << "MemoryOptPass: " << num_inplace_nodes
+               << " nodes reuse the buffer of an input.";
 }
 
 Status RunMemoryOptPass(OptimizerContext* opt_ctx, const GrapplerItem& item,
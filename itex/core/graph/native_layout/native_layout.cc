@@ -16,6 +16,7 @@ limitations under the License.
 #include "itex/core/graph/native_layout/native_layout.h"
 
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -24,6 +25,8 @@ limitations under the License.
 #include "itex/core/graph/utils/op_types.h"
 #include "itex/core/graph/utils/utils.h"
 #include "itex/core/utils/attr_value_util.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/str_util.h"
 #include "itex/core/utils/types.h"
 
 namespace itex {
@@ -85,6 +88,8 @@ const std::vector<NativeFormatInfo>* GetCPUNativeFormatInfo() {
        AlwaysRewrite},
       {"Gelu", "ITEXGelu", CopyAttrsAll, AlwaysRewrite},
       {"GeluGrad", "ITEXGeluGrad", CopyAttrsAll, RewriteBackwardDataType},
+      // Rewritten as itself to mark constant params for the weight cache.
+      {"ItexRnn", "ItexRnn", CopyAttrsAllCheckConstFilter, AlwaysRewrite},
       {"LayerNorm", "ITEXLayerNorm", CopyAttrsAll, RewriteLayerNorm},
       {"LayerNormGrad", "ITEXLayerNormGrad", CopyAttrsAll,
        RewriteLayerNormGrad},
@@ -101,9 +106,11 @@ const std::vector<NativeFormatInfo>* GetCPUNativeFormatInfo() {
       {"Relu6", "_ITEXRelu6", CopyAttrsAll, AlwaysRewrite},
       {"Relu6Grad", "_ITEXRelu6Grad", CopyAttrsAll, RewriteBackwardDataType},
       {"ReluGrad", "_ITEXReluGrad", CopyAttrsAll, RewriteBackwardDataType},
-      {"ResizeBilinear", "_ITEXResizeBilinear", CopyAttrsAll, RewriteResize},
+      {"ResizeBilinear", "_ITEXResizeBilinear", CopyAttrsAll, AlwaysRewrite},
       {"ResizeBilinearGrad", "_ITEXResizeBilinearGrad", CopyAttrsAll,
        RewriteResize},
+      {"ResizeNearestNeighbor", "_ITEXResizeNearestNeighbor", CopyAttrsAll,
+       AlwaysRewrite},
       {"Slice", "_ITEXSlice", CopyAttrsAll, AlwaysRewrite},
       {"Softmax", "_ITEXSoftmax", CopyAttrsAll, AlwaysRewrite},
       {"Transpose", "_ITEXTranspose", CopyAttrsAll, AlwaysRewrite},
@@ -337,13 +344,112 @@ const std::vector<NativeFormatInfo>* GetCustomNativeFormatInfo() {
   return &rinfo;
 }
 
+// The native CPU resize kernels also take 8-bit images, which oneDNN layout
+// doesn't rewrite.
+bool IsCPUResizeWith8BitImages(const NodeDef& node_def) {
+  if (node_def.op() != "ResizeBilinear" &&
+      node_def.op() != "ResizeNearestNeighbor") {
+    return false;
+  }
+  DataType T;
+  if (!TryGetNodeAttr(node_def, "T", &T)) return false;
+  return NodeIsOnCpu(&node_def) &&
+         (T == DataType::DT_INT8 || T == DataType::DT_UINT8);
+}
+
+// Returns true if `weight` is a non-empty constant of rank >= 2, whose dims
+// except the last two are 1.
+bool IsConst2DWeight(const NodeDef& weight) {
+  if (!IsConstant(weight)) return false;
+  auto value = weight.attr().find("value");
+  if (value == weight.attr().end() || !value->second.has_tensor()) {
+    return false;
+  }
+  const TensorShapeProto& shape = value->second.tensor().tensor_shape();
+  if (shape.dim_size() < 2) return false;
+  for (int i = 0; i < shape.dim_size(); ++i) {
+    if (shape.dim(i).size() <= 0) return false;
+    if (i < shape.dim_size() - 2 && shape.dim(i).size() != 1) return false;
+  }
+  return true;
+}
+
+// Rewrites fp32/bf16 MatMul and BatchMatMulV2 with a constant 2D weight to
+// _ITEXDynamicQuantizedMatMul, which runs them in int8 with activations
+// quantized at runtime. The int8 kernel dequantizes into its post ops, so
+// only bias and activation fusions are kept.
+void RewriteDynamicQuantizedMatMul(const utils::MutableNodeView* node_view,
+                                   const string& quantization_mode,
+                                   NodeDef* new_node) {
+  const string& op = new_node->op();
+  const bool is_batch_matmul = (op == "_ITEXBatchMatMulV2");
+  if (op != "_ITEXMatMul" && op != "_ITEXFusedMatMul" && !is_batch_matmul) {
+    return;
+  }
+
+  DataType T;
+  bool is_filter_const = false;
+  if (!TryGetNodeAttr(*new_node, "T", &T) ||
+      (T != DT_FLOAT && T != DT_BFLOAT16) ||
+      !TryGetNodeAttr(*new_node, "is_filter_const", &is_filter_const) ||
+      !is_filter_const) {
+    return;
+  }
+
+  bool transpose_a = false, transpose_b = false;
+  TryGetNodeAttr(*new_node, is_batch_matmul ? "adj_x" : "transpose_a",
+                 &transpose_a);
+  TryGetNodeAttr(*new_node, is_batch_matmul ? "adj_y" : "transpose_b",
+                 &transpose_b);
+  if (transpose_a) return;
+  if (!IsConst2DWeight(*node_view->GetRegularFanin(1).node_view()->node())) {
+    return;
+  }
+
+  std::vector<string> fused_ops;
+  int32 num_args = 0;
+  float leakyrelu_alpha = 0.2f;
+  if (op == "_ITEXFusedMatMul") {
+    TryGetNodeAttr(*new_node, "fused_ops", &fused_ops);
+    TryGetNodeAttr(*new_node, "num_args", &num_args);
+    TryGetNodeAttr(*new_node, "leakyrelu_alpha", &leakyrelu_alpha);
+    static const std::unordered_set<string> kActivations = {
+        "Elu",  "GeluApproximate", "GeluExact", "HardSwish", "LeakyRelu",
+        "Relu", "Relu6",           "Sigmoid",   "Tanh",      "_ITEXMish",
+        "_ITEXSwish"};
+    bool has_bias = false;
+    for (size_t i = 0; i < fused_ops.size(); ++i) {
+      if (i == 0 && fused_ops[i] == "BiasAdd") {
+        has_bias = true;
+      } else if (i + 1 != fused_ops.size() ||
+                 !kActivations.count(fused_ops[i])) {
+        return;
+      }
+    }
+    if (num_args != (has_bias ? 1 : 0)) return;
+  }
+
+  new_node->set_op("_ITEXDynamicQuantizedMatMul");
+  auto* attr = new_node->mutable_attr();
+  attr->clear();
+  SetAttrValue(T, &(*attr)["T"]);
+  SetAttrValue(transpose_b, &(*attr)["transpose_b"]);
+  SetAttrValue(num_args, &(*attr)["num_args"]);
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+  SetAttrValue(leakyrelu_alpha, &(*attr)["leakyrelu_alpha"]);
+  SetAttrValue(quantization_mode, &(*attr)["quantization_mode"]);
+}
+
 }  // namespace
 
 const NativeFormatInfo* CheckForNodeNativeFormat(
     OptimizerContext* opt_ctx, const utils::MutableNodeView& node_view) {
   NodeDef& node_def = *(node_view.node());
 
-  if (!IsLayoutRewriteSupportedDataType(node_def)) return nullptr;
+  if (!IsLayoutRewriteSupportedDataType(node_def) &&
+      !IsCPUResizeWith8BitImages(node_def)) {
+    return nullptr;
+  }
 
   // We now check if rewrite rule applies for this op. If rewrite rule passes
   // for this op, then we rewrite it to Native op.
@@ -412,6 +518,11 @@ Status RewriteNode(NativeFormatContext* ctx, const int node_index,
 
   SetConstFilterAttr(node_view, &new_node_def, ctx->nodes_to_preserve);
 
+  if (!ctx->dynamic_quantization_mode.empty()) {
+    RewriteDynamicQuantizedMatMul(node_view, ctx->dynamic_quantization_mode,
+                                  &new_node_def);
+  }
+
   // Incoming data edges from 'orig_node' node to new 'new_node' node are
   // already copied in BuildNode. We need to handle control edges now.
   for (int idx = 0; idx < node_view->NumControllingFanins(); idx++) {
@@ -435,6 +546,19 @@ Status RunNativeLayout(OptimizerContext* opt_ctx, const GrapplerItem& item,
   GraphDef multable_graph_def = graph_def;
   NativeFormatContext ctx(item, &multable_graph_def, &status);
 
+  // Dynamic quantization only has CPU kernels.
+  if (absl::StrContains(opt_ctx->device_name, DEVICE_CPU)) {
+    string mode;
+    ITEX_CHECK_OK(ReadStringFromEnvVar("ITEX_DYNAMIC_QUANTIZATION", "", &mode));
+    mode = str_util::Uppercase(mode);
+    if (mode == "PER_TENSOR" || mode == "PER_ROW") {
+      ctx.dynamic_quantization_mode = mode;
+    } else if (!mode.empty() && mode != "0" && mode != "OFF") {
+      ITEX_LOG(WARNING) << "Invalid ITEX_DYNAMIC_QUANTIZATION " << mode
+                        << ", should be PER_TENSOR, PER_ROW or OFF.";
+    }
+  }
+
   // Processing graph in reverse-topological sorted order allows to remap
   // longer chains of dependent ops in one pass.
   TF_ABORT_IF_ERROR(
@@ -41,6 +41,9 @@ struct NativeFormatContext {
   utils::MutableGraphView graph_view;
   std::unordered_set<string> nodes_to_preserve;
   NodeTypeAttrMap node_type_map;
+  // Value of `quantization_mode` of _ITEXDynamicQuantizedMatMul if MatMul is
+  // rewritten to it, empty otherwise. See ITEX_DYNAMIC_QUANTIZATION.
+  string dynamic_quantization_mode;
 };
 
 /// Structure to specify the name of an original node, its new name after
@@ -1677,7 +1677,7 @@ Status TranslateReduce(const OneDnnGraphContext* ctx, const int node_index,
   auto* node_def = node_view->node();
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
-      ctx->graph_properties.GetInputProperties(node_def->name(), &props));
+      ctx->graph_properties->GetInputProperties(node_def->name(), &props));
   if (props.size() != 2) {
     onednn_graph_node = nullptr;
     return Status::OK();
@@ -3247,8 +3247,8 @@ void DumpLLGAGraph(const GraphDef& graph_def, const std::string prefix) {
   ITEX_VLOG(4) << "Dump graph to: " << dump_file_name;
 }
 
-Status RunOneDnnGraph(const GrapplerItem& item, const GraphDef& graph_def,
-                      GraphDef* optimized_graph) {
+Status RunOneDnnGraph(OptimizerContext* opt_ctx, const GrapplerItem& item,
+                      const GraphDef& graph_def, GraphDef* optimized_graph) {
   // TODO(itex): Remove the lock, when LLGA modify their all thread unsafe
   // data structure, such as "pass_manager". Seems LLGA already fix the error
   mutex_lock m(&mu);
@@ -3282,14 +3282,11 @@ Status RunOneDnnGraph(const GrapplerItem& item, const GraphDef& graph_def,
   // TODO(itex): shape inference currently only used in verify scalar tensor
   // for LLGA Mul. Remove this shape inference function, once LLGA supports
   // scalar tensor.
-  if (!ctx.inferred_graph_properties) {
-    TF_RETURN_IF_ERROR(ctx.graph_properties.InferStatically(
-        /*assume_valid_feeds=*/true,
-        /*aggressive_shape_inference=*/false,
-        /*include_input_tensor_values=*/true,
-        /*include_output_tensor_values=*/false));
-    ctx.inferred_graph_properties = true;
-  }
+  TF_RETURN_IF_ERROR(opt_ctx->GetGraphProperties(
+      item, /*assume_valid_feeds=*/true,
+      /*aggressive_shape_inference=*/false,
+      /*include_input_tensor_values=*/true,
+      /*include_output_tensor_values=*/false, &ctx.graph_properties));
 
   TF_ABORT_IF_ERROR(ctx.graph_view.SortTopologically(false, {}));
   TF_ABORT_IF_ERROR(RunPrePass(&ctx));
@@ -24,6 +24,7 @@ limitations under the License.
 #include "itex/core/graph/utils/graph_view.h"
 #include "itex/core/graph/utils/grappler_item.h"
 #include "itex/core/graph/utils/node_type_attr_map.h"
+#include "itex/core/graph/utils/utils.h"
 #include "itex/core/utils/node_def_util.h"
 #include "protos/graph.pb.h"
 
@@ -36,20 +37,19 @@ struct OneDnnGraphContext {
       : graph_view(g_def, status),
         fetch_tensors(item.fetch),
         nodes_to_preserve(item.NodesToPreserve()),
-        graph_properties(item),
-        inferred_graph_properties(false) {
+        graph_properties(nullptr) {
     TF_ABORT_IF_ERROR(node_type_map.Init(*g_def));
   }
   utils::MutableGraphView graph_view;
   NodeTypeAttrMap node_type_map;
   std::vector<string> fetch_tensors;
   std::unordered_set<string> nodes_to_preserve;
-  GraphProperties graph_properties;
-  bool inferred_graph_properties;
+  // Owned by OptimizerContext and shared with other passes.
+  GraphProperties* graph_properties;
 };
 
-Status RunOneDnnGraph(const GrapplerItem& item, const GraphDef& graph_def,
-                      GraphDef* optimized_graph);
+Status RunOneDnnGraph(OptimizerContext* opt_ctx, const GrapplerItem& item,
+                      const GraphDef& graph_def, GraphDef* optimized_graph);
 
 }  // namespace graph
 }  // namespace itex
@@ -0,0 +1,241 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/graph/optimized_graph_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "itex/core/utils/coding.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/fingerprint.h"
+#include "itex/core/utils/hash.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/path.h"
+#include "itex/core/utils/proto_serialization.h"
+
+extern char** environ;
+
+namespace itex {
+namespace graph {
+
+namespace {
+
+// Disk entry layout: 8 bytes magic, 8 bytes Hash64 of the graph, the
+// serialized optimized GraphDef.
+constexpr char kMagic[] = "ITEXGC01";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+constexpr size_t kHeaderSize = kMagicSize + sizeof(uint64);
+
+string* VersionString() {
+  static string* version = new string();
+  return version;
+}
+
+// Environment variables read by ITEX passes, e.g. the auto mixed precision
+// lists, aren't all part of OptimizerConfigFlags.
+string ItexEnvironment() {
+  std::vector<string> vars;
+  for (char** env = environ; env != nullptr && *env != nullptr; ++env) {
+    if (absl::StartsWith(*env, "ITEX_") || absl::StartsWith(*env, "_ITEX_")) {
+      vars.emplace_back(*env);
+    }
+  }
+  std::sort(vars.begin(), vars.end());
+  return absl::StrJoin(vars, ";");
+}
+
+}  // namespace
+
+OptimizedGraphCache* OptimizedGraphCache::Get() {
+  static OptimizedGraphCache* cache = []() -> OptimizedGraphCache* {
+    bool enabled;
+    ITEX_CHECK_OK(ReadBoolFromEnvVar("ITEX_GRAPH_OPT_CACHE", false, &enabled));
+    if (!enabled) return nullptr;
+
+    int64 budget_mb;
+    ITEX_CHECK_OK(
+        ReadInt64FromEnvVar("ITEX_GRAPH_OPT_CACHE_MB", 256, &budget_mb));
+    string dir;
+    ITEX_CHECK_OK(ReadStringFromEnvVar("ITEX_GRAPH_OPT_CACHE_DIR", "", &dir));
+    if (!dir.empty()) {
+      Status status = Env::Default()->RecursivelyCreateDir(dir);
+      if (!status.ok()) {
+        ITEX_LOG(WARNING) << "Failed to create graph cache directory " << dir
+                          << ", the cache is kept in memory only: " << status;
+        dir.clear();
+      }
+    }
+    size_t budget = budget_mb < 0 ? 0 : static_cast<size_t>(budget_mb) << 20;
+    return new OptimizedGraphCache(budget, std::move(dir));
+  }();
+  return cache;
+}
+
+void OptimizedGraphCache::SetVersion(const string& version) {
+  *VersionString() = version;
+}
+
+string OptimizedGraphCache::Key(const GraphDef& graph_def,
+                                const GrapplerItem& item,
+                                const char* device_name,
+                                const OptimizerConfigFlags& config) {
+  // Attributes are a map field, the serialization TF passed in may order them
+  // differently for identical graphs.
+  string serialized_graph;
+  SerializeToStringDeterministic(graph_def, &serialized_graph);
+  Fprint128 graph_fingerprint = Fingerprint128(serialized_graph);
+
+  std::unordered_set<string> preserve_set = item.NodesToPreserve();
+  std::vector<string> nodes_to_preserve(preserve_set.begin(),
+                                        preserve_set.end());
+  std::sort(nodes_to_preserve.begin(), nodes_to_preserve.end());
+
+  string key_string = absl::StrCat(
+      *VersionString(), "::", device_name, "::", graph_fingerprint.high64, "_",
+      graph_fingerprint.low64, "::", absl::StrJoin(nodes_to_preserve, ","),
+      "::", absl::StrJoin(item.fetch, ","), "::");
+  for (bool flag :
+       {config.enable_sharding, config.enable_onednn_graph,
+        config.enable_onednn_graph_all_type,
+        config.enable_onednn_graph_compiler_backend,
+        config.enable_onednn_graph_dnnl_backend,
+        config.enable_tf_constant_folding, config.enable_optimize_aggressive,
+        config.enable_remapper, config.enable_auto_mixed_precision,
+        config.enable_layout_opt, config.enable_test_mode}) {
+    key_string.push_back(flag ? '1' : '0');
+  }
+  absl::StrAppend(&key_string, "_", config.remapper_run_pass,
+                  "::", ItexEnvironment());
+
+  Fprint128 fingerprint = Fingerprint128(key_string);
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+OptimizedGraphCache::OptimizedGraphCache(size_t budget, string dir)
+    : budget_(budget),
+      dir_(std::move(dir)),
+      bytes_(0),
+      hits_(0),
+      misses_(0) {}
+
+string OptimizedGraphCache::FilePath(const string& key) const {
+  return io::JoinPath(dir_, absl::StrCat(key, ".graph"));
+}
+
+bool OptimizedGraphCache::Lookup(const string& key,
+                                 TF_Buffer* optimized_graph_buf) {
+  string data;
+  {
+    mutex_lock lock(&mu_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+      data = iter->second->second;
+    }
+  }
+  if (data.empty()) {
+    if (dir_.empty() || !ReadFromDisk(key, &data)) {
+      misses_++;
+      return false;
+    }
+    mutex_lock lock(&mu_);
+    InsertLocked(key, data);
+  }
+  hits_++;
+
+  void* buf = malloc(data.size());
+  if (buf == nullptr) return false;
+  memcpy(buf, data.data(), data.size());
+  optimized_graph_buf->data = buf;
+  optimized_graph_buf->length = data.size();
+  optimized_graph_buf->data_deallocator = [](void* data, size_t length) {
+    free(data);
+  };
+  ITEX_VLOG(2) << "Optimized graph cache hit: " << key << ", hits "
+               << hits_.load() << ", misses " << misses_.load();
+  return true;
+}
+
+void OptimizedGraphCache::Insert(const string& key,
+                                 const TF_Buffer* optimized_graph_buf) {
+  string data(static_cast<const char*>(optimized_graph_buf->data),
+              optimized_graph_buf->length);
+  if (!dir_.empty()) WriteToDisk(key, data);
+  mutex_lock lock(&mu_);
+  InsertLocked(key, std::move(data));
+}
+
+void OptimizedGraphCache::InsertLocked(const string& key, string data) {
+  if (data.size() > budget_ || index_.count(key) > 0) return;
+  while (bytes_ + data.size() > budget_) {
+    bytes_ -= lru_list_.back().second.size();
+    index_.erase(lru_list_.back().first);
+    lru_list_.pop_back();
+  }
+  bytes_ += data.size();
+  lru_list_.emplace_front(key, std::move(data));
+  index_[key] = lru_list_.begin();
+}
+
+bool OptimizedGraphCache::ReadFromDisk(const string& key, string* data) {
+  string path = FilePath(key);
+  string file_data;
+  if (!ReadFileToString(Env::Default(), path, &file_data).ok()) return false;
+
+  if (file_data.size() < kHeaderSize ||
+      StringPiece(file_data.data(), kMagicSize) != kMagic ||
+      core::DecodeFixed64(file_data.data() + kMagicSize) !=
+          Hash64(file_data.data() + kHeaderSize,
+                 file_data.size() - kHeaderSize)) {
+    ITEX_LOG(WARNING) << "Removing corrupted graph cache entry " << path;
+    Env::Default()->DeleteFile(path).IgnoreError();
+    return false;
+  }
+  *data = file_data.substr(kHeaderSize);
+  return true;
+}
+
+void OptimizedGraphCache::WriteToDisk(const string& key, const string& data) {
+  string file_data(kMagic, kMagicSize);
+  core::PutFixed64(&file_data, Hash64(data));
+  file_data.append(data);
+
+  // Write to a unique temporary file then rename, so other processes never
+  // read a partial entry.
+  Env* env = Env::Default();
+  string path = FilePath(key);
+  string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) return;
+  Status status = WriteStringToFile(env, tmp_path, file_data);
+  if (status.ok()) status = env->RenameFile(tmp_path, path);
+  if (!status.ok()) {
+    env->DeleteFile(tmp_path).IgnoreError();
+    ITEX_LOG(WARNING) << "Failed to write graph cache entry " << path << ": "
+                      << status;
+  }
+}
+
+}  // namespace graph
+}  // namespace itex
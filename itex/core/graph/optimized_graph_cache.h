@@ -0,0 +1,102 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_GRAPH_OPTIMIZED_GRAPH_CACHE_H_
+#define ITEX_CORE_GRAPH_OPTIMIZED_GRAPH_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "itex/core/graph/optimizer_config.h"
+#include "itex/core/graph/utils/grappler_item.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/types.h"
+#include "protos/graph.pb.h"
+#include "tensorflow/c/c_api.h"
+
+namespace itex {
+namespace graph {
+
+// Cache of graphs optimized by the ITEX graph optimizer. TF calls the plugin
+// optimizer for every function and session, so identical graphs, e.g. each
+// replica of a tf.function or each worker of a multi-instance launch, would
+// otherwise run the whole pipeline again.
+//
+// The key is a fingerprint of the input graph, the nodes to preserve, the
+// device type, the optimizer config flags, all `ITEX_*` environment variables
+// and the ITEX and TF versions, so entries of another build or configuration
+// are never used.
+//
+// Graphs are not cached while oneDNN Graph is enabled: `_OneDnnGraph` nodes
+// index partitions owned by the process that ran the oneDNN Graph pass.
+//
+// The cache is opt-in through `ITEX_GRAPH_OPT_CACHE`. Entries are kept in
+// memory up to `ITEX_GRAPH_OPT_CACHE_MB`, least recently used first out. If
+// `ITEX_GRAPH_OPT_CACHE_DIR` is set, entries are also written there and
+// shared by all processes using the directory.
+class OptimizedGraphCache {
+ public:
+  // Returns the process-wide cache, or nullptr if it is disabled.
+  static OptimizedGraphCache* Get();
+
+  // Sets the ITEX and TF versions that are part of every key. Called once
+  // when the graph optimizer is registered.
+  static void SetVersion(const string& version);
+
+  static string Key(const GraphDef& graph_def, const GrapplerItem& item,
+                    const char* device_name,
+                    const OptimizerConfigFlags& config);
+
+  // Copies the optimized graph stored for `key` to `optimized_graph_buf`.
+  // Returns false on miss.
+  bool Lookup(const string& key, TF_Buffer* optimized_graph_buf);
+
+  void Insert(const string& key, const TF_Buffer* optimized_graph_buf);
+
+  int64 hits() const { return hits_.load(); }
+  int64 misses() const { return misses_.load(); }
+
+ private:
+  using LRUList = std::list<std::pair<string, string>>;
+
+  OptimizedGraphCache(size_t budget, string dir);
+
+  string FilePath(const string& key) const;
+  bool ReadFromDisk(const string& key, string* data);
+  void WriteToDisk(const string& key, const string& data);
+  void InsertLocked(const string& key, string data)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const size_t budget_;
+  const string dir_;
+
+  mutex mu_;
+  size_t bytes_ TF_GUARDED_BY(mu_);
+  LRUList lru_list_ TF_GUARDED_BY(mu_);
+  std::unordered_map<string, LRUList::iterator> index_ TF_GUARDED_BY(mu_);
+  std::atomic<int64> hits_;
+  std::atomic<int64> misses_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(OptimizedGraphCache);
+};
+
+}  // namespace graph
+}  // namespace itex
+
+#endif  // ITEX_CORE_GRAPH_OPTIMIZED_GRAPH_CACHE_H_
@@ -46,6 +46,7 @@ constexpr char kDequantize[] = "Dequantize";
 constexpr char kFill[] = "Fill";
 constexpr char kFusedBatchNormV3[] = "FusedBatchNormV3";
 constexpr char kGelu[] = "ITEXGelu";
+constexpr char kGroupNorm[] = "ITEXGroupNorm";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMatMul[] = "MatMul";
 constexpr char kMean[] = "Mean";
@@ -105,6 +106,7 @@ constexpr char kFusedDepthwiseConv2dNative[] =
 constexpr char kFusedMatMul[] = "_ITEXFusedMatMul";
 constexpr char kFusedMatMulWithSum[] = "_ITEXFusedMatMulWithSum";
 constexpr char kFusedMatMulGrad[] = "_ITEXFusedMatMulGrad";
+constexpr char kFusedGroupNorm[] = "_ITEXFusedGroupNorm";
 constexpr char kFusedInstanceNorm[] = "_ITEXFusedInstanceNorm";
 constexpr char kFusedRandom[] = "_ITEXFusedRandom";
 constexpr char kFusedResourceApplyAdam[] = "_ITEXFusedResourceApplyAdam";
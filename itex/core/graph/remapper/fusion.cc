@@ -132,9 +132,11 @@ Status LaunchPatternMatcher(RemapperContext* ctx, int index,
   for (auto const& fusion : FusionMgr::GetInstance().GetFusions(node->op())) {
     if (!is_full && !fusion->IsPartial()) continue;
     ITEX_VLOG(3) << "Start to run fusion pass: " << fusion->Name();
-    auto properties = fusion->Check(ctx, index);
-    if (!properties.Empty()) {
-      Status status = fusion->Update(ctx, properties);
+    Status status;
+    bool matched = RecordMatcher(ctx, fusion->Name(), [&]() {
+      auto properties = fusion->Check(ctx, index);
+      if (properties.Empty()) return false;
+      status = fusion->Update(ctx, properties);
 
       for (auto const& index : properties.invalidated) {
         invalidated->at(index) = true;
@@ -144,7 +146,9 @@ Status LaunchPatternMatcher(RemapperContext* ctx, int index,
         RemoveAllRegularFanin(ctx, index);
         deleted->at(index) = true;
       }
-
+      return true;
+    });
+    if (matched) {
       ITEX_VLOG(3) << "Succeed to match fusion pass: " << fusion->Name();
       return status;
     }
@@ -0,0 +1,113 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/graph/remapper/constant_names.h"
+#include "itex/core/graph/remapper/fusion.h"
+#include "itex/core/graph/remapper/remapper.h"
+#include "itex/core/graph/utils/pattern_utils.h"
+#include "itex/core/graph/utils/utils.h"
+
+namespace itex {
+namespace graph {
+
+// Fuse ITEXGroupNorm and Swish into _ITEXFusedGroupNorm, which applies the
+// activation while normalizing, so the output is written once. The UNets of
+// diffusion models follow nearly every GroupNorm with SiLU.
+/*
+        swish
+          |                 _ITEXFusedGroupNorm
+     ITEXGroupNorm    =>      /      |      \
+      /    |    \           input  gamma   beta
+   input gamma  beta
+*/
+// Swish is matched after the sigmoid-with-mul fusion rewrote Sigmoid and Mul.
+// Only the CPU kernel fuses the activation.
+class GroupNormWithSwishFusion : public Fusion {
+ public:
+  GroupNormWithSwishFusion() : Fusion() {
+    using utils::NodeStatus;
+    using utils::OpTypePattern;
+    OpTypePattern input = {kAny, "input", NodeStatus::kRemain};
+    OpTypePattern gamma = {kAny, "gamma", NodeStatus::kRemain};
+    OpTypePattern beta = {kAny, "beta", NodeStatus::kRemain};
+    OpTypePattern group_norm = {kGroupNorm, "group_norm", NodeStatus::kRemove};
+    OpTypePattern swish = {kSwish, "swish", NodeStatus::kReplace};
+
+    group_norm.AddInput(input).AddInput(gamma).AddInput(beta);
+    swish.AddInput(group_norm);
+
+    pattern_ = InternalPattern(std::move(swish));
+  }
+
+  ~GroupNormWithSwishFusion() {}
+
+  std::string Name() override { return "group-norm-with-swish"; }
+
+  MatchedProperties Check(RemapperContext* ctx,
+                          const int node_index) const override {
+    MatchedProperties ret;
+    auto& graph_view = ctx->graph_view;
+    auto* swish_view = graph_view.GetNode(node_index);
+    const NodeDef* swish = swish_view->node();
+    if (!NodeIsOnCpu(swish)) return ret;
+    if (!HasDataType(swish, DT_FLOAT) && !HasDataType(swish, DT_BFLOAT16))
+      return ret;
+
+    // Plain Swish only, i.e. x * sigmoid(x).
+    float alpha = 1.0f;
+    TryGetNodeAttr(*swish, "alpha", &alpha);
+    if (alpha != 1.0f) return ret;
+
+    ret = FillProperties(&graph_view, swish_view, pattern_);
+    if (ret.Empty()) return ret;
+
+    // The normalized output mustn't be used by anything else, e.g. by the
+    // gradient of Swish in training graphs.
+    auto* group_norm_view = graph_view.GetNode(ret.map.at("group_norm"));
+    if (!HasAtMostOneFanoutAtPort0(*group_norm_view) ||
+        HasControlFaninOrFanout(*group_norm_view)) {
+      return ret.ToEmpty();
+    }
+    return ret;
+  }
+
+  Status Update(RemapperContext* ctx,
+                const MatchedProperties& properties) const override {
+    auto& graph_view = ctx->graph_view;
+    const NodeDef* swish = properties.GetNode(&graph_view, "swish");
+    const NodeDef* group_norm = properties.GetNode(&graph_view, "group_norm");
+
+    NodeDef fused_op;
+    fused_op.set_name(swish->name());
+    fused_op.set_op(kFusedGroupNorm);
+    fused_op.set_device(swish->device());
+    for (int i = 0; i < 3; ++i) fused_op.add_input(group_norm->input(i));
+
+    auto* attr = fused_op.mutable_attr();
+    *attr = group_norm->attr();
+    SetAttrValue("Swish", &(*attr)["activation_mode"]);
+
+    Status status;
+    utils::Mutation* mutation = graph_view.GetMutationBuilder();
+    mutation->AddNode(std::move(fused_op), &status);
+    TF_RETURN_IF_ERROR(status);
+    TF_RETURN_IF_ERROR(mutation->Apply());
+    return Status::OK();
+  }
+};
+REGISTER_FUSION(GroupNormWithSwishFusion)
+
+}  // namespace graph
+}  // namespace itex
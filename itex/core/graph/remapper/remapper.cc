@@ -17,10 +17,12 @@ limitations under the License.
 
 #include "itex/core/graph/remapper/remapper.h"
 
+#include <algorithm>
 #include <map>
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -492,7 +494,7 @@ bool IsAddWithNoBroadcast(const RemapperContext& ctx, const NodeDef& node) {
   // Check if this is case of broadcasting - Add node supports broadcasting.
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
-      ctx.graph_properties.GetInputProperties(node.name(), &props));
+      ctx.graph_properties->GetInputProperties(node.name(), &props));
   if (props.size() == 2 &&
       ShapesSymbolicallyEqual(props[0].shape(), props[1].shape())) {
     return true;
@@ -516,7 +518,7 @@ bool IsBiasSemanticAdd(const RemapperContext& ctx,
 
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
-      ctx.graph_properties.GetInputProperties(node_def->name(), &props));
+      ctx.graph_properties->GetInputProperties(node_def->name(), &props));
 
   if (props.size() < 2) return false;
 
@@ -589,7 +591,7 @@ int GetMulScalarInputIndex(const RemapperContext& ctx,
                            const NodeDef& node_def) {
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
-      ctx.graph_properties.GetInputProperties(node_def.name(), &props));
+      ctx.graph_properties->GetInputProperties(node_def.name(), &props));
   if (props.size() != 2) return -1;
 
   bool left_is_scalar = IsScalar(props[0].shape());
@@ -993,13 +995,13 @@ bool FindMatmulReshapeBiasadd(const RemapperContext& ctx, int node_index,
   int weight_dim = 0;
 
   std::vector<OpInfo_TensorProperties> props_bias;
-  TF_ABORT_IF_ERROR(ctx.graph_properties.GetInputProperties(
+  TF_ABORT_IF_ERROR(ctx.graph_properties->GetInputProperties(
       biasadd->node()->name(), &props_bias));
   if (props_bias.empty() || Rank(props_bias[1].shape()) < 1) return false;
   bias_dim = props_bias[1].shape().dim(0).size();
 
   std::vector<OpInfo_TensorProperties> props_weight;
-  TF_ABORT_IF_ERROR(ctx.graph_properties.GetInputProperties(
+  TF_ABORT_IF_ERROR(ctx.graph_properties->GetInputProperties(
       matmul->node()->name(), &props_weight));
   if (props_weight.empty() || Rank(props_weight[1].shape()) < 2) return false;
   weight_dim = props_weight[1].shape().dim(1).size();
@@ -1584,7 +1586,7 @@ bool FindFusedBatchNormEx(const RemapperContext& ctx, int node_index,
 
     // Add node supports broadcasting, FusedBatchNormEx does not.
     std::vector<OpInfo_TensorProperties> props;
-    TF_ABORT_IF_ERROR(ctx.graph_properties.GetInputProperties(
+    TF_ABORT_IF_ERROR(ctx.graph_properties->GetInputProperties(
         relu_fanin_0_node_def->name(), &props));
     if (props.size() < 2 ||
         !ShapesSymbolicallyEqual(props[0].shape(), props[1].shape()))
@@ -1720,7 +1722,7 @@ bool FindAddV2WithSoftmax(const RemapperContext& ctx, int node_index,
   // check the shape of input nodes of AddV2
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
-      ctx.graph_properties.GetInputProperties(addv2_node_def->name(), &props));
+      ctx.graph_properties->GetInputProperties(addv2_node_def->name(), &props));
 
   if (props.size() < 2) return false;
   const TensorShapeProto& left_shape = props[0].shape();
@@ -2152,9 +2154,12 @@ bool FindFusedTrainingOp(const RemapperContext& ctx, int node_index,
   const auto* node_view = ctx.graph_view.GetNode(node_index);
   const auto* node_def = node_view->node();
 
-  // Only GPU supports this fusion.
-  // TODO(itex): Remove this limitation once it's supported.
-  if (!NodeIsOnGpu(node_def)) return false;
+  // CPU kernels are only registered for float, bfloat16 and half.
+  if (NodeIsOnCpu(node_def)) {
+    DataType dtype = GetDataTypeFromAttr(*node_def, "T");
+    if (dtype != DT_FLOAT && dtype != DT_BFLOAT16 && dtype != DT_HALF)
+      return false;
+  }
 
   int input_index = -1;
   if (IsApplyMomentum(*node_def) || IsResourceApplyMomentum(*node_def)) {
@@ -2477,7 +2482,7 @@ bool FindRandomWithComparisonAndCast(const RemapperContext& ctx, int node_index,
 
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
-      ctx.graph_properties.GetInputProperties(node_def->name(), &props));
+      ctx.graph_properties->GetInputProperties(node_def->name(), &props));
 
   if (props.size() != 2) return false;
   const auto HasRandom = [&](int direction) -> bool {
@@ -2710,6 +2715,8 @@ bool FindPadConvFwdBwd(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+bool IsRootOfOtherFusion(const RemapperContext& ctx, const NodeDef& node);
+
 // Find sequatial binary ops.
 bool FindFusedBinary(const RemapperContext& ctx, int node_index,
                      FusedBinary* matched) {
@@ -2719,11 +2726,16 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
   // Only check control fanin for output node is enough.
   if (HasControlFanin(*node_view)) return false;
 
-  // Only support on GPU.
-  if (NodeIsOnCpu(node_def)) return false;
+  // The CPU kernel also evaluates RealDiv/Maximum/Minimum and broadcasts the
+  // inputs, so it fuses longer chains than the GPU one.
+  const bool on_cpu = NodeIsOnCpu(node_def);
+  const auto is_binary = [on_cpu](const NodeDef& binary) -> bool {
+    if (IsAdd(binary) || IsMul(binary) || IsSub(binary)) return true;
+    return on_cpu &&
+           (IsRealDiv(binary) || IsMaximum(binary) || IsMinimum(binary));
+  };
 
-  // Only support Add/Mul/Sub now because they satisfy the commutative law.
-  if (!IsAdd(*node_def) && !IsMul(*node_def) && !IsSub(*node_def)) return false;
+  if (!is_binary(*node_def)) return false;
 
   if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_BFLOAT16) &&
       !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)))
@@ -2734,9 +2746,22 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
     const auto* binary_def = binary.node();
     std::vector<OpInfo_TensorProperties> props;
     TF_ABORT_IF_ERROR(
-        ctx.graph_properties.GetInputProperties(binary_def->name(), &props));
+        ctx.graph_properties->GetInputProperties(binary_def->name(), &props));
 
     if (props.size() < 2) return false;
+    if (on_cpu) {
+      // The kernel broadcasts its inputs at run time, but only take inputs
+      // known to be compatible so that no invalid graph is fused.
+      const auto is_static = [](const TensorShapeProto& shape) -> bool {
+        if (shape.unknown_rank()) return false;
+        for (const auto& dim : shape.dim()) {
+          if (dim.size() < 0) return false;
+        }
+        return true;
+      };
+      return is_static(props[0].shape()) && is_static(props[1].shape()) &&
+             ShapesBroadcastable(props[0], props[1]);
+    }
     bool same_input =
         ShapesSymbolicallyEqual(props[0].shape(), props[1].shape());
     bool has_scalar =
@@ -2747,11 +2772,30 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
 
   if (!valid_shape(*node_view)) return false;
 
+  // BiasAdd + Add is left to the contraction fusions.
+  const auto adds_bias_add = [](const utils::MutableNodeView& binary) -> bool {
+    if (!IsAdd(*binary.node())) return false;
+    for (const auto& fanin : binary.GetRegularFanins()) {
+      if (IsBiasAdd(*fanin.node_view()->node())) return true;
+    }
+    return false;
+  };
+  if (on_cpu && adds_bias_add(*node_view)) return false;
+
+  // Leave the ops to the fusion rooted at their consumer, e.g. LayerNorm, so
+  // the binary chain doesn't break it.
+  if (on_cpu && node_view->NumRegularFanouts() == 1) {
+    const auto& fanouts = node_view->GetRegularFanout(0);
+    if (fanouts.size() == 1 &&
+        IsRootOfOtherFusion(ctx, *fanouts[0].node_view()->node()))
+      return false;
+  }
+
   // Initialize root node.
   matched->root_ = node_index;
   matched->num_ = 1;
 
-  const int max_depth = 3;
+  const int max_depth = on_cpu ? 8 : 3;
 
   // Check inputs iteratively til they can't match sequatial Binary op.
   bool is_found = true;
@@ -2767,9 +2811,7 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
       const auto* input_node_view = regular_fanin.node_view();
       const auto* input_node_def = input_node_view->node();
 
-      if (!IsAdd(*input_node_def) && !IsMul(*input_node_def) &&
-          !IsSub(*input_node_def))
-        continue;
+      if (!is_binary(*input_node_def)) continue;
 
       if (!HasDataType(input_node_def, DT_FLOAT) &&
           !HasDataType(input_node_def, DT_BFLOAT16) &&
@@ -2784,6 +2826,8 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
 
       if (!valid_shape(*input_node_view)) continue;
 
+      if (on_cpu && adds_bias_add(*input_node_view)) continue;
+
       is_found = true;
       node_index = regular_fanin.node_index();
       matched->fused_ops_.push_back(node_index);
@@ -2819,7 +2863,7 @@ bool FindDropout(const RemapperContext& ctx, int node_index, Dropout* matched) {
     const auto* select_ref = select.node();
     std::vector<OpInfo_TensorProperties> props;
     TF_ABORT_IF_ERROR(
-        ctx.graph_properties.GetInputProperties(select_ref->name(), &props));
+        ctx.graph_properties->GetInputProperties(select_ref->name(), &props));
 
     if (props.size() < 3) return false;
     // Make sure the condition and t has same shape.
@@ -5892,6 +5936,358 @@ Status AddDilatedContractionNode(RemapperContext* ctx,
   return Status::OK();
 }
 
+// A hand-written fusion of the remapper. Like the fusions of `FusionMgr`, it
+// is only attempted on nodes whose op is one of `roots` or passes
+// `root_filter`, so each node runs the few matchers whose pattern can be rooted
+// at it instead of all of them. The roots only pre-filter the nodes, `run`
+// still checks the whole pattern.
+struct RemapperMatcher {
+  // Finds the pattern rooted at `node_index` and rewrites it. Returns true if
+  // the graph was changed.
+  using RunFn = bool (*)(RemapperContext* ctx, int node_index,
+                         std::vector<bool>* invalidated_nodes,
+                         std::vector<bool>* nodes_to_delete);
+
+  string name;
+  std::vector<string> roots;
+  bool (*root_filter)(absl::string_view op);
+  // Returns false if the matcher is disabled in the current remapper run.
+  // Always enabled if null.
+  bool (*enabled)(const RemapperContext& ctx);
+  RunFn run;
+};
+
+// Builds a `RemapperMatcher::RunFn` from a Find function filling a `pattern`
+// and the Add function rewriting it.
+#define REMAPPER_RUN_FN(pattern, find, add)                         \
+  [](RemapperContext* ctx, int node_index,                          \
+     std::vector<bool>* invalidated_nodes,                          \
+     std::vector<bool>* nodes_to_delete) -> bool {                  \
+    pattern matched;                                                \
+    if (!find(*ctx, node_index, &matched)) return false;            \
+    TF_ABORT_IF_ERROR(                                              \
+        add(ctx, matched, invalidated_nodes, nodes_to_delete));     \
+    return true;                                                    \
+  }
+
+bool IsBasicLevel(const RemapperContext& ctx) {
+  return ctx.remap_level == RemapperLevel::BASIC;
+}
+
+// Sequential binary fusion may break other high priority fusions, so it's
+// disabled in the 1st remapper.
+bool IsAdvancedLevel(const RemapperContext& ctx) {
+  return ctx.remap_level != RemapperLevel::BASIC;
+}
+
+bool IsLayoutOpt(const RemapperContext& ctx) {
+  return GetOptimizerConfigFlags().enable_layout_opt;
+}
+
+bool IsBasicLevelWithLayoutOpt(const RemapperContext& ctx) {
+  return IsBasicLevel(ctx) && IsLayoutOpt(ctx);
+}
+
+bool IsOneDnnGraphCompilerBackend(const RemapperContext& ctx) {
+  return GetOptimizerConfigFlags().enable_onednn_graph_all_type &&
+         GetOptimizerConfigFlags().enable_onednn_graph_compiler_backend;
+}
+
+const std::vector<string>& FusedConvRoots() {
+  static const std::vector<string>* roots =
+      new std::vector<string>{"Conv2D", kFusedConv2D, "Conv3D", kFusedConv3D};
+  return *roots;
+}
+
+// The fusions that always need to be enabled no matter `is_full` is true or
+// false, in priority order.
+const std::vector<RemapperMatcher>& CommonMatchers() {
+  static const std::vector<RemapperMatcher>* matchers =
+      new std::vector<RemapperMatcher>{
+          // Use AddV2 for AddN when N=2
+          {"AddNToAddV2", {"AddN"}, nullptr, nullptr,
+           REMAPPER_RUN_FN(int, FindAddV2, ReplaceAddN)},
+          // Remap TF2.11 dropout select to TF2.10 cast+mul.
+          {"Dropout", {"Select", "SelectV2"}, nullptr, nullptr,
+           REMAPPER_RUN_FN(Dropout, FindDropout, AddDropout)},
+          // Remap Gelu subgraph
+          {"Gelu", {"Mul"}, nullptr, IsBasicLevel,
+           [](RemapperContext* ctx, int node_index,
+              std::vector<bool>* invalidated_nodes,
+              std::vector<bool>* nodes_to_delete) -> bool {
+             std::map<string, int> matched_nodes_map;
+             std::set<int> remove_node_indices;
+             bool is_gelu_approximate = false;
+             if (!FindGelu(ctx, node_index, &matched_nodes_map,
+                           &remove_node_indices, &is_gelu_approximate)) {
+               return false;
+             }
+             TF_ABORT_IF_ERROR(AddGelu(ctx, &matched_nodes_map,
+                                       &remove_node_indices, invalidated_nodes,
+                                       nodes_to_delete, is_gelu_approximate));
+             return true;
+           }},
+          // Remap Mul+Max into the LeakyRelu.
+          {"MulWithMaximum", {"Maximum"}, nullptr, IsBasicLevel,
+           REMAPPER_RUN_FN(MulWithMaximum, FindMulWithMaximum,
+                           AddMulWithMaximumNode)},
+          {"MatmulReshapeBiasadd", {"Reshape"}, nullptr, nullptr,
+           REMAPPER_RUN_FN(MatmulReshapeBiasadd, FindMatmulReshapeBiasadd,
+                           AddMatmulReshapeBiasadd)},
+          {"DilatedContraction", {"BatchToSpaceND"}, nullptr, nullptr,
+           REMAPPER_RUN_FN(DilatedContraction, FindDilatedContraction,
+                           AddDilatedContractionNode)},
+      };
+  return *matchers;
+}
+
+// The fusions only enabled if `is_full` is true, in priority order.
+const std::vector<RemapperMatcher>& FullMatchers() {
+  static const std::vector<RemapperMatcher>* matchers = new std::vector<
+      RemapperMatcher>{
+      // keras Dense layer fwd
+      {"KerasDenseLayerFwd", {"Reshape"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(KerasDenseLayerFwd, FindKerasDenseLayerFwd,
+                       AddKerasDenseLayerFwd)},
+      // Remap Conv2D+BiasAdd+Activation+Add into the _ITEXFusedConv2D.
+      {"ContractionWithBiasAndActivationAdd", {"Add", "AddV2"}, nullptr,
+       nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAndActivationAdd,
+                       FindContractionWithBiasAndActivationAdd,
+                       AddFusedContractionNode)},
+      {"ResNeXtGroupConv2DBlock", {"ConcatV2"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(GroupConv2DBlock, FindResNeXtGroupConv2DBlock,
+                       AddGroupConv2DNode)},
+      // Remap Conv2D+BiasAdd+Add+Activation into the _ITEXFusedConv2D.
+      {"ContractionWithBiasAndAddActivation", {},
+       PostOpUtil::IsSupportedActivation, nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAndAddActivation,
+                       FindContractionWithBiasAndAddActivation,
+                       AddFusedContractionNode)},
+      // Remap Conv2D+BiasAdd+Add into the _ITEXFusedConv2D.
+      {"ContractionWithBiasAddAndAdd", {"AddN", "Add", "AddV2"}, nullptr,
+       nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAddAndAdd,
+                       FindContractionWithBiasAddAndAdd,
+                       AddFusedContractionNode)},
+      // Remap {Conv2D,DepthwiseConv2D,Conv3D,MatMul}+BiasAdd into the
+      // _ITEXFused{Conv2D,DepthwiseConv2dNative,Conv3D,MatMul}
+      {"ContractionWithBias",
+       {"BiasAdd", "BiasAddV1", "Add", "AddV2"},
+       nullptr,
+       nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAdd, FindContractionWithBias,
+                       AddFusedContractionNode)},
+      // Remap MatMul+BiasAddGrad into the _fusedMatMulGrad
+      {"ContractionWithBiasAddGrad", {"BiasAddGrad"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAddGrad,
+                       FindContractionWithBiasAddGrad,
+                       AddFusedContractionGradNode)},
+      // Remap {Conv2DBackpropFilter,Conv3DBackpropFilter}+BiasAddGrad into
+      // FusedContractionBackpropFiler.
+      {"ConvContractionWithBiasAddGrad", {"BiasAddGrad"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAddGrad,
+                       FindConvContractionWithBiasAddGrad,
+                       AddFusedContractionGradNode)},
+      // Remap {Conv2D,Conv3D,MatMul}+BiasAdd+Activation into
+      // _ITEXFused{Conv2D,Conv3D,MatMul}.
+      {"ContractionWithBiasAndActivation", {},
+       PostOpUtil::IsSupportedActivation, nullptr,
+       REMAPPER_RUN_FN(ContractionWithBiasAddAndActivation,
+                       FindContractionWithBiasAndActivation,
+                       AddFusedContractionNode)},
+      // Remap FusedBatchNorm+<SideInput>+<Activation> into the
+      // _FusedBatchNormEx.
+      {"FusedBatchNormEx", {"Relu"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(FusedBatchNormEx, FindFusedBatchNormEx,
+                       AddFusedBatchNormExNode)},
+      {"FusedBatchNormGradEx",
+       {"FusedBatchNormGrad", "FusedBatchNormGradV2", "FusedBatchNormGradV3"},
+       nullptr,
+       nullptr,
+       REMAPPER_RUN_FN(FusedBatchNormGradEx, FindFusedBatchNormGradEx,
+                       AddFusedBatchNormGradExNode)},
+      {"PadWithContractionFwdBwd", FusedConvRoots(), nullptr, nullptr,
+       REMAPPER_RUN_FN(PadWithContractionFwdBwd, FindPadWithContractionFwdBwd,
+                       AddPadWithContractionFwdBwd)},
+      // Remap Pad+{Conv2D, _ITEXFusedConv2D} into the _FusedPadConv2D.
+      {"PadWithContraction", FusedConvRoots(), nullptr, nullptr,
+       REMAPPER_RUN_FN(PadWithContraction, FindPadWithContraction,
+                       AddPadWithContractionNode)},
+      {"ConvBackpropInputWithSlice", {"Slice"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(ConvBackpropInputWithSlice,
+                       FindConvBackpropInputWithSlice,
+                       AddConvBackpropInputWithSliceNode)},
+      // Remap Mul + AddN + TrainingOp into the _FusedTrainingOp.
+      {"FusedTrainingOp",
+       {"ApplyMomentum", "ResourceApplyMomentum", "ApplyAdam",
+        "ResourceApplyAdam", "ITEXApplyAdamWithWeightDecay",
+        "ITEXResourceApplyAdamWithWeightDecay"},
+       nullptr,
+       IsBasicLevel,
+       REMAPPER_RUN_FN(FusedTrainingOp, FindFusedTrainingOp,
+                       AddFusedTrainingNode)},
+      // Remap BatchMatMul+Mul into the _FusedBatchMatMul.
+      {"ContractionWithMul", {"Mul", "MulNoNan"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(ContractionWithMul, FindContractionWithMul,
+                       AddFusedContractionNode)},
+      // delete dequantize node if it finds dequantize_with_shape pattern
+      {"DequantizeWithShape", {"Shape"}, nullptr, IsBasicLevel,
+       REMAPPER_RUN_FN(DequantizeWithShape, FindDequantizeWithShape,
+                       AddFusedDequantizeWithShape)},
+      // delete dequantize node if it finds dequantize_with_reshape pattern
+      {"DequantizeWithReshape", {"Reshape"}, nullptr, IsBasicLevelWithLayoutOpt,
+       REMAPPER_RUN_FN(DequantizeWithReshape, FindDequantizeWithReshape,
+                       AddFusedDequantizeWithReshape)},
+      // Remap QuantizeV2+QuantizedConv2D into the
+      // _ITEXQuantizeV2WithQuantizedConv2D
+      {"QuantizeV2WithQuantizedConv2D",
+       {"QuantizedConv2DWithBiasAndReluAndRequantize"},
+       nullptr,
+       IsLayoutOpt,
+       REMAPPER_RUN_FN(QuantizeV2WithQuantizedConv2D,
+                       FindQuantizeV2WithQuantizedConv2D,
+                       AddQuantizeV2WithQuantizedConv2DNode)},
+      {"QuantizedConv2DWithDequantize", {"Dequantize"}, nullptr, IsLayoutOpt,
+       REMAPPER_RUN_FN(QuantizedConv2DWithDequantize,
+                       FindQuantizedConv2DWithDequantize,
+                       AddQuantizedConv2DWithDequantizeNode)},
+      {"QuantizedConv2DWithCast", {"Cast"}, nullptr, IsLayoutOpt,
+       REMAPPER_RUN_FN(QuantizedConv2DWithCast, FindQuantizedConv2DWithCast,
+                       AddQuantizedConv2DWithCastNode)},
+      // Remap L2loss+AddN into the _FusedAddN
+      {"FusedAddN", {"AddN"}, nullptr, IsBasicLevel,
+       REMAPPER_RUN_FN(FusedAddN, FindFusedAddN, AddFusedAddN)},
+      {"AddV2WithSoftmax", {"Softmax"}, nullptr, IsBasicLevel,
+       REMAPPER_RUN_FN(AddV2WithSoftmax, FindAddV2WithSoftmax,
+                       AddFusedAddV2WithSoftmaxNode)},
+      // Remap Bf16(Fused)Matmul+CastFp32 into the _ITEX(Fused)AccMatMul.
+      {"Bf16ContractionWithCastFp32", {"Cast"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(Bf16ContractionWithCastFp32,
+                       FindBf16ContractionWithCastFp32,
+                       AddBf16ContractionWithCastFp32Node)},
+      // Remap Random Comparison+Cast into the RandomWithComparisonAndCast.
+      {"RandomWithComparisonAndCast", {"Cast"}, nullptr, IsBasicLevel,
+       REMAPPER_RUN_FN(RandomWithComparisonAndCast,
+                       FindRandomWithComparisonAndCast,
+                       AddRandomWithComparisonAndCastNode)},
+      // Remap Bf16FusedMatmulGrad+CastFp32 into the _ITEXFusedAccMatMulGrad.
+      {"Bf16ContractionGradWithCastFp32", {"Cast"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(Bf16ContractionGradWithCastFp32,
+                       FindBf16ContractionGradWithCastFp32,
+                       AddFusedContractionGradWithCastNode)},
+      // Remap Comparison+Cast into the ComparisonWithCast.
+      {"ComparisonWithCast", {"Cast"}, nullptr, IsBasicLevel,
+       REMAPPER_RUN_FN(ComparisonWithCast, FindComparisonWithCast,
+                       AddComparisonWithCastNode)},
+      // Remap Const+Cast into the Const. this fusion aims to reduce the number
+      // of Cast which were produced by auto mixed precision.
+      {"ConstWithCast", {"Cast"}, nullptr, IsBasicLevel,
+       REMAPPER_RUN_FN(ConstWithCast, FindConstWithCast,
+                       AddConstWithCastNode)},
+      // Remap sequatial Binary ops into the _ITEXFusedBinary op.
+      {"FusedBinary",
+       {"Add", "AddV2", "Mul", "Sub", "RealDiv", "Maximum", "Minimum"},
+       nullptr, IsAdvancedLevel,
+       REMAPPER_RUN_FN(FusedBinary, FindFusedBinary, AddFusedBinaryNode)},
+      // Remap StridedSliceGrad to Pad when the stride of it is 1.
+      {"StridedSliceGrad", {"StridedSliceGrad"}, nullptr, nullptr,
+       REMAPPER_RUN_FN(StridedSliceGrad, FindStridedSliceGrad,
+                       AddStridedSliceGrad)},
+  };
+  return *matchers;
+}
+
+// The fusions only enabled in llga mode, i.e. `is_full` is false.
+// TODO(itex): create other names for functions below
+const std::vector<RemapperMatcher>& LlgaMatchers() {
+  static const std::vector<RemapperMatcher>* matchers =
+      new std::vector<RemapperMatcher>{
+          {"Conv2DBackpropInputWithSliceLLGA", {"Slice"}, nullptr,
+           IsOneDnnGraphCompilerBackend,
+           REMAPPER_RUN_FN(ConvBackpropInputWithSlice,
+                           FindConv2DBackpropInputWithSliceLLGA,
+                           AddConv2DBackpropInputWithSliceNodeLLGA)},
+          {"PadConvFwdBwd", {"Conv2DBackpropFilter"}, nullptr,
+           IsOneDnnGraphCompilerBackend,
+           REMAPPER_RUN_FN(PadConvFwdBwd, FindPadConvFwdBwd,
+                           AddPadConvFwdBwd)},
+      };
+  return *matchers;
+}
+
+#undef REMAPPER_RUN_FN
+
+// Candidate matchers of each op type in one remapper run, in priority order.
+// Matchers disabled in the run are dropped up front.
+// Returns true if `node` may be the root of an enabled fusion other than the
+// binary chain.
+bool IsRootOfOtherFusion(const RemapperContext& ctx, const NodeDef& node) {
+  if (!FusionMgr::GetInstance().GetFusions(node.op()).empty()) return true;
+  for (const auto* matchers : {&CommonMatchers(), &FullMatchers()}) {
+    for (const RemapperMatcher& matcher : *matchers) {
+      if (matcher.name == "FusedBinary") continue;
+      if (matcher.enabled != nullptr && !matcher.enabled(ctx)) continue;
+      if (std::find(matcher.roots.begin(), matcher.roots.end(), node.op()) !=
+              matcher.roots.end() ||
+          (matcher.root_filter != nullptr && matcher.root_filter(node.op()))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+class MatcherIndex {
+ public:
+  MatcherIndex(const RemapperContext& ctx,
+               const std::vector<RemapperMatcher>& matchers) {
+    for (const RemapperMatcher& matcher : matchers) {
+      if (matcher.enabled == nullptr || matcher.enabled(ctx)) {
+        matchers_.push_back(&matcher);
+      }
+    }
+  }
+
+  const std::vector<const RemapperMatcher*>& Candidates(const string& op) {
+    auto iter = candidates_.find(op);
+    if (iter != candidates_.end()) return iter->second;
+
+    std::vector<const RemapperMatcher*>& candidates = candidates_[op];
+    for (const RemapperMatcher* matcher : matchers_) {
+      if (std::find(matcher->roots.begin(), matcher->roots.end(), op) !=
+              matcher->roots.end() ||
+          (matcher->root_filter != nullptr && matcher->root_filter(op))) {
+        candidates.push_back(matcher);
+      }
+    }
+    return candidates;
+  }
+
+ private:
+  std::vector<const RemapperMatcher*> matchers_;
+  std::unordered_map<string, std::vector<const RemapperMatcher*>> candidates_;
+};
+
+// Runs the candidate matchers of the node until one of them rewrites the
+// graph. Returns true if a matcher matched.
+bool RunMatchers(MatcherIndex* index, RemapperContext* ctx, int node_index,
+                 std::vector<bool>* invalidated_nodes,
+                 std::vector<bool>* nodes_to_delete) {
+  const string& op = ctx->graph_view.GetNode(node_index)->node()->op();
+  for (const RemapperMatcher* matcher : index->Candidates(op)) {
+    ITEX_VLOG(3) << "Start to run remapper matcher: " << matcher->name;
+    if (RecordMatcher(ctx, matcher->name, [&]() {
+          return matcher->run(ctx, node_index, invalidated_nodes,
+                              nodes_to_delete);
+        })) {
+      ITEX_VLOG(3) << "Succeed to match remapper matcher: " << matcher->name;
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 // `is_full` is true by default. It will be set as false if this pass runs
@@ -5908,7 +6304,7 @@ Status RunRemapper(OptimizerContext* opt_ctx, const GrapplerItem& item,
 
   Status status;
   GraphDef multable_graph_def = graph_def;
-  RemapperContext ctx(item, &multable_graph_def, &status, level);
+  RemapperContext ctx(opt_ctx, item, &multable_graph_def, &status, level);
   // TODO(itex): Currently some fusions will be disabled when LayoutOPT is off,
   //       remove this dependency once all plain fusions are supported.
   bool is_layout_opt = GetOptimizerConfigFlags().enable_layout_opt;
@@ -5940,6 +6336,11 @@ Status RunRemapper(OptimizerContext* opt_ctx, const GrapplerItem& item,
   // Infer statically first and only once.
   ctx.GetGraphProperties();
 
+  // Hand-written fusions indexed by the op types they can be rooted at. The
+  // full remapper runs the complete set, the partial one the llga fusions.
+  MatcherIndex common_matchers(ctx, CommonMatchers());
+  MatcherIndex stage_matchers(ctx, is_full ? FullMatchers() : LlgaMatchers());
+
   bool is_visited = false;
   string last_op;
   for (int i = num_nodes - 1; i >= 0;) {
@@ -5989,360 +6390,17 @@ Status RunRemapper(OptimizerContext* opt_ctx, const GrapplerItem& item,
 
     // Put the fusions that always need to be enabled here no matter `is_full`
     // is true or false.
-    {
-      // Use AddV2 for AddN when N=2
-      int AddN_index;
-      if (FindAddV2(ctx, i, &AddN_index)) {
-        TF_ABORT_IF_ERROR(ReplaceAddN(&ctx, AddN_index, &invalidated_nodes,
-                                      &nodes_to_delete));
-        continue;
-      }
-
-      // Remap TF2.11 dropout select to TF2.10 cast+mul.
-      Dropout dropout;
-      if (FindDropout(ctx, i, &dropout)) {
-        TF_ABORT_IF_ERROR(
-            AddDropout(&ctx, dropout, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Gelu subgraph
-      std::map<string, int> matched_nodes_map;
-      std::set<int> remove_node_indices;
-      bool is_gelu_approximate = false;
-      if (level == RemapperLevel::BASIC &&
-          FindGelu(&ctx, i, &matched_nodes_map, &remove_node_indices,
-                   &is_gelu_approximate)) {
-        TF_ABORT_IF_ERROR(AddGelu(&ctx, &matched_nodes_map,
-                                  &remove_node_indices, &invalidated_nodes,
-                                  &nodes_to_delete, is_gelu_approximate));
-        continue;
-      }
-
-      // Remap Mul+Max into the LeakyRelu.
-      MulWithMaximum mul_with_maximum;
-      if (level == RemapperLevel::BASIC &&
-          FindMulWithMaximum(ctx, i, &mul_with_maximum)) {
-        TF_ABORT_IF_ERROR(AddMulWithMaximumNode(
-            &ctx, mul_with_maximum, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      MatmulReshapeBiasadd matmul_reshape_biasadd;
-      if (FindMatmulReshapeBiasadd(ctx, i, &matmul_reshape_biasadd)) {
-        TF_ABORT_IF_ERROR(AddMatmulReshapeBiasadd(&ctx, matmul_reshape_biasadd,
-                                                  &invalidated_nodes,
-                                                  &nodes_to_delete));
-        continue;
-      }
-
-      DilatedContraction dilated_contraction;
-      if (FindDilatedContraction(ctx, i, &dilated_contraction)) {
-        TF_ABORT_IF_ERROR(AddDilatedContractionNode(
-            &ctx, dilated_contraction, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
+    if (RunMatchers(&common_matchers, &ctx, i, &invalidated_nodes,
+                    &nodes_to_delete)) {
+      continue;
     }
 
     // The entry of pattern matcher. It will iterate all fusion registered.
     TF_ABORT_IF_ERROR(LaunchPatternMatcher(&ctx, i, &invalidated_nodes,
                                            &nodes_to_delete, is_full));
 
-    if (is_full) {
-      // keras Dense layer fwd
-      KerasDenseLayerFwd keras_dense_layer_fwd;
-      if (FindKerasDenseLayerFwd(ctx, i, &keras_dense_layer_fwd)) {
-        TF_ABORT_IF_ERROR(AddKerasDenseLayerFwd(
-            &ctx, keras_dense_layer_fwd, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Conv2D+BiasAdd+Activation+Add into the _ITEXFusedConv2D.
-      ContractionWithBiasAndActivationAdd contract_with_bias_and_activation_add;
-      if (FindContractionWithBiasAndActivationAdd(
-              ctx, i, &contract_with_bias_and_activation_add)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedContractionNode(&ctx, contract_with_bias_and_activation_add,
-                                    &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      GroupConv2DBlock group_conv;
-      if (FindResNeXtGroupConv2DBlock(ctx, i, &group_conv)) {
-        TF_ABORT_IF_ERROR(AddGroupConv2DNode(
-            &ctx, group_conv, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Conv2D+BiasAdd+Add+Activation into the _ITEXFusedConv2D.
-      ContractionWithBiasAndAddActivation contract_with_bias_and_add_activation;
-      if (FindContractionWithBiasAndAddActivation(
-              ctx, i, &contract_with_bias_and_add_activation)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedContractionNode(&ctx, contract_with_bias_and_add_activation,
-                                    &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Conv2D+BiasAdd+Add into the _ITEXFusedConv2D.
-      ContractionWithBiasAddAndAdd contract_with_bias_and_add;
-      if (FindContractionWithBiasAddAndAdd(ctx, i,
-                                           &contract_with_bias_and_add)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedContractionNode(&ctx, contract_with_bias_and_add,
-                                    &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap {Conv2D,DepthwiseConv2D,Conv3D,MatMul}+BiasAdd into the
-      // _ITEXFused{Conv2D,DepthwiseConv2dNative,Conv3D,MatMul}
-      ContractionWithBiasAdd contract_with_bias;
-      if (FindContractionWithBias(ctx, i, &contract_with_bias)) {
-        TF_ABORT_IF_ERROR(AddFusedContractionNode(
-            &ctx, contract_with_bias, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap MatMul+BiasAddGrad into the _fusedMatMulGrad
-      ContractionWithBiasAddGrad contract_with_bias_grad;
-      if (FindContractionWithBiasAddGrad(ctx, i, &contract_with_bias_grad)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedContractionGradNode(&ctx, contract_with_bias_grad,
-                                        &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap {Conv2DBackpropFilter,Conv3DBackpropFilter}+BiasAddGrad into
-      // FusedContractionBackpropFiler.
-      ContractionWithBiasAddGrad conv_contract_with_bias_grad;
-      if (FindConvContractionWithBiasAddGrad(ctx, i,
-                                             &conv_contract_with_bias_grad)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedContractionGradNode(&ctx, conv_contract_with_bias_grad,
-                                        &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-      // Remap {Conv2D,Conv3D,MatMul}+BiasAdd+Activation into
-      // _ITEXFused{Conv2D,Conv3D,MatMul}.
-      ContractionWithBiasAddAndActivation contract_with_bias_and_activation;
-      if (FindContractionWithBiasAndActivation(
-              ctx, i, &contract_with_bias_and_activation)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedContractionNode(&ctx, contract_with_bias_and_activation,
-                                    &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap FusedBatchNorm+<SideInput>+<Activation> into the
-      // _FusedBatchNormEx.
-      FusedBatchNormEx fused_batch_norm_ex;
-      if (FindFusedBatchNormEx(ctx, i, &fused_batch_norm_ex)) {
-        TF_ABORT_IF_ERROR(AddFusedBatchNormExNode(
-            &ctx, fused_batch_norm_ex, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      FusedBatchNormGradEx fused_batch_norm_grad_ex;
-      if (FindFusedBatchNormGradEx(ctx, i, &fused_batch_norm_grad_ex)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedBatchNormGradExNode(&ctx, fused_batch_norm_grad_ex,
-                                        &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      PadWithContractionFwdBwd pad_with_contract_fwd_bwd;
-      if (FindPadWithContractionFwdBwd(ctx, i, &pad_with_contract_fwd_bwd)) {
-        TF_ABORT_IF_ERROR(
-            AddPadWithContractionFwdBwd(&ctx, pad_with_contract_fwd_bwd,
-                                        &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Pad+{Conv2D, _ITEXFusedConv2D} into the _FusedPadConv2D.
-      PadWithContraction pad_with_contract;
-      if (FindPadWithContraction(ctx, i, &pad_with_contract)) {
-        TF_ABORT_IF_ERROR(AddPadWithContractionNode(
-            &ctx, pad_with_contract, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      ConvBackpropInputWithSlice conv_with_slice;
-      if (FindConvBackpropInputWithSlice(ctx, i, &conv_with_slice)) {
-        TF_ABORT_IF_ERROR(AddConvBackpropInputWithSliceNode(
-            &ctx, conv_with_slice, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Mul + AddN + TrainingOp into the _FusedTrainingOp.
-      FusedTrainingOp fused_training_op;
-      if (level == RemapperLevel::BASIC &&
-          FindFusedTrainingOp(ctx, i, &fused_training_op)) {
-        TF_ABORT_IF_ERROR(AddFusedTrainingNode(
-            &ctx, fused_training_op, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap BatchMatMul+Mul into the _FusedBatchMatMul.
-      ContractionWithMul contract_with_mul;
-      if (FindContractionWithMul(ctx, i, &contract_with_mul)) {
-        TF_ABORT_IF_ERROR(AddFusedContractionNode(
-            &ctx, contract_with_mul, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // delete dequantize node if it finds dequantize_with_shape pattern
-      DequantizeWithShape dequantize_with_shape;
-      if (level == RemapperLevel::BASIC &&
-          FindDequantizeWithShape(ctx, i, &dequantize_with_shape)) {
-        TF_ABORT_IF_ERROR(AddFusedDequantizeWithShape(
-            &ctx, dequantize_with_shape, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // delete dequantize node if it finds dequantize_with_reshape pattern
-      DequantizeWithReshape dequantize_with_reshape;
-      if (is_layout_opt && level == RemapperLevel::BASIC &&
-          FindDequantizeWithReshape(ctx, i, &dequantize_with_reshape)) {
-        TF_ABORT_IF_ERROR(AddFusedDequantizeWithReshape(
-            &ctx, dequantize_with_reshape, &invalidated_nodes,
-            &nodes_to_delete));
-        continue;
-      }
-
-      // Remap QuantizeV2+QuantizedConv2D into the
-      // _ITEXQuantizeV2WithQuantizedConv2D
-      QuantizeV2WithQuantizedConv2D quantizev2_with_quantizedconv;
-      if (is_layout_opt && FindQuantizeV2WithQuantizedConv2D(
-                               ctx, i, &quantizev2_with_quantizedconv)) {
-        TF_ABORT_IF_ERROR(AddQuantizeV2WithQuantizedConv2DNode(
-            &ctx, quantizev2_with_quantizedconv, &invalidated_nodes,
-            &nodes_to_delete));
-        continue;
-      }
-
-      QuantizedConv2DWithDequantize conv2d_with_dequantize;
-      if (is_layout_opt && (FindQuantizedConv2DWithDequantize(
-                               ctx, i, &conv2d_with_dequantize))) {
-        TF_ABORT_IF_ERROR(AddQuantizedConv2DWithDequantizeNode(
-            &ctx, conv2d_with_dequantize, &invalidated_nodes,
-            &nodes_to_delete));
-        continue;
-      }
-
-      QuantizedConv2DWithCast conv2d_with_cast;
-      if (is_layout_opt &&
-          (FindQuantizedConv2DWithCast(ctx, i, &conv2d_with_cast))) {
-        TF_ABORT_IF_ERROR(AddQuantizedConv2DWithCastNode(
-            &ctx, conv2d_with_cast, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap L2loss+AddN into the _FusedAddN
-      FusedAddN fused_addn;
-      if (level == RemapperLevel::BASIC && FindFusedAddN(ctx, i, &fused_addn)) {
-        TF_ABORT_IF_ERROR(AddFusedAddN(&ctx, fused_addn, &invalidated_nodes,
-                                       &nodes_to_delete));
-        continue;
-      }
-
-      AddV2WithSoftmax fused_addv2_with_softmax;
-      if (level == RemapperLevel::BASIC &&
-          FindAddV2WithSoftmax(ctx, i, &fused_addv2_with_softmax)) {
-        TF_ABORT_IF_ERROR(
-            AddFusedAddV2WithSoftmaxNode(&ctx, fused_addv2_with_softmax,
-                                         &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Bf16(Fused)Matmul+CastFp32 into the _ITEX(Fused)AccMatMul.
-      Bf16ContractionWithCastFp32 contraction_with_cast;
-      if (FindBf16ContractionWithCastFp32(ctx, i, &contraction_with_cast)) {
-        TF_ABORT_IF_ERROR(AddBf16ContractionWithCastFp32Node(
-            &ctx, contraction_with_cast, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Random Comparison+Cast into the RandomWithComparisonAndCast.
-      RandomWithComparisonAndCast random_with_compare_and_cast;
-      if (level == RemapperLevel::BASIC &&
-          FindRandomWithComparisonAndCast(ctx, i,
-                                          &random_with_compare_and_cast)) {
-        TF_ABORT_IF_ERROR(AddRandomWithComparisonAndCastNode(
-            &ctx, random_with_compare_and_cast, &invalidated_nodes,
-            &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Bf16FusedMatmulGrad+CastFp32 into the _ITEXFusedAccMatMulGrad.
-      Bf16ContractionGradWithCastFp32 contraction_grad_with_cast;
-      if (FindBf16ContractionGradWithCastFp32(ctx, i,
-                                              &contraction_grad_with_cast)) {
-        TF_ABORT_IF_ERROR(AddFusedContractionGradWithCastNode(
-            &ctx, contraction_grad_with_cast, &invalidated_nodes,
-            &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Comparison+Cast into the ComparisonWithCast.
-      ComparisonWithCast comparison_with_cast;
-      if (level == RemapperLevel::BASIC &&
-          FindComparisonWithCast(ctx, i, &comparison_with_cast)) {
-        TF_ABORT_IF_ERROR(AddComparisonWithCastNode(
-            &ctx, comparison_with_cast, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap Const+Cast into the Const. this fusion aims to reduce the number
-      // of Cast which were produced by auto mixed precision.
-      ConstWithCast const_with_cast;
-      if (level == RemapperLevel::BASIC &&
-          FindConstWithCast(ctx, i, &const_with_cast)) {
-        TF_ABORT_IF_ERROR(AddConstWithCastNode(
-            &ctx, const_with_cast, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      // Remap sequatial Binary ops into the _ITEXFusedBinary op.
-      // Disable it in 1st remapper since it may break other high priority
-      // fusions.
-      FusedBinary seq_binary;
-      if (level != RemapperLevel::BASIC &&
-          FindFusedBinary(ctx, i, &seq_binary)) {
-        TF_ABORT_IF_ERROR(AddFusedBinaryNode(
-            &ctx, seq_binary, &invalidated_nodes, &nodes_to_delete));
-      }
-
-      // Remap StridedSliceGrad to Pad when the stride of it is 1.
-      StridedSliceGrad strided_slice_grad;
-      if (FindStridedSliceGrad(ctx, i, &strided_slice_grad)) {
-        TF_ABORT_IF_ERROR(AddStridedSliceGrad(
-            &ctx, strided_slice_grad, &invalidated_nodes, &nodes_to_delete));
-      }
-    } else {
-      // Only run in llga mode
-      // TODO(itex): create other names for functions below
-      bool onednn_graph_all_type_flag =
-          GetOptimizerConfigFlags().enable_onednn_graph_all_type;
-      bool onednn_graph_compiler_backend_flag =
-          GetOptimizerConfigFlags().enable_onednn_graph_compiler_backend;
-      if (!onednn_graph_all_type_flag || !onednn_graph_compiler_backend_flag) {
-        continue;
-      }
-
-      ConvBackpropInputWithSlice conv_with_slice;
-      if (FindConv2DBackpropInputWithSliceLLGA(ctx, i, &conv_with_slice)) {
-        TF_ABORT_IF_ERROR(AddConv2DBackpropInputWithSliceNodeLLGA(
-            &ctx, conv_with_slice, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-
-      PadConvFwdBwd pad_conv_fwd_bwd;
-      if (FindPadConvFwdBwd(ctx, i, &pad_conv_fwd_bwd)) {
-        TF_ABORT_IF_ERROR(AddPadConvFwdBwd(
-            &ctx, pad_conv_fwd_bwd, &invalidated_nodes, &nodes_to_delete));
-        continue;
-      }
-    }
+    RunMatchers(&stage_matchers, &ctx, i, &invalidated_nodes,
+                &nodes_to_delete);
   }
 
   // Remove invalidated nodes.
@@ -18,6 +18,7 @@ limitations under the License.
 #ifndef ITEX_CORE_GRAPH_REMAPPER_REMAPPER_H_
 #define ITEX_CORE_GRAPH_REMAPPER_REMAPPER_H_
 
+#include <chrono>  // NOLINT
 #include <map>
 #include <set>
 #include <string>
@@ -42,38 +43,61 @@ namespace graph {
 enum RemapperLevel : int { BASIC = 0, ADVANCED };
 
 struct RemapperContext {
-  explicit RemapperContext(const GrapplerItem& item, GraphDef* g_def,
-                           Status* status, RemapperLevel level)
-      : nodes_to_preserve(item.NodesToPreserve()),
+  explicit RemapperContext(OptimizerContext* opt_ctx, const GrapplerItem& item,
+                           GraphDef* g_def, Status* status,
+                           RemapperLevel level)
+      : opt_ctx(opt_ctx),
+        item(item),
+        nodes_to_preserve(item.NodesToPreserve()),
         graph_view(g_def, status),
-        graph_properties(item),
-        inferred_graph_properties(false),
+        graph_properties(nullptr),
         remap_level(level) {}
 
+  OptimizerContext* opt_ctx;
+  const GrapplerItem& item;
   std::unordered_set<string> nodes_to_preserve;
   utils::MutableGraphView graph_view;
-  GraphProperties graph_properties;
-  bool inferred_graph_properties;
+  // Shared by all passes, see OptimizerContext::GetGraphProperties.
+  GraphProperties* graph_properties;
   RemapperLevel remap_level;
 
   GraphProperties& GetGraphProperties() {
-    if (!inferred_graph_properties) {
-      Status s = graph_properties.InferStatically(
-          /*assume_valid_feeds=*/true,
+    if (graph_properties == nullptr) {
+      Status s = opt_ctx->GetGraphProperties(
+          item, /*assume_valid_feeds=*/true,
           /*aggressive_shape_inference=*/false,
           /*include_input_tensor_values=*/true,
-          /*include_output_tensor_values=*/true);
+          /*include_output_tensor_values=*/true, &graph_properties);
 
       // TODO(itex) Is there any case that InferStatically will return an
       // unsuccessful state?
       TF_ABORT_IF_ERROR(s);
-      inferred_graph_properties = true;
     }
 
-    return graph_properties;
+    return *graph_properties;
   }
 };
 
+// Runs `matcher`, a callable returning true if it matched and rewrote the
+// graph, and records it in the matcher statistics of the optimization when
+// they are collected.
+template <typename Matcher>
+bool RecordMatcher(RemapperContext* ctx, const string& name,
+                   Matcher&& matcher) {
+  if (!ctx->opt_ctx->collect_matcher_stats) return matcher();
+
+  auto start = std::chrono::steady_clock::now();
+  bool matched = matcher();
+  std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+
+  MatcherStats& stats = ctx->opt_ctx->matcher_stats[name];
+  stats.attempts++;
+  if (matched) stats.matches++;
+  stats.seconds += duration.count();
+  return matched;
+}
+
 namespace {  // NOLINT
 
 [[maybe_unused]] bool IsInPreserveSet(const RemapperContext& ctx,
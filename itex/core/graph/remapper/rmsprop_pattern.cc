@@ -78,11 +78,7 @@ class RMSpropComputeRMSFusion : public Fusion {
       return ret.ToEmpty();
     }
 
-    // TODO(itex) Enable it on CPU.
     auto* new_rms = ret.GetNode(&graph_view, "new_rms");
-    if (NodeIsOnCpu(new_rms)) {
-      return ret.ToEmpty();
-    }
 
     if (!OneOfDataTypes(new_rms, DT_FLOAT, DT_HALF, DT_BFLOAT16)) {
       return ret.ToEmpty();
@@ -196,11 +192,7 @@ class RMSpropVarUpdateFusion : public Fusion {
       return ret;
     }
 
-    // TODO(itex) Enable it on CPU.
     auto* sub = ret.GetNode(&graph_view, "sub");
-    if (NodeIsOnCpu(sub)) {
-      return ret.ToEmpty();
-    }
 
     if (!OneOfDataTypes(sub, DT_FLOAT, DT_HALF, DT_BFLOAT16)) {
       return ret.ToEmpty();
@@ -64,32 +64,34 @@ namespace itex {
 namespace graph {
 
 struct AutoShardContext {
-  explicit AutoShardContext(const GrapplerItem& item, GraphDef* g_def,
-                            Status* status)
-      : nodes_to_preserve(item.NodesToPreserve()),
+  explicit AutoShardContext(OptimizerContext* opt_ctx, const GrapplerItem& item,
+                            GraphDef* g_def, Status* status)
+      : opt_ctx(opt_ctx),
+        item(item),
+        nodes_to_preserve(item.NodesToPreserve()),
         graph_view(g_def, status),
-        graph_properties(item),
-        inferred_graph_properties(false) {}
+        graph_properties(nullptr) {}
 
+  OptimizerContext* opt_ctx;
+  const GrapplerItem& item;
   std::unordered_set<string> nodes_to_preserve;
   utils::MutableGraphView graph_view;
-  GraphProperties graph_properties;
-  bool inferred_graph_properties;
+  // Shared by all passes, see OptimizerContext::GetGraphProperties.
+  GraphProperties* graph_properties;
 
   GraphProperties& GetGraphProperties() {
-    if (!inferred_graph_properties) {
-      Status s = graph_properties.InferStatically(
-          /*assume_valid_feeds=*/true,
+    if (graph_properties == nullptr) {
+      Status s = opt_ctx->GetGraphProperties(
+          item, /*assume_valid_feeds=*/true,
           /*aggressive_shape_inference=*/false,
           /*include_input_tensor_values=*/true,
-          /*include_output_tensor_values=*/true);
+          /*include_output_tensor_values=*/true, &graph_properties);
 
       // TODO(itex) Is there any case that InferStatically will return an
       // unsuccessful state?
       TF_ABORT_IF_ERROR(s);
-      inferred_graph_properties = true;
     }
-    return graph_properties;
+    return *graph_properties;
   }
 };
 }  // namespace graph
@@ -173,7 +175,8 @@ Status RunAutoShard(itex::graph::OptimizerContext* opt_ctx,
   // Use shape inference feature.
   Status status;
   GraphDef multable_graph_def = graph_def;
-  auto ctx = itex::graph::AutoShardContext(item, &multable_graph_def, &status);
+  itex::graph::AutoShardContext ctx(opt_ctx, item, &multable_graph_def,
+                                    &status);
   // Infer statically first and only once.
   ctx.GetGraphProperties();
 
@@ -276,7 +279,7 @@ Status RunAutoShard(itex::graph::OptimizerContext* opt_ctx,
     config.setNeedDeadNodePrune(model_prune);
     as::tensorflow::auto_sharding_pass_mlir(impl->GetContext(), &module, config,
                                             device_info,
-                                            &(ctx.graph_properties));
+                                            ctx.graph_properties);
     ITEX_LOG(INFO) << "Run AutoShard pass successfully";
   }
 
@@ -39,6 +39,7 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
                      tf_status);
   Status status = StatusFromTF_Status(tf_status);
   TF_DeleteStatus(tf_status);
+  ClearSnapshot();
   return status;
 }
 
@@ -76,20 +77,111 @@ static Status GetProperties(TF_GraphProperties* graph_prop,
   return status;
 }
 
+Status GraphProperties::FetchProperties(const string& node_name,
+                                        bool is_input, int* first_row,
+                                        int* num_rows) const {
+  std::vector<OpInfo_TensorProperties> props;
+  if (is_input) {
+    TF_RETURN_IF_ERROR(GetProperties(graph_prop_, node_name, &props,
+                                     TF_GetInputPropertiesListSize,
+                                     TF_GetInputPropertiesList));
+  } else {
+    TF_RETURN_IF_ERROR(GetProperties(graph_prop_, node_name, &props,
+                                     TF_GetOutputPropertiesListSize,
+                                     TF_GetOutputPropertiesList));
+  }
+
+  *first_row = dtype_.size();
+  *num_rows = props.size();
+  for (OpInfo_TensorProperties& prop : props) {
+    const TensorShapeProto& shape = prop.shape();
+    dtype_.push_back(prop.dtype());
+    rank_.push_back(shape.unknown_rank() ? -1 : shape.dim_size());
+    dims_offset_.push_back(dims_.size());
+    for (const auto& dim : shape.dim()) dims_.push_back(dim.size());
+    if (prop.has_value()) {
+      value_index_.push_back(values_.size());
+      values_.emplace_back();
+      values_.back().Swap(prop.mutable_value());
+    } else {
+      value_index_.push_back(-1);
+    }
+  }
+  return Status::OK();
+}
+
+Status GraphProperties::GetNodeEntry(const string& node_name,
+                                     const NodeEntry** entry) const {
+  auto iter = nodes_.find(node_name);
+  if (iter == nodes_.end()) {
+    NodeEntry new_entry;
+    TF_RETURN_IF_ERROR(FetchProperties(node_name, /*is_input=*/true,
+                                       &new_entry.first_input,
+                                       &new_entry.num_inputs));
+    TF_RETURN_IF_ERROR(FetchProperties(node_name, /*is_input=*/false,
+                                       &new_entry.first_output,
+                                       &new_entry.num_outputs));
+    iter = nodes_.emplace(node_name, new_entry).first;
+  }
+  *entry = &iter->second;
+  return Status::OK();
+}
+
+void GraphProperties::ExpandProperties(
+    int first_row, int num_rows,
+    std::vector<OpInfo_TensorProperties>* props) const {
+  props->clear();
+  props->resize(num_rows);
+  for (int i = 0; i < num_rows; ++i) {
+    const int row = first_row + i;
+    OpInfo_TensorProperties& prop = props->at(i);
+    prop.set_dtype(dtype_[row]);
+    TensorShapeProto* shape = prop.mutable_shape();
+    if (rank_[row] < 0) {
+      shape->set_unknown_rank(true);
+    } else {
+      for (int d = 0; d < rank_[row]; ++d) {
+        shape->add_dim()->set_size(dims_[dims_offset_[row] + d]);
+      }
+    }
+    if (value_index_[row] >= 0) {
+      *prop.mutable_value() = values_[value_index_[row]];
+    }
+  }
+}
+
 Status GraphProperties::GetInputProperties(
     const string& node_name,
     std::vector<OpInfo_TensorProperties>* input_props) const {
-  return GetProperties(graph_prop_, node_name, input_props,
-                       TF_GetInputPropertiesListSize,
-                       TF_GetInputPropertiesList);
+  const NodeEntry* entry;
+  TF_RETURN_IF_ERROR(GetNodeEntry(node_name, &entry));
+  ExpandProperties(entry->first_input, entry->num_inputs, input_props);
+  return Status::OK();
 }
 
 Status GraphProperties::GetOutputProperties(
     const string& node_name,
     std::vector<OpInfo_TensorProperties>* output_props) const {
-  return GetProperties(graph_prop_, node_name, output_props,
-                       TF_GetOutputPropertiesListSize,
-                       TF_GetOutputPropertiesList);
+  const NodeEntry* entry;
+  TF_RETURN_IF_ERROR(GetNodeEntry(node_name, &entry));
+  ExpandProperties(entry->first_output, entry->num_outputs, output_props);
+  return Status::OK();
+}
+
+void GraphProperties::Invalidate(const string& node_name) {
+  // The rows of the node are left in the columns until the next
+  // InferStatically.
+  nodes_.erase(node_name);
+}
+
+void GraphProperties::ClearSnapshot() {
+  nodes_.clear();
+  dtype_.clear();
+  rank_.clear();
+  dims_offset_.clear();
+  value_index_.clear();
+  dims_.clear();
+  values_.clear();
 }
 
 }  // namespace graph
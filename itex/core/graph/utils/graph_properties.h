@@ -19,15 +19,24 @@ limitations under the License.
 #define ITEX_CORE_GRAPH_UTILS_GRAPH_PROPERTIES_H_
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "itex/core/graph/utils/grappler_item.h"
 #include "itex/core/utils/status.h"
+#include "itex/core/utils/types.h"
 #include "protos/op_performance_data.pb.h"
 
 namespace itex {
 namespace graph {
 
+// Statically inferred properties of the graph TF passed to the optimizer.
+//
+// The properties live in TF and every query copies them across the C API as
+// serialized protos. To avoid doing that again whenever a pass asks about a
+// node, the properties of a node are fetched on its first query and kept in a
+// columnar snapshot (dtype, rank, dims and whether a value is known per
+// tensor, plus the known values) that serves all later queries.
 class GraphProperties {
  public:
   explicit GraphProperties(const GrapplerItem& item);
@@ -73,8 +82,45 @@ class GraphProperties {
       const string& node_name,
       std::vector<OpInfo_TensorProperties>* output_props) const;
 
+  // Drops the snapshot of `node_name`, its properties are fetched from TF
+  // again on the next query. InferStatically drops the whole snapshot.
+  void Invalidate(const string& node_name);
+
  private:
+  // Rows of the tensor columns holding the inputs and outputs of a node.
+  struct NodeEntry {
+    int first_input;
+    int num_inputs;
+    int first_output;
+    int num_outputs;
+  };
+
+  // Returns the snapshot of `node_name`, fetching it from TF if needed.
+  Status GetNodeEntry(const string& node_name, const NodeEntry** entry) const;
+
+  // Fetches the properties of one side of a node and appends them to the
+  // tensor columns. Returns the first row in `first_row`.
+  Status FetchProperties(const string& node_name, bool is_input,
+                         int* first_row, int* num_rows) const;
+
+  // Rebuilds the properties of `num_rows` tensors from the columns.
+  void ExpandProperties(int first_row, int num_rows,
+                        std::vector<OpInfo_TensorProperties>* props) const;
+
+  void ClearSnapshot();
+
   TF_GraphProperties* graph_prop_;
+
+  // Snapshot, filled lazily by the const getters.
+  mutable std::unordered_map<string, NodeEntry> nodes_;
+  // One row per tensor. A rank of -1 means the rank is unknown, a dim of -1
+  // means the dim is unknown. `value_index` is -1 if the value isn't known.
+  mutable std::vector<DataType> dtype_;
+  mutable std::vector<int32> rank_;
+  mutable std::vector<int64> dims_offset_;
+  mutable std::vector<int32> value_index_;
+  mutable std::vector<int64> dims_;
+  mutable std::vector<TensorProto> values_;
 };
 
 }  // namespace graph
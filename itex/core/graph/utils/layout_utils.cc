@@ -408,6 +408,7 @@ static const std::vector<int> GetConstFilterCheckList(
                                 {"_ITEXAUGRUCell", {3, 4, 5, 6}},
                                 {"_ITEXForwardGRU", {2, 3, 4, 5}},
                                 {"_ITEXForwardAUGRU", {3, 4, 5, 6}},
+                                {"ItexRnn", {3}},
                                 {"_default", {1}}};
 
   if (op_const_checklist_map.find(op_name) == op_const_checklist_map.end()) {
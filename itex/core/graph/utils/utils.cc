@@ -163,6 +163,26 @@ NodeMapInternal<const GraphDef, const NodeDef>::GetNodeDefFromGraph(
 }
 }  // namespace internal
 
+Status OptimizerContext::GetGraphProperties(
+    const GrapplerItem& item, bool assume_valid_feeds,
+    bool aggressive_shape_inference, bool include_input_tensor_values,
+    bool include_output_tensor_values, GraphProperties** graph_properties) {
+  const int key = assume_valid_feeds | aggressive_shape_inference << 1 |
+                  include_input_tensor_values << 2 |
+                  include_output_tensor_values << 3;
+  auto it = graph_properties_.find(key);
+  if (it == graph_properties_.end()) {
+    ScopedPassTimer timer(this, "InferStatically");
+    auto properties = std::make_unique<GraphProperties>(item);
+    TF_RETURN_IF_ERROR(properties->InferStatically(
+        assume_valid_feeds, aggressive_shape_inference,
+        include_input_tensor_values, include_output_tensor_values));
+    it = graph_properties_.emplace(key, std::move(properties)).first;
+  }
+  *graph_properties = it->second.get();
+  return Status::OK();
+}
+
 bool HaveComputeIntensiveNode(const GraphDef& graph_def) {
   for (auto node : graph_def.node()) {
     if (node.op().find("Conv") != std::string::npos ||
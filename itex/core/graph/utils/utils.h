@@ -19,8 +19,11 @@ limitations under the License.
 #define ITEX_CORE_GRAPH_UTILS_UTILS_H_
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <functional>
 #include <iterator>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -31,6 +34,8 @@ limitations under the License.
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "itex/core/graph/utils/graph_properties.h"
+#include "itex/core/graph/utils/grappler_item.h"
 #include "itex/core/utils/gtl/flatmap.h"
 #include "itex/core/utils/gtl/flatset.h"
 #include "itex/core/utils/gtl/inlined_vector.h"
@@ -44,14 +49,67 @@ limitations under the License.
 namespace itex {
 namespace graph {
 
+// Statistics of one remapper matcher, accumulated over all remapper runs of
+// one graph optimization.
+struct MatcherStats {
+  int64 attempts = 0;
+  int64 matches = 0;
+  // Wall time of the attempts in seconds, including the rewrites.
+  double seconds = 0;
+};
+
+// State shared by all passes of one ITEX graph optimization.
 struct OptimizerContext {
   explicit OptimizerContext(const char* device_name)
       : device_name(device_name),
         is_compute_intensive(true),
-        enable_complete_opt(true) {}
+        enable_complete_opt(true),
+        collect_matcher_stats(false) {}
   const char* device_name;
   bool is_compute_intensive;
   bool enable_complete_opt;
+
+  // Returns the statically inferred properties of the graph in `item`.
+  // Shape inference always runs on the graph TF passed to the optimizer, not
+  // on the graph being rewritten, so the result only depends on the inference
+  // options. It is computed once per combination of options and shared by all
+  // passes instead of each pass inferring the whole graph again.
+  Status GetGraphProperties(const GrapplerItem& item, bool assume_valid_feeds,
+                            bool aggressive_shape_inference,
+                            bool include_input_tensor_values,
+                            bool include_output_tensor_values,
+                            GraphProperties** graph_properties);
+
+  // Wall time of each pass in seconds, in execution order.
+  std::vector<std::pair<string, double>> pass_times;
+
+  // Remapper matcher statistics keyed by matcher name, only recorded if
+  // `collect_matcher_stats` is set.
+  bool collect_matcher_stats;
+  std::map<string, MatcherStats> matcher_stats;
+
+ private:
+  std::map<int, std::unique_ptr<GraphProperties>> graph_properties_;
+};
+
+// Records the wall time of a pass in `OptimizerContext::pass_times` when it
+// goes out of scope.
+class ScopedPassTimer {
+ public:
+  ScopedPassTimer(OptimizerContext* opt_ctx, const string& pass_name)
+      : opt_ctx_(opt_ctx),
+        pass_name_(pass_name),
+        start_(std::chrono::steady_clock::now()) {}
+  ~ScopedPassTimer() {
+    std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start_;
+    opt_ctx_->pass_times.emplace_back(pass_name_, duration.count());
+  }
+
+ private:
+  OptimizerContext* opt_ctx_;
+  string pass_name_;
+  std::chrono::steady_clock::time_point start_;
 };
 
 // Check whether current graph contains compute-intensive ops or not.
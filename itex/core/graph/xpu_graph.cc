@@ -15,7 +15,9 @@ limitations under the License.
 
 #include <algorithm>
 
+#include "absl/strings/str_cat.h"
 #include "itex/core/devices/xpu_device_util.h"
+#include "itex/core/graph/optimized_graph_cache.h"
 #include "itex/core/graph/optimizer_config.h"
 #include "itex/core/graph/xpu_optimizer.h"
 #include "itex/core/utils/cpu_info.h"
@@ -66,6 +68,9 @@ void InitGlobalSetting(const OptimizerConfigFlags& config) {
   ITEX_VLOG(1) << "Intel Extension for Tensorflow version: "
                << itex_version->major << "." << itex_version->minor << "."
                << itex_version->patch << ", commit: " << itex_version->hash;
+  itex::graph::OptimizedGraphCache::SetVersion(absl::StrCat(
+      itex_version->major, ".", itex_version->minor, ".", itex_version->patch,
+      "-", itex_version->hash, "::", TF_Version()));
 
 #ifdef INTEL_CPU_ONLY
   const int32_t cpu_num = itex::port::MaxParallelism();
@@ -12,19 +12,26 @@ limitations under the License.
 
 #include "itex/core/graph/xpu_optimizer.h"
 
+#include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/strings/match.h"
 #include "itex/core/graph/auto_mixed_precision/auto_mixed_precision.h"
 #include "itex/core/graph/generic_layout_optimizer/generic_layout_optimizer.h"
 #include "itex/core/graph/memory_opt_pass/memory_opt_pass.h"
 #include "itex/core/graph/native_layout/native_layout.h"
 #include "itex/core/graph/onednn_graph/onednn_graph.h"
 #include "itex/core/graph/onednn_layout/onednn_layout.h"
+#include "itex/core/graph/optimized_graph_cache.h"
 #include "itex/core/graph/optimizer_config.h"
 #include "itex/core/graph/remapper/remapper.h"
 #include "itex/core/graph/utils/utils.h"
+#include "itex/core/utils/env_var.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/str_util.h"
 #include "tensorflow/c/experimental/grappler/grappler.h"
 
 #ifndef INTEL_CPU_ONLY
@@ -34,6 +41,17 @@ limitations under the License.
 namespace itex {
 namespace graph {
 
+namespace {
+
+bool HasOneDnnGraphNode(const GraphDef& graph_def) {
+  for (const NodeDef& node : graph_def.node()) {
+    if (node.op() == "_OneDnnGraph" || node.op() == "OneDnnGraph") return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 void* Optimizer_CPU_Create() {
   auto* optimizer = new Optimizer;
   optimizer->device_name = DEVICE_CPU;
@@ -66,6 +84,7 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   std::chrono::steady_clock::time_point start, end;
   if (IsVerboseEnabled()) {
     start = std::chrono::steady_clock::now();
+    opt_ctx.collect_matcher_stats = true;
   }
 
   // Get GrapplerItem.
@@ -74,9 +93,28 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   // Deserialize graph_buf into GraphDef
   GraphDef graph_def;
   SET_STATUS_IF_ERROR(tf_status, BufferToMessage(graph_buf, graph_def));
-  GraphDef optimized_graph_def = graph_def;
   auto config = GetOptimizerConfigFlags();
 
+  // oneDNN Graph nodes index partitions owned by the process that ran the
+  // oneDNN Graph pass, so a cached graph containing them would dangle on a hit.
+  OptimizedGraphCache* graph_cache = nullptr;
+  if (!config.enable_onednn_graph && !HasOneDnnGraphNode(graph_def)) {
+    graph_cache = OptimizedGraphCache::Get();
+  }
+  string cache_key;
+  if (graph_cache != nullptr) {
+    cache_key =
+        OptimizedGraphCache::Key(graph_def, item, opt_ctx.device_name, config);
+    if (graph_cache->Lookup(cache_key, optimized_graph_buf)) {
+      TF_StatusFromStatus(status, tf_status);
+      return;
+    }
+  }
+  // TODO(itex): Share one MutableGraphView across the passes instead of
+  // copying and re-indexing the graph in each of them, see
+  // docs/design/optimization/graph_pass_pipeline.md.
+  GraphDef optimized_graph_def = graph_def;
+
   opt_ctx.is_compute_intensive = HaveComputeIntensiveNode(graph_def);
 #ifndef INTEL_CPU_ONLY
   // Compute-extensive check is not required on GPU except AutoShard.
@@ -115,9 +153,12 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
       if (ITEX_VLOG_IS_ON(4)) {
         DumpGraphDefToFile("itex_optimizer_before_sharding", graph_def, "./");
       }
-      SET_STATUS_IF_ERROR(tf_status,
-                          mlir::tfg::RunAutoShard(&opt_ctx, item, graph_def,
-                                                  &optimized_graph_def));
+      {
+        ScopedPassTimer timer(&opt_ctx, "AutoShard");
+        SET_STATUS_IF_ERROR(tf_status,
+                            mlir::tfg::RunAutoShard(&opt_ctx, item, graph_def,
+                                                    &optimized_graph_def));
+      }
       if (ITEX_VLOG_IS_ON(4)) {
         DumpGraphDefToFile("itex_optimizer_after_sharding", optimized_graph_def,
                            "./");
@@ -126,21 +167,26 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   }
 #endif  // INTEL_CPU_ONLY
 
-  optimized_graph_def.Swap(&graph_def);
-  GenericLayoutOptimizer generic_layout_opt;
-  SET_STATUS_IF_ERROR(tf_status,
-                      generic_layout_opt.Optimize(&opt_ctx, item, graph_def,
-                                                  &optimized_graph_def));
+  {
+    ScopedPassTimer timer(&opt_ctx, "GenericLayoutOptimizer");
+    optimized_graph_def.Swap(&graph_def);
+    GenericLayoutOptimizer generic_layout_opt;
+    SET_STATUS_IF_ERROR(tf_status,
+                        generic_layout_opt.Optimize(&opt_ctx, item, graph_def,
+                                                    &optimized_graph_def));
+  }
 
   if (config.enable_remapper && opt_ctx.enable_complete_opt) {
     if (config.enable_onednn_graph) {
       // We don't want full scope remapper here if oneDNN graph is enabled.
+      ScopedPassTimer timer(&opt_ctx, "Remapper(partial)");
       optimized_graph_def.Swap(&graph_def);
       SET_STATUS_IF_ERROR(tf_status, RunRemapper(&opt_ctx, item, graph_def,
                                                  &optimized_graph_def, false));
     } else {
       // Run remapper twice for full scope fusions if oneDNN graph is disabled.
       for (int i = 0; i < config.remapper_run_pass; ++i) {
+        ScopedPassTimer timer(&opt_ctx, "Remapper");
         optimized_graph_def.Swap(&graph_def);
         SET_STATUS_IF_ERROR(tf_status, RunRemapper(&opt_ctx, item, graph_def,
                                                    &optimized_graph_def, true,
@@ -150,15 +196,19 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   }
 
   if (config.enable_auto_mixed_precision && opt_ctx.enable_complete_opt) {
-    optimized_graph_def.Swap(&graph_def);
-    SET_STATUS_IF_ERROR(
-        tf_status,
-        RunAutoMixedPrecision(&opt_ctx, item, graph_def, &optimized_graph_def));
+    {
+      ScopedPassTimer timer(&opt_ctx, "AutoMixedPrecision");
+      optimized_graph_def.Swap(&graph_def);
+      SET_STATUS_IF_ERROR(tf_status,
+                          RunAutoMixedPrecision(&opt_ctx, item, graph_def,
+                                                &optimized_graph_def));
+    }
     // Because after running auto_mixed_precision, it will insert Cast op
     // before Const op. So run remapper Const + Cast fusion will remove
     // these overhead.
     // We don't want ITEX remapper pass change graph before LLGA pass
     if (config.enable_remapper && !config.enable_onednn_graph) {
+      ScopedPassTimer timer(&opt_ctx, "Remapper");
       optimized_graph_def.Swap(&graph_def);
       SET_STATUS_IF_ERROR(tf_status, RunRemapper(&opt_ctx, item, graph_def,
                                                  &optimized_graph_def));
@@ -166,14 +216,18 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   }
 
   if (config.enable_onednn_graph && opt_ctx.enable_complete_opt) {
-    optimized_graph_def.Swap(&graph_def);
-    SET_STATUS_IF_ERROR(tf_status,
-                        RunOneDnnGraph(item, graph_def, &optimized_graph_def));
+    {
+      ScopedPassTimer timer(&opt_ctx, "OneDnnGraph");
+      optimized_graph_def.Swap(&graph_def);
+      SET_STATUS_IF_ERROR(tf_status, RunOneDnnGraph(&opt_ctx, item, graph_def,
+                                                    &optimized_graph_def));
+    }
 
     // Run the full scope remapper here since only got partial remapper before
     // if oneDNN graph is enabled.
     if (config.enable_remapper) {
       for (int i = 0; i < config.remapper_run_pass; ++i) {
+        ScopedPassTimer timer(&opt_ctx, "Remapper");
         optimized_graph_def.Swap(&graph_def);
         SET_STATUS_IF_ERROR(tf_status, RunRemapper(&opt_ctx, item, graph_def,
                                                    &optimized_graph_def, true,
@@ -183,6 +237,19 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   }
 
   if (config.enable_layout_opt && opt_ctx.enable_complete_opt) {
+    // Dynamic quantization is applied by the native layout pass, which never
+    // sees the MatMuls once they are rewritten to oneDNN layout ops.
+    if (absl::StrContains(opt_ctx.device_name, DEVICE_CPU)) {
+      string mode;
+      ITEX_CHECK_OK(
+          ReadStringFromEnvVar("ITEX_DYNAMIC_QUANTIZATION", "", &mode));
+      mode = str_util::Uppercase(mode);
+      if (!mode.empty() && mode != "0" && mode != "OFF") {
+        ITEX_LOG(WARNING) << "ITEX_DYNAMIC_QUANTIZATION is ignored when "
+                          << "ITEX_LAYOUT_OPT is on.";
+      }
+    }
+    ScopedPassTimer timer(&opt_ctx, "OneDnnLayout");
     optimized_graph_def.Swap(&graph_def);
     SET_STATUS_IF_ERROR(tf_status, RunOneDnnLayout(&opt_ctx, item, graph_def,
                                                    &optimized_graph_def));
@@ -190,20 +257,47 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
 
   // Put post Native Format rewrite pass for better co-working with oneDNN
   // layout.
-  optimized_graph_def.Swap(&graph_def);
-  SET_STATUS_IF_ERROR(tf_status, RunNativeLayout(&opt_ctx, item, graph_def,
-                                                 &optimized_graph_def));
+  {
+    ScopedPassTimer timer(&opt_ctx, "NativeLayout");
+    optimized_graph_def.Swap(&graph_def);
+    SET_STATUS_IF_ERROR(tf_status, RunNativeLayout(&opt_ctx, item, graph_def,
+                                                   &optimized_graph_def));
+  }
 
   // Memory Optimization
-  optimized_graph_def.Swap(&graph_def);
-  SET_STATUS_IF_ERROR(tf_status, RunMemoryOptPass(&opt_ctx, item, graph_def,
-                                                  &optimized_graph_def));
+  {
+    ScopedPassTimer timer(&opt_ctx, "MemoryOpt");
+    optimized_graph_def.Swap(&graph_def);
+    SET_STATUS_IF_ERROR(tf_status, RunMemoryOptPass(&opt_ctx, item, graph_def,
+                                                    &optimized_graph_def));
+  }
 
   if (IsVerboseEnabled()) {
     end = std::chrono::steady_clock::now();
     std::chrono::duration<double> duration = end - start;
     ITEX_VLOG(0) << "Time for graph optimize costs " << duration.count()
                  << " sec\n";
+    // InferStatically is reported separately and is also included in the time
+    // of the pass that first needed it.
+    for (const auto& pass_time : opt_ctx.pass_times) {
+      ITEX_VLOG(0) << "  " << pass_time.first << " costs " << pass_time.second
+                   << " sec";
+    }
+
+    // Remapper matchers, most expensive first.
+    std::vector<std::pair<string, MatcherStats>> matcher_stats(
+        opt_ctx.matcher_stats.begin(), opt_ctx.matcher_stats.end());
+    std::sort(matcher_stats.begin(), matcher_stats.end(),
+              [](const std::pair<string, MatcherStats>& a,
+                 const std::pair<string, MatcherStats>& b) {
+                return a.second.seconds > b.second.seconds;
+              });
+    for (const auto& matcher : matcher_stats) {
+      ITEX_VLOG(0) << "  Remapper matcher " << matcher.first << ": "
+                   << matcher.second.attempts << " attempts, "
+                   << matcher.second.matches << " matches, costs "
+                   << matcher.second.seconds << " sec";
+    }
   }
 
   if (ITEX_VLOG_IS_ON(4)) {
@@ -213,6 +307,9 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   // Serialize output GraphDef into optimized_graph_buf.
   SET_STATUS_IF_ERROR(
       tf_status, MessageToBuffer(optimized_graph_def, optimized_graph_buf));
+  if (graph_cache != nullptr) {
+    graph_cache->Insert(cache_key, optimized_graph_buf);
+  }
 
   TF_StatusFromStatus(status, tf_status);
 }
@@ -98,16 +98,11 @@ class AvgPoolGradOp : public PoolingBackwardOpBase<T> {
       dnnl::pooling_backward::primitive_desc pooling_bwd_pd(
           pooling_bwd_desc, attr, onednn_engine, pooling_fwd_pd);
 #endif
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          pooling_bwd_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(pooling_bwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, pooling_bwd_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       dnnl::pooling_backward pooling_bwd_primitive(pooling_bwd_pd);
 
@@ -170,9 +170,9 @@ class BatchMatMulOp : public OpKernel {
       }
 
       // Create matmul forward primitive
-      auto fwd_pd =
-          GetPrimitiveDesc(ctx, src_md, wei_md_prefer, bias_md, dst_md);
-      matmul_primitive_ = matmul(fwd_pd);
+      auto cached = GetPrimitive(ctx, src_md, wei_md_prefer, bias_md, dst_md);
+      const matmul::primitive_desc& fwd_pd = cached.pd;
+      matmul_primitive_ = cached.primitive;
 
       // Create src memory, check if src needs to be reordered
       src_mem_ = CreateDnnlMemory(src_md, onednn_engine_,
@@ -225,13 +225,9 @@ class BatchMatMulOp : public OpKernel {
       dst_mem_ = CreateDnnlMemory(fwd_pd.dst_desc(), onednn_engine_,
                                   GetTensorBuffer<Toutput>(dst_tensor_));
 
-      scratchpad_size_ = fwd_pd.scratchpad_desc().get_size() / sizeof(Tlhs);
-      OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<Tlhs>::v(),
-                                             TensorShape({scratchpad_size_}),
-                                             scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine_,
-                       GetTensorBuffer<Tlhs>(scratchpad_tensor_.get()));
+      OP_REQUIRES_OK(ctx, scratchpad_.Init(ctx, fwd_pd.scratchpad_desc(),
+                                           onednn_engine_));
+      scratchpad_mem_ = scratchpad_.memory();
 
       // Execute BatchMatMul
       fwd_primitive_args_.emplace(DNNL_ARG_SRC, src_mem_);
@@ -295,11 +291,9 @@ class BatchMatMulOp : public OpKernel {
     }
 
     OP_REQUIRES_OK(context,
-                   context->allocate_temp(DataTypeToEnum<Tlhs>::v(),
-                                          TensorShape({scratchpad_size_}),
-                                          scratchpad_tensor_.get()));
-    scratchpad_mem_.set_data_handle(
-        GetTensorBuffer<Tlhs>(scratchpad_tensor_.get()));
+                   scratchpad_.Init(context, scratchpad_mem_.get_desc(),
+                                    onednn_engine_));
+    scratchpad_mem_.set_data_handle(scratchpad_.data());
 
     OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape_,
                                                      &dst_tensor_));
@@ -311,7 +305,6 @@ class BatchMatMulOp : public OpKernel {
     dst_tensor_ = nullptr;
     onednn_engine_ = CreateDnnlEngine<Device>(*context);
     onednn_stream_ = CreateDnnlStream(*context, onednn_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
     InitOrSetMemory(context);
 
     // Skip primitive execution if the calculation is meaningless.
@@ -319,7 +312,7 @@ class BatchMatMulOp : public OpKernel {
       matmul_primitive_.execute(onednn_stream_, fwd_primitive_args_);
     }
 
-    scratchpad_tensor_.reset();
+    scratchpad_ = OneDnnScratchpad();
   }
 
   virtual void AccumulateMulAndInt8Scale(OpKernelContext* ctx,
@@ -327,17 +320,13 @@ class BatchMatMulOp : public OpKernel {
     return;
   }
 
-  matmul::primitive_desc GetPrimitiveDesc(OpKernelContext* ctx,
-                                          const memory::desc& src_desc,
-                                          const memory::desc& weights_desc,
-                                          const memory::desc& bias_desc,
-                                          const memory::desc& dst_desc) {
-    dnnl::primitive_attr post_ops_attr;
-    post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
-    if (std::is_same<Tlhs, float>::value) {
-      post_ops_attr.set_fpmath_mode(fp32_math_mode_);
-    }
-
+  // Returns the primitive desc and primitive of the given mds, shared through
+  // `MatMulPrimitiveCache` with all kernels using the same configuration.
+  MatMulPrimitiveCache::Entry GetPrimitive(OpKernelContext* ctx,
+                                           const memory::desc& src_desc,
+                                           const memory::desc& weights_desc,
+                                           const memory::desc& bias_desc,
+                                           const memory::desc& dst_desc) {
     if (post_op_util_.HasOutputScales()) {
       // mul_value = INT8 scale
       float mul_value = 1.0;
@@ -377,24 +366,45 @@ class BatchMatMulOp : public OpKernel {
           {DNNL_ARG_ATTR_MULTIPLE_POST_OP(i) | DNNL_ARG_SRC_1, binary_mem_[i]});
     }
 
-    post_op_util_.SetPostOpAttr(&post_ops_attr, md_list);
+    OneDnnKeyCreator key_creator;
+    key_creator.AddAsKey("batch_matmul");
+    key_creator.AddAsKey(onednn_engine_);
+    key_creator.AddAsKey(src_desc);
+    key_creator.AddAsKey(weights_desc);
+    key_creator.AddAsKey(dst_desc);
+    key_creator.AddAsKey(fp32_math_mode_);
+    post_op_util_.AddAsKey(&key_creator);
+    if (post_op_util_.HasBias()) key_creator.AddAsKey(bias_desc);
+    for (const auto& md : md_list) key_creator.AddAsKey(md);
+
+    auto create_pd = [&]() {
+      dnnl::primitive_attr post_ops_attr;
+      post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+      if (std::is_same<Tlhs, float>::value) {
+        post_ops_attr.set_fpmath_mode(fp32_math_mode_);
+      }
+      post_op_util_.SetPostOpAttr(&post_ops_attr, md_list);
 #ifdef ITEX_ONEDNN_3_0
-    if (post_op_util_.HasBias()) {
-      return matmul::primitive_desc(onednn_engine_, src_desc, weights_desc,
-                                    bias_desc, dst_desc, post_ops_attr);
-    } else {
-      return matmul::primitive_desc(onednn_engine_, src_desc, weights_desc,
-                                    dst_desc, post_ops_attr);
-    }
+      if (post_op_util_.HasBias()) {
+        return matmul::primitive_desc(onednn_engine_, src_desc, weights_desc,
+                                      bias_desc, dst_desc, post_ops_attr);
+      } else {
+        return matmul::primitive_desc(onednn_engine_, src_desc, weights_desc,
+                                      dst_desc, post_ops_attr);
+      }
 #else
-    if (post_op_util_.HasBias()) {
-      auto fwd_desc = matmul::desc(src_desc, weights_desc, bias_desc, dst_desc);
-      return matmul::primitive_desc(fwd_desc, post_ops_attr, onednn_engine_);
-    } else {
-      auto fwd_desc = matmul::desc(src_desc, weights_desc, dst_desc);
-      return matmul::primitive_desc(fwd_desc, post_ops_attr, onednn_engine_);
-    }
+      if (post_op_util_.HasBias()) {
+        auto fwd_desc =
+            matmul::desc(src_desc, weights_desc, bias_desc, dst_desc);
+        return matmul::primitive_desc(fwd_desc, post_ops_attr, onednn_engine_);
+      } else {
+        auto fwd_desc = matmul::desc(src_desc, weights_desc, dst_desc);
+        return matmul::primitive_desc(fwd_desc, post_ops_attr, onednn_engine_);
+      }
 #endif  // ITEX_ONEDNN_3_0
+    };
+    return MatMulPrimitiveCache::GetInstance()->FindOrCreate(
+        key_creator.GetKey(), create_pd);
   }
 
  private:
@@ -429,8 +439,8 @@ class BatchMatMulOp : public OpKernel {
       binary_mem_[kMaxBinaryNum_], scratchpad_mem_;
   dnnl::matmul matmul_primitive_;
   Tensor* dst_tensor_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64_t scratchpad_size_, binary_start_index_;
+  OneDnnScratchpad scratchpad_;
+  int64_t binary_start_index_;
   std::vector<int64> input_dims_, weights_dims_;
   TensorShape dst_shape_;
   dnnl::stream onednn_stream_;
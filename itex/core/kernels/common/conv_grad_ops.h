@@ -399,16 +399,11 @@ class ConvBackpropFilterOp
       }
 #endif
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          bwd_filter_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(bwd_filter_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, bwd_filter_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       // Create memory.
       auto src_mem = CreateDnnlMemory(fwd_src_md, onednn_engine,
@@ -670,16 +665,11 @@ class ConvBackpropInputOp
           ConvBwdInputPd(bwd_input_desc, attr, onednn_engine, fwd_pd);
 #endif
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          bwd_input_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(bwd_input_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, bwd_input_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       // Create memory.
       auto diff_dst_mem = CreateDnnlMemory(
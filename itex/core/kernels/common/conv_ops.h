@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "itex/core/kernels/common/host_data_cache.h"
@@ -28,6 +29,7 @@ limitations under the License.
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
 #include "itex/core/utils/onednn/onednn_post_op_util.h"
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
@@ -43,6 +45,8 @@ using dnnl::prop_kind;
 using ConvFwdDesc = dnnl::convolution_forward::desc;
 #endif
 using ConvFwdPd = dnnl::convolution_forward::primitive_desc;
+using ConvFwdPrimitiveCache =
+    OneDnnPrimitiveCache<ConvFwdPd, dnnl::convolution_forward>;
 
 #define DNNL_SIZE_DTYPE int64_t
 
@@ -708,159 +712,133 @@ class ConvOpBase : public OpKernel {
     fp32_math_mode_ = GetFP32MathMode<Device>();
   }
 
-  void InitOrSetMemory(OpKernelContext* context) {
-    if (!(enable_cache_ && is_init_ && context->is_input_same(0, input_dims_) &&
-          context->is_input_same(1, filter_dims_) && !is_format_reordered_)) {
-      Init(context);
-      return;
-    }
-
-    if (is_input_zero_) {
-      OP_REQUIRES_OK(context, context->allocate_output(
-                                  kDstIndex_, dst_tensor_shape_, &dst_tensor_));
+  void Compute(OpKernelContext* context) override {
+    // oneDNN stream and memory objects are not thread safe, so they are
+    // created in every Compute. Only the immutable `FwdContext` is shared
+    // between concurrent calls. INT8 kernels update their scales and bias
+    // caches in the hooks below, so they still run under `mu_compute_`.
+    if (!kIsInt8) {
+      ComputeWithContext(context);
       return;
     }
+    mutex_lock lock(&mu_compute_);
+    ComputeWithContext(context);
+  }
 
-    src_mem_opt_.set_data_handle(context->tensor_data(kSrcIndex_));
-
-    if (is_filter_reordered_) {
-      if (!is_filter_const_) {
-        filter_mem_input_.set_data_handle(context->tensor_data(kFilterIndex_));
-        filter_mem_.set_data_handle(GetTensorBuffer<Tfilter>(&tmp_weight_));
-        weight_reorder_.execute(onednn_stream_, weight_reorder_args_);
-      }
-    } else {
-      filter_mem_.set_data_handle(context->tensor_data(kFilterIndex_));
+ protected:
+  // Everything that only depends on the input shapes. It is not modified
+  // after creation, so concurrent Compute calls can share it.
+  struct FwdContext {
+    std::vector<int64> input_dims, filter_dims;
+    TensorShape dst_shape;
+    memory::dims dst_dims_onednn;
+    bool is_input_zero = false;
+    // The primitive runs in NHWC/NDHWC, src and dst are reordered if the
+    // kernel's data format differs.
+    bool is_format_reordered = false;
+    bool is_filter_reordered = false;
+    memory::desc src_md, src_md_opt, filter_md, filter_md_prefer, dst_md,
+        dst_md_opt, add_dst_md, bias_md, scratchpad_md;
+    primitive fwd_primitive;
+  };
+
+  static constexpr bool kIsInt8 = std::is_same<Tfilter, qint8>::value;
+
+  void ComputeWithContext(OpKernelContext* context) {
+    dnnl::engine onednn_engine = CreateDnnlEngine<Device>(*context);
+    std::shared_ptr<const FwdContext> fwd_context;
+    if (enable_cache_) fwd_context = std::atomic_load(&fwd_context_);
+    if (fwd_context == nullptr ||
+        !context->is_input_same(kSrcIndex_, fwd_context->input_dims) ||
+        !context->is_input_same(kFilterIndex_, fwd_context->filter_dims)) {
+      OP_REQUIRES_OK(context,
+                     CreateFwdContext(context, onednn_engine, &fwd_context));
+      if (enable_cache_) std::atomic_store(&fwd_context_, fwd_context);
     }
 
-    if (post_op_util_.HasBias()) {
-      // TODO(itex): avoid to use context->input, which may call C API
-      // more than once and cause overhead.
-      const Tensor& bias_tensor = context->input(kBiasIndex_);
-      // GetBiasHandle is needed for INT8 kernels, where bias scaling is
-      // required.
-      Tbias* bias_data = this->GetBiasHandle(context, bias_tensor);
-      bias_mem_.set_data_handle(bias_data);
+    try {
+      Execute(context, onednn_engine, *fwd_context);
+    } catch (dnnl::error& e) {
+      string error_msg = "Status: " + std::to_string(e.status) +
+                         ", message: " + string(e.message) + ", in file " +
+                         string(__FILE__) + ":" + std::to_string(__LINE__);
+      OP_REQUIRES_OK(
+          context,
+          errors::Aborted("Operation received an exception:", error_msg));
     }
-
-    // Reallocate scratchpad memory.
-    OP_REQUIRES_OK(context,
-                   context->allocate_temp(DataTypeToEnum<Tinput>::v(),
-                                          TensorShape({scratchpad_size_}),
-                                          scratchpad_tensor_.get()));
-    scratchpad_mem_.set_data_handle(
-        GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
-
-    Tensor dst_tensor_opt;
-    AllocateOutputTensor(context, fwd_pd_, dst_dims_onednn_, dst_tensor_shape_,
-                         &dst_tensor_, &dst_tensor_opt);
-
-    // Set dst mem if output need reorder.
-    // Here is trick to calculate INT8 conv + bias + add + relu, where
-    // Tsummand is s8, and Toutput is u8
-    dst_mem_opt_.set_data_handle(
-        reinterpret_cast<Tsummand*>(GetTensorBuffer<Toutput>(dst_tensor_)));
   }
 
-  void Compute(OpKernelContext* context) override {
-    mutex_lock lock(&mu_compute_);
-    onednn_engine_ = CreateDnnlEngine<Device>(*context);
-    // onednn_stream has thread safety issue, need create a new one in
-    // every compute.
-    onednn_stream_ = CreateDnnlStream(*context, onednn_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
-    InitOrSetMemory(context);
-
-    // Skip primitive execution if the calculation is meaningless.
-    if (is_filter_zero_ || is_input_zero_) {
-      scratchpad_tensor_.reset();
-      return;
+  Status CreateFwdContext(OpKernelContext* context,
+                          const dnnl::engine& onednn_engine,
+                          std::shared_ptr<const FwdContext>* fwd_context) {
+    const Tensor& src_tensor = context->input(kSrcIndex_);
+    const Tensor& filter_tensor = context->input(kFilterIndex_);
+
+    // Corner cases: filter with 0 elements
+    if (filter_tensor.NumElements() == 0) {
+      return errors::InvalidArgument(
+          "filter must not have zero elements "
+          "(i.e. all dimensions must be non-zero)");
     }
 
-    if (!is_format_reordered_) {
-      fwd_primitive_.execute(onednn_stream_, fwd_primitives_args_);
+    auto fwd = std::make_shared<FwdContext>();
+    TensorShape src_tensor_shape = src_tensor.shape();
+    TensorShape filter_tensor_shape = filter_tensor.shape();
+    for (int i = 0; i < src_tensor_shape.dims(); ++i) {
+      fwd->input_dims.push_back(src_tensor_shape.dim_size(i));
+    }
+    for (int i = 0; i < filter_tensor_shape.dims(); ++i) {
+      fwd->filter_dims.push_back(filter_tensor_shape.dim_size(i));
     }
-    scratchpad_tensor_.reset();
-  }
-
-  void Init(OpKernelContext* context) {
-    try {
-      fwd_primitives_args_.clear();
-
-      const Tensor& src_tensor = context->input(kSrcIndex_);
-      const Tensor& filter_tensor = context->input(kFilterIndex_);
-
-      // Corner cases: filter with 0 elements
-      if (filter_tensor.NumElements() == 0) {
-        context->CtxFailure(
-            errors::InvalidArgument("filter must not have zero elements "
-                                    "(i.e. all dimensions must be non-zero)"));
-        is_filter_zero_ = true;
-        return;
-      }
-
-      TensorShape src_tensor_shape = src_tensor.shape();
-      TensorShape filter_tensor_shape = filter_tensor.shape();
-
-      input_dims_.clear();
-      for (int i = 0; i < src_tensor_shape.dims(); ++i) {
-        input_dims_.push_back(src_tensor_shape.dim_size(i));
-      }
-      filter_dims_.clear();
-      for (int i = 0; i < filter_tensor_shape.dims(); ++i) {
-        filter_dims_.push_back(filter_tensor_shape.dim_size(i));
-      }
 
-      // Memory dimensions
-      memory::dims src_dims, filter_dims, pad_left_dims, pad_right_dims,
-          dilation_dims, stride_dims, bias_dims;
-      memory::dims dst_dims_tf;
+    // Memory dimensions
+    memory::dims src_dims, filter_dims, pad_left_dims, pad_right_dims,
+        dilation_dims, stride_dims, bias_dims;
+    memory::dims dst_dims_tf;
 
-      OneDnnConvUtil conv_util(context, data_format_, strides_, dilations_,
-                               padding_, explicit_paddings_, is_conv2d_,
-                               is_depthwise);
+    OneDnnConvUtil conv_util(context, data_format_, strides_, dilations_,
+                             padding_, explicit_paddings_, is_conv2d_,
+                             is_depthwise);
 
-      if (pad_enabled) {
-        const int kPadIndex =
-            post_op_util_.HasBias() ? kBiasIndex_ + 1 : kBiasIndex_;
-        conv_util.InitPadWithFusion(kPadIndex, true);
-      }
+    if (pad_enabled) {
+      const int kPadIndex =
+          post_op_util_.HasBias() ? kBiasIndex_ + 1 : kBiasIndex_;
+      conv_util.InitPadWithFusion(kPadIndex, true);
+    }
 
-      bool is_grouped_convolution;
-      conv_util.InitFwdDimensions(
-          src_tensor_shape, filter_tensor_shape, &src_dims, &filter_dims,
-          &stride_dims, &dilation_dims, &dst_dims_tf, &dst_dims_onednn_,
-          &pad_left_dims, &pad_right_dims, &is_grouped_convolution);
+    bool is_grouped_convolution;
+    conv_util.InitFwdDimensions(
+        src_tensor_shape, filter_tensor_shape, &src_dims, &filter_dims,
+        &stride_dims, &dilation_dims, &dst_dims_tf, &fwd->dst_dims_onednn,
+        &pad_left_dims, &pad_right_dims, &is_grouped_convolution);
+    TF_RETURN_IF_ERROR(context->status());
 
-      // OneDNN dilations start from 0.
-      for (int i = 0; i < dilation_dims.size(); ++i) {
-        --dilation_dims[i];
-      }
+    // OneDNN dilations start from 0.
+    for (int i = 0; i < dilation_dims.size(); ++i) {
+      --dilation_dims[i];
+    }
 
-      // output tensor shape.
-      dst_tensor_shape_ = OneDnnDimsToTFShape(dst_dims_tf);
+    // output tensor shape.
+    fwd->dst_shape = OneDnnDimsToTFShape(dst_dims_tf);
 
-      // Corner cases: output with 0 elements and 0 batch size.
-      if (dst_tensor_shape_.num_elements() == 0 || dst_dims_tf[0] == 0) {
-        is_input_zero_ = true;
-        OP_REQUIRES_OK(context,
-                       context->allocate_output(kDstIndex_, dst_tensor_shape_,
-                                                &dst_tensor_));
-        is_init_ = true;
-        return;
-      }
+    // Corner cases: output with 0 elements and 0 batch size.
+    if (fwd->dst_shape.num_elements() == 0 || dst_dims_tf[0] == 0) {
+      fwd->is_input_zero = true;
+      *fwd_context = std::move(fwd);
+      return Status::OK();
+    }
 
-      data_format_onednn_ =
+    try {
+      OneDnnTensorFormat data_format_onednn =
           TFDataFormatToOneDnnDataFormat(data_format_, is_conv2d_);
       memory::format_tag data_layout =
-          OneDnnTensorFormatToTag(data_format_onednn_);
-      memory::desc src_md =
-          memory::desc({src_dims}, OneDnnType<Tinput>(), data_layout);
+          OneDnnTensorFormatToTag(data_format_onednn);
+      fwd->src_md = memory::desc({src_dims}, OneDnnType<Tinput>(), data_layout);
       auto filter_format = is_conv2d_ ? (is_depthwise || is_grouped_convolution
                                              ? memory::format_tag::hwigo
                                              : memory::format_tag::hwio)
                                       : memory::format_tag::dhwio;
-      memory::desc filter_md =
+      fwd->filter_md =
           memory::desc({filter_dims}, OneDnnType<Tfilter>(), filter_format);
       memory::desc filter_md_prefer = memory::desc(
           {filter_dims}, OneDnnType<Tfilter>(), memory::format_tag::any);
@@ -874,229 +852,248 @@ class ConvOpBase : public OpKernel {
       // The reason for using Tsummand is to deal with the situation for int8
       // fusion conv + bias + add + relu fusion. Two inputs for add op may be
       // respectively quint8 and qint8.
-      dst_md_ =
-          memory::desc({dst_dims_onednn_}, OneDnnType<Tsummand>(), data_layout);
-      auto dst_md_opt =
-          memory::desc({dst_dims_onednn_}, OneDnnType<Tsummand>(), tag_opt);
+      fwd->dst_md = memory::desc({fwd->dst_dims_onednn}, OneDnnType<Tsummand>(),
+                                 data_layout);
+      memory::desc dst_md_opt = memory::desc(
+          {fwd->dst_dims_onednn}, OneDnnType<Tsummand>(), tag_opt);
       // Handle INT8 fusion, where Tsummand s8 and Toutput u8
-      add_dst_md_ =
-          memory::desc({dst_dims_onednn_}, OneDnnType<Toutput>(), tag_opt);
+      fwd->add_dst_md =
+          memory::desc({fwd->dst_dims_onednn}, OneDnnType<Toutput>(), tag_opt);
 
       this->ExtendInt8PostOps(context);
-      // Set post op attribution.
-      dnnl::primitive_attr post_ops_attr;
-      post_op_util_.SetPostOpAttr(&post_ops_attr);
-      post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
-      if (std::is_same<Tinput, float>::value) {
-        post_ops_attr.set_fpmath_mode(fp32_math_mode_);
-      }
-#ifdef ITEX_ONEDNN_3_0
-      if (this->post_op_util_.HasOutputScales() &&
-          post_op_util_.GetOutputScale().size() > 1 && is_depthwise) {
-        // For depthwise convolution mask should be 1<<0 + 1<<1 in onednn3.0
-        post_ops_attr.set_scales_mask(DNNL_ARG_WEIGHTS, 3);
-      }
-#endif
-
-#ifndef ITEX_ONEDNN_3_0
-      ConvFwdDesc fwd_desc =
-          ConvFwdDesc(prop_kind::forward, dnnl::algorithm::convolution_direct,
-                      src_md_opt, filter_md_prefer, dst_md_opt, stride_dims,
-                      dilation_dims, pad_left_dims, pad_right_dims);
-      fwd_pd_ = ConvFwdPd(fwd_desc, post_ops_attr, onednn_engine_);
-#else
-      fwd_pd_ =
-          ConvFwdPd(onednn_engine_, prop_kind::forward,
-                    dnnl::algorithm::convolution_direct, src_md_opt,
-                    filter_md_prefer, dst_md_opt, stride_dims, dilation_dims,
-                    pad_left_dims, pad_right_dims, post_ops_attr);
-#endif
 
       if (post_op_util_.HasBias()) {
         const Tensor& bias_tensor = context->input(kBiasIndex_);
         TensorShape bias_tensor_shape = bias_tensor.shape();
         conv_util.GetBiasDimension(bias_tensor_shape, &bias_dims);
-        auto bias_md =
+        fwd->bias_md =
             memory::desc(bias_dims, OneDnnType<Tbias>(), memory::format_tag::x);
-        // GetBiasHandle is needed for INT8 kernels, where bias scaling is
-        // required.
-        Tbias* bias_data = this->GetBiasHandle(context, bias_tensor);
-
 #ifdef ITEX_ONEDNN_3_0
         // OneDNN 3.0 requires float Bias for bias in INT8 model, will have an
         // internal conversion when bias is INT8.
         if (std::is_same<Tbias, qint32>::value &&
             !std::is_same<Toutput, qint32>::value) {
-          bias_md = memory::desc(bias_dims, OneDnnType<float>(),
-                                 memory::format_tag::x);
-          bias_mem_ = CreateDnnlMemory(bias_md, onednn_engine_,
-                                       static_cast<void*>(bias_data));
-        } else {
-          bias_mem_ = CreateDnnlMemory(bias_md, onednn_engine_, bias_data);
+          fwd->bias_md = memory::desc(bias_dims, OneDnnType<float>(),
+                                      memory::format_tag::x);
+        }
+#endif
+      }
+
+      // Reuse the primitive if any Conv kernel has created it before.
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("conv_fwd");
+      key_creator.AddAsKey(onednn_engine);
+      key_creator.AddAsKey(src_md_opt);
+      key_creator.AddAsKey(filter_md_prefer);
+      key_creator.AddAsKey(dst_md_opt);
+      key_creator.AddAsKey(stride_dims);
+      key_creator.AddAsKey(dilation_dims);
+      key_creator.AddAsKey(pad_left_dims);
+      key_creator.AddAsKey(pad_right_dims);
+      key_creator.AddAsKey(is_depthwise);
+      key_creator.AddAsKey(fp32_math_mode_);
+      post_op_util_.AddAsKey(&key_creator);
+      if (post_op_util_.HasBias()) key_creator.AddAsKey(fwd->bias_md);
+
+      auto create_pd = [&]() {
+        // Set post op attribution.
+        dnnl::primitive_attr post_ops_attr;
+        post_op_util_.SetPostOpAttr(&post_ops_attr);
+        post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+        if (std::is_same<Tinput, float>::value) {
+          post_ops_attr.set_fpmath_mode(fp32_math_mode_);
+        }
+#ifdef ITEX_ONEDNN_3_0
+        if (this->post_op_util_.HasOutputScales() &&
+            post_op_util_.GetOutputScale().size() > 1 && is_depthwise) {
+          // For depthwise convolution mask should be 1<<0 + 1<<1 in onednn3.0
+          post_ops_attr.set_scales_mask(DNNL_ARG_WEIGHTS, 3);
         }
-#else
-        bias_mem_ = CreateDnnlMemory(bias_md, onednn_engine_, bias_data);
 #endif
 
-        fwd_primitives_args_.insert({DNNL_ARG_BIAS, bias_mem_});
+        if (post_op_util_.HasBias()) {
 #ifndef ITEX_ONEDNN_3_0
-        fwd_desc = ConvFwdDesc(
-            prop_kind::forward, dnnl::algorithm::convolution_direct, src_md_opt,
-            filter_md_prefer, bias_md, dst_md_opt, stride_dims, dilation_dims,
-            pad_left_dims, pad_right_dims);
-        fwd_pd_ = ConvFwdPd(fwd_desc, post_ops_attr, onednn_engine_);
+          ConvFwdDesc fwd_desc = ConvFwdDesc(
+              prop_kind::forward, dnnl::algorithm::convolution_direct,
+              src_md_opt, filter_md_prefer, fwd->bias_md, dst_md_opt,
+              stride_dims, dilation_dims, pad_left_dims, pad_right_dims);
+          return ConvFwdPd(fwd_desc, post_ops_attr, onednn_engine);
 #else
-        fwd_pd_ = ConvFwdPd(onednn_engine_, prop_kind::forward,
-                            dnnl::algorithm::convolution_direct, src_md_opt,
-                            filter_md_prefer, bias_md, dst_md_opt, stride_dims,
-                            dilation_dims, pad_left_dims, pad_right_dims,
-                            post_ops_attr);
+          return ConvFwdPd(onednn_engine, prop_kind::forward,
+                           dnnl::algorithm::convolution_direct, src_md_opt,
+                           filter_md_prefer, fwd->bias_md, dst_md_opt,
+                           stride_dims, dilation_dims, pad_left_dims,
+                           pad_right_dims, post_ops_attr);
 #endif
-      }
-
-      // keep tensor out of if block to avoid of being deallocated
-      is_format_reordered_ = data_layout != tag_opt;
+        }
+#ifndef ITEX_ONEDNN_3_0
+        ConvFwdDesc fwd_desc = ConvFwdDesc(
+            prop_kind::forward, dnnl::algorithm::convolution_direct,
+            src_md_opt, filter_md_prefer, dst_md_opt, stride_dims,
+            dilation_dims, pad_left_dims, pad_right_dims);
+        return ConvFwdPd(fwd_desc, post_ops_attr, onednn_engine);
+#else
+        return ConvFwdPd(onednn_engine, prop_kind::forward,
+                         dnnl::algorithm::convolution_direct, src_md_opt,
+                         filter_md_prefer, dst_md_opt, stride_dims,
+                         dilation_dims, pad_left_dims, pad_right_dims,
+                         post_ops_attr);
+#endif
+      };
+      auto cached = ConvFwdPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const ConvFwdPd& fwd_pd = cached.pd;
+      fwd->fwd_primitive = cached.primitive;
+
+      fwd->is_format_reordered = data_layout != tag_opt;
+      fwd->src_md_opt = fwd_pd.src_desc();
+      fwd->dst_md_opt = fwd_pd.dst_desc();
+      fwd->filter_md_prefer = fwd_pd.weights_desc();
+      fwd->is_filter_reordered = (fwd->filter_md_prefer != fwd->filter_md);
+      fwd->scratchpad_md = fwd_pd.scratchpad_desc();
+    } catch (dnnl::error& e) {
+      string error_msg = "Status: " + std::to_string(e.status) +
+                         ", message: " + string(e.message) + ", in file " +
+                         string(__FILE__) + ":" + std::to_string(__LINE__);
+      return errors::Aborted("Operation received an exception:", error_msg);
+    }
+    *fwd_context = std::move(fwd);
+    return Status::OK();
+  }
 
-      // This one for dnnl primitive output when output need reorder.
-      Tensor dst_tensor_opt;
-      // This one for dnnl primitive input when input need reorder.
-      Tensor src_tensor_opt;
+  // Binds the tensors of this call to `fwd` and runs the primitive. All
+  // memory objects and temporary buffers are local to the call.
+  void Execute(OpKernelContext* context, const dnnl::engine& onednn_engine,
+               const FwdContext& fwd) {
+    if (fwd.is_input_zero) {
+      Tensor* dst_tensor = nullptr;
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  kDstIndex_, fwd.dst_shape, &dst_tensor));
+      return;
+    }
 
-      dnnl::reorder src_reorder;
-      dnnl::reorder dst_reorder;
-      std::unordered_map<int, memory> src_reorder_args;
-      std::unordered_map<int, memory> dst_reorder_args;
+    const Tensor& src_tensor = context->input(kSrcIndex_);
+    const Tensor& filter_tensor = context->input(kFilterIndex_);
+
+    // Reorder src to NHWC if needed.
+    memory src_mem = CreateDnnlMemory(fwd.src_md, onednn_engine,
+                                      GetTensorBuffer<Tinput>(&src_tensor));
+    memory src_mem_opt = src_mem;
+    Tensor src_tensor_opt;
+    if (fwd.is_format_reordered) {
+      int64 src_nums = fwd.src_md_opt.get_size() / sizeof(Tinput);
+      OP_REQUIRES_OK(context, context->allocate_temp(
+                                  DataTypeToEnum<Tinput>::v(),
+                                  TensorShape({src_nums}), &src_tensor_opt));
+      src_mem_opt = CreateDnnlMemory(fwd.src_md_opt, onednn_engine,
+                                     GetTensorBuffer<Tinput>(&src_tensor_opt));
+      ReorderMemory(*context, &src_mem, &src_mem_opt, onednn_engine);
+    }
 
-      if (is_format_reordered_) {
-        // allocate dst memory for reorder back later
-        int64 dst_nums = fwd_pd_.dst_desc().get_size() / sizeof(Tsummand);
-        OP_REQUIRES_OK(context, context->allocate_temp(
-                                    DataTypeToEnum<Tsummand>::v(),
-                                    TensorShape({dst_nums}), &dst_tensor_opt));
+    // Check filter reorder and do cache if filter is const.
+    memory filter_mem_input =
+        CreateDnnlMemory(fwd.filter_md, onednn_engine,
+                         GetTensorBuffer<Tfilter>(&filter_tensor));
+    memory filter_mem = filter_mem_input;
+    Tensor tmp_weight;
+    if (fwd.is_filter_reordered) {
+      Tfilter* filter_cached_data = nullptr;
+      if (is_filter_const_) {
+        if (weight_cache_manager_.IsEmpty()) {
+          weight_cache_manager_.SetCache(
+              context, fwd.filter_md, fwd.filter_md_prefer,
+              GetTensorBuffer<Tfilter>(&filter_tensor), onednn_engine);
+        }
+        filter_cached_data =
+            weight_cache_manager_.GetCache(context, fwd.filter_md_prefer);
       }
-
-      AllocateOutputTensor(context, fwd_pd_, dst_dims_onednn_,
-                           dst_tensor_shape_, &dst_tensor_, &dst_tensor_opt);
-      scratchpad_size_ = fwd_pd_.scratchpad_desc().get_size() / sizeof(Tinput);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<Tinput>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(fwd_pd_.scratchpad_desc(), onednn_engine_,
-                       GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
-
-      fwd_primitive_ = convolution_forward(fwd_pd_);
-
-      src_mem_ = CreateDnnlMemory(src_md, onednn_engine_,
-                                  GetTensorBuffer<Tinput>(&src_tensor));
-      dst_mem_ = CreateDnnlMemory(
-          dst_md_, onednn_engine_,
-          reinterpret_cast<Tsummand*>(GetTensorBuffer<Toutput>(dst_tensor_)));
-      // reorder src/dst to NHWC if needed
-      src_mem_opt_ = src_mem_;
-      dst_mem_opt_ = dst_mem_;
-
-      if (is_format_reordered_) {
-        int64 src_nums = fwd_pd_.src_desc().get_size() / sizeof(Tinput);
+      if (filter_cached_data != nullptr) {
+        filter_mem = CreateDnnlMemory(fwd.filter_md_prefer, onednn_engine,
+                                      filter_cached_data);
+      } else {
+        // allocate temporay tensor for reordering filter
+        int64_t reorder_filter_data_size =
+            fwd.filter_md_prefer.get_size() / sizeof(Tfilter);
         OP_REQUIRES_OK(context, context->allocate_temp(
-                                    DataTypeToEnum<Tinput>::v(),
-                                    TensorShape({src_nums}), &src_tensor_opt));
-        src_mem_opt_ =
-            CreateDnnlMemory(src_md_opt, onednn_engine_,
-                             GetTensorBuffer<Tinput>(&src_tensor_opt));
-
-        src_reorder_args.insert({DNNL_ARG_SRC, src_mem_});
-        src_reorder_args.insert({DNNL_ARG_DST, src_mem_opt_});
-        src_reorder = dnnl::reorder(src_mem_, src_mem_opt_);
-        src_reorder.execute(onednn_stream_, src_reorder_args);
-
-        dst_mem_opt_ =
-            CreateDnnlMemory(dst_md_opt, onednn_engine_,
-                             GetTensorBuffer<Tsummand>(&dst_tensor_opt));
-
-        dst_reorder_args.insert({DNNL_ARG_SRC, dst_mem_opt_});
-        dst_reorder_args.insert({DNNL_ARG_DST, dst_mem_});
-        dst_reorder = dnnl::reorder(dst_mem_opt_, dst_mem_);
+                                    DataTypeToEnum<Tfilter>::v(),
+                                    TensorShape({reorder_filter_data_size}),
+                                    &tmp_weight));
+        filter_mem = CreateDnnlMemory(fwd.filter_md_prefer, onednn_engine,
+                                      GetTensorBuffer<Tfilter>(&tmp_weight));
+        ReorderMemory(*context, &filter_mem_input, &filter_mem,
+                      onednn_engine);
       }
+    }
 
-      // Check filter reorder and do cache if filter is const.
-      filter_mem_input_ = CreateDnnlMemory(
-          filter_md, onednn_engine_, GetTensorBuffer<Tfilter>(&filter_tensor));
-      filter_md_prefer = fwd_pd_.weights_desc();
-      is_filter_reordered_ = (filter_md_prefer != filter_md);
-      if (is_filter_reordered_) {
-        Tfilter* filter_cached_data = nullptr;
-        if (is_filter_const_) {
-          if (weight_cache_manager_.IsEmpty()) {
-            weight_cache_manager_.SetCache(
-                context, filter_md, filter_md_prefer,
-                GetTensorBuffer<Tfilter>(&filter_tensor), onednn_engine_);
-          }
-          filter_cached_data =
-              weight_cache_manager_.GetCache(context, filter_md_prefer);
-          if (filter_cached_data != nullptr) {
-            filter_mem_ = CreateDnnlMemory(filter_md_prefer, onednn_engine_,
-                                           filter_cached_data);
-          }
-        }
-        if (filter_cached_data == nullptr) {
-          // allocate temporay tensor for reordering filter
-          int64_t reorder_filter_data_size =
-              fwd_pd_.weights_desc().get_size() / sizeof(Tfilter);
-          OP_REQUIRES_OK(context, context->allocate_temp(
-                                      DataTypeToEnum<Tfilter>::v(),
-                                      TensorShape({reorder_filter_data_size}),
-                                      &tmp_weight_));
-          void* filter_data_handle = GetTensorBuffer<Tfilter>(&tmp_weight_);
-          filter_mem_ = CreateDnnlMemory(filter_md_prefer, onednn_engine_,
-                                         filter_data_handle);
-          weight_reorder_args_.clear();
-          weight_reorder_args_.insert({DNNL_ARG_SRC, filter_mem_input_});
-          weight_reorder_args_.insert({DNNL_ARG_DST, filter_mem_});
-          weight_reorder_ = dnnl::reorder(filter_mem_input_, filter_mem_);
-          weight_reorder_.execute(onednn_stream_, weight_reorder_args_);
-        }
-      } else {
-        filter_mem_ = filter_mem_input_;
-      }
+    // This one for dnnl primitive output when output need reorder.
+    Tensor dst_tensor_opt;
+    if (fwd.is_format_reordered) {
+      int64 dst_nums = fwd.dst_md_opt.get_size() / sizeof(Tsummand);
+      OP_REQUIRES_OK(context, context->allocate_temp(
+                                  DataTypeToEnum<Tsummand>::v(),
+                                  TensorShape({dst_nums}), &dst_tensor_opt));
+    }
+    Tensor* dst_tensor = nullptr;
+    AllocateOutputTensor(context, onednn_engine, fwd, &dst_tensor,
+                         &dst_tensor_opt);
+    if (!context->status().ok()) return;
+
+    // Here is trick to calculate INT8 conv + bias + add + relu, where
+    // Tsummand is s8, and Toutput is u8
+    memory dst_mem = CreateDnnlMemory(
+        fwd.dst_md, onednn_engine,
+        reinterpret_cast<Tsummand*>(GetTensorBuffer<Toutput>(dst_tensor)));
+    memory dst_mem_opt = dst_mem;
+    if (fwd.is_format_reordered) {
+      dst_mem_opt =
+          CreateDnnlMemory(fwd.dst_md_opt, onednn_engine,
+                           GetTensorBuffer<Tsummand>(&dst_tensor_opt));
+    }
 
-      // Execute convolution
-      fwd_primitives_args_.insert({DNNL_ARG_SRC, src_mem_opt_});
-      fwd_primitives_args_.insert({DNNL_ARG_WEIGHTS, filter_mem_});
-      fwd_primitives_args_.insert({DNNL_ARG_DST, dst_mem_opt_});
-      fwd_primitives_args_.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem_});
+    OneDnnScratchpad scratchpad;
+    OP_REQUIRES_OK(context,
+                   scratchpad.Init(context, fwd.scratchpad_md, onednn_engine));
+
+    std::unordered_map<int, memory> fwd_primitive_args = {
+        {DNNL_ARG_SRC, src_mem_opt},
+        {DNNL_ARG_WEIGHTS, filter_mem},
+        {DNNL_ARG_DST, dst_mem_opt},
+        {DNNL_ARG_SCRATCHPAD, scratchpad.memory()}};
+    if (post_op_util_.HasBias()) {
+      // GetBiasHandle is needed for INT8 kernels, where bias scaling is
+      // required.
+      const Tensor& bias_tensor = context->input(kBiasIndex_);
+      Tbias* bias_data =
+          this->GetBiasHandle(context, onednn_engine, bias_tensor);
+      fwd_primitive_args.emplace(
+          DNNL_ARG_BIAS,
+          CreateDnnlMemory(fwd.bias_md, onednn_engine, bias_data));
+    }
 #ifdef ITEX_ONEDNN_3_0
-      if (this->post_op_util_.HasOutputScales()) {
-        float* output_scale_ptr = output_scale_cache_.GetCachedPtr(
-            context, this->post_op_util_.GetOutputScale().data(),
-            this->post_op_util_.GetOutputScale().size());
-        dnnl::memory output_scales_mem(
-            {{static_cast<dnnl_dim_t>(post_op_util_.GetOutputScale().size())},
-             memory::data_type::f32,
-             memory::format_tag::x},
-            onednn_engine_, reinterpret_cast<void*>(output_scale_ptr));
-        fwd_primitives_args_.insert(
-            {DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS, output_scales_mem});
-      }
+    if (post_op_util_.HasOutputScales()) {
+      // Only INT8 kernels have output scales, and they run under
+      // `mu_compute_`, so the cached buffer isn't replaced while the
+      // primitive reads it.
+      float* output_scale_ptr = output_scale_cache_.GetCachedPtr(
+          context, output_scale_key_, post_op_util_.GetOutputScale().data(),
+          post_op_util_.GetOutputScale().size());
+      dnnl::memory output_scales_mem(
+          {{static_cast<dnnl_dim_t>(post_op_util_.GetOutputScale().size())},
+           memory::data_type::f32,
+           memory::format_tag::x},
+          onednn_engine, reinterpret_cast<void*>(output_scale_ptr));
+      fwd_primitive_args.emplace(DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS,
+                                 output_scales_mem);
+    }
 #endif
 
-      // reorder back if needed
-      if (is_format_reordered_) {
-        fwd_primitive_.execute(onednn_stream_, fwd_primitives_args_);
-        dst_reorder.execute(onednn_stream_, dst_reorder_args);
-      }
+    dnnl::stream onednn_stream = CreateDnnlStream(*context, onednn_engine);
+    ExecutePrimitive(fwd.fwd_primitive, onednn_stream, fwd_primitive_args);
 
-      is_init_ = true;
-    } catch (dnnl::error& e) {
-      string error_msg = "Status: " + std::to_string(e.status) +
-                         ", message: " + string(e.message) + ", in file " +
-                         string(__FILE__) + ":" + std::to_string(__LINE__);
-      OP_REQUIRES_OK(
-          context,
-          errors::Aborted("Operation received an exception:", error_msg));
+    // reorder back if needed
+    if (fwd.is_format_reordered) {
+      ReorderMemory(*context, &dst_mem_opt, &dst_mem, onednn_engine);
     }
-    return;
   }
 
  private:
@@ -1106,11 +1103,14 @@ class ConvOpBase : public OpKernel {
   Padding padding_;
 
   bool inplace_sum_ = false;
-  bool is_filter_const_ = false;
 
   // Weight cache manager
   WeightCacheManager<Tfilter> weight_cache_manager_;
 
+  // Context of the last input shapes, only accessed with std::atomic_load
+  // and std::atomic_store.
+  std::shared_ptr<const FwdContext> fwd_context_;
+  // Serializes the INT8 kernels, see Compute.
   mutex mu_compute_;
 #ifdef ITEX_ONEDNN_3_0
   HostDataCache<Device, float> output_scale_cache_;
@@ -1122,53 +1122,10 @@ class ConvOpBase : public OpKernel {
   const int kSrcIndex_ = 0, kFilterIndex_ = 1, kBiasIndex_ = 2, kAddIndex_ = 3;
   const int kDstIndex_ = 0;
   PostOpUtil post_op_util_;
-
-  // Cache oneDNN object and TF memory
-  bool is_init_ = false;
-  bool is_input_zero_ = false;
-  bool is_filter_zero_ = false;
-  bool is_format_reordered_ = false;
-  bool is_filter_reordered_ = false;
-
-  // This one for TF input when input need reorder.
-  dnnl::memory src_mem_;
-  // This one for dnnl primitive input
-  dnnl::memory src_mem_opt_;
-  // This one for TF output when output need reorder.
-  dnnl::memory dst_mem_;
-  // This one for dnnl primitive output
-  dnnl::memory dst_mem_opt_;
-  // This one for dnnl primitive weight
-  dnnl::memory filter_mem_;
-  // This one for TF weight when weight need reorder.
-  dnnl::memory filter_mem_input_;
-  dnnl::memory scratchpad_mem_;
-  dnnl::memory bias_mem_;
-  dnnl::memory::dims dst_dims_onednn_;
-
-  memory::desc dst_md_;
-  // This one for dnnl sum fusion.
-  memory::desc add_dst_md_;
-
-  dnnl::stream onednn_stream_;
-  dnnl::engine onednn_engine_;
-
-  dnnl::reorder weight_reorder_;
-  primitive fwd_primitive_;
-  ConvFwdPd fwd_pd_;
-
-  std::unordered_map<int, memory> fwd_primitives_args_;
-  std::unordered_map<int, memory> weight_reorder_args_;
-
-  TensorShape dst_tensor_shape_;
-  OneDnnTensorFormat data_format_onednn_;
-  std::vector<int64> input_dims_, filter_dims_;
-
-  Tensor* dst_tensor_ = nullptr;
-  // This one for dnnl primitive weight when weight need reorder.
-  Tensor tmp_weight_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64_t scratchpad_size_ = 0;
+  bool is_filter_const_ = false;
+  // Inputs the output scales of INT8 kernels were computed from, set in
+  // `ExtendInt8PostOps`.
+  HostDataKey output_scale_key_;
 
   bool enable_cache_ = false;
   dnnl::fpmath_mode fp32_math_mode_ = dnnl::fpmath_mode::strict;
@@ -1176,11 +1133,10 @@ class ConvOpBase : public OpKernel {
   // ExtendInt8PostOps is only used in Int8 ops.
   virtual void ExtendInt8PostOps(OpKernelContext* context) {}
 
-  virtual void AllocateOutputTensor(
-      OpKernelContext* context,
-      const dnnl::convolution_forward::primitive_desc& conv_pd,
-      const memory::dims& dst_dims_onednn, TensorShape dst_tensor_shape,
-      Tensor** dst_tensor, Tensor* dst_tensor_opt) {
+  virtual void AllocateOutputTensor(OpKernelContext* context,
+                                    const dnnl::engine& onednn_engine,
+                                    const FwdContext& fwd, Tensor** dst_tensor,
+                                    Tensor* dst_tensor_opt) {
     ITEX_DCHECK(dst_tensor);
 
     if (post_op_util_.HasAdd() &&
@@ -1194,40 +1150,39 @@ class ConvOpBase : public OpKernel {
 
       // Try to do in-place.
       // TODO(itex): Remove this workaround when inplace works.
-      if (!this->is_format_reordered_) {
+      if (!fwd.is_format_reordered) {
         if (inplace_sum_) {
           context->set_output(this->kDstIndex_, add_tensor);
-          dst_tensor_ = context->mutable_output(this->kDstIndex_);
+          *dst_tensor = context->mutable_output(this->kDstIndex_);
           is_forward_success = this->kAddIndex_;
         } else {
           OP_REQUIRES_OK(context,
                          context->forward_input_or_allocate_output(
-                             {this->kAddIndex_}, kDstIndex_, dst_tensor_shape,
+                             {this->kAddIndex_}, kDstIndex_, fwd.dst_shape,
                              dst_tensor, &is_forward_success));
         }
       } else {
         OP_REQUIRES_OK(context,
                        context->allocate_output(this->kDstIndex_,
-                                                dst_tensor_shape, dst_tensor));
+                                                fwd.dst_shape, dst_tensor));
       }
 
       // Reorder is needed, forward is failed but dst has been allocated;
       if (is_forward_success == kUnsuccess) {
         // In-place do not success, need reorder.
         auto fuse_add_src =
-            CreateDnnlMemory(this->dst_md_, this->onednn_engine_,
+            CreateDnnlMemory(fwd.dst_md, onednn_engine,
                              GetTensorBuffer<Toutput>(&add_tensor));
         auto fuse_add_dst =
-            CreateDnnlMemory(this->add_dst_md_, this->onednn_engine_,
+            CreateDnnlMemory(fwd.add_dst_md, onednn_engine,
                              GetTensorBuffer<Toutput>(*dst_tensor));
 
         // Reset data handle to tmp tensor if the dst needs to be reordered.
-        if (this->is_format_reordered_) {
+        if (fwd.is_format_reordered) {
           fuse_add_dst.set_data_handle(
               GetTensorBuffer<Tsummand>(dst_tensor_opt));
         }
-        ReorderMemory(*context, &fuse_add_src, &fuse_add_dst,
-                      this->onednn_engine_);
+        ReorderMemory(*context, &fuse_add_src, &fuse_add_dst, onednn_engine);
       }
     } else {
       OP_REQUIRES(
@@ -1238,15 +1193,15 @@ class ConvOpBase : public OpKernel {
                                        std::is_same<Toutput, qint32>::value))),
           errors::InvalidArgument("ConvOp: Invalid data type in AddN fusion."));
 
-      OP_REQUIRES_OK(
-          context, context->allocate_output(this->kDstIndex_, dst_tensor_shape,
-                                            dst_tensor));
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  this->kDstIndex_, fwd.dst_shape, dst_tensor));
     }
 
     return;
   }
 
   virtual Tbias* GetBiasHandle(OpKernelContext* context,
+                               const dnnl::engine& onednn_engine,
                                const Tensor& bias_tensor) {
     return static_cast<Tbias*>(
         const_cast<Tbias*>(bias_tensor.flat<Tbias>().data()));
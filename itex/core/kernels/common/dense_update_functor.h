@@ -15,8 +15,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#ifndef ITEX_CORE_KERNELS_GPU_DENSE_UPDATE_FUNCTOR_H_
-#define ITEX_CORE_KERNELS_GPU_DENSE_UPDATE_FUNCTOR_H_
+#ifndef ITEX_CORE_KERNELS_COMMON_DENSE_UPDATE_FUNCTOR_H_
+#define ITEX_CORE_KERNELS_COMMON_DENSE_UPDATE_FUNCTOR_H_
 
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
@@ -88,6 +88,7 @@ struct DenseUpdate<GPUDevice, T, SUB> {
 
 }  // end namespace functor
 
+#ifndef INTEL_CPU_ONLY
 #define DEFINE_GPU_KERNELS(T)                              \
   template struct functor::DenseUpdate<GPUDevice, T, ADD>; \
   template struct functor::DenseUpdate<GPUDevice, T, SUB>;
@@ -114,7 +115,8 @@ TF_CALL_complex128(DEFINE_GPU_KERNELS);
 #endif  // ITEX_ENABLE_DOUBLE
 
 #undef DEFINE_GPU_KERNELS
+#endif  // INTEL_CPU_ONLY
 
 }  // end namespace itex
 
-#endif  // ITEX_CORE_KERNELS_GPU_DENSE_UPDATE_FUNCTOR_H_
+#endif  // ITEX_CORE_KERNELS_COMMON_DENSE_UPDATE_FUNCTOR_H_
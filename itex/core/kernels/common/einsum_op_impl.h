@@ -685,15 +685,10 @@ struct EinsumHelper {
       dnnl::matmul::primitive_desc matmul_pd(matmul_desc, post_ops_attr,
                                              dnnl_engine);
 #endif
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          matmul_pd.scratchpad_desc().get_size() / sizeof(T);
-      TF_ABORT_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<T>::v(),
-                                           TensorShape({scratchpad_size}),
-                                           &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(matmul_pd.scratchpad_desc(), dnnl_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+      OneDnnScratchpad scratchpad;
+      TF_ABORT_IF_ERROR(
+          scratchpad.Init(ctx, matmul_pd.scratchpad_desc(), dnnl_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       auto matmul_primitive = dnnl::matmul(matmul_pd);
 
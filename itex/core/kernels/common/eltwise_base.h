@@ -84,15 +84,10 @@ class EltwiseBaseOp : public OpKernel {
                                      alpha_, beta_);
       eltwise_forward::primitive_desc fwd_pd(fwd_desc, attr, onednn_engine);
 #endif
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size = fwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, fwd_pd.scratchpad_desc(),
+                                              onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       primitive fwd_primitive(fwd_pd);
 
@@ -204,15 +199,10 @@ class EltwiseGradBaseOp : public OpKernel {
       eltwise_backward::primitive_desc bwd_pd(bwd_desc, attr, onednn_engine_,
                                               fwd_pd);
 #endif
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size = bwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(bwd_pd.scratchpad_desc(), onednn_engine_,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, bwd_pd.scratchpad_desc(),
+                                              onednn_engine_));
+      auto scratchpad_mem = scratchpad.memory();
 
       primitive bwd_primitive(bwd_pd);
 
@@ -199,16 +199,11 @@ class FusedBatchNormOp : public OpKernel {
           bn_fwd_desc, attr, onednn_engine);
 #endif
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          bn_fwd_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(bn_fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, bn_fwd_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       dnnl::batch_normalization_forward bn_fwd_primitive(bn_fwd_pd);
 
@@ -787,16 +782,11 @@ class FusedBatchNormGradOp : public OpKernel {
           bn_bwd_desc, attr, onednn_engine, bn_fwd_pd);
 #endif
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          bn_bwd_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(bn_bwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, bn_bwd_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       dnnl::batch_normalization_backward bn_bwd_primitive(bn_bwd_pd);
 #ifndef ITEX_ONEDNN_3_0
@@ -77,7 +77,7 @@ class OneDnnGRUForwardOp : public OpKernel {
     Tensor augru_weights_iter_tensor;
     Tensor dst_iter_tensor;
     Tensor workspace_tensor;
-    Tensor scratchpad_tensor;
+    OneDnnScratchpad scratchpad;
 
     memory::dim N = 1,  // batch size
         TimeS = 1,      // time steps
@@ -369,9 +369,9 @@ class OneDnnGRUForwardOp : public OpKernel {
       augru_args.insert({DNNL_ARG_WORKSPACE, workspace_mem});
     }
     if (augru_pd.scratchpad_desc().get_size() != 0) {
-      auto scratchpad_mem = AllocateMemory(ctx, augru_pd.scratchpad_desc(),
-                                           dnnl_engine, &scratchpad_tensor);
-      augru_args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
+      OP_REQUIRES_OK(
+          ctx, scratchpad.Init(ctx, augru_pd.scratchpad_desc(), dnnl_engine));
+      augru_args.insert({DNNL_ARG_SCRATCHPAD, scratchpad.memory()});
     }
 
     if (std::is_same<GruType, augru_forward>())
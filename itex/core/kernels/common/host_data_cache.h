@@ -24,27 +24,89 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "itex/core/utils/hash.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
 #include "itex/core/utils/tensor_types.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
 typedef Eigen::GpuDevice GPUDevice;
 namespace itex {
 
+// Identifies host data, e.g. the scales of an INT8 kernel, by the inputs it is
+// computed from. A kernel can then tell the data didn't change without
+// computing it and comparing it to the cached one. Inputs are identified by a
+// hash of their contents, which doesn't assume anything about where their
+// buffers come from.
+class HostDataKey {
+ public:
+  HostDataKey& AddValue(float value) {
+    return Combine(
+        Hash64(reinterpret_cast<const char*>(&value), sizeof(value)));
+  }
+
+  // `tensor` must be in host memory.
+  HostDataKey& AddTensor(const Tensor& tensor) {
+    StringPiece data = tensor.tensor_data();
+    return Combine(Hash64(data.data(), data.size()));
+  }
+
+  // `HostDataCache` compares the data itself for an empty key.
+  bool empty() const { return num_parts_ == 0; }
+
+  bool operator==(const HostDataKey& other) const {
+    return num_parts_ == other.num_parts_ && hash_ == other.hash_;
+  }
+  bool operator!=(const HostDataKey& other) const { return !(*this == other); }
+
+ private:
+  HostDataKey& Combine(uint64 hash) {
+    hash_ = Hash64Combine(hash_, hash);
+    ++num_parts_;
+    return *this;
+  }
+
+  uint64 hash_ = 0;
+  int num_parts_ = 0;
+};
+
 #ifdef ITEX_ONEDNN_3_0
 template <typename Device, typename T>
 class HostDataCache {
  public:
   HostDataCache() : gpu_capacity_(0) {}
   T* GetCachedPtr(OpKernelContext* ctx, const T* host_data, size_t count) {
+    return GetCachedPtr(ctx, HostDataKey(), host_data, count);
+  }
+
+  // Returns the cached data if it was cached with `key`, otherwise nullptr.
+  // The caller then computes the data and caches it with `GetCachedPtr`.
+  T* Lookup(const HostDataKey& key) {
+    if (key.empty() || key != last_key_) return nullptr;
+    if (std::is_same<Device, GPUDevice>::value) {
+#ifndef INTEL_CPU_ONLY
+      return gpu_tensor_.flat<T>().data();
+#endif
+    }
+    return last_host_data_.data();
+  }
+
+  // Caches `host_data` computed from the inputs identified by `key`. The data
+  // is only compared to the cached one if `key` is empty.
+  T* GetCachedPtr(OpKernelContext* ctx, const HostDataKey& key,
+                  const T* host_data, size_t count) {
+    const bool is_same =
+        key.empty() ? IsSame(host_data, count)
+                    : key == last_key_ && last_host_data_.size() == count;
+    last_key_ = key;
     T* out_ptr = nullptr;
     if (std::is_same<Device, GPUDevice>::value) {
 #ifndef INTEL_CPU_ONLY
-      GetCachedPtrGPU(ctx, host_data, count, &out_ptr);
+      GetCachedPtrGPU(ctx, host_data, count, is_same, &out_ptr);
 #endif
     } else {
-      GetCachedPtrCPU(ctx, host_data, count, &out_ptr);
+      GetCachedPtrCPU(ctx, host_data, count, is_same, &out_ptr);
     }
     return out_ptr;
   }
@@ -58,15 +120,15 @@ class HostDataCache {
     return true;
   }
   void GetCachedPtrCPU(OpKernelContext* ctx, const T* host_data, size_t count,
-                       T** out_ptr) {
-    if (!IsSame(host_data, count)) {
+                       bool is_same, T** out_ptr) {
+    if (!is_same) {
       last_host_data_ = std::move(std::vector<T>(host_data, host_data + count));
     }
     *out_ptr = last_host_data_.data();
   }
 #ifndef INTEL_CPU_ONLY
   void GetCachedPtrGPU(OpKernelContext* ctx, const T* host_data, size_t count,
-                       T** out_ptr) {
+                       bool is_same, T** out_ptr) {
     bool need_copy = false;
     if (gpu_capacity_ < count) {
       OP_REQUIRES_OK(
@@ -76,7 +138,7 @@ class HostDataCache {
       gpu_capacity_ = count;
       need_copy = true;
     }
-    if (!IsSame(host_data, count)) {
+    if (!is_same) {
       last_host_data_ = std::move(std::vector<T>(host_data, host_data + count));
       need_copy = true;
     }
@@ -90,6 +152,7 @@ class HostDataCache {
     *out_ptr = gpu_data_ptr;
   }
 #endif
+  HostDataKey last_key_;
   std::vector<T> last_host_data_;
   Tensor gpu_tensor_;
   size_t gpu_capacity_;
@@ -201,16 +201,11 @@ class InstanceNormOp : public OpKernel {
       args.insert({DNNL_ARG_SCALE, scale_mem});
       args.insert({DNNL_ARG_SHIFT, shift_mem});
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          bn_fwd_pd.scratchpad_desc().get_size() / sizeof(U);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<U>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(bn_fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<U>(&scratchpad_tensor));
+                     scratchpad.Init(context, bn_fwd_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
       // Perform batchnorm computation for each batch in input
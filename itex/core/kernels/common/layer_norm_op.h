@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "itex/core/devices/xpu_device_util.h"
 #include "itex/core/utils/errors.h"
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
@@ -30,6 +31,10 @@ limitations under the License.
 
 namespace itex {
 
+using LayerNormFwdPrimitiveCache =
+    OneDnnPrimitiveCache<dnnl::layer_normalization_forward::primitive_desc,
+                         dnnl::layer_normalization_forward>;
+
 template <typename Device, typename T, typename U, bool is_inteltf_ln = false>
 class LayerNormOp : public OpKernel {
  public:
@@ -128,18 +133,30 @@ class LayerNormOp : public OpKernel {
       auto flags = dnnl::normalization_flags::use_scale |
                    dnnl::normalization_flags::use_shift;
 
-      dnnl::primitive_attr attr;
-      attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("layer_norm_fwd");
+      key_creator.AddAsKey(onednn_engine);
+      key_creator.AddAsKey(src_md);
+      key_creator.AddAsKey(propagation);
+      key_creator.AddAsKey(flags);
+      key_creator.AddAsKey(epsilon_);
+      auto create_pd = [&]() {
+        dnnl::primitive_attr attr;
+        attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
 #ifdef ITEX_ONEDNN_3_0
-      dnnl::layer_normalization_forward::primitive_desc ln_fwd_pd(
-          onednn_engine, propagation, src_md, src_md, epsilon_, flags, attr);
+        return dnnl::layer_normalization_forward::primitive_desc(
+            onednn_engine, propagation, src_md, src_md, epsilon_, flags, attr);
 #else
-      dnnl::layer_normalization_forward::desc ln_fwd_desc(propagation, src_md,
-                                                          epsilon_, flags);
-      dnnl::layer_normalization_forward::primitive_desc ln_fwd_pd(
-          ln_fwd_desc, attr, onednn_engine);
+        dnnl::layer_normalization_forward::desc ln_fwd_desc(propagation, src_md,
+                                                            epsilon_, flags);
+        return dnnl::layer_normalization_forward::primitive_desc(
+            ln_fwd_desc, attr, onednn_engine);
 #endif
-      dnnl::layer_normalization_forward ln_fwd_primitive(ln_fwd_pd);
+      };
+      auto cached = LayerNormFwdPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const auto& ln_fwd_pd = cached.pd;
+      const auto& ln_fwd_primitive = cached.primitive;
 
       // Allocate output dst tensor.
       OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
@@ -226,16 +243,11 @@ class LayerNormOp : public OpKernel {
         args.insert({DNNL_ARG_MEAN, mean_memory});
         args.insert({DNNL_ARG_VARIANCE, var_memory});
       }
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          ln_fwd_pd.scratchpad_desc().get_size() / sizeof(U);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<U>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(ln_fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<U>(&scratchpad_tensor));
+                     scratchpad.Init(context, ln_fwd_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
       ln_fwd_primitive.execute(onednn_stream, args);
@@ -456,16 +468,11 @@ class LayerNormGradOp : public OpKernel {
           {DNNL_ARG_DIFF_SCALE, diff_scale_mem},
           {DNNL_ARG_DIFF_SHIFT, diff_shift_mem}};
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          ln_bwd_pd.scratchpad_desc().get_size() / sizeof(U);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<U>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(ln_bwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<U>(&scratchpad_tensor));
+                     scratchpad.Init(context, ln_bwd_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
       ln_bwd_primitive.execute(onednn_stream, args);
     } catch (dnnl::error& e) {
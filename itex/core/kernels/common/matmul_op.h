@@ -28,6 +28,7 @@ limitations under the License.
 #include "itex/core/utils/bcast.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/onednn/onednn_post_op_util.h"
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
@@ -103,6 +104,9 @@ class MatMulBCast {
   std::vector<int64> y_batch_indices_;
 };
 
+using MatMulPrimitiveCache =
+    OneDnnPrimitiveCache<dnnl::matmul::primitive_desc, dnnl::matmul>;
+
 struct OneDnnMatMulParams {
   memory::dims a_dims;
   memory::dims b_dims;
@@ -248,122 +252,97 @@ class MatMulOp : public OpKernel {
         ReadBoolFromEnvVar("ITEX_CACHE_ONEDNN_OBJECT", false, &enable_cache_));
   }
 
-  void InitOrSetMemory(OpKernelContext* context) {
-    if (!(enable_cache_ && is_init_ && context->is_input_same(0, input_dims_) &&
-          context->is_input_same(1, weights_dims_))) {
-      Init(context);
-      return;
-    }
-
-    if (is_input_zero_) {
-      functor::SetZeroFunctor<Device, Tout> f;
-      OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape_,
-                                                       &dst_tensor_));
-      f(context->eigen_device<Device>(), dst_tensor_->flat<Tout>());
-      return;
-    }
-
-    src_mem_.set_data_handle(context->tensor_data(kSrcIndex_));
-    if (is_weight_reorder_) {
-      if (!is_filter_const_) {
-        weights_mem_input_.set_data_handle(context->tensor_data(kWeightIndex_));
-        weights_mem_.set_data_handle(GetTensorBuffer<T>(&tmp_weight_));
-        ReorderMemory(*context, &weights_mem_input_, &weights_mem_,
-                      dnnl_engine_);
-      }
-    } else {
-      weights_mem_.set_data_handle(context->tensor_data(kWeightIndex_));
-    }
-
-    if (post_op_util_.HasBias()) {
-      bias_mem_.set_data_handle(context->tensor_data(kBiasIndex_));
+  void Compute(OpKernelContext* context) override {
+    // oneDNN stream and memory objects are not thread safe, so they are
+    // created in every Compute. Only the immutable `FwdContext` is shared
+    // between concurrent calls.
+    dnnl::engine dnnl_engine = CreateDnnlEngine<Device>(*context);
+    std::shared_ptr<const FwdContext> fwd_context;
+    if (enable_cache_) fwd_context = std::atomic_load(&fwd_context_);
+    if (fwd_context == nullptr ||
+        !context->is_input_same(kSrcIndex_, fwd_context->input_dims) ||
+        !context->is_input_same(kWeightIndex_, fwd_context->weights_dims)) {
+      OP_REQUIRES_OK(context,
+                     CreateFwdContext(context, dnnl_engine, &fwd_context));
+      if (enable_cache_) std::atomic_store(&fwd_context_, fwd_context);
     }
 
-    OP_REQUIRES_OK(context,
-                   context->allocate_temp(DataTypeToEnum<T>::v(),
-                                          TensorShape({scratchpad_size_}),
-                                          scratchpad_tensor_.get()));
-    scratchpad_mem_.set_data_handle(
-        GetTensorBuffer<T>(scratchpad_tensor_.get()));
-
-    if (post_op_util_.HasAdd()) {
-      int is_forward_success = kUnsuccess_;
-      add_tensor_ = &context->input(kAddIndex_);
-      // Try to do in-place.
-      // TODO(itex): Remove this workaround when inplace works.
-      if (inplace_sum_) {
-        context->set_output(kDstIndex_, *add_tensor_);
-        dst_tensor_ = context->mutable_output(kDstIndex_);
-        is_forward_success = kAddIndex_;
-      } else {
-        OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
-                                    {kAddIndex_}, kDstIndex_, dst_shape_,
-                                    &dst_tensor_, &is_forward_success));
-      }
-      // Reorder is needed, forward is failed but dst has been allocated;
-      if (is_forward_success == kUnsuccess_) {
-        // In-place do not success, need reorder.
-        fuse_add_src_mem_.set_data_handle(GetTensorBuffer<Tpost>(add_tensor_));
-        fuse_add_dst_mem_.set_data_handle(GetTensorBuffer<Tout>(dst_tensor_));
-        ReorderMemory(*context, &fuse_add_src_mem_, &fuse_add_dst_mem_,
-                      dnnl_engine_);
-      }
-
-    } else {
-      OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape_,
-                                                       &dst_tensor_));
+    try {
+      Execute(context, dnnl_engine, *fwd_context);
+    } catch (dnnl::error& e) {
+      string error_msg = "Status: " + std::to_string(e.status) +
+                         ", message: " + string(e.message) + ", in file " +
+                         string(__FILE__) + ":" + std::to_string(__LINE__);
+      OP_REQUIRES_OK(
+          context,
+          errors::Aborted("Operation received an exception:", error_msg));
     }
-    dst_mem_.set_data_handle(GetTensorBuffer<Tout>(dst_tensor_));
   }
 
-  void Init(OpKernelContext* context) {
-    const Tensor& src_tensor = context->input(0);
-    const Tensor& weights_tensor = context->input(1);
-    fwd_primitive_args_.clear();
+ protected:
+  // Everything that only depends on the input shapes. It is not modified
+  // after creation, so concurrent Compute calls can share it.
+  struct FwdContext {
+    std::vector<int64> input_dims, weights_dims;
+    TensorShape dst_shape;
+    bool is_input_zero = false;
+    bool is_weight_reorder = false;
+    memory::desc src_md, weights_md, weights_md_prefer, dst_md, bias_md,
+        add_md, scratchpad_md;
+    dnnl::matmul primitive;
+#ifdef ITEX_ONEDNN_3_0
+    float* output_scale_ptr = nullptr;
+#endif
+  };
+
+  Status CreateFwdContext(OpKernelContext* context,
+                          const dnnl::engine& dnnl_engine,
+                          std::shared_ptr<const FwdContext>* fwd_context) {
+    const Tensor& src_tensor = context->input(kSrcIndex_);
+    const Tensor& weights_tensor = context->input(kWeightIndex_);
+    auto fwd = std::make_shared<FwdContext>();
     auto input_shape = src_tensor.shape();
-    input_dims_.clear();
     for (int i = 0; i < input_shape.dims(); ++i) {
-      input_dims_.push_back(input_shape.dim_size(i));
+      fwd->input_dims.push_back(input_shape.dim_size(i));
     }
     auto weights_tensor_shape = weights_tensor.shape();
-    weights_dims_.clear();
     for (int i = 0; i < weights_tensor_shape.dims(); ++i) {
-      weights_dims_.push_back(weights_tensor_shape.dim_size(i));
+      fwd->weights_dims.push_back(weights_tensor_shape.dim_size(i));
     }
 
-    OP_REQUIRES(context, src_tensor.dims() >= 2,
-                errors::InvalidArgument("In[0] ndims must be >= 2: ",
-                                        src_tensor.dims()));
+    if (src_tensor.dims() < 2) {
+      return errors::InvalidArgument("In[0] ndims must be >= 2: ",
+                                     src_tensor.dims());
+    }
 
     if (!allow_bcast) {
       // Using V1, so check to make sure lhs and rhs dimensions are correct and
       // no broadcasting is needed.
-      OP_REQUIRES(
-          context, src_tensor.dims() == weights_tensor.dims(),
-          errors::InvalidArgument("lhs and rhs has different ndims: ",
-                                  src_tensor.shape().DebugString(), " vs. ",
-                                  weights_tensor.shape().DebugString()));
+      if (src_tensor.dims() != weights_tensor.dims()) {
+        return errors::InvalidArgument("lhs and rhs has different ndims: ",
+                                       src_tensor.shape().DebugString(),
+                                       " vs. ",
+                                       weights_tensor.shape().DebugString());
+      }
       const int ndims = src_tensor.dims();
-      OP_REQUIRES(
-          context, ndims >= 2,
-          errors::InvalidArgument("lhs and rhs ndims must be >= 2: ", ndims));
       for (int i = 0; i < ndims - 2; ++i) {
-        OP_REQUIRES(
-            context, src_tensor.dim_size(i) == weights_tensor.dim_size(i),
-            errors::InvalidArgument(
-                "lhs.dim(", i, ") and rhs.dim(", i,
-                ") must be the same: ", src_tensor.shape().DebugString(),
-                " vs ", weights_tensor.shape().DebugString()));
+        if (src_tensor.dim_size(i) != weights_tensor.dim_size(i)) {
+          return errors::InvalidArgument(
+              "lhs.dim(", i, ") and rhs.dim(", i,
+              ") must be the same: ", src_tensor.shape().DebugString(), " vs ",
+              weights_tensor.shape().DebugString());
+        }
       }
     }
 
     MatMulBCast bcast(src_tensor.shape().dim_sizes(),
                       weights_tensor.shape().dim_sizes());
-    OP_REQUIRES(context, bcast.IsValid(),
-                errors::InvalidArgument(
-                    "In[0] and In[1] must have compatible batch dimensions: ",
-                    src_tensor.shape().DebugString(), " vs. ",
-                    weights_tensor.shape().DebugString()));
+    if (!bcast.IsValid()) {
+      return errors::InvalidArgument(
+          "In[0] and In[1] must have compatible batch dimensions: ",
+          src_tensor.shape().DebugString(), " vs. ",
+          weights_tensor.shape().DebugString());
+    }
 
     // dst(bs, m,n) = \sigma{src(bs, m,k) * weights(bs, k, n)} + bias(bs, m,n)
     // Get the actual m & n to set dst_shape, and MatMulBCast will calculate the
@@ -378,248 +357,241 @@ class MatMulOp : public OpKernel {
                                   : weights_tensor.dim_size(kWeightsDims - 2);
     const auto n = adj_y_ ? weights_tensor.dim_size(kWeightsDims - 2)
                           : weights_tensor.dim_size(kWeightsDims - 1);
-    OP_REQUIRES(context, k == k_weights,
-                errors::InvalidArgument(
-                    "Matrix size-incompatible: In[0]: ",
-                    src_tensor.shape().DebugString(),
-                    ", In[1]: ", weights_tensor.shape().DebugString()));
+    if (k != k_weights) {
+      return errors::InvalidArgument(
+          "Matrix size-incompatible: In[0]: ", src_tensor.shape().DebugString(),
+          ", In[1]: ", weights_tensor.shape().DebugString());
+    }
 
-    dst_shape_ = bcast.output_batch_shape();
-    dst_shape_.AddDim(m);
-    dst_shape_.AddDim(n);
+    fwd->dst_shape = bcast.output_batch_shape();
+    fwd->dst_shape.AddDim(m);
+    fwd->dst_shape.AddDim(n);
     // The maximum number of dimensions for a tensor in DNNL is 6 on GPU.
-    OP_REQUIRES(
-        context, dst_shape_.dims() <= 6,
-        errors::InvalidArgument(
-            "Rank of output tensor must be <= 6, but is ", dst_shape_.dims(),
-            ". Current implementation supports up to rank 6 tensors."));
-
-    if (dst_shape_.num_elements() == 0) {
-      is_input_zero_ = true;
-      functor::SetZeroFunctor<Device, Tout> f;
-      OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape_,
-                                                       &dst_tensor_));
-      f(context->eigen_device<Device>(), dst_tensor_->flat<Tout>());
-      is_init_ = true;
-      return;
+    if (fwd->dst_shape.dims() > 6) {
+      return errors::InvalidArgument(
+          "Rank of output tensor must be <= 6, but is ", fwd->dst_shape.dims(),
+          ". Current implementation supports up to rank 6 tensors.");
     }
 
     // Direct return if either input has 0 elements, but take care of fused ops
     // because they will change default value.
-    if (!post_op_util_.HasBias() && !post_op_util_.HasAdd() &&
-        (src_tensor.NumElements() == 0 || weights_tensor.NumElements() == 0)) {
-      is_input_zero_ = true;
-      functor::SetZeroFunctor<Device, Tout> f;
-      OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape_,
-                                                       &dst_tensor_));
-      f(context->eigen_device<Device>(), dst_tensor_->flat<Tout>());
-      is_init_ = true;
-      return;
+    const bool has_empty_input =
+        src_tensor.NumElements() == 0 || weights_tensor.NumElements() == 0;
+    if (fwd->dst_shape.num_elements() == 0 ||
+        (!post_op_util_.HasBias() && !post_op_util_.HasAdd() &&
+         has_empty_input)) {
+      fwd->is_input_zero = true;
+      *fwd_context = std::move(fwd);
+      return Status::OK();
     }
 
     try {
       // Compute parameters for DNNL matmul primitive.
       auto params = MatMulBaseUtil::CreateMatMulParams(
-          src_tensor.shape(), weights_tensor.shape(), dst_shape_, adj_x_,
+          src_tensor.shape(), weights_tensor.shape(), fwd->dst_shape, adj_x_,
           adj_y_);
-      auto src_md =
+      fwd->src_md =
           memory::desc(params->a_dims, OneDnnType<T>(), params->a_strides);
-      auto weights_md =
+      fwd->weights_md =
           memory::desc(params->b_dims, OneDnnType<T>(), params->b_strides);
       // Let oneDNN choose weight format if Weight is const and can be cached
       auto weights_md_prefer =
           is_filter_const_ ? memory::desc(params->b_dims, OneDnnType<T>(),
                                           memory::format_tag::any)
-                           : weights_md;
-      auto dst_md =
+                           : fwd->weights_md;
+      fwd->dst_md =
           memory::desc(params->c_dims, OneDnnType<Tout>(), params->c_strides);
-      dnnl::matmul::primitive_desc matmul_pd;
-      dnnl::primitive_attr post_ops_attr;
-
-      post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
-      if (std::is_same<T, float>::value) {
-        post_ops_attr.set_fpmath_mode(fp32_math_mode_);
-      }
-      // Set post ops attr after handling all fusions.
-      post_op_util_.SetPostOpAttr(&post_ops_attr);
+      // bias use same dims as dst
+      fwd->bias_md = memory::desc(params->bias_dims, OneDnnType<Tpost>(),
+                                  params->bias_strides);
+      fwd->add_md =
+          memory::desc(params->c_dims, OneDnnType<Tpost>(), params->c_strides);
+
+      // Reuse the primitive if any MatMul kernel has created it before.
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("matmul");
+      key_creator.AddAsKey(dnnl_engine);
+      key_creator.AddAsKey(fwd->src_md);
+      key_creator.AddAsKey(weights_md_prefer);
+      key_creator.AddAsKey(fwd->dst_md);
+      key_creator.AddAsKey(fp32_math_mode_);
+      post_op_util_.AddAsKey(&key_creator);
+      if (post_op_util_.HasBias()) key_creator.AddAsKey(fwd->bias_md);
+
+      auto create_pd = [&]() {
+        dnnl::primitive_attr post_ops_attr;
+        post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+        if (std::is_same<T, float>::value) {
+          post_ops_attr.set_fpmath_mode(fp32_math_mode_);
+        }
+        // Set post ops attr after handling all fusions.
+        post_op_util_.SetPostOpAttr(&post_ops_attr);
 
-      if (post_op_util_.HasBias()) {
-        // bias use same dims as dst
-        auto bias_md = memory::desc(params->bias_dims, OneDnnType<Tpost>(),
-                                    params->bias_strides);
-        // create bias memory
-        const Tensor& bias_tensor = context->input(kBiasIndex_);
-        bias_mem_ = CreateDnnlMemory(bias_md, dnnl_engine_,
-                                     GetTensorBuffer<Tpost>(&bias_tensor));
+        if (post_op_util_.HasBias()) {
 #ifndef ITEX_ONEDNN_3_0
-        auto matmul_desc =
-            dnnl::matmul::desc(src_md, weights_md_prefer, bias_md, dst_md);
-        matmul_pd = dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
-                                                 dnnl_engine_);
+          auto matmul_desc = dnnl::matmul::desc(
+              fwd->src_md, weights_md_prefer, fwd->bias_md, fwd->dst_md);
+          return dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
+                                              dnnl_engine);
 #else
-        matmul_pd = dnnl::matmul::primitive_desc(dnnl_engine_, src_md,
-                                                 weights_md_prefer, bias_md,
-                                                 dst_md, post_ops_attr);
+          return dnnl::matmul::primitive_desc(dnnl_engine, fwd->src_md,
+                                              weights_md_prefer, fwd->bias_md,
+                                              fwd->dst_md, post_ops_attr);
 #endif
-      } else {
+        }
 #ifndef ITEX_ONEDNN_3_0
         auto matmul_desc =
-            dnnl::matmul::desc(src_md, weights_md_prefer, dst_md);
-        matmul_pd = dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
-                                                 dnnl_engine_);
+            dnnl::matmul::desc(fwd->src_md, weights_md_prefer, fwd->dst_md);
+        return dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
+                                            dnnl_engine);
 #else
-        matmul_pd = dnnl::matmul::primitive_desc(
-            dnnl_engine_, src_md, weights_md_prefer, dst_md, post_ops_attr);
+        return dnnl::matmul::primitive_desc(dnnl_engine, fwd->src_md,
+                                            weights_md_prefer, fwd->dst_md,
+                                            post_ops_attr);
 #endif
-      }
-
-      // Handle Add fusion and decide output tensor buffer.
-      if (post_op_util_.HasAdd()) {
-        // const Tensor& add_tensor = context->input(kAddIndex_);
-        int is_forward_success = kUnsuccess_;
-        add_tensor_ = &context->input(kAddIndex_);
-
-        // Try to do in-place.
-        // TODO(itex): Remove this workaround when inplace works.
-        if (inplace_sum_) {
-          context->set_output(kDstIndex_, *add_tensor_);
-          dst_tensor_ = context->mutable_output(kDstIndex_);
-          is_forward_success = kAddIndex_;
-        } else {
-          OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
-                                      {kAddIndex_}, kDstIndex_, dst_shape_,
-                                      &dst_tensor_, &is_forward_success));
-        }
-        // Reorder is needed, forward is failed but dst has been allocated;
-        if (is_forward_success == kUnsuccess_) {
-          // In-place do not success, need reorder.
-          fuse_add_src_mem_ = CreateDnnlMemory(
-              memory::desc(params->c_dims, OneDnnType<Tpost>(),
-                           params->c_strides),
-              dnnl_engine_, GetTensorBuffer<Tpost>(add_tensor_));
-          fuse_add_dst_mem_ = CreateDnnlMemory(
-              dst_md, dnnl_engine_, GetTensorBuffer<Tout>(dst_tensor_));
-          ReorderMemory(*context, &fuse_add_src_mem_, &fuse_add_dst_mem_,
-                        dnnl_engine_);
-        }
-      } else {
-        OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape_,
-                                                         &dst_tensor_));
-      }
+      };
+      auto cached = MatMulPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const dnnl::matmul::primitive_desc& matmul_pd = cached.pd;
+      fwd->primitive = cached.primitive;
 
 #ifdef ITEX_ONEDNN_3_0
       if (post_op_util_.HasOutputScales()) {
-        float* output_scale_ptr = output_scale_cache_.GetCachedPtr(
+        mutex_lock lock(&mu_output_scale_);
+        fwd->output_scale_ptr = output_scale_cache_.GetCachedPtr(
             context, post_op_util_.GetOutputScale().data(), 1);
-        dnnl::memory scale_mem(
-            {{1}, dnnl::memory::data_type::f32, dnnl::memory::format_tag::x},
-            dnnl_engine_, reinterpret_cast<void*>(output_scale_ptr));
-        fwd_primitive_args_.emplace(DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS,
-                                    scale_mem);
       }
 #endif
 
       // Do weight cache only if Reorder is needed and weight is const.
-      weights_mem_input_ = CreateDnnlMemory(
-          weights_md, dnnl_engine_, GetTensorBuffer<T>(&weights_tensor));
-      weights_md_prefer = matmul_pd.weights_desc();
-      is_weight_reorder_ = (weights_md != weights_md_prefer);
-      if (is_weight_reorder_) {
-        T* weight_cached_data = nullptr;
+      fwd->weights_md_prefer = matmul_pd.weights_desc();
+      fwd->is_weight_reorder = (fwd->weights_md != fwd->weights_md_prefer);
+      fwd->scratchpad_md = matmul_pd.scratchpad_desc();
+    } catch (dnnl::error& e) {
+      string error_msg = "Status: " + std::to_string(e.status) +
+                         ", message: " + string(e.message) + ", in file " +
+                         string(__FILE__) + ":" + std::to_string(__LINE__);
+      return errors::Aborted("Operation received an exception:", error_msg);
+    }
+    *fwd_context = std::move(fwd);
+    return Status::OK();
+  }
 
-        // Check weight cache
-        if (is_filter_const_) {
-          if (weight_cache_manager_.IsEmpty()) {
-            // Cache weight in first time executing this node.
-            weight_cache_manager_.SetCache(
-                context, weights_md, weights_md_prefer,
-                GetTensorBuffer<T>(&weights_tensor), dnnl_engine_);
-          }
-          weight_cached_data =
-              this->weight_cache_manager_.GetCache(context, weights_md_prefer);
-        }
+  // Binds the tensors of this call to `fwd` and runs the primitive. All
+  // memory objects and temporary buffers are local to the call.
+  void Execute(OpKernelContext* context, const dnnl::engine& dnnl_engine,
+               const FwdContext& fwd) {
+    Tensor* dst_tensor = nullptr;
+    if (fwd.is_input_zero) {
+      functor::SetZeroFunctor<Device, Tout> f;
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  kDstIndex_, fwd.dst_shape, &dst_tensor));
+      f(context->eigen_device<Device>(), dst_tensor->flat<Tout>());
+      return;
+    }
 
-        if (weight_cached_data != nullptr) {
-          weights_mem_ = CreateDnnlMemory(weights_md_prefer, dnnl_engine_,
-                                          weight_cached_data);
-        } else {
-          // Reorder if cache is failed since pd has already used any format.
-          int64_t reorder_size = weights_md_prefer.get_size() / sizeof(T);
-          OP_REQUIRES_OK(context,
-                         context->allocate_temp(DataTypeToEnum<T>::v(),
-                                                TensorShape({reorder_size}),
-                                                &tmp_weight_));
-          void* data_handle = GetTensorBuffer<T>(&tmp_weight_);
-          weights_mem_ =
-              CreateDnnlMemory(weights_md_prefer, dnnl_engine_, data_handle);
-          ReorderMemory(*context, &weights_mem_input_, &weights_mem_,
-                        dnnl_engine_);
+    const Tensor& weights_tensor = context->input(kWeightIndex_);
+    memory weights_mem_input = CreateDnnlMemory(
+        fwd.weights_md, dnnl_engine, GetTensorBuffer<T>(&weights_tensor));
+    memory weights_mem = weights_mem_input;
+    Tensor tmp_weight;
+    if (fwd.is_weight_reorder) {
+      T* weight_cached_data = nullptr;
+
+      // Check weight cache
+      if (is_filter_const_) {
+        if (weight_cache_manager_.IsEmpty()) {
+          // Cache weight in first time executing this node.
+          weight_cache_manager_.SetCache(
+              context, fwd.weights_md, fwd.weights_md_prefer,
+              GetTensorBuffer<T>(&weights_tensor), dnnl_engine);
         }
-      } else {
-        weights_mem_ = weights_mem_input_;
+        weight_cached_data =
+            weight_cache_manager_.GetCache(context, fwd.weights_md_prefer);
       }
-      scratchpad_size_ = matmul_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(matmul_pd.scratchpad_desc(), dnnl_engine_,
-                       GetTensorBuffer<T>(scratchpad_tensor_.get()));
-
-      matmul_primitive_ = dnnl::matmul(matmul_pd);
-      src_mem_ = CreateDnnlMemory(src_md, dnnl_engine_,
-                                  GetTensorBuffer<T>(&src_tensor));
-      dst_mem_ = CreateDnnlMemory(dst_md, dnnl_engine_,
-                                  GetTensorBuffer<Tout>(dst_tensor_));
-      fwd_primitive_args_.emplace(DNNL_ARG_SRC, src_mem_);
-      fwd_primitive_args_.emplace(DNNL_ARG_WEIGHTS, weights_mem_);
-      fwd_primitive_args_.emplace(DNNL_ARG_DST, dst_mem_);
-      fwd_primitive_args_.emplace(DNNL_ARG_SCRATCHPAD, scratchpad_mem_);
 
-      if (post_op_util_.HasBias()) {
-        fwd_primitive_args_.emplace(DNNL_ARG_BIAS, bias_mem_);
+      if (weight_cached_data != nullptr) {
+        weights_mem = CreateDnnlMemory(fwd.weights_md_prefer, dnnl_engine,
+                                       weight_cached_data);
+      } else {
+        // Reorder if cache is failed since pd has already used any format.
+        int64_t reorder_size = fwd.weights_md_prefer.get_size() / sizeof(T);
+        OP_REQUIRES_OK(context, context->allocate_temp(
+                                    DataTypeToEnum<T>::v(),
+                                    TensorShape({reorder_size}), &tmp_weight));
+        weights_mem = CreateDnnlMemory(fwd.weights_md_prefer, dnnl_engine,
+                                       GetTensorBuffer<T>(&tmp_weight));
+        ReorderMemory(*context, &weights_mem_input, &weights_mem, dnnl_engine);
       }
-      is_init_ = true;
-    } catch (dnnl::error& e) {
-      string error_msg = "Status: " + std::to_string(e.status) +
-                         ", message: " + string(e.message) + ", in file " +
-                         string(__FILE__) + ":" + std::to_string(__LINE__);
-      OP_REQUIRES_OK(
-          context,
-          errors::Aborted("Operation received an exception:", error_msg));
     }
-  }
 
-  void Compute(OpKernelContext* context) override {
-    mutex_lock lock(&mu_compute_);
-    dst_tensor_ = nullptr;
-    dnnl_engine_ = CreateDnnlEngine<Device>(*context);
-    // onednn_stream has thread safety issue, need create a new one in
-    // every compute.
-    dnnl_stream_ = CreateDnnlStream(*context, dnnl_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
-    InitOrSetMemory(context);
+    // Handle Add fusion and decide output tensor buffer.
+    if (post_op_util_.HasAdd()) {
+      int is_forward_success = kUnsuccess_;
+      const Tensor* add_tensor = &context->input(kAddIndex_);
 
-    // Skip primitive execution if the calculation is meaningless.
-    if (is_input_zero_) {
-      scratchpad_tensor_.reset();
-      return;
+      // Try to do in-place.
+      // TODO(itex): Remove this workaround when inplace works.
+      if (inplace_sum_) {
+        context->set_output(kDstIndex_, *add_tensor);
+        dst_tensor = context->mutable_output(kDstIndex_);
+        is_forward_success = kAddIndex_;
+      } else {
+        OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                    {kAddIndex_}, kDstIndex_, fwd.dst_shape,
+                                    &dst_tensor, &is_forward_success));
+      }
+      // Reorder is needed, forward is failed but dst has been allocated;
+      if (is_forward_success == kUnsuccess_) {
+        // In-place do not success, need reorder.
+        memory fuse_add_src_mem = CreateDnnlMemory(
+            fwd.add_md, dnnl_engine, GetTensorBuffer<Tpost>(add_tensor));
+        memory fuse_add_dst_mem = CreateDnnlMemory(
+            fwd.dst_md, dnnl_engine, GetTensorBuffer<Tout>(dst_tensor));
+        ReorderMemory(*context, &fuse_add_src_mem, &fuse_add_dst_mem,
+                      dnnl_engine);
+      }
+    } else {
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  kDstIndex_, fwd.dst_shape, &dst_tensor));
     }
 
-    matmul_primitive_.execute(dnnl_stream_, fwd_primitive_args_);
-    scratchpad_tensor_.reset();
+    OneDnnScratchpad scratchpad;
+    OP_REQUIRES_OK(context,
+                   scratchpad.Init(context, fwd.scratchpad_md, dnnl_engine));
+
+    std::unordered_map<int, memory> fwd_primitive_args = {
+        {DNNL_ARG_SRC,
+         CreateDnnlMemory(fwd.src_md, dnnl_engine,
+                          context->tensor_data(kSrcIndex_))},
+        {DNNL_ARG_WEIGHTS, weights_mem},
+        {DNNL_ARG_DST, CreateDnnlMemory(fwd.dst_md, dnnl_engine,
+                                        GetTensorBuffer<Tout>(dst_tensor))},
+        {DNNL_ARG_SCRATCHPAD, scratchpad.memory()}};
+    if (post_op_util_.HasBias()) {
+      fwd_primitive_args.emplace(
+          DNNL_ARG_BIAS, CreateDnnlMemory(fwd.bias_md, dnnl_engine,
+                                          context->tensor_data(kBiasIndex_)));
+    }
+#ifdef ITEX_ONEDNN_3_0
+    if (post_op_util_.HasOutputScales()) {
+      dnnl::memory scale_mem(
+          {{1}, dnnl::memory::data_type::f32, dnnl::memory::format_tag::x},
+          dnnl_engine, reinterpret_cast<void*>(fwd.output_scale_ptr));
+      fwd_primitive_args.emplace(DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS,
+                                 scale_mem);
+    }
+#endif
+
+    dnnl::stream dnnl_stream = CreateDnnlStream(*context, dnnl_engine);
+    ExecutePrimitive(fwd.primitive, dnnl_stream, fwd_primitive_args);
   }
 
- protected:
   bool adj_x_ = false;
   bool adj_y_ = false;
   bool inplace_sum_ = false;
   bool is_filter_const_ = false;
-  bool is_weight_reorder_ = false;
   bool enable_cache_ = false;
-  bool is_init_ = false;
-  bool is_input_zero_ = false;
   static const int kSrcIndex_ = 0, kDstIndex_ = 0, kWeightIndex_ = 1,
                    kBiasIndex_ = 2, kAddIndex_ = 3, kUnsuccess_ = -1;
 
@@ -630,22 +602,12 @@ class MatMulOp : public OpKernel {
   WeightCacheManager<T> weight_cache_manager_;
 
  private:
-  mutex mu_compute_;
-  std::unordered_map<int, memory> fwd_primitive_args_;
-  memory src_mem_, weights_mem_, weights_mem_input_, dst_mem_, bias_mem_,
-      add_mem_, fuse_add_src_mem_, fuse_add_dst_mem_, scratchpad_mem_;
-  dnnl::matmul matmul_primitive_;
-  Tensor* dst_tensor_;
-  const Tensor* add_tensor_;
-  Tensor tmp_weight_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64_t scratchpad_size_ = 0;
-  std::vector<int64> input_dims_, weights_dims_;
-  TensorShape dst_shape_;
+  // Context of the last input shapes, only accessed with std::atomic_load
+  // and std::atomic_store.
+  std::shared_ptr<const FwdContext> fwd_context_;
   dnnl::fpmath_mode fp32_math_mode_ = dnnl::fpmath_mode::strict;
-  dnnl::stream dnnl_stream_;
-  dnnl::engine dnnl_engine_;
 #ifdef ITEX_ONEDNN_3_0
+  mutex mu_output_scale_;
   HostDataCache<Device, float> output_scale_cache_;
 #endif
 };
@@ -712,11 +674,9 @@ class MatMulFunctor {
     }
 
     OP_REQUIRES_OK(context,
-                   context->allocate_temp(DataTypeToEnum<T>::v(),
-                                          TensorShape({scratchpad_size_}),
-                                          scratchpad_tensor_.get()));
-    scratchpad_mem_.set_data_handle(
-        GetTensorBuffer<T>(scratchpad_tensor_.get()));
+                   scratchpad_.Init(context, scratchpad_mem_.get_desc(),
+                                    dnnl_engine_));
+    scratchpad_mem_.set_data_handle(scratchpad_.data());
 
     if (post_op_util_.HasAdd()) {
       // In-place do not success, need reorder.
@@ -828,42 +788,58 @@ class MatMulFunctor {
       auto dst_md =
           memory::desc(params->c_dims, OneDnnType<Tout>(), params->c_strides);
 
-      dnnl::primitive_attr post_ops_attr;
-      post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
-      if (std::is_same<T, float>::value) {
-        post_ops_attr.set_fpmath_mode(fp32_math_mode_);
-      }
-      // Set post ops attr after handling all fusions.
-      post_op_util_.SetPostOpAttr(&post_ops_attr);
-
-      dnnl::matmul::primitive_desc matmul_pd;
+      // bias use same dims as dst
+      auto bias_md = memory::desc(params->bias_dims, OneDnnType<Tpost>(),
+                                  params->bias_strides);
       if (post_op_util_.HasBias()) {
-        // bias use same dims as dst
-        auto bias_md = memory::desc(params->bias_dims, OneDnnType<Tpost>(),
-                                    params->bias_strides);
         bias_mem_ = CreateDnnlMemory(bias_md, dnnl_engine_, bias_tensor_data);
-        // Reassigin desc if it has bias.
+      }
+
+      // Reuse the primitive if any MatMul kernel has created it before.
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("matmul");
+      key_creator.AddAsKey(dnnl_engine_);
+      key_creator.AddAsKey(src_md);
+      key_creator.AddAsKey(weights_md_prefer);
+      key_creator.AddAsKey(dst_md);
+      key_creator.AddAsKey(fp32_math_mode_);
+      post_op_util_.AddAsKey(&key_creator);
+      if (post_op_util_.HasBias()) key_creator.AddAsKey(bias_md);
+
+      auto create_pd = [&]() {
+        dnnl::primitive_attr post_ops_attr;
+        post_ops_attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+        if (std::is_same<T, float>::value) {
+          post_ops_attr.set_fpmath_mode(fp32_math_mode_);
+        }
+        // Set post ops attr after handling all fusions.
+        post_op_util_.SetPostOpAttr(&post_ops_attr);
+
+        if (post_op_util_.HasBias()) {
 #ifdef ITEX_ONEDNN_3_0
-        matmul_pd = dnnl::matmul::primitive_desc(dnnl_engine_, src_md,
-                                                 weights_md_prefer, bias_md,
-                                                 dst_md, post_ops_attr);
+          return dnnl::matmul::primitive_desc(dnnl_engine_, src_md,
+                                              weights_md_prefer, bias_md,
+                                              dst_md, post_ops_attr);
 #else
-        auto matmul_desc =
-            dnnl::matmul::desc(src_md, weights_md_prefer, bias_md, dst_md);
-        matmul_pd = dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
-                                                 dnnl_engine_);
+          auto matmul_desc =
+              dnnl::matmul::desc(src_md, weights_md_prefer, bias_md, dst_md);
+          return dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
+                                              dnnl_engine_);
 #endif
-      } else {
+        }
 #ifndef ITEX_ONEDNN_3_0
         auto matmul_desc =
             dnnl::matmul::desc(src_md, weights_md_prefer, dst_md);
-        matmul_pd = dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
-                                                 dnnl_engine_);
+        return dnnl::matmul::primitive_desc(matmul_desc, post_ops_attr,
+                                            dnnl_engine_);
 #else
-        matmul_pd = dnnl::matmul::primitive_desc(
+        return dnnl::matmul::primitive_desc(
             dnnl_engine_, src_md, weights_md_prefer, dst_md, post_ops_attr);
 #endif
-      }
+      };
+      auto cached = MatMulPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const dnnl::matmul::primitive_desc& matmul_pd = cached.pd;
 
       // Handle Add fusion and decide output tensor buffer.
       if (post_op_util_.HasAdd()) {
@@ -930,16 +906,12 @@ class MatMulFunctor {
       } else {
         weights_mem_ = weights_mem_input_;
       }
-      scratchpad_size_ = matmul_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(matmul_pd.scratchpad_desc(), dnnl_engine_,
-                       GetTensorBuffer<T>(scratchpad_tensor_.get()));
-
-      matmul_primitive_ = dnnl::matmul(matmul_pd);
+      OP_REQUIRES_OK(context, scratchpad_.Init(context,
+                                               matmul_pd.scratchpad_desc(),
+                                               dnnl_engine_));
+      scratchpad_mem_ = scratchpad_.memory();
+
+      matmul_primitive_ = cached.primitive;
       src_mem_ = CreateDnnlMemory(src_md, dnnl_engine_, input_tensor_data);
       dst_mem_ = CreateDnnlMemory(dst_md, dnnl_engine_, output_tensor_data);
       fwd_primitive_args_.emplace(DNNL_ARG_SRC, src_mem_);
@@ -976,7 +948,6 @@ class MatMulFunctor {
     // onednn_stream has thread safety issue, need create a new one in
     // every compute.
     dnnl_stream_ = CreateDnnlStream(*context_, dnnl_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
     InitOrSetMemory(context_, input_tensor_data, input_dims,
                     weights_tensor_data, weights_dims, is_filter_const,
                     output_tensor_data, bias_tensor_data, scale_data,
@@ -984,13 +955,13 @@ class MatMulFunctor {
 
     // Skip primitive execution if the calculation is meaningless.
     if (is_input_zero_) {
-      scratchpad_tensor_.reset();
+      scratchpad_ = OneDnnScratchpad();
       return;
     }
 
     matmul_primitive_.execute(dnnl_stream_, fwd_primitive_args_);
 
-    scratchpad_tensor_.reset();
+    scratchpad_ = OneDnnScratchpad();
   }
 
  protected:
@@ -1016,8 +987,7 @@ class MatMulFunctor {
   dnnl::matmul matmul_primitive_;
 
   Tensor tmp_weight_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64_t scratchpad_size_ = 0;
+  OneDnnScratchpad scratchpad_;
   std::vector<int64> input_dims_, weights_dims_;
   TensorShape dst_shape_;
   dnnl::fpmath_mode fp32_math_mode_ = dnnl::fpmath_mode::strict;
@@ -1066,73 +1036,86 @@ class FusedMatMulGradOp : public OpKernel {
         ReadBoolFromEnvVar("ITEX_CACHE_ONEDNN_OBJECT", false, &enable_cache_));
   }
 
-  void InitOrSetMemory(OpKernelContext* context) {
-    Tensor* diff_weight_tensor = nullptr;
-    Tensor* diff_bias_tensor = nullptr;
-
-    if (enable_cache_ && is_init_ &&
-        context->is_input_same(kSrcIndex_, input_dims_) &&
-        context->is_input_same(kDiffDstIndex_, diff_dst_dims_)) {
-      src_mem_.set_data_handle(context->tensor_data(kSrcIndex_));
-      diff_dst_mem_.set_data_handle(context->tensor_data(kDiffDstIndex_));
-
-      OP_REQUIRES_OK(context, context->allocate_output(kDiffWeightIndex_,
-                                                       diff_weight_tf_shape_,
-                                                       &diff_weight_tensor));
-      OP_REQUIRES_OK(context, context->allocate_output(kDiffBiasIndex_,
-                                                       diff_bias_tf_shape_,
-                                                       &diff_bias_tensor));
-
-      diff_weight_mem_.set_data_handle(GetTensorBuffer<T>(diff_weight_tensor));
-      if (is_reorder_) {
-        diff_weight_mem_prefer_.set_data_handle(
-            GetTensorBuffer<T>(&tmp_reorder_));
-      } else {
-        diff_weight_mem_prefer_.set_data_handle(
-            GetTensorBuffer<T>(diff_weight_tensor));
-      }
-
-      diff_bias_mem_.set_data_handle(GetTensorBuffer<Tgrad>(diff_bias_tensor));
+  void Compute(OpKernelContext* context) override {
+    // oneDNN stream and memory objects are not thread safe, so they are
+    // created in every Compute. Only the immutable `BwdContext` is shared
+    // between concurrent calls.
+    dnnl::engine onednn_engine = CreateDnnlEngine<Device>(*context);
+    std::shared_ptr<const BwdContext> bwd_context;
+    if (enable_cache_) bwd_context = std::atomic_load(&bwd_context_);
+    if (bwd_context == nullptr ||
+        !context->is_input_same(kSrcIndex_, bwd_context->input_dims) ||
+        !context->is_input_same(kDiffDstIndex_, bwd_context->diff_dst_dims)) {
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_.set_data_handle(
-          GetTensorBuffer<T>(scratchpad_tensor_.get()));
-    } else {
-      Init(context);
+                     CreateBwdContext(context, onednn_engine, &bwd_context));
+      if (enable_cache_) std::atomic_store(&bwd_context_, bwd_context);
+    }
+
+    try {
+      Execute(context, onednn_engine, *bwd_context);
+    } catch (dnnl::error& e) {
+      string error_msg = "Status: " + std::to_string(e.status) +
+                         ", message: " + string(e.message) + ", in file " +
+                         string(__FILE__) + ":" + std::to_string(__LINE__);
+      OP_REQUIRES_OK(
+          context,
+          errors::Aborted("Operation received an exception:", error_msg));
     }
   }
 
-  void Init(OpKernelContext* context) {
-    fwd_primitive_args_.clear();
+ protected:
+  static const int kSrcIndex_ = 0, kDiffDstIndex_ = 1, kDiffWeightIndex_ = 0,
+                   kDiffBiasIndex_ = 1;
+  bool enable_cache_ = false;
+
+ private:
+  // Everything that only depends on the input shapes. It is not modified
+  // after creation, so concurrent Compute calls can share it.
+  struct BwdContext {
+    std::vector<int64> input_dims, diff_dst_dims;
+    TensorShape diff_weight_tf_shape, diff_bias_tf_shape;
+    bool is_empty = false;
+    bool is_reorder = false;
+    dnnl::memory::desc src_md, diff_dst_md, diff_weight_md,
+        diff_weight_md_prefer, diff_bias_md, scratchpad_md;
+    dnnl::inner_product_backward_weights primitive;
+  };
+
+  Status CreateBwdContext(OpKernelContext* context,
+                          const dnnl::engine& onednn_engine,
+                          std::shared_ptr<const BwdContext>* bwd_context) {
     const Tensor& src_tensor = context->input(kSrcIndex_);
     const Tensor& diff_dst_tensor = context->input(kDiffDstIndex_);
     auto src_tf_shape = src_tensor.shape();
     auto diff_dst_tf_shape = diff_dst_tensor.shape();
-    input_dims_.clear();
+    auto bwd = std::make_shared<BwdContext>();
     for (int i = 0; i < src_tf_shape.dims(); ++i) {
-      input_dims_.push_back(src_tf_shape.dim_size(i));
+      bwd->input_dims.push_back(src_tf_shape.dim_size(i));
     }
-    diff_dst_dims_.clear();
     for (int i = 0; i < diff_dst_tf_shape.dims(); ++i) {
-      diff_dst_dims_.push_back(diff_dst_tf_shape.dim_size(i));
+      bwd->diff_dst_dims.push_back(diff_dst_tf_shape.dim_size(i));
     }
-    try {
-      const int dim_pair[] = {transpose_a_ ? 0 : 1, transpose_a_ ? 1 : 0};
-      const int batch = src_tf_shape.dim_size(1 - dim_pair[0]);
-      const int k = src_tf_shape.dim_size(dim_pair[0]);
-      const int channel = diff_dst_tf_shape.dim_size(1);
 
-      OP_REQUIRES(
-          context, batch == diff_dst_tf_shape.dim_size(0),
-          errors::InvalidArgument(
-              "Matrix size-incompatible: In[0]: ", src_tf_shape.DebugString(),
-              ", In[1]: ", diff_dst_tf_shape.DebugString()));
+    const int dim_pair[] = {transpose_a_ ? 0 : 1, transpose_a_ ? 1 : 0};
+    const int batch = src_tf_shape.dim_size(1 - dim_pair[0]);
+    const int k = src_tf_shape.dim_size(dim_pair[0]);
+    const int channel = diff_dst_tf_shape.dim_size(1);
 
-      if (batch == 0 || channel == 0) {
-        return;
-      }
+    if (batch != diff_dst_tf_shape.dim_size(0)) {
+      return errors::InvalidArgument(
+          "Matrix size-incompatible: In[0]: ", src_tf_shape.DebugString(),
+          ", In[1]: ", diff_dst_tf_shape.DebugString());
+    }
+
+    bwd->diff_weight_tf_shape = TensorShape({k, channel});
+    bwd->diff_bias_tf_shape = TensorShape({channel});
+    if (batch == 0 || channel == 0) {
+      bwd->is_empty = true;
+      *bwd_context = std::move(bwd);
+      return Status::OK();
+    }
+
+    try {
       // Create primitive.
       dnnl::memory::dims src_dims = dnnl::memory::dims({batch, k});
       dnnl::memory::dims diff_dst_dims = dnnl::memory::dims({batch, channel});
@@ -1154,137 +1137,119 @@ class FusedMatMulGradOp : public OpKernel {
         attr.set_fpmath_mode(fp32_math_mode_);
       }
 
-      auto src_md = dnnl::memory::desc(src_dims, OneDnnType<T>(), src_format);
-      auto diff_dst_md = dnnl::memory::desc(diff_dst_dims, OneDnnType<T>(),
+      bwd->src_md = dnnl::memory::desc(src_dims, OneDnnType<T>(), src_format);
+      bwd->diff_dst_md = dnnl::memory::desc(diff_dst_dims, OneDnnType<T>(),
                                             dnnl::memory::format_tag::nc);
-      auto diff_weight_md = dnnl::memory::desc(
+      bwd->diff_weight_md = dnnl::memory::desc(
           diff_weight_dims, OneDnnType<T>(), diff_weight_format);
       auto diff_weight_md_prefer = dnnl::memory::desc(
           diff_weight_dims, OneDnnType<T>(), diff_weight_format_prefer);
-      auto diff_bias_md = dnnl::memory::desc(
+      bwd->diff_bias_md = dnnl::memory::desc(
           diff_bias_dims, OneDnnType<Tgrad>(), dnnl::memory::format_tag::x);
 #ifdef ITEX_ONEDNN_3_0
       auto fwd_pd = dnnl::inner_product_forward::primitive_desc(
-          onednn_engine_, dnnl::prop_kind::forward, src_md,
-          diff_weight_md_prefer, diff_bias_md, diff_dst_md, attr);
+          onednn_engine, dnnl::prop_kind::forward, bwd->src_md,
+          diff_weight_md_prefer, bwd->diff_bias_md, bwd->diff_dst_md, attr);
       auto matmul_bwd_pd = dnnl::inner_product_backward_weights::primitive_desc(
-          onednn_engine_, src_md, diff_weight_md_prefer, diff_bias_md,
-          diff_dst_md, fwd_pd, attr);
+          onednn_engine, bwd->src_md, diff_weight_md_prefer, bwd->diff_bias_md,
+          bwd->diff_dst_md, fwd_pd, attr);
 #else
       auto fwd_desc = dnnl::inner_product_forward::desc(
-          dnnl::prop_kind::forward, src_md, diff_weight_md_prefer, diff_bias_md,
-          diff_dst_md);
+          dnnl::prop_kind::forward, bwd->src_md, diff_weight_md_prefer,
+          bwd->diff_bias_md, bwd->diff_dst_md);
       auto fwd_pd = dnnl::inner_product_forward::primitive_desc(fwd_desc, attr,
-                                                                onednn_engine_);
+                                                                onednn_engine);
       auto bwd_desc = dnnl::inner_product_backward_weights::desc(
-          src_md, diff_weight_md_prefer, diff_bias_md, diff_dst_md);
+          bwd->src_md, diff_weight_md_prefer, bwd->diff_bias_md,
+          bwd->diff_dst_md);
       auto matmul_bwd_pd = dnnl::inner_product_backward_weights::primitive_desc(
-          bwd_desc, attr, onednn_engine_, fwd_pd);
+          bwd_desc, attr, onednn_engine, fwd_pd);
 #endif
-      matmul_bwd_primitive_ =
-          dnnl::inner_product_backward_weights(matmul_bwd_pd);
-
-      // Allocate output tensors.
-      Tensor* diff_weight_tensor = nullptr;
-      Tensor* diff_bias_tensor = nullptr;
-      diff_weight_tf_shape_ = TensorShape({k, channel});
-      OP_REQUIRES_OK(context, context->allocate_output(kDiffWeightIndex_,
-                                                       diff_weight_tf_shape_,
-                                                       &diff_weight_tensor));
-      diff_bias_tf_shape_ = TensorShape({channel});
-      OP_REQUIRES_OK(context, context->allocate_output(kDiffBiasIndex_,
-                                                       diff_bias_tf_shape_,
-                                                       &diff_bias_tensor));
-
-      // Create memory primitive.
-      src_mem_ = CreateDnnlMemory(src_md, onednn_engine_,
-                                  GetTensorBuffer<T>(&src_tensor));
-      diff_dst_mem_ = CreateDnnlMemory(diff_dst_md, onednn_engine_,
-                                       GetTensorBuffer<T>(&diff_dst_tensor));
-      diff_bias_mem_ =
-          CreateDnnlMemory(diff_bias_md, onednn_engine_,
-                           GetTensorBuffer<Tgrad>(diff_bias_tensor));
-      diff_weight_mem_ =
-          CreateDnnlMemory(diff_weight_md, onednn_engine_,
-                           GetTensorBuffer<T>(diff_weight_tensor));
-      scratchpad_size_ = matmul_bwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(matmul_bwd_pd.scratchpad_desc(), onednn_engine_,
-                       GetTensorBuffer<T>(scratchpad_tensor_.get()));
+      bwd->primitive = dnnl::inner_product_backward_weights(matmul_bwd_pd);
+      bwd->scratchpad_md = matmul_bwd_pd.scratchpad_desc();
 
       // Reorder diff weight for better performance.
-      diff_weight_md_prefer = matmul_bwd_pd.diff_weights_desc();
-      is_reorder_ = (diff_weight_md != diff_weight_md_prefer);
-      if (is_reorder_) {
-        int64_t reorder_size = diff_weight_md_prefer.get_size() / sizeof(T);
-        OP_REQUIRES_OK(
-            context,
-            context->allocate_temp(DataTypeToEnum<T>::v(),
-                                   TensorShape({reorder_size}), &tmp_reorder_));
-        diff_weight_mem_prefer_ =
-            CreateDnnlMemory(diff_weight_md_prefer, onednn_engine_,
-                             GetTensorBuffer<T>(&tmp_reorder_));
-      } else {
-        diff_weight_mem_prefer_ = diff_weight_mem_;
-      }
-
-      // Execute.
-      fwd_primitive_args_ = {{DNNL_ARG_SRC, src_mem_},
-                             {DNNL_ARG_DIFF_DST, diff_dst_mem_},
-                             {DNNL_ARG_DIFF_WEIGHTS, diff_weight_mem_prefer_},
-                             {DNNL_ARG_DIFF_BIAS, diff_bias_mem_},
-                             {DNNL_ARG_SCRATCHPAD, scratchpad_mem_}};
-      is_init_ = true;
+      bwd->diff_weight_md_prefer = matmul_bwd_pd.diff_weights_desc();
+      bwd->is_reorder = (bwd->diff_weight_md != bwd->diff_weight_md_prefer);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
                          string(__FILE__) + ":" + std::to_string(__LINE__);
-      OP_REQUIRES_OK(
-          context,
-          errors::Aborted("Operation received an exception:", error_msg));
+      return errors::Aborted("Operation received an exception:", error_msg);
     }
+    *bwd_context = std::move(bwd);
+    return Status::OK();
   }
 
-  void Compute(OpKernelContext* context) override {
-    mutex_lock lock(&mu_compute_);
-    onednn_engine_ = CreateDnnlEngine<Device>(*context);
-    onednn_stream_ = CreateDnnlStream(*context, onednn_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
-    InitOrSetMemory(context);
-    matmul_bwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
+  // Binds the tensors of this call to `bwd` and runs the primitive. All
+  // memory objects and temporary buffers are local to the call.
+  void Execute(OpKernelContext* context, const dnnl::engine& onednn_engine,
+               const BwdContext& bwd) {
+    // Allocate output tensors.
+    Tensor* diff_weight_tensor = nullptr;
+    Tensor* diff_bias_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(kDiffWeightIndex_,
+                                                     bwd.diff_weight_tf_shape,
+                                                     &diff_weight_tensor));
+    OP_REQUIRES_OK(context, context->allocate_output(kDiffBiasIndex_,
+                                                     bwd.diff_bias_tf_shape,
+                                                     &diff_bias_tensor));
+    if (bwd.is_empty) {
+      functor::SetZeroFunctor<Device, T> zero_weight;
+      zero_weight(context->eigen_device<Device>(),
+                  diff_weight_tensor->flat<T>());
+      functor::SetZeroFunctor<Device, Tgrad> zero_bias;
+      zero_bias(context->eigen_device<Device>(),
+                diff_bias_tensor->flat<Tgrad>());
+      return;
+    }
+
+    // Create memory primitive.
+    dnnl::memory diff_weight_mem =
+        CreateDnnlMemory(bwd.diff_weight_md, onednn_engine,
+                         GetTensorBuffer<T>(diff_weight_tensor));
+    dnnl::memory diff_weight_mem_prefer = diff_weight_mem;
+    Tensor tmp_reorder;
+    if (bwd.is_reorder) {
+      int64_t reorder_size = bwd.diff_weight_md_prefer.get_size() / sizeof(T);
+      OP_REQUIRES_OK(context, context->allocate_temp(
+                                  DataTypeToEnum<T>::v(),
+                                  TensorShape({reorder_size}), &tmp_reorder));
+      diff_weight_mem_prefer =
+          CreateDnnlMemory(bwd.diff_weight_md_prefer, onednn_engine,
+                           GetTensorBuffer<T>(&tmp_reorder));
+    }
+
+    OneDnnScratchpad scratchpad;
+    OP_REQUIRES_OK(context,
+                   scratchpad.Init(context, bwd.scratchpad_md, onednn_engine));
+
+    // Execute.
+    std::unordered_map<int, dnnl::memory> bwd_primitive_args = {
+        {DNNL_ARG_SRC,
+         CreateDnnlMemory(bwd.src_md, onednn_engine,
+                          context->tensor_data(kSrcIndex_))},
+        {DNNL_ARG_DIFF_DST,
+         CreateDnnlMemory(bwd.diff_dst_md, onednn_engine,
+                          context->tensor_data(kDiffDstIndex_))},
+        {DNNL_ARG_DIFF_WEIGHTS, diff_weight_mem_prefer},
+        {DNNL_ARG_DIFF_BIAS,
+         CreateDnnlMemory(bwd.diff_bias_md, onednn_engine,
+                          GetTensorBuffer<Tgrad>(diff_bias_tensor))},
+        {DNNL_ARG_SCRATCHPAD, scratchpad.memory()}};
+    dnnl::stream onednn_stream = CreateDnnlStream(*context, onednn_engine);
+    ExecutePrimitive(bwd.primitive, onednn_stream, bwd_primitive_args);
 
-    scratchpad_tensor_.reset();
     // Reorder diff weight to plain format if it's reordered.
-    if (is_reorder_) {
-      ReorderMemory(*context, &diff_weight_mem_prefer_, &diff_weight_mem_,
-                    onednn_engine_);
+    if (bwd.is_reorder) {
+      ReorderMemory(*context, &diff_weight_mem_prefer, &diff_weight_mem,
+                    onednn_engine);
     }
   }
 
- protected:
-  static const int kSrcIndex_ = 0, kDiffDstIndex_ = 1, kDiffWeightIndex_ = 0,
-                   kDiffBiasIndex_ = 1;
-  bool is_init_ = false;
-  bool enable_cache_ = false;
-
- private:
-  mutex mu_compute_;
-  std::unordered_map<int, memory> fwd_primitive_args_;  // ?
-  dnnl::stream onednn_stream_;
-  dnnl::engine onednn_engine_;
-  dnnl::inner_product_backward_weights matmul_bwd_primitive_;
-  dnnl::memory src_mem_, diff_dst_mem_, diff_bias_mem_, diff_weight_mem_,
-      diff_weight_mem_prefer_, scratchpad_mem_;
-  Tensor tmp_reorder_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64 scratchpad_size_ = 0;
-  TensorShape diff_weight_tf_shape_, diff_bias_tf_shape_;
-  std::vector<int64> input_dims_, diff_dst_dims_;
-  bool is_reorder_;
+  // Context of the last input shapes, only accessed with std::atomic_load
+  // and std::atomic_store.
+  std::shared_ptr<const BwdContext> bwd_context_;
   bool transpose_a_;
   dnnl::fpmath_mode fp32_math_mode_ = dnnl::fpmath_mode::strict;
 };
@@ -116,16 +116,11 @@ class MaxPoolGradOp : public PoolingBackwardOpBase<T> {
       dnnl::pooling_forward::primitive_desc pooling_fwd_pd(pooling_fwd_desc,
                                                            attr, onednn_engine);
 #endif
-      Tensor scratchpad_tensor_fwd;
-      int64 scratchpad_size_fwd =
-          pooling_fwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size_fwd}),
-                                            &scratchpad_tensor_fwd));
-      auto scratchpad_mem_fwd =
-          dnnl::memory(pooling_fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor_fwd));
+      OneDnnScratchpad scratchpad_fwd;
+      OP_REQUIRES_OK(context, scratchpad_fwd.Init(
+                                  context, pooling_fwd_pd.scratchpad_desc(),
+                                  onednn_engine));
+      auto scratchpad_mem_fwd = scratchpad_fwd.memory();
 #ifdef ITEX_ONEDNN_3_0
       dnnl::pooling_backward::primitive_desc pooling_bwd_pd(
           onednn_engine, dnnl::algorithm::pooling_max, src_md, diff_dst_md,
@@ -135,16 +130,11 @@ class MaxPoolGradOp : public PoolingBackwardOpBase<T> {
       dnnl::pooling_backward::primitive_desc pooling_bwd_pd(
           pooling_bwd_desc, attr, onednn_engine, pooling_fwd_pd);
 #endif
-      Tensor scratchpad_tensor_bwd;
-      int64 scratchpad_size_bwd =
-          pooling_bwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size_bwd}),
-                                            &scratchpad_tensor_bwd));
-      auto scratchpad_mem_bwd =
-          dnnl::memory(pooling_bwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor_bwd));
+      OneDnnScratchpad scratchpad_bwd;
+      OP_REQUIRES_OK(context, scratchpad_bwd.Init(
+                                  context, pooling_bwd_pd.scratchpad_desc(),
+                                  onednn_engine));
+      auto scratchpad_mem_bwd = scratchpad_bwd.memory();
 
       dnnl::pooling_backward pooling_bwd_primitive(pooling_bwd_pd);
       Tensor* output_tensor = nullptr;
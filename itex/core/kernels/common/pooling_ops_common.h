@@ -24,6 +24,7 @@ limitations under the License.
 #include "itex/core/utils/bounds_check.h"
 #include "itex/core/utils/common_shape_fns.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
@@ -36,6 +37,10 @@ namespace itex {
 using dnnl::memory;
 using dnnl::prop_kind;
 
+using PoolingFwdPrimitiveCache =
+    OneDnnPrimitiveCache<dnnl::pooling_forward::primitive_desc,
+                         dnnl::pooling_forward>;
+
 struct OneDnnPoolParameters {
   int depth;
 
@@ -602,31 +607,43 @@ class PoolingOp : public PoolingForwardOpBase<T> {
       dnnl::memory::desc dst_md(dst_dims, OneDnnType<T>(),
                                 this->data_format_onednn_);
 
-      dnnl::primitive_attr attr;
-      attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("pooling_fwd");
+      key_creator.AddAsKey(onednn_engine);
+      key_creator.AddAsKey(pooling_prop_kind);
+      key_creator.AddAsKey(algo);
+      key_creator.AddAsKey(src_md);
+      key_creator.AddAsKey(dst_md);
+      key_creator.AddAsKey(strides);
+      key_creator.AddAsKey(filter_dims);
+      key_creator.AddAsKey(dilation_dims);
+      key_creator.AddAsKey(padding_left);
+      key_creator.AddAsKey(padding_right);
+      auto create_pd = [&]() {
+        dnnl::primitive_attr attr;
+        attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
 #ifdef ITEX_ONEDNN_3_0
-      dnnl::pooling_forward::primitive_desc fwd_pd(
-          onednn_engine, pooling_prop_kind, algo, src_md, dst_md, strides,
-          filter_dims, dilation_dims, padding_left, padding_right, attr);
+        return dnnl::pooling_forward::primitive_desc(
+            onednn_engine, pooling_prop_kind, algo, src_md, dst_md, strides,
+            filter_dims, dilation_dims, padding_left, padding_right, attr);
 #else
-      dnnl::pooling_forward::desc fwd_desc(pooling_prop_kind, algo, src_md,
-                                           dst_md, strides, filter_dims,
-                                           padding_left, padding_right);
+        dnnl::pooling_forward::desc fwd_desc(pooling_prop_kind, algo, src_md,
+                                             dst_md, strides, filter_dims,
+                                             padding_left, padding_right);
 
-      dnnl::pooling_forward::primitive_desc fwd_pd(fwd_desc, attr,
-                                                   onednn_engine);
+        return dnnl::pooling_forward::primitive_desc(fwd_desc, attr,
+                                                     onednn_engine);
 #endif
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size = fwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
-
-      dnnl::pooling_forward fwd(fwd_pd);
+      };
+      auto cached = PoolingFwdPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const auto& fwd_pd = cached.pd;
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, fwd_pd.scratchpad_desc(),
+                                              onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
+
+      const auto& fwd = cached.primitive;
 
       const T* src_data = input_tensor.flat<T>().data();
       T* dst_data = output_tensor->flat<T>().data();
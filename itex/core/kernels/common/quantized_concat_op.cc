@@ -199,16 +199,11 @@ class QuantizedConcatOp : public OpKernel {
       concat_pd = dnnl::concat::primitive_desc(dst_md, axis_in_eigen, srcs_pd,
                                                onednn_engine, attr);
 #endif
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          concat_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(concat_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, concat_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       output_tf_shape = OneDnnDimsToTFShape(dst_dims);
 
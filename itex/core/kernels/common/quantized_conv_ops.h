@@ -326,74 +326,82 @@ class LegacyQuantizedConvOpBase
   }
 
  protected:
+  using FwdContext =
+      typename ConvOpBase<Device, Tinput, qint8, Tbias, Toutput, Tsummand,
+                          false, is_depthwise>::FwdContext;
+
   void ExtendInt8PostOps(OpKernelContext* context) override {
     // When the output type is quint8, the output data is requantized
     // into quint8. A post_op "output_scale" is added to do the conversion.
     // Otherwise the output_scale will be 1.f
-    const Tensor& min_filter_vector = context->input(kFilterMinRangeIndex);
-    const Tensor& max_filter_vector = context->input(kFilterMaxRangeIndex);
-    size_t depth = min_filter_vector.NumElements();
-
-    const float* min_filter = min_filter_vector.flat<float>().data();
-    const float* max_filter = max_filter_vector.flat<float>().data();
-
-    std::vector<float> scales(depth, 1.f);
-
-    if (std::is_same<Toutput, quint8>::value ||
-        std::is_same<Toutput, qint8>::value ||
-        std::is_same<Toutput, float>::value ||
-        std::is_same<Toutput, Eigen::half>::value ||
-        std::is_same<Toutput, Eigen::bfloat16>::value) {
-      const float min_input =
-          context->input(kSrcMinRangeIndex).flat<float>()(0);
-      const float max_input =
-          context->input(kSrcMaxRangeIndex).flat<float>()(0);
-
-      if (std::is_same<Toutput, float>::value ||
+    // The scales only change with the ranges of the inputs.
+    const HostDataKey scale_key = ScaleKey(context);
+    if (scale_key != this->output_scale_key_) {
+      const Tensor& min_filter_vector = context->input(kFilterMinRangeIndex);
+      const Tensor& max_filter_vector = context->input(kFilterMaxRangeIndex);
+      size_t depth = min_filter_vector.NumElements();
+      const float* min_filter = min_filter_vector.flat<float>().data();
+      const float* max_filter = max_filter_vector.flat<float>().data();
+
+      std::vector<float> scales(depth, 1.f);
+
+      if (std::is_same<Toutput, quint8>::value ||
+          std::is_same<Toutput, qint8>::value ||
+          std::is_same<Toutput, float>::value ||
           std::is_same<Toutput, Eigen::half>::value ||
           std::is_same<Toutput, Eigen::bfloat16>::value) {
-        const float int_input_limit =
-            (std::is_same<Tinput, quint8>::value) ? 255.0 : 127.0;
-        const float int_filter_limit = 127.0;
-        float src_qscale_f32 =
-            std::max(std::abs(min_input), std::abs(max_input)) /
-            int_input_limit;
-        for (size_t i = 0; i < depth; ++i) {
-          float wei_qscale_f32 =
-              std::max(std::abs(min_filter[i]), std::abs(max_filter[i])) /
-              int_filter_limit;
-          scales[i] = src_qscale_f32 * wei_qscale_f32;
-        }
-      } else {
-        // min_freezed_output and max_freezed_output are the actual range
-        // for the output.
-        const float min_freezed_output =
-            context->input(kMinFreezedIndex).flat<float>()(0);
-        const float max_freezed_output =
-            context->input(kMaxFreezedIndex).flat<float>()(0);
-
-        float int_output_limit =
-            std::is_same<Toutput, quint8>::value ? 255.0f : 127.0f;
+        const float min_input =
+            context->input(kSrcMinRangeIndex).flat<float>()(0);
+        const float max_input =
+            context->input(kSrcMaxRangeIndex).flat<float>()(0);
 
-        float float_input_range =
-            std::max(std::abs(min_input), std::abs(max_input));
-        float float_output_range = std::max(std::abs(min_freezed_output),
-                                            std::abs(max_freezed_output));
-        const float int_const_scale_limit =
-            (std::is_same<Tinput, quint8>::value) ? 255.0 * 127.0
-                                                  : 127.0 * 127.0;
-        for (size_t i = 0; i < depth; ++i) {
-          // For simplicity and symmetry, we set filter range to be outer
-          // bounds of min_filter and max_filter.
-          float float_filter_range =
-              std::max(std::abs(min_filter[i]), std::abs(max_filter[i]));
-          scales[i] = int_output_limit * float_input_range *
-                      float_filter_range /
-                      (int_const_scale_limit * float_output_range);
+        if (std::is_same<Toutput, float>::value ||
+            std::is_same<Toutput, Eigen::half>::value ||
+            std::is_same<Toutput, Eigen::bfloat16>::value) {
+          const float int_input_limit =
+              (std::is_same<Tinput, quint8>::value) ? 255.0 : 127.0;
+          const float int_filter_limit = 127.0;
+          float src_qscale_f32 =
+              std::max(std::abs(min_input), std::abs(max_input)) /
+              int_input_limit;
+          for (size_t i = 0; i < depth; ++i) {
+            float wei_qscale_f32 =
+                std::max(std::abs(min_filter[i]), std::abs(max_filter[i])) /
+                int_filter_limit;
+            scales[i] = src_qscale_f32 * wei_qscale_f32;
+          }
+        } else {
+          // min_freezed_output and max_freezed_output are the actual range
+          // for the output.
+          const float min_freezed_output =
+              context->input(kMinFreezedIndex).flat<float>()(0);
+          const float max_freezed_output =
+              context->input(kMaxFreezedIndex).flat<float>()(0);
+
+          float int_output_limit =
+              std::is_same<Toutput, quint8>::value ? 255.0f : 127.0f;
+
+          float float_input_range =
+              std::max(std::abs(min_input), std::abs(max_input));
+          float float_output_range = std::max(std::abs(min_freezed_output),
+                                              std::abs(max_freezed_output));
+          const float int_const_scale_limit =
+              (std::is_same<Tinput, quint8>::value) ? 255.0 * 127.0
+                                                    : 127.0 * 127.0;
+          for (size_t i = 0; i < depth; ++i) {
+            // For simplicity and symmetry, we set filter range to be outer
+            // bounds of min_filter and max_filter.
+            float float_filter_range =
+                std::max(std::abs(min_filter[i]), std::abs(max_filter[i]));
+            scales[i] = int_output_limit * float_input_range *
+                        float_filter_range /
+                        (int_const_scale_limit * float_output_range);
+          }
         }
       }
+      this->post_op_util_.SetOutputScale(scales);
+      this->output_scale_key_ = scale_key;
     }
-    this->post_op_util_.SetOutputScale(scales);
 
     if (fuse_sum_) {
       // Calculate the scale (beta in OneDnn api term) for sum
@@ -446,6 +454,7 @@ class LegacyQuantizedConvOpBase
   }
 
   Tbias* GetBiasHandle(OpKernelContext* context,
+                       const dnnl::engine& onednn_engine,
                        const Tensor& bias_tensor) override {
     if (std::is_same<Tbias, qint32>::value) {
 #ifdef ITEX_ONEDNN_3_0
@@ -491,26 +500,29 @@ class LegacyQuantizedConvOpBase
 
         // TODO(itex): avoid to use new memory
         size_t depth = min_filter_vector.NumElements();
-        scales_.resize(depth);
-
-        for (size_t i = 0; i < depth; ++i) {
-          float tmp_scale =
-              (std::max(std::abs(max_input), std::abs(min_input)) *
-               std::max(std::abs(max_filter[i]), std::abs(min_filter[i]))) /
-              int_const_scale_limit;
-          // TODO(itex): Check whether delete some instuctions about
-          // scales_are_valid is correct
-          scales_[i] = tmp_scale;
+        const HostDataKey scale_key = ScaleKey(context);
+        if (bias_scale_key_ != scale_key) {
+          scales_.resize(depth);
+          for (size_t i = 0; i < depth; ++i) {
+            float tmp_scale =
+                (std::max(std::abs(max_input), std::abs(min_input)) *
+                 std::max(std::abs(max_filter[i]), std::abs(min_filter[i]))) /
+                int_const_scale_limit;
+            // TODO(itex): Check whether delete some instuctions about
+            // scales_are_valid is correct
+            scales_[i] = tmp_scale;
+          }
+          bias_scale_key_ = scale_key;
         }
         if (bias_cache_manager.IsEmpty()) {
           bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
-              context, scales_.data(), scales_.size());
+              context, bias_scale_key_, scales_.data(), scales_.size());
         }
 
       } else {
         if (bias_cache_manager.IsEmpty()) {
           bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
-              context, scale.data(), scale.size());
+              context, this->output_scale_key_, scale.data(), scale.size());
         }
       }
       if (bias_cache_manager.IsEmpty()) {
@@ -518,7 +530,7 @@ class LegacyQuantizedConvOpBase
         memory bias_scales_mem({{static_cast<dnnl_dim_t>(scale.size())},
                                 memory::data_type::f32,
                                 memory::format_tag::x},
-                               this->onednn_engine_,
+                               onednn_engine,
                                reinterpret_cast<void*>(bias_scales_ptr));
         if (scale.size() == 1) {
           bias_attr.set_scales_mask(DNNL_ARG_SRC, 0);
@@ -535,7 +547,7 @@ class LegacyQuantizedConvOpBase
         // TODO(itex): Check whether the bias_md is always equals to
         // conv_pd.bias_desc()
         bias_cache_manager.SetCache(context, bias_md, bias_attr, bias_data,
-                                    this->onednn_engine_, bias_scales_mem);
+                                    onednn_engine, bias_scales_mem);
       }
       return static_cast<Tbias*>(bias_cache_manager.GetCache(context));
 #else
@@ -558,34 +570,38 @@ class LegacyQuantizedConvOpBase
 
     // TODO(itex): avoid to use new memory
     size_t depth = min_filter_vector.NumElements();
-    scales_.resize(depth);
-
+    // The bias scales are computed from the same ranges as the output scales.
+    const HostDataKey scale_key = ScaleKey(context);
+    if (bias_scale_key_ != scale_key) {
+      scales_.resize(depth);
 #ifdef ITEX_ONEDNN_3_0
-    const std::vector<float>& scale = this->post_op_util_.GetOutputScale();
+      const std::vector<float>& scale = this->post_op_util_.GetOutputScale();
 #endif
-    for (size_t i = 0; i < depth; ++i) {
-      float tmp_scale =
-          int_const_scale_limit /
-          (std::max(std::abs(max_input), std::abs(min_input)) *
-           std::max(std::abs(max_filter[i]), std::abs(min_filter[i])));
-      // TODO(itex): Check whether delete some instuctions about
-      // scales_are_valid is correct
+      for (size_t i = 0; i < depth; ++i) {
+        float tmp_scale =
+            int_const_scale_limit /
+            (std::max(std::abs(max_input), std::abs(min_input)) *
+             std::max(std::abs(max_filter[i]), std::abs(min_filter[i])));
+        // TODO(itex): Check whether delete some instuctions about
+        // scales_are_valid is correct
 #ifdef ITEX_ONEDNN_3_0
-      scales_[i] = tmp_scale * scale[i];
+        scales_[i] = tmp_scale * scale[i];
 #else
-      scales_[i] = tmp_scale;
+        scales_[i] = tmp_scale;
 #endif
+      }
+      bias_scale_key_ = scale_key;
     }
     // TODO(itex): is_bias_const_ is useless, delete it
     if (!is_bias_const_ || bias_cache_manager.IsEmpty()) {
       dnnl::primitive_attr bias_attr;
 #ifdef ITEX_ONEDNN_3_0
-      float* bias_scales_ptr =
-          bias_scale_cache_.GetCachedPtr(context, scales_.data(), depth);
+      float* bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
+          context, bias_scale_key_, scales_.data(), depth);
       memory bias_scales_mem({{static_cast<dnnl_dim_t>(depth)},
                               memory::data_type::f32,
                               memory::format_tag::x},
-                             this->onednn_engine_,
+                             onednn_engine,
                              reinterpret_cast<void*>(bias_scales_ptr));
       if (depth == 1) {
         bias_attr.set_scales_mask(DNNL_ARG_SRC, 0);
@@ -610,26 +626,23 @@ class LegacyQuantizedConvOpBase
 
 #ifdef ITEX_ONEDNN_3_0
       bias_cache_manager.SetCache(context, bias_md, bias_attr, bias_data,
-                                  this->onednn_engine_, bias_scales_mem);
+                                  onednn_engine, bias_scales_mem);
 #else
       bias_cache_manager.SetCache(context, bias_md, bias_attr, bias_data,
-                                  this->onednn_engine_);
+                                  onednn_engine);
 #endif
     }
     return bias_cache_manager.GetCache(context);
   }
 
-  void AllocateOutputTensor(
-      OpKernelContext* context,
-      const dnnl::convolution_forward::primitive_desc& conv_prim_desc,
-      const memory::dims& dst_dims_onednn, TensorShape dst_tensor_shape,
-      Tensor** dst_tensor, Tensor* dst_tensor_opt) override {
+  void AllocateOutputTensor(OpKernelContext* context,
+                            const dnnl::engine& onednn_engine,
+                            const FwdContext& fwd, Tensor** dst_tensor,
+                            Tensor* dst_tensor_opt) override {
     if (!fuse_sum_) {
       ConvOpBase<Device, Tinput, qint8, Tbias, Toutput, Tsummand, false,
-                 is_depthwise>::AllocateOutputTensor(context, conv_prim_desc,
-                                                     dst_dims_onednn,
-                                                     dst_tensor_shape,
-                                                     dst_tensor,
+                 is_depthwise>::AllocateOutputTensor(context, onednn_engine,
+                                                     fwd, dst_tensor,
                                                      dst_tensor_opt);
       return;
     }
@@ -665,7 +678,7 @@ class LegacyQuantizedConvOpBase
         // TODO(itex): Discuss with INC to fix incorrect pb.
         OP_REQUIRES_OK(context,
                        context->allocate_output(this->kDstIndex_,
-                                                dst_tensor_shape, dst_tensor));
+                                                fwd.dst_shape, dst_tensor));
       } else {
         context->set_output(this->kDstIndex_,
                             context->input(kSummandDataIndex));
@@ -676,10 +689,8 @@ class LegacyQuantizedConvOpBase
     }
     // TODO(itex): investigate the influence of additional attr tensor_shape
     ConvOpBase<Device, Tinput, qint8, Tbias, Toutput, Tsummand, false,
-               is_depthwise>::AllocateOutputTensor(context, conv_prim_desc,
-                                                   dst_dims_onednn,
-                                                   dst_tensor_shape, dst_tensor,
-                                                   dst_tensor_opt);
+               is_depthwise>::AllocateOutputTensor(context, onednn_engine, fwd,
+                                                   dst_tensor, dst_tensor_opt);
     const Tensor& summand = context->input(kSummandDataIndex);
     if (summand.dtype() != DT_FLOAT) {
       ITEX_LOG(FATAL) << "Current fusion requires summand to be float";
@@ -716,7 +727,7 @@ class LegacyQuantizedConvOpBase
     memory output_scales_mem({{static_cast<dnnl_dim_t>(depth)},
                               memory::data_type::f32,
                               memory::format_tag::x},
-                             this->onednn_engine_,
+                             onednn_engine,
                              reinterpret_cast<void*>(output_scale_ptr));
     if (depth == 1) {
       reorder_attr.set_scales_mask(DNNL_ARG_SRC, 0);
@@ -732,7 +743,7 @@ class LegacyQuantizedConvOpBase
 #endif
     // TODO(itex) Remove this hard code.
     auto summand_md =
-        memory::desc(dst_dims_onednn, OneDnnType<Tbias>(),
+        memory::desc(fwd.dst_dims_onednn, OneDnnType<Tbias>(),
                      this->is_conv2d_ ? memory::format_tag::nhwc
                                       : memory::format_tag::ndhwc);
 
@@ -744,9 +755,8 @@ class LegacyQuantizedConvOpBase
     void* dst_buf = static_cast<void*>((*dst_tensor)->flat<Tsummand>().data());
 
     memory summand_mem =
-        CreateDnnlMemory(summand_md, this->onednn_engine_, summand_buf);
-    memory dst_mem = CreateDnnlMemory(conv_prim_desc.dst_desc(),
-                                      this->onednn_engine_, dst_buf);
+        CreateDnnlMemory(summand_md, onednn_engine, summand_buf);
+    memory dst_mem = CreateDnnlMemory(fwd.dst_md_opt, onednn_engine, dst_buf);
 
     dnnl::reorder summand_scaled_primitive =
         dnnl::reorder(summand_mem, dst_mem, reorder_attr);
@@ -757,7 +767,7 @@ class LegacyQuantizedConvOpBase
         {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, output_scales_mem},
 #endif
     };
-    auto onednn_stream = CreateDnnlStream(*context, this->onednn_engine_);
+    auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
     summand_scaled_primitive.execute(onednn_stream, reorder_args);
   }
 
@@ -789,7 +799,25 @@ class LegacyQuantizedConvOpBase
   const int kDstMaxRangeIndex = 2;
 
  private:
+  // Identifies the ranges the output scales and the bias scales are computed
+  // from.
+  HostDataKey ScaleKey(OpKernelContext* context) {
+    HostDataKey key;
+    key.AddValue(context->input(kSrcMinRangeIndex).flat<float>()(0))
+        .AddValue(context->input(kSrcMaxRangeIndex).flat<float>()(0))
+        .AddTensor(context->input(kFilterMinRangeIndex))
+        .AddTensor(context->input(kFilterMaxRangeIndex));
+    if (std::is_same<Toutput, quint8>::value ||
+        std::is_same<Toutput, qint8>::value) {
+      key.AddValue(context->input(kMinFreezedIndex).flat<float>()(0))
+          .AddValue(context->input(kMaxFreezedIndex).flat<float>()(0));
+    }
+    return key;
+  }
+
   std::vector<float> scales_;
+  // Ranges `scales_` was computed from.
+  HostDataKey bias_scale_key_;
   // Bias cache manager
   BiasCacheManager<Tbias> bias_cache_manager;
 #ifdef ITEX_ONEDNN_3_0
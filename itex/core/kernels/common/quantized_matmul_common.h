@@ -65,7 +65,6 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
     // onednn_stream has thread safety issue, need create a new one in
     // every compute.
     onednn_stream_ = CreateDnnlStream(*context, onednn_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
     InitOrSetMemory(context);
 
     if (is_input_zero_) {
@@ -83,12 +82,12 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
           kFilterMaxRangeIndex, kMinFreezedIndex, kMaxFreezedIndex,
           kDstMinRangeIndex, kDstMaxRangeIndex);
 
-      scratchpad_tensor_.reset();
+      scratchpad_ = OneDnnScratchpad();
       return;
     }
 
     fwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
-    scratchpad_tensor_.reset();
+    scratchpad_ = OneDnnScratchpad();
 
     const float min_input = context->input(kSrcMinRangeIndex).flat<float>()(0);
     const float max_input = context->input(kSrcMaxRangeIndex).flat<float>()(0);
@@ -139,11 +138,9 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
       }
 
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<Tinput>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_.set_data_handle(
-          GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
+                     scratchpad_.Init(context, scratchpad_mem_.get_desc(),
+                                      onednn_engine_));
+      scratchpad_mem_.set_data_handle(scratchpad_.data());
 
       AllocateOutputTensor(context, fwd_pd_, dst_dims_onednn_, dst_shape_,
                            &dst_tensor_);
@@ -285,14 +282,10 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
       dst_mem_ = CreateDnnlMemory(fwd_pd_.dst_desc(), onednn_engine_,
                                   static_cast<void*>(dst_data));
 
-      scratchpad_size_ = fwd_pd_.scratchpad_desc().get_size() / sizeof(Tinput);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<Tinput>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(fwd_pd_.scratchpad_desc(), onednn_engine_,
-                       GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
+      OP_REQUIRES_OK(context, scratchpad_.Init(context,
+                                               fwd_pd_.scratchpad_desc(),
+                                               onednn_engine_));
+      scratchpad_mem_ = scratchpad_.memory();
 
       // Execute MatMul INT8
       fwd_primitive_args_ = {{DNNL_ARG_SRC, src_mem_},
@@ -302,7 +295,8 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
 #ifdef ITEX_ONEDNN_3_0
       if (this->post_op_util_.HasOutputScales()) {
         float* output_scale_ptr = output_scale_cache_.GetCachedPtr(
-            context, this->post_op_util_.GetOutputScale().data(),
+            context, output_scale_key_,
+            this->post_op_util_.GetOutputScale().data(),
             this->post_op_util_.GetOutputScale().size());
         dnnl::memory scale_mem(
             {{static_cast<dnnl_dim_t>(
@@ -463,6 +457,22 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
     return const_cast<Tbias*>(cached_bias_data->flat<Tbias>().data());
   }
 
+  // Identifies the ranges the output scales and the bias scales are computed
+  // from.
+  HostDataKey ScaleKey(OpKernelContext* context) {
+    HostDataKey key;
+    key.AddValue(context->input(kSrcMinRangeIndex).flat<float>()(0))
+        .AddValue(context->input(kSrcMaxRangeIndex).flat<float>()(0))
+        .AddTensor(context->input(kFilterMinRangeIndex))
+        .AddTensor(context->input(kFilterMaxRangeIndex));
+    // The requantization range, if the kernel has one.
+    if (kMaxFreezedIndex < context->num_inputs()) {
+      key.AddValue(context->input(kMinFreezedIndex).flat<float>()(0))
+          .AddValue(context->input(kMaxFreezedIndex).flat<float>()(0));
+    }
+    return key;
+  }
+
   bool IsCachedBiasValid(float current_min_input, float current_max_input) {
     if (this->is_bias_const_ && this->is_weight_const_ &&
         std::abs(current_min_input - saved_min_input_) < 1e-5f &&
@@ -517,15 +527,19 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
               ? max_input - min_input
               : std::max(std::abs(min_input), std::abs(max_input));
       const size_t num_weight_scales = min_weight_tensor.NumElements();
-      std::vector<float> bias_scales(num_weight_scales, 1.0);
-      for (size_t i = 0; i < num_weight_scales; ++i) {
-        float range_weight =
-            std::max(std::abs(min_weight[i]), std::abs(max_weight[i]));
-        float scale_factor =
-            (max_int8_input * max_int8_weight) / (range_input * range_weight);
-        bias_scales[i] = scale_factor;
-      }
+      const auto compute_bias_scales = [&]() {
+        std::vector<float> bias_scales(num_weight_scales, 1.0);
+        for (size_t i = 0; i < num_weight_scales; ++i) {
+          float range_weight =
+              std::max(std::abs(min_weight[i]), std::abs(max_weight[i]));
+          float scale_factor =
+              (max_int8_input * max_int8_weight) / (range_input * range_weight);
+          bias_scales[i] = scale_factor;
+        }
+        return bias_scales;
+      };
       if (mode_ == QuantizeMode::MIN_FIRST) {
+        const std::vector<float> bias_scales = compute_bias_scales();
         const Tensor& weight_tensor = context->input(1);
 
         int k = weight_tensor.dim_size(0);
@@ -619,8 +633,8 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
         (num_weight_scales == 1) ? bias_attr.set_scales_mask(DNNL_ARG_SRC, 0)
                                  : bias_attr.set_scales_mask(DNNL_ARG_SRC, 1);
 #else
-        (num_weight_scales == 1) ? bias_attr.set_output_scales(0, bias_scales)
-                                 : bias_attr.set_output_scales(1, bias_scales);
+        bias_attr.set_output_scales(num_weight_scales == 1 ? 0 : 1,
+                                    compute_bias_scales());
 #endif
         memory::dims input_bias_dims =
             memory::dims({1, bias_tensor.shape().dim_size(0)});
@@ -635,8 +649,14 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
         auto scaled_bias_mem =
             dnnl::memory(scaled_bias_md, onednn_engine_, scaled_bias_buf);
 #ifdef ITEX_ONEDNN_3_0
-        float* bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
-            context, bias_scales.data(), num_weight_scales);
+        // The scales are only computed if the ranges changed.
+        const HostDataKey scale_key = this->ScaleKey(context);
+        float* bias_scales_ptr = bias_scale_cache_.Lookup(scale_key);
+        if (bias_scales_ptr == nullptr) {
+          const std::vector<float> bias_scales = compute_bias_scales();
+          bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
+              context, scale_key, bias_scales.data(), num_weight_scales);
+        }
         dnnl::memory bias_scales_mem = dnnl::memory(
             {{static_cast<dnnl_dim_t>(num_weight_scales)},
              dnnl::memory::data_type::f32,
@@ -715,6 +735,8 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
   QuantizeMode mode_;
   /* Fused MatMul */
   PostOpUtil post_op_util_;
+  // Ranges the output scales were computed from, set in `ExtendInt8PostOps`.
+  HostDataKey output_scale_key_;
   // Weight cache manager
   WeightCacheManager<Tweight> weight_cache_manager;
 
@@ -745,8 +767,7 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
 
   Tensor* dst_tensor_ = nullptr;
   Tensor tmp_weight_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64_t scratchpad_size_ = 0;
+  OneDnnScratchpad scratchpad_;
 
   dnnl::stream onednn_stream_;
   dnnl::engine onednn_engine_;
@@ -781,7 +802,6 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
     // onednn_stream has thread safety issue, need create a new one in
     // every compute.
     onednn_stream_ = CreateDnnlStream(*context, onednn_engine_);
-    scratchpad_tensor_ = std::make_shared<Tensor>();
     InitOrSetMemory(context);
 
     if (is_input_zero_) {
@@ -799,12 +819,12 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
           kFilterMaxRangeIndex, kMinFreezedIndex, kMaxFreezedIndex,
           kDstMinRangeIndex, kDstMaxRangeIndex);
 
-      scratchpad_tensor_.reset();
+      scratchpad_ = OneDnnScratchpad();
       return;
     }
 
     fwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
-    scratchpad_tensor_.reset();
+    scratchpad_ = OneDnnScratchpad();
 
     const float min_input = context->input(kSrcMinRangeIndex).flat<float>()(0);
     const float max_input = context->input(kSrcMaxRangeIndex).flat<float>()(0);
@@ -855,11 +875,9 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
       }
 
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<Tinput>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_.set_data_handle(
-          GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
+                     scratchpad_.Init(context, scratchpad_mem_.get_desc(),
+                                      onednn_engine_));
+      scratchpad_mem_.set_data_handle(scratchpad_.data());
 
       AllocateOutputTensor(context, fwd_pd_, dst_dims_onednn_, dst_shape_,
                            &dst_tensor_);
@@ -995,14 +1013,10 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
       dst_mem_ = CreateDnnlMemory(fwd_pd_.dst_desc(), onednn_engine_,
                                   static_cast<void*>(dst_data));
 
-      scratchpad_size_ = fwd_pd_.scratchpad_desc().get_size() / sizeof(Tinput);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<Tinput>::v(),
-                                            TensorShape({scratchpad_size_}),
-                                            scratchpad_tensor_.get()));
-      scratchpad_mem_ =
-          dnnl::memory(fwd_pd_.scratchpad_desc(), onednn_engine_,
-                       GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
+      OP_REQUIRES_OK(context, scratchpad_.Init(context,
+                                               fwd_pd_.scratchpad_desc(),
+                                               onednn_engine_));
+      scratchpad_mem_ = scratchpad_.memory();
 
       // Execute MatMul INT8
       fwd_primitive_args_ = {{DNNL_ARG_SRC, src_mem_},
@@ -1011,7 +1025,8 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
                              {DNNL_ARG_SCRATCHPAD, scratchpad_mem_}};
       if (this->post_op_util_.HasOutputScales()) {
         float* output_scale_ptr = output_scale_cache_.GetCachedPtr(
-            context, this->post_op_util_.GetOutputScale().data(),
+            context, output_scale_key_,
+            this->post_op_util_.GetOutputScale().data(),
             this->post_op_util_.GetOutputScale().size());
         dnnl::memory scale_mem(
             {{static_cast<dnnl_dim_t>(
@@ -1166,6 +1181,22 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
     return const_cast<float*>(cached_bias_data->flat<float>().data());
   }
 
+  // Identifies the ranges the output scales and the bias scales are computed
+  // from.
+  HostDataKey ScaleKey(OpKernelContext* context) {
+    HostDataKey key;
+    key.AddValue(context->input(kSrcMinRangeIndex).flat<float>()(0))
+        .AddValue(context->input(kSrcMaxRangeIndex).flat<float>()(0))
+        .AddTensor(context->input(kFilterMinRangeIndex))
+        .AddTensor(context->input(kFilterMaxRangeIndex));
+    // The requantization range, if the kernel has one.
+    if (kMaxFreezedIndex < context->num_inputs()) {
+      key.AddValue(context->input(kMinFreezedIndex).flat<float>()(0))
+          .AddValue(context->input(kMaxFreezedIndex).flat<float>()(0));
+    }
+    return key;
+  }
+
   bool IsCachedBiasValid(float current_min_input, float current_max_input) {
     if (this->is_bias_const_ && this->is_weight_const_ &&
         std::abs(current_min_input - saved_min_input_) < 1e-5f &&
@@ -1227,16 +1258,20 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
               ? max_input - min_input
               : std::max(std::abs(min_input), std::abs(max_input));
       const size_t num_weight_scales = min_weight_tensor.NumElements();
-      std::vector<float> bias_scales(num_weight_scales, 1.0);
-      for (size_t i = 0; i < num_weight_scales; ++i) {
-        float range_weight =
-            std::max(std::abs(min_weight[i]), std::abs(max_weight[i]));
-        // scale_factor = 1/scale_factor now
-        float scale_factor =
-            (range_input * range_weight) / (max_int8_input * max_int8_weight);
-        bias_scales[i] = scale_factor;
-      }
+      const auto compute_bias_scales = [&]() {
+        std::vector<float> bias_scales(num_weight_scales, 1.0);
+        for (size_t i = 0; i < num_weight_scales; ++i) {
+          float range_weight =
+              std::max(std::abs(min_weight[i]), std::abs(max_weight[i]));
+          // scale_factor = 1/scale_factor now
+          float scale_factor =
+              (range_input * range_weight) / (max_int8_input * max_int8_weight);
+          bias_scales[i] = scale_factor;
+        }
+        return bias_scales;
+      };
       if (mode_ == QuantizeMode::MIN_FIRST) {
+        const std::vector<float> bias_scales = compute_bias_scales();
         const Tensor& weight_tensor = context->input(1);
 
         // int k = weight_tensor.dim_size(0);
@@ -1310,8 +1345,14 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
 
         auto scaled_bias_mem =
             dnnl::memory(scaled_bias_md, onednn_engine_, scaled_bias_buf);
-        float* bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
-            context, bias_scales.data(), num_weight_scales);
+        // The scales are only computed if the ranges changed.
+        const HostDataKey scale_key = this->ScaleKey(context);
+        float* bias_scales_ptr = bias_scale_cache_.Lookup(scale_key);
+        if (bias_scales_ptr == nullptr) {
+          const std::vector<float> bias_scales = compute_bias_scales();
+          bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
+              context, scale_key, bias_scales.data(), num_weight_scales);
+        }
         dnnl::memory bias_scales_mem = dnnl::memory(
             {{static_cast<dnnl_dim_t>(num_weight_scales)},
              dnnl::memory::data_type::f32,
@@ -1390,6 +1431,8 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
   QuantizeMode mode_;
   /* Fused MatMul */
   PostOpUtil post_op_util_;
+  // Ranges the output scales were computed from, set in `ExtendInt8PostOps`.
+  HostDataKey output_scale_key_;
   // Weight cache manager
   WeightCacheManager<Tweight> weight_cache_manager;
 
@@ -1420,8 +1463,7 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
 
   Tensor* dst_tensor_ = nullptr;
   Tensor tmp_weight_;
-  std::shared_ptr<Tensor> scratchpad_tensor_;
-  int64_t scratchpad_size_ = 0;
+  OneDnnScratchpad scratchpad_;
 
   dnnl::stream onednn_stream_;
   dnnl::engine onednn_engine_;
@@ -1502,6 +1544,10 @@ class QuantizedMatMulOp
         std::is_same<Toutput, float>::value ||
         std::is_same<Toutput, Eigen::bfloat16>::value ||
         std::is_same<Toutput, Eigen::half>::value) {
+      // The scale only changes with the ranges of the inputs.
+      const HostDataKey scale_key = this->ScaleKey(context);
+      if (scale_key == this->output_scale_key_) return;
+
       float min_output_value;
       float max_output_value;
       this->ComputeOutputRangeForInt32(context, &min_output_value,
@@ -1529,6 +1575,7 @@ class QuantizedMatMulOp
         scale = scale_int32 / scale_eightbit / static_cast<float>(1u << 24);
       }
       this->post_op_util_.SetOutputScale({scale});
+      this->output_scale_key_ = scale_key;
     }
   }
 };
@@ -1645,6 +1692,10 @@ class QuantizedFusedMatMulOp
       // When Toutput is float, the fusion semantic has its output dequantized,
       // and when Toutput is q{u}int8 the fusion semantic has its output
       // requantized.
+      // The scales only change with the ranges of the inputs and the output.
+      const HostDataKey scale_key = this->ScaleKey(context);
+      if (scale_key == this->output_scale_key_) return;
+
       const float min_input =
           context->input(this->kSrcMinRangeIndex).template flat<float>()(0);
       const float max_input =
@@ -1723,6 +1774,7 @@ class QuantizedFusedMatMulOp
           this->post_op_util_.SetPostOpScale("Add", 1.0f);
         }
       }
+      this->output_scale_key_ = scale_key;
     }
   }
 
@@ -1828,6 +1880,10 @@ class QuantizedFusedMatMulV2Op
 
   void ExtendInt8PostOps(OpKernelContext* context) override {
     if (!fused_ops_.empty()) {
+      // The scales only change with the ranges of the inputs and the output.
+      const HostDataKey scale_key = this->ScaleKey(context);
+      if (scale_key == this->output_scale_key_) return;
+
       // Hard code output range here since it's never changed.
       const int kOutputMinIdx = 7;
       const int kOutputMaxIdx = 8;
@@ -1907,6 +1963,7 @@ class QuantizedFusedMatMulV2Op
         // the input index is always 3.
         this->post_op_util_.SetPostOpScale("Add", 1.0f);
       }
+      this->output_scale_key_ = scale_key;
     }
   }
 };
@@ -0,0 +1,262 @@
+/* Copyright (c) 2021-2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_COMMON_RNN_OPS_H_
+#define ITEX_CORE_KERNELS_COMMON_RNN_OPS_H_
+
+#include <string>
+
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/stringprintf.h"
+#include "itex/core/utils/tensor_shape.h"
+
+namespace itex {
+
+enum class RnnMode {
+  kRnnRelu = 0,
+  kRnnTanh = 1,
+  kRnnLstm = 2,
+  kRnnGru = 3,
+};
+
+struct RnnModelConfig {
+  // input attribute
+  RnnMode rnn_mode;
+  float dropout;
+  float recurrent_dropout;
+  int num_proj;
+  bool var_seq_length;
+  bool is_training;
+
+  // model shapes
+  int max_seq_length;
+  int batch_size;
+  int input_size;
+  int output_size;
+  int cell_size;
+  int num_gates;
+  TensorShape input_shape;
+  TensorShape output_shape;
+  TensorShape hidden_state_shape;
+  TensorShape cell_state_shape;
+  TensorShape params_shape;
+  TensorShape workspace_shape;
+
+  bool HasInputC() const { return rnn_mode == RnnMode::kRnnLstm; }
+  bool HasDpMask() const { return dropout > 0 && dropout < 1; }
+  bool HasRecDpMask() const {
+    return recurrent_dropout > 0 && recurrent_dropout < 1;
+  }
+
+  string DebugString() const {
+    return strings::Printf(
+        "rnn_mode: %d, dropout: %f, recurrent_dropout: %f, num_proj: %d, "
+        "var_seq_length: %d, is_training: %d\n"
+        "seq_length: %d, batch_size: %d, input_size: %d, output size: %d, "
+        "cell_size: %d, num_gates: %d\n",
+        rnn_mode, dropout, recurrent_dropout, num_proj, var_seq_length,
+        is_training, max_seq_length, batch_size, input_size, output_size,
+        cell_size, num_gates);
+  }
+};
+
+inline Status ParseRNNMode(const string& str, RnnMode* rnn_mode) {
+  if (str == "rnn_relu") {
+    *rnn_mode = RnnMode::kRnnRelu;
+  } else if (str == "rnn_tanh") {
+    *rnn_mode = RnnMode::kRnnTanh;
+  } else if (str == "lstm") {
+    *rnn_mode = RnnMode::kRnnLstm;
+  } else if (str == "gru") {
+    *rnn_mode = RnnMode::kRnnGru;
+  } else {
+    return errors::InvalidArgument("Invalid RNN mode: ", str);
+  }
+  return Status::OK();
+}
+
+// ------------------------------------------------------------------
+// A common base class for RNN kernels. It extracts common attributes and
+// checks the inputs, for both the CPU and GPU kernels.
+class RnnCommonKernel : public OpKernel {
+ protected:
+  RnnModelConfig rmc_;
+
+  explicit RnnCommonKernel(OpKernelConstruction* context) : OpKernel(context) {
+    std::string str;
+    OP_REQUIRES_OK(context, context->GetAttr("rnn_mode", &str));
+    OP_REQUIRES_OK(context, ParseRNNMode(str, &rmc_.rnn_mode));
+    OP_REQUIRES_OK(context, context->GetAttr("dropout", &rmc_.dropout));
+    OP_REQUIRES_OK(context, context->GetAttr("recurrent_dropout",
+                                             &rmc_.recurrent_dropout));
+    OP_REQUIRES_OK(context, context->GetAttr("num_proj", &rmc_.num_proj));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("var_seq_length", &rmc_.var_seq_length));
+  }
+
+  Status ExtractInput(OpKernelContext* context, const Tensor** input,
+                      const Tensor** input_h, const Tensor** input_c,
+                      const Tensor** params, const Tensor** seq_lengths,
+                      const Tensor** dp_mask, const Tensor** rec_dp_mask) {
+    TF_RETURN_IF_ERROR(context->input("input", input));
+    if ((*input)->dims() != 3) {
+      return errors::InvalidArgument("input must be 3-D, got ",
+                                     (*input)->shape().DebugString());
+    }
+
+    TF_RETURN_IF_ERROR(context->input("input_h", input_h));
+    if ((*input_h)->dims() != 2) {
+      return errors::InvalidArgument("input_h must be 2-D, got ",
+                                     (*input_h)->shape().DebugString());
+    }
+
+    if (rmc_.HasInputC()) {
+      TF_RETURN_IF_ERROR(context->input("input_c", input_c));
+      if ((*input_c)->dims() != 2) {
+        return errors::InvalidArgument("input_c must be 2-D, got ",
+                                       (*input_c)->shape().DebugString());
+      }
+    }
+
+    TF_RETURN_IF_ERROR(context->input("params", params));
+    if ((*params)->dims() != 1) {
+      return errors::InvalidArgument("params must be 1-D, got ",
+                                     (*params)->shape().DebugString());
+    }
+
+    if (rmc_.var_seq_length) {
+      TF_RETURN_IF_ERROR(context->input("sequence_lengths", seq_lengths));
+      if ((*seq_lengths)->dims() != 1) {
+        return errors::InvalidArgument("sequence_lengths must be 1-D, got ",
+                                       (*seq_lengths)->shape().DebugString());
+      }
+    }
+
+    if (rmc_.HasDpMask()) {
+      TF_RETURN_IF_ERROR(context->input("dropout_mask", dp_mask));
+      if ((*dp_mask)->dims() != 2) {
+        return errors::InvalidArgument("dropout_mask must be 2-D, got ",
+                                       (*dp_mask)->shape().DebugString());
+      }
+    }
+    if (rmc_.HasRecDpMask()) {
+      TF_RETURN_IF_ERROR(context->input("recurrent_dropout_mask", rec_dp_mask));
+      if ((*rec_dp_mask)->dims() != 2) {
+        return errors::InvalidArgument(
+            "recurrent_dropout_mask must be 2-D, got ",
+            (*rec_dp_mask)->shape().DebugString());
+      }
+    }
+
+    // assign model shapes
+    rmc_.max_seq_length = (*input)->dim_size(0);
+    rmc_.batch_size = (*input)->dim_size(1);
+    rmc_.input_size = (*input)->dim_size(2);
+    rmc_.output_size = (*input_h)->dim_size(1);
+
+    rmc_.input_shape = (*input)->shape();
+    rmc_.output_shape =
+        TensorShape({rmc_.max_seq_length, rmc_.batch_size, rmc_.output_size});
+
+    rmc_.hidden_state_shape = TensorShape({rmc_.batch_size, rmc_.output_size});
+    if ((*input_h)->shape() != rmc_.hidden_state_shape) {
+      return errors::InvalidArgument(
+          "invalid input_h shape: ", (*input_h)->shape().DebugString(),
+          "expected: ", rmc_.hidden_state_shape.DebugString());
+    }
+
+    if (rmc_.var_seq_length) {
+      if ((*seq_lengths)->dim_size(0) != rmc_.batch_size) {
+        return errors::InvalidArgument("invalid sequence_lengths size: ",
+                                       (*seq_lengths)->shape().DebugString());
+      }
+    }
+
+    if (rmc_.rnn_mode == RnnMode::kRnnLstm) {
+      rmc_.num_gates = 4;
+    } else if (rmc_.rnn_mode == RnnMode::kRnnGru) {
+      rmc_.num_gates = 3;
+    } else {
+      rmc_.num_gates = 1;
+    }
+
+    rmc_.params_shape = (*params)->shape();
+    int params_size = rmc_.num_gates * rmc_.output_size *
+                      (rmc_.input_size + rmc_.output_size + 1);
+    if ((*params)->NumElements() != params_size) {
+      return errors::InvalidArgument(
+          "invalid params shape size: ", (*params)->shape().DebugString(),
+          "expected: ", params_size);
+    }
+
+    if (rmc_.HasInputC()) {
+      rmc_.cell_size = (*input_c)->dim_size(1);
+      rmc_.cell_state_shape = (*input_c)->shape();
+      if (rmc_.num_proj == 0) {
+        if ((*input_h)->shape() != (*input_c)->shape()) {
+          return errors::InvalidArgument(
+              "input_h and input_c must have the same shape ",
+              (*input_h)->shape().DebugString(), " ",
+              (*input_c)->shape().DebugString());
+        }
+      } else {
+        if ((*input_h)->dim_size(0) != (*input_c)->dim_size(0) ||
+            (*input_h)->dim_size(1) > (*input_c)->dim_size(1) ||
+            rmc_.num_proj != (*input_h)->dim_size(1)) {
+          return errors::InvalidArgument(
+              "invalid input_h and input_c w/ projection size: ", rmc_.num_proj,
+              " ", (*input_h)->shape().DebugString(), " ",
+              (*input_c)->shape().DebugString());
+        }
+      }
+    } else {
+      // dummy cell_state_shape
+      rmc_.cell_size = 0;
+      rmc_.cell_state_shape = TensorShape({});
+    }
+
+    // The CPU kernels replace this with the size of the oneDNN workspace.
+    if (rmc_.is_training) {
+      // workspace structure (training):
+      // 1. gates: (max_seq_length, num_gates, batch_size, ouput_size)
+      // 2. masked_input: (max_seq_length, num_gates, batch_size, input_size)
+      // 3. masked_h_prev: (max_seq_length, num_gates, batch_size, output_size)
+      // 4. c_states: (max_seq_length, batch_size, cell_size)
+      const int ss = rmc_.max_seq_length * rmc_.num_gates * rmc_.batch_size;
+      int size = ss * rmc_.output_size;
+      if (rmc_.HasDpMask()) {
+        size += ss * rmc_.input_size;
+      }
+      if (rmc_.HasRecDpMask()) {
+        size += ss * rmc_.output_size;
+      }
+      if (rmc_.HasInputC()) {
+        size += rmc_.max_seq_length * rmc_.batch_size * rmc_.cell_size;
+      }
+      rmc_.workspace_shape = TensorShape({size});
+    } else {
+      rmc_.workspace_shape = TensorShape({});
+    }
+
+    return Status::OK();
+  }
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_COMMON_RNN_OPS_H_
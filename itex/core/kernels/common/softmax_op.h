@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 
 #include "itex/core/utils/errors.h"
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
@@ -30,6 +31,11 @@ limitations under the License.
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
 namespace itex {
+
+using SoftmaxFwdPrimitiveCache =
+    OneDnnPrimitiveCache<dnnl::softmax_forward::primitive_desc,
+                         dnnl::softmax_forward>;
+
 // Softmax op implementation is based on OneDnn kernel
 template <typename Device, typename T>
 class SoftmaxOp : public OpKernel {
@@ -56,18 +62,28 @@ class SoftmaxOp : public OpKernel {
       int axis = input_dims - 1;
       auto src_md = CreatePlainMemDescWithFormatTag<T>(src_dims);
 
-      dnnl::primitive_attr attr;
-      attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("softmax_fwd");
+      key_creator.AddAsKey(onednn_engine);
+      key_creator.AddAsKey(src_md);
+      key_creator.AddAsKey(axis);
+      auto create_pd = [&]() {
+        dnnl::primitive_attr attr;
+        attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
 #ifdef ITEX_ONEDNN_3_0
-      auto fwd_pd = dnnl::softmax_forward::primitive_desc(
-          onednn_engine, dnnl::prop_kind::forward_training,
-          dnnl::algorithm::softmax_accurate, src_md, src_md, axis, attr);
+        return dnnl::softmax_forward::primitive_desc(
+            onednn_engine, dnnl::prop_kind::forward_training,
+            dnnl::algorithm::softmax_accurate, src_md, src_md, axis, attr);
 #else
-      auto fwd_desc = dnnl::softmax_forward::desc(
-          dnnl::prop_kind::forward_training, src_md, axis);
-      auto fwd_pd =
-          dnnl::softmax_forward::primitive_desc(fwd_desc, attr, onednn_engine);
+        auto fwd_desc = dnnl::softmax_forward::desc(
+            dnnl::prop_kind::forward_training, src_md, axis);
+        return dnnl::softmax_forward::primitive_desc(fwd_desc, attr,
+                                                     onednn_engine);
 #endif
+      };
+      auto cached = SoftmaxFwdPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const auto& fwd_pd = cached.pd;
       auto src_mem =
           dnnl::memory(src_md, onednn_engine, GetTensorBuffer<T>(&src_tensor));
 
@@ -84,17 +100,12 @@ class SoftmaxOp : public OpKernel {
                                   GetTensorBuffer<T>(output_tensor));
 
       // Prepare for creating scratchpad tensor.
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size = fwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
-
-      auto softmax_fwd = dnnl::softmax_forward(fwd_pd);
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, fwd_pd.scratchpad_desc(),
+                                              onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
+
+      const auto& softmax_fwd = cached.primitive;
       softmax_fwd.execute(onednn_stream,
                           {
                               {DNNL_ARG_SRC, src_mem},
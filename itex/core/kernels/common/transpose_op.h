@@ -21,6 +21,9 @@ limitations under the License.
 #include <vector>
 
 #include "itex/core/kernels/common/transpose_functor.h"
+#ifdef INTEL_CPU_ONLY
+#include "itex/core/kernels/common/transpose_plan.h"
+#endif  // INTEL_CPU_ONLY
 #include "itex/core/utils/bounds_check.h"
 #include "itex/core/utils/logging.h"
 #include "itex/core/utils/onednn/onednn_util.h"
@@ -90,7 +93,11 @@ Status TransposeND(OpKernelContext* context, const Tensor& in, Tensor* out,
 template <typename Device, typename T, bool is_conjugate = false>
 class TransposeOp : public OpKernel {
  public:
-  explicit TransposeOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
+  explicit TransposeOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+#ifdef INTEL_CPU_ONLY
+    backend_ = GetCPUTransposeBackend();
+#endif  // INTEL_CPU_ONLY
+  }
 
   void Compute(OpKernelContext* ctx) override {
     const Tensor& input = ctx->input(0);
@@ -162,7 +169,14 @@ class TransposeOp : public OpKernel {
     // all gpu primitive is using MAX_NDIMS, align with it first
     // Need check with oneDNN team
     if (!is_conjugate) {
-      if (in.dims() <= MAX_NDIMS) {
+      bool use_onednn = in.dims() <= MAX_NDIMS;
+#ifdef INTEL_CPU_ONLY
+      if (backend_ == CPUTransposeBackend::kPlan) {
+        return TransposeWithPlan(in, perm, out);
+      }
+      use_onednn = use_onednn && backend_ == CPUTransposeBackend::kOneDnn;
+#endif  // INTEL_CPU_ONLY
+      if (use_onednn) {
         switch (in.dtype()) {
           case DT_FLOAT:
             return TransposeND<Device, float>(ctx, in, out, perm);
@@ -189,6 +203,10 @@ class TransposeOp : public OpKernel {
                                           out);
     }
   }
+
+#ifdef INTEL_CPU_ONLY
+  CPUTransposeBackend backend_;
+#endif  // INTEL_CPU_ONLY
 };
 
 // INT8 Transpose = FP32 Transpose + Pass min/max tensor
@@ -0,0 +1,118 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/kernels/common/transpose_plan.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/ascii.h"
+#include "itex/core/compiler/xla/pjrt/transpose.h"
+#include "itex/core/utils/cpu_threadpool.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mutex.h"
+
+namespace itex {
+
+namespace {
+
+// Plans are cheap to keep but not to build, the capacity covers the distinct
+// transposes of a typical model.
+constexpr int kPlanCacheCapacity = 128;
+
+// Smallest transpose, in bytes, worth handing a thread of its own.
+constexpr int64 kMinBytesPerThread = 256 << 10;
+
+// TransposePlanCache isn't thread-safe, kernels of concurrent steps share it
+// through the lock. Plans are immutable and kept alive by their shared_ptr
+// after eviction, so they are executed without holding it.
+class SharedPlanCache {
+ public:
+  static SharedPlanCache* Get() {
+    static SharedPlanCache* cache = new SharedPlanCache();
+    return cache;
+  }
+
+  StatusOr<std::shared_ptr<itex_xla::TransposePlan>> GetOrCreate(
+      size_t elem_size, absl::Span<int64_t const> dims,
+      absl::Span<int64_t const> permutation, int num_threads) {
+    mutex_lock lock(&mu_);
+    return cache_.GetOrCreate(
+        elem_size, dims, permutation, itex_xla::TransposePlan::Tiling{},
+        itex_xla::TransposePlan::Tiling{},
+        itex_xla::TransposePlan::Transformation::kNone, num_threads);
+  }
+
+ private:
+  SharedPlanCache() : cache_(kPlanCacheCapacity) {}
+
+  mutex mu_;
+  itex_xla::TransposePlanCache cache_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+CPUTransposeBackend GetCPUTransposeBackend() {
+  string backend;
+  ITEX_CHECK_OK(
+      ReadStringFromEnvVar("ITEX_CPU_TRANSPOSE_BACKEND", "onednn", &backend));
+  backend = absl::AsciiStrToLower(backend);
+  if (backend == "plan") return CPUTransposeBackend::kPlan;
+  if (backend == "eigen") return CPUTransposeBackend::kEigen;
+  if (backend != "onednn") {
+    ITEX_LOG(WARNING) << "Unknown ITEX_CPU_TRANSPOSE_BACKEND " << backend
+                      << ", using onednn.";
+  }
+  return CPUTransposeBackend::kOneDnn;
+}
+
+Status TransposeWithPlan(const Tensor& in, gtl::ArraySlice<int32> perm,
+                         Tensor* out) {
+  const int elem_size = DataTypeSize(in.dtype());
+  if (elem_size != 1 && elem_size != 2 && elem_size != 4 && elem_size != 8 &&
+      elem_size != 16) {
+    return errors::Unimplemented("TransposePlan doesn't support ",
+                                 DataTypeString(in.dtype()));
+  }
+
+  absl::InlinedVector<int64_t, 8> dims(in.dims());
+  absl::InlinedVector<int64_t, 8> permutation(perm.size());
+  for (int i = 0; i < in.dims(); ++i) dims[i] = in.dim_size(i);
+  for (size_t i = 0; i < perm.size(); ++i) permutation[i] = perm[i];
+
+  CPUThreadPool* pool = CPUThreadPool::GetInstance();
+  const int64 num_bytes = in.NumElements() * elem_size;
+  const int num_threads = static_cast<int>(std::max<int64>(
+      1, std::min<int64>(pool->NumThreads(), num_bytes / kMinBytesPerThread)));
+
+  auto plan = SharedPlanCache::Get()->GetOrCreate(elem_size, dims, permutation,
+                                                  num_threads);
+  TF_RETURN_IF_ERROR(plan.status());
+
+  thread::ThreadPool* threadpool = pool->threadpool();
+  (*plan)->Execute(
+      in.data(), out->data(),
+      [threadpool](std::function<void()> fn) {
+        threadpool->Schedule(std::move(fn));
+      });
+  return Status::OK();
+}
+
+}  // namespace itex
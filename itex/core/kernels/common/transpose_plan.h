@@ -0,0 +1,47 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_COMMON_TRANSPOSE_PLAN_H_
+#define ITEX_CORE_KERNELS_COMMON_TRANSPOSE_PLAN_H_
+
+#include "itex/core/utils/gtl/array_slice.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/status.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+// Backends of the CPU transpose kernels, chosen by
+// `ITEX_CPU_TRANSPOSE_BACKEND`:
+//  * `onednn` (default): oneDNN reorder, Eigen shuffle above MAX_NDIMS.
+//  * `eigen`: Eigen shuffle.
+//  * `plan`: tiled TransposePlan of the XLA PJRT runtime.
+enum class CPUTransposeBackend { kOneDnn, kEigen, kPlan };
+
+// Reads `ITEX_CPU_TRANSPOSE_BACKEND`. Kernels read it when they are
+// constructed, so graphs built after the variable changes pick up the new
+// backend.
+CPUTransposeBackend GetCPUTransposeBackend();
+
+// Transposes `in` into `out` with a TransposePlan, see
+// itex/core/compiler/xla/pjrt/transpose.h. Plans are cached by element size,
+// shape and permutation, and large transposes are split across the ITEX CPU
+// intra-op thread pool.
+Status TransposeWithPlan(const Tensor& in, gtl::ArraySlice<int32> perm,
+                         Tensor* out);
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_COMMON_TRANSPOSE_PLAN_H_
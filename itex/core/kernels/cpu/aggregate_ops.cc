@@ -162,15 +162,10 @@ class AddNOp : public OpKernel {
           dnnl::sum::primitive_desc(coeff, srcs_pd, onednn_engine, attr);
 #endif
 
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size = sum_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(sum_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, sum_pd.scratchpad_desc(),
+                                              onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
 
       OP_REQUIRES_OK(context, context->allocate_output(
                                   kOutputIdx, output_tf_shape, &dst_tensor));
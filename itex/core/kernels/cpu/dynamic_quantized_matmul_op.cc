@@ -0,0 +1,428 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "itex/core/kernels/common/matmul_op.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/onednn/onednn_post_op_util.h"
+#include "itex/core/utils/onednn/onednn_util.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+namespace {
+
+// Symmetric int8 range, -128 is never used so that -x quantizes to -q.
+constexpr float kInt8Max = 127.0f;
+
+// Dequantization scale of values in [-max_abs, max_abs]. All-zero data keeps
+// scale 1 and quantizes to zeros.
+inline float SymmetricScale(float max_abs) {
+  return max_abs > 0.0f ? max_abs / kInt8Max : 1.0f;
+}
+
+inline int8 QuantizeValue(float value, float inv_scale) {
+  float q = std::round(value * inv_scale);
+  return static_cast<int8>(std::min(std::max(q, -kInt8Max), kInt8Max));
+}
+
+// Quantizes `rows` x `cols` row-major `src` to int8, and writes the
+// dequantization scale of each row to `scales`. In per tensor mode all rows
+// share the scale of the largest magnitude.
+template <typename T>
+void QuantizeActivation(const CPUDevice& d, const T* src, int64 rows,
+                        int64 cols, bool per_row, int8* dst, float* scales) {
+  const Eigen::TensorOpCost cost(cols * sizeof(T), 0, cols);
+  d.parallelFor(rows, cost, [&](int64 begin, int64 end) {
+    for (int64 r = begin; r < end; ++r) {
+      const T* row = src + r * cols;
+      float max_abs = 0.0f;
+      for (int64 c = 0; c < cols; ++c) {
+        max_abs = std::max(max_abs, std::abs(static_cast<float>(row[c])));
+      }
+      scales[r] = max_abs;
+    }
+  });
+
+  if (per_row) {
+    for (int64 r = 0; r < rows; ++r) scales[r] = SymmetricScale(scales[r]);
+  } else {
+    const float scale =
+        SymmetricScale(*std::max_element(scales, scales + rows));
+    std::fill(scales, scales + rows, scale);
+  }
+
+  const Eigen::TensorOpCost quantize_cost(cols * sizeof(T), cols, 2 * cols);
+  d.parallelFor(rows, quantize_cost, [&](int64 begin, int64 end) {
+    for (int64 r = begin; r < end; ++r) {
+      const T* row = src + r * cols;
+      int8* q_row = dst + r * cols;
+      const float inv_scale = 1.0f / scales[r];
+      for (int64 c = 0; c < cols; ++c) {
+        q_row[c] = QuantizeValue(static_cast<float>(row[c]), inv_scale);
+      }
+    }
+  });
+}
+
+// Quantizes the `k` x `n` weight to int8 with one scale per output channel.
+// The weight is stored [k, n], or [n, k] if `transpose`, and keeps its layout.
+template <typename T>
+void QuantizeWeight(const CPUDevice& d, const T* weight, int64 k, int64 n,
+                    bool transpose, int8* dst, float* scales) {
+  const Eigen::TensorOpCost cost(k * sizeof(T), k, 3 * k);
+  d.parallelFor(n, cost, [&](int64 begin, int64 end) {
+    if (transpose) {
+      // Each output channel is a contiguous row.
+      for (int64 c = begin; c < end; ++c) {
+        const T* row = weight + c * k;
+        float max_abs = 0.0f;
+        for (int64 i = 0; i < k; ++i) {
+          max_abs = std::max(max_abs, std::abs(static_cast<float>(row[i])));
+        }
+        scales[c] = SymmetricScale(max_abs);
+        const float inv_scale = 1.0f / scales[c];
+        for (int64 i = 0; i < k; ++i) {
+          dst[c * k + i] = QuantizeValue(static_cast<float>(row[i]), inv_scale);
+        }
+      }
+      return;
+    }
+    // Output channels are columns, walk the rows of the block of columns.
+    std::vector<float> max_abs(end - begin, 0.0f);
+    for (int64 i = 0; i < k; ++i) {
+      const T* row = weight + i * n;
+      for (int64 c = begin; c < end; ++c) {
+        max_abs[c - begin] =
+            std::max(max_abs[c - begin], std::abs(static_cast<float>(row[c])));
+      }
+    }
+    for (int64 c = begin; c < end; ++c) {
+      scales[c] = SymmetricScale(max_abs[c - begin]);
+    }
+    for (int64 i = 0; i < k; ++i) {
+      const T* row = weight + i * n;
+      for (int64 c = begin; c < end; ++c) {
+        dst[i * n + c] =
+            QuantizeValue(static_cast<float>(row[c]), 1.0f / scales[c]);
+      }
+    }
+  });
+}
+
+}  // namespace
+
+// MatMul of a float activation and a constant float weight, computed in int8.
+// The weight is quantized once per output channel and its reordered copy is
+// cached. The activation is quantized on every call, per tensor or per row,
+// from its current range, so no calibration is needed. The int8 product is
+// dequantized by the weight scales and a post op multiplying the row scales,
+// followed by the fused bias and activation post ops.
+//
+// Inputs of rank > 2 are flattened to rows, so the weight must be 2D after
+// dropping leading dims of size 1, and the activation can't be transposed.
+// The graph rewrite only emits this op for such MatMul and BatchMatMulV2.
+template <typename Device, typename T>
+class DynamicQuantizedMatMulOp : public OpKernel {
+ public:
+  explicit DynamicQuantizedMatMulOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("transpose_b", &transpose_b_));
+
+    string mode;
+    OP_REQUIRES_OK(context, context->GetAttr("quantization_mode", &mode));
+    per_row_ = (mode == "PER_ROW");
+
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    // The row scales are applied first, then the bias and activation.
+    std::vector<string> post_ops = {"BinaryMul"};
+    for (const string& op : fused_ops) {
+      if (op == "BiasAdd") {
+        has_bias_ = true;
+        post_ops.push_back("BinaryAdd");
+      } else {
+        OP_REQUIRES(context, PostOpUtil::IsSupportedActivation(op),
+                    errors::InvalidArgument(
+                        "Found unsupported fusion in DynamicQuantizedMatMul: ",
+                        op));
+        post_ops.push_back(op);
+      }
+    }
+    OP_REQUIRES(context, post_op_util_.AddOps(post_ops),
+                errors::InvalidArgument(
+                    "Found unsupported fusion in DynamicQuantizedMatMul."));
+    if (post_op_util_.HasLeakyRelu()) {
+      float alpha;
+      OP_REQUIRES_OK(context, context->GetAttr("leakyrelu_alpha", &alpha));
+      post_op_util_.SetLeakyReluAlpha(alpha);
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& src_tensor = context->input(kSrcIndex_);
+    const Tensor& weights_tensor = context->input(kWeightIndex_);
+    OP_REQUIRES(context, src_tensor.dims() >= 2,
+                errors::InvalidArgument("In[0] ndims must be >= 2: ",
+                                        src_tensor.dims()));
+    OP_REQUIRES(context, weights_tensor.dims() >= 2,
+                errors::InvalidArgument("In[1] ndims must be >= 2: ",
+                                        weights_tensor.dims()));
+    for (int i = 0; i < weights_tensor.dims() - 2; ++i) {
+      OP_REQUIRES(context, weights_tensor.dim_size(i) == 1,
+                  errors::InvalidArgument(
+                      "DynamicQuantizedMatMul requires a 2D weight, got ",
+                      weights_tensor.shape().DebugString()));
+    }
+
+    MatMulBCast bcast(src_tensor.shape().dim_sizes(),
+                      weights_tensor.shape().dim_sizes());
+    OP_REQUIRES(context, bcast.IsValid(),
+                errors::InvalidArgument(
+                    "In[0] and In[1] must have compatible batch dimensions: ",
+                    src_tensor.shape().DebugString(), " vs. ",
+                    weights_tensor.shape().DebugString()));
+
+    const int kWeightsDims = weights_tensor.dims();
+    const int64 m = src_tensor.dim_size(src_tensor.dims() - 2);
+    const int64 k = src_tensor.dim_size(src_tensor.dims() - 1);
+    const int64 k_weights = weights_tensor.dim_size(
+        transpose_b_ ? kWeightsDims - 1 : kWeightsDims - 2);
+    const int64 n = weights_tensor.dim_size(transpose_b_ ? kWeightsDims - 2
+                                                         : kWeightsDims - 1);
+    OP_REQUIRES(context, k == k_weights,
+                errors::InvalidArgument(
+                    "Matrix size-incompatible: In[0]: ",
+                    src_tensor.shape().DebugString(),
+                    ", In[1]: ", weights_tensor.shape().DebugString()));
+    OP_REQUIRES(context, k > 0,
+                errors::InvalidArgument(
+                    "DynamicQuantizedMatMul requires a non-empty weight, got ",
+                    weights_tensor.shape().DebugString()));
+
+    TensorShape dst_shape = bcast.output_batch_shape();
+    dst_shape.AddDim(m);
+    dst_shape.AddDim(n);
+    Tensor* dst_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(kDstIndex_, dst_shape,
+                                                     &dst_tensor));
+    if (dst_shape.num_elements() == 0) return;
+
+    const CPUDevice& d = context->eigen_device<CPUDevice>();
+    {
+      mutex_lock lock(&mu_);
+      if (!is_weight_quantized_) {
+        OP_REQUIRES_OK(context,
+                       QuantizeConstWeight(context, weights_tensor, k, n));
+      }
+    }
+
+    // Weights carry no batch, so all batches of the activation are rows.
+    const int64 rows = src_tensor.NumElements() / k;
+    Tensor src_q_tensor, row_scales_tensor;
+    OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<qint8>::v(),
+                                                   TensorShape({rows * k}),
+                                                   &src_q_tensor));
+    OP_REQUIRES_OK(context, context->allocate_temp(DataTypeToEnum<float>::v(),
+                                                   TensorShape({rows}),
+                                                   &row_scales_tensor));
+    QuantizeActivation<T>(
+        d, src_tensor.flat<T>().data(), rows, k, per_row_,
+        reinterpret_cast<int8*>(GetTensorBuffer<qint8>(&src_q_tensor)),
+        row_scales_tensor.flat<float>().data());
+
+    try {
+      auto onednn_engine = CreateDnnlEngine<Device>(*context);
+      auto src_md =
+          memory::desc({rows, k}, OneDnnType<qint8>(), memory::format_tag::ab);
+      auto weights_md = memory::desc({k, n}, OneDnnType<qint8>(),
+                                     transpose_b_ ? memory::format_tag::ba
+                                                  : memory::format_tag::ab);
+      auto weights_md_prefer =
+          memory::desc({k, n}, OneDnnType<qint8>(), memory::format_tag::any);
+      auto dst_md =
+          memory::desc({rows, n}, OneDnnType<T>(), memory::format_tag::ab);
+      auto row_scales_md = memory::desc({rows, 1}, OneDnnType<float>(),
+                                        memory::format_tag::ab);
+      auto bias_md =
+          memory::desc({1, n}, OneDnnType<T>(), memory::format_tag::ab);
+      std::vector<memory::desc> binary_mds = {row_scales_md};
+      if (has_bias_) binary_mds.push_back(bias_md);
+
+      OneDnnKeyCreator key_creator;
+      key_creator.AddAsKey("dynamic_quantized_matmul");
+      key_creator.AddAsKey(onednn_engine);
+      key_creator.AddAsKey(src_md);
+      key_creator.AddAsKey(weights_md_prefer);
+      key_creator.AddAsKey(dst_md);
+      post_op_util_.AddAsKey(&key_creator);
+
+      auto create_pd = [&]() {
+        dnnl::primitive_attr attr;
+        attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+        post_op_util_.SetPostOpAttr(&attr, binary_mds);
+        // Per output channel weight scales, passed at execution.
+#ifdef ITEX_ONEDNN_3_0
+        attr.set_scales_mask(DNNL_ARG_WEIGHTS, 1 << 1);
+        return dnnl::matmul::primitive_desc(onednn_engine, src_md,
+                                            weights_md_prefer, dst_md, attr);
+#else
+        attr.set_output_scales(1 << 1, {DNNL_RUNTIME_F32_VAL});
+        auto matmul_desc =
+            dnnl::matmul::desc(src_md, weights_md_prefer, dst_md);
+        return dnnl::matmul::primitive_desc(matmul_desc, attr, onednn_engine);
+#endif
+      };
+      auto cached = MatMulPrimitiveCache::GetInstance()->FindOrCreate(
+          key_creator.GetKey(), create_pd);
+      const dnnl::matmul::primitive_desc& matmul_pd = cached.pd;
+
+      // Reorder the quantized weight to the format the primitive prefers,
+      // and cache it. The format may change with the number of rows, then
+      // reorder it again for this call only.
+      void* weights_q_data =
+          GetTensorBuffer<qint8>(weights_q_.AccessTensor(context));
+      auto weights_mem =
+          CreateDnnlMemory(weights_md, onednn_engine, weights_q_data);
+      Tensor tmp_weight;
+      if (weights_md != matmul_pd.weights_desc()) {
+        {
+          mutex_lock lock(&mu_);
+          if (weight_cache_manager_.IsEmpty()) {
+            weight_cache_manager_.SetCache(context, weights_md,
+                                           matmul_pd.weights_desc(),
+                                           weights_q_data, onednn_engine);
+          }
+        }
+        qint8* weight_cached_data =
+            weight_cache_manager_.GetCache(context, matmul_pd.weights_desc());
+        if (weight_cached_data != nullptr) {
+          weights_mem = CreateDnnlMemory(matmul_pd.weights_desc(),
+                                         onednn_engine, weight_cached_data);
+        } else {
+          int64 reorder_size = matmul_pd.weights_desc().get_size();
+          OP_REQUIRES_OK(context,
+                         context->allocate_temp(DataTypeToEnum<qint8>::v(),
+                                                TensorShape({reorder_size}),
+                                                &tmp_weight));
+          auto reorder_mem =
+              CreateDnnlMemory(matmul_pd.weights_desc(), onednn_engine,
+                               GetTensorBuffer<qint8>(&tmp_weight));
+          ReorderMemory(*context, &weights_mem, &reorder_mem, onednn_engine);
+          weights_mem = reorder_mem;
+        }
+      }
+
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(
+                                  context, matmul_pd.scratchpad_desc(),
+                                  onednn_engine));
+
+      std::unordered_map<int, memory> args = {
+          {DNNL_ARG_SRC,
+           CreateDnnlMemory(src_md, onednn_engine,
+                            GetTensorBuffer<qint8>(&src_q_tensor))},
+          {DNNL_ARG_WEIGHTS, weights_mem},
+          {DNNL_ARG_DST, CreateDnnlMemory(dst_md, onednn_engine,
+                                          GetTensorBuffer<T>(dst_tensor))},
+          {DNNL_ARG_SCRATCHPAD, scratchpad.memory()},
+          {DNNL_ARG_ATTR_MULTIPLE_POST_OP(0) | DNNL_ARG_SRC_1,
+           CreateDnnlMemory(row_scales_md, onednn_engine,
+                            GetTensorBuffer<float>(&row_scales_tensor))}};
+      if (has_bias_) {
+        const Tensor& bias_tensor = context->input(kBiasIndex_);
+        OP_REQUIRES(context, bias_tensor.NumElements() == n,
+                    errors::InvalidArgument(
+                        "Bias must have ", n, " elements, got ",
+                        bias_tensor.shape().DebugString()));
+        args.emplace(DNNL_ARG_ATTR_MULTIPLE_POST_OP(1) | DNNL_ARG_SRC_1,
+                     CreateDnnlMemory(bias_md, onednn_engine,
+                                      GetTensorBuffer<T>(&bias_tensor)));
+      }
+      auto weight_scales_mem =
+          CreateDnnlMemory(memory::desc({n}, OneDnnType<float>(),
+                                        memory::format_tag::x),
+                           onednn_engine, weight_scales_.data());
+#ifdef ITEX_ONEDNN_3_0
+      args.emplace(DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS, weight_scales_mem);
+#else
+      args.emplace(DNNL_ARG_ATTR_OUTPUT_SCALES, weight_scales_mem);
+#endif
+
+      auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
+      cached.primitive.execute(onednn_stream, args);
+    } catch (dnnl::error& e) {
+      string error_msg = "Status: " + std::to_string(e.status) +
+                         ", message: " + string(e.message) + ", in file " +
+                         string(__FILE__) + ":" + std::to_string(__LINE__);
+      OP_REQUIRES_OK(
+          context,
+          errors::Aborted("Operation received an exception:", error_msg));
+    }
+  }
+
+ private:
+  Status QuantizeConstWeight(OpKernelContext* context, const Tensor& weights,
+                             int64 k, int64 n)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    Tensor* weights_q = nullptr;
+    TF_RETURN_IF_ERROR(context->allocate_persistent(
+        DataTypeToEnum<qint8>::v(), TensorShape({k * n}), &weights_q_,
+        &weights_q));
+    weight_scales_.resize(n);
+    int8* weights_q_data =
+        reinterpret_cast<int8*>(GetTensorBuffer<qint8>(weights_q));
+    QuantizeWeight<T>(context->eigen_device<CPUDevice>(),
+                      weights.flat<T>().data(), k, n, transpose_b_,
+                      weights_q_data, weight_scales_.data());
+    is_weight_quantized_ = true;
+    return Status::OK();
+  }
+
+  static const int kSrcIndex_ = 0, kDstIndex_ = 0, kWeightIndex_ = 1,
+                   kBiasIndex_ = 2;
+
+  bool transpose_b_ = false;
+  bool per_row_ = false;
+  bool has_bias_ = false;
+  PostOpUtil post_op_util_;
+
+  mutex mu_;
+  bool is_weight_quantized_ TF_GUARDED_BY(mu_) = false;
+  // Written once under `mu_`, read-only afterwards.
+  PersistentTensor weights_q_;
+  std::vector<float> weight_scales_;
+  WeightCacheManager<qint8> weight_cache_manager_;
+};
+
+#define REGISTER_KERNEL(TYPE)                                  \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXDynamicQuantizedMatMul") \
+                              .Device(DEVICE_CPU)              \
+                              .TypeConstraint<TYPE>("T"),      \
+                          DynamicQuantizedMatMulOp<CPUDevice, TYPE>);
+TF_CALL_CPU_NUMBER_TYPES(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+
+}  // namespace itex
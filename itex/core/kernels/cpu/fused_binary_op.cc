@@ -0,0 +1,315 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/tensor_shape.h"
+#include "itex/core/utils/types.h"
+#include "third_party/eigen3/Eigen/Core"
+
+namespace itex {
+
+namespace {
+
+// Elements of one chunk of an output row. A chunk goes through the whole
+// chain in a float buffer that stays in L1.
+constexpr int64 kChunkSize = 512;
+
+enum class BinaryOp { kAdd, kSub, kMul, kDiv, kMaximum, kMinimum };
+
+// One step of the chain, `acc = acc op input`, or `acc = input op acc` if
+// `swapped`.
+struct ChainStep {
+  BinaryOp op;
+  bool swapped;
+};
+
+// Output dims after merging adjacent dims which all inputs broadcast the same
+// way, and the strides of each input over them. A stride of 0 broadcasts the
+// input along that dim.
+struct ChainShape {
+  std::vector<int64> dims;
+  std::vector<std::vector<int64>> strides;
+};
+
+using FloatArray = Eigen::Map<Eigen::ArrayXf, Eigen::Unaligned>;
+template <typename T>
+using ConstArray =
+    Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>, Eigen::Unaligned>;
+template <typename T>
+using Array = Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>, Eigen::Unaligned>;
+
+Status ParseBinaryOp(const string& name, BinaryOp* op) {
+  if (name == "Add" || name == "AddV2") {
+    *op = BinaryOp::kAdd;
+  } else if (name == "Sub") {
+    *op = BinaryOp::kSub;
+  } else if (name == "Mul") {
+    *op = BinaryOp::kMul;
+  } else if (name == "RealDiv") {
+    *op = BinaryOp::kDiv;
+  } else if (name == "Maximum") {
+    *op = BinaryOp::kMaximum;
+  } else if (name == "Minimum") {
+    *op = BinaryOp::kMinimum;
+  } else {
+    return errors::InvalidArgument("Unsupported op in _ITEXFusedBinary: ",
+                                   name);
+  }
+  return Status::OK();
+}
+
+// Broadcasts all `inputs` to `output_shape` with numpy semantics.
+Status GetChainShape(const std::vector<const Tensor*>& inputs,
+                     TensorShape* output_shape, ChainShape* shape) {
+  int rank = 0;
+  for (const Tensor* input : inputs) rank = std::max(rank, input->dims());
+
+  std::vector<int64> dims(rank, 1);
+  for (const Tensor* input : inputs) {
+    const int offset = rank - input->dims();
+    for (int d = 0; d < input->dims(); ++d) {
+      const int64 size = input->dim_size(d);
+      if (dims[offset + d] == 1) {
+        dims[offset + d] = size;
+      } else if (size != 1 && size != dims[offset + d]) {
+        return errors::InvalidArgument(
+            "Incompatible shapes in _ITEXFusedBinary: ",
+            input->shape().DebugString(), " can't be broadcast to dim ",
+            offset + d, " of size ", dims[offset + d]);
+      }
+    }
+  }
+  *output_shape = TensorShape(dims);
+
+  // Contiguous strides of each input over the output dims.
+  std::vector<std::vector<int64>> strides(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    strides[i].resize(rank, 0);
+    const int offset = rank - inputs[i]->dims();
+    int64 stride = 1;
+    for (int d = inputs[i]->dims() - 1; d >= 0; --d) {
+      const int64 size = inputs[i]->dim_size(d);
+      strides[i][offset + d] = (size == 1) ? 0 : stride;
+      stride *= size;
+    }
+  }
+
+  // Drop dims of size 1, then merge a dim into the previous one if every
+  // input walks both of them as a single dim.
+  shape->dims.clear();
+  shape->strides.assign(inputs.size(), {});
+  for (int d = 0; d < rank; ++d) {
+    if (dims[d] == 1) continue;
+    bool mergeable = !shape->dims.empty();
+    for (size_t i = 0; i < inputs.size() && mergeable; ++i) {
+      mergeable = shape->strides[i].back() == strides[i][d] * dims[d];
+    }
+    if (mergeable) {
+      shape->dims.back() *= dims[d];
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        shape->strides[i].back() = strides[i][d];
+      }
+    } else {
+      shape->dims.push_back(dims[d]);
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        shape->strides[i].push_back(strides[i][d]);
+      }
+    }
+  }
+  if (shape->dims.empty()) {
+    shape->dims.push_back(1);
+    for (auto& input_strides : shape->strides) input_strides.push_back(0);
+  }
+  return Status::OK();
+}
+
+template <typename Rhs>
+void ApplyStep(const ChainStep& step, const Rhs& rhs, FloatArray* acc) {
+  switch (step.op) {
+    case BinaryOp::kAdd:
+      *acc += rhs;
+      break;
+    case BinaryOp::kSub:
+      if (step.swapped) {
+        *acc = rhs - *acc;
+      } else {
+        *acc -= rhs;
+      }
+      break;
+    case BinaryOp::kMul:
+      *acc *= rhs;
+      break;
+    case BinaryOp::kDiv:
+      if (step.swapped) {
+        *acc = rhs / *acc;
+      } else {
+        *acc /= rhs;
+      }
+      break;
+    case BinaryOp::kMaximum:
+      *acc = acc->max(rhs);
+      break;
+    case BinaryOp::kMinimum:
+      *acc = acc->min(rhs);
+      break;
+  }
+}
+
+}  // namespace
+
+// Evaluates a chain of binary ops fused by the remapper in one pass over the
+// output. Inputs broadcast with numpy semantics, as the ops of the chain do.
+// The output is split into chunks of rows, and each chunk is evaluated through
+// the whole chain in float before it is stored, so no intermediate tensor is
+// written to memory.
+//
+// The remapper adds the inputs from the root of the chain to its first op.
+// Input `num_args - 1` and `num_args - 2` are the operands of the first op,
+// and each later op takes the next input towards 0. `input_order` records
+// whether the running result is the first or the second operand of each op.
+template <typename Device, typename T>
+class FusedBinaryOp : public OpKernel {
+ public:
+  explicit FusedBinaryOp(OpKernelConstruction* context) : OpKernel(context) {
+    std::vector<int> input_order;
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("input_order", &input_order));
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    // The first op of the chain takes its operands in order.
+    input_order.push_back(0);
+    OP_REQUIRES(context, input_order.size() == fused_ops.size(),
+                errors::InvalidArgument(
+                    "input_order and fused_ops must have same size. ",
+                    input_order.size(), " vs ", fused_ops.size()));
+
+    // `fused_ops` starts from the root, steps run from the first op.
+    steps_.resize(fused_ops.size());
+    for (size_t i = 0; i < fused_ops.size(); ++i) {
+      ChainStep& step = steps_[fused_ops.size() - 1 - i];
+      OP_REQUIRES_OK(context, ParseBinaryOp(fused_ops[i], &step.op));
+      step.swapped = (input_order[i] == 1);
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const int num_inputs = context->num_inputs();
+    OP_REQUIRES(context, num_inputs == static_cast<int>(steps_.size()) + 1,
+                errors::InvalidArgument("_ITEXFusedBinary expects ",
+                                        steps_.size() + 1, " inputs, got ",
+                                        num_inputs));
+    // Inputs in the order the chain consumes them.
+    std::vector<const Tensor*> inputs(num_inputs);
+    for (int i = 0; i < num_inputs; ++i) {
+      inputs[i] = &context->input(num_inputs - 1 - i);
+    }
+
+    TensorShape output_shape;
+    ChainShape shape;
+    OP_REQUIRES_OK(context, GetChainShape(inputs, &output_shape, &shape));
+
+    // An input of the output shape is read at the same position as the
+    // output is written, so it can be reused in place.
+    std::vector<int> candidates;
+    for (int i = 0; i < num_inputs; ++i) {
+      if (context->input(i).shape() == output_shape) candidates.push_back(i);
+    }
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                candidates, 0, output_shape, &output));
+    if (output_shape.num_elements() == 0) return;
+
+    const int outer_dims = shape.dims.size() - 1;
+    const int64 inner = shape.dims.back();
+    const int64 rows = output_shape.num_elements() / inner;
+    const int64 chunks_per_row = (inner + kChunkSize - 1) / kChunkSize;
+    const int64 chunk_size = std::min(inner, kChunkSize);
+
+    std::vector<const T*> input_data(num_inputs);
+    for (int i = 0; i < num_inputs; ++i) {
+      input_data[i] = inputs[i]->flat<T>().data();
+    }
+    T* output_data = output->flat<T>().data();
+
+    auto eval_chunks = [&](int64 begin, int64 end) {
+      float acc_buf[kChunkSize];
+      std::vector<int64> offsets(num_inputs);
+      for (int64 chunk = begin; chunk < end; ++chunk) {
+        const int64 row = chunk / chunks_per_row;
+        const int64 col = (chunk % chunks_per_row) * kChunkSize;
+        const int64 len = std::min(kChunkSize, inner - col);
+
+        std::fill(offsets.begin(), offsets.end(), 0);
+        int64 remain = row;
+        for (int d = outer_dims - 1; d >= 0; --d) {
+          const int64 index = remain % shape.dims[d];
+          remain /= shape.dims[d];
+          for (int i = 0; i < num_inputs; ++i) {
+            offsets[i] += index * shape.strides[i][d];
+          }
+        }
+
+        FloatArray acc(acc_buf, len);
+        for (int i = 0; i < num_inputs; ++i) {
+          const T* data = input_data[i] + offsets[i];
+          const bool is_broadcast = (shape.strides[i][outer_dims] == 0);
+          if (i == 0) {
+            if (is_broadcast) {
+              acc.setConstant(static_cast<float>(data[0]));
+            } else {
+              acc = ConstArray<T>(data + col, len).template cast<float>();
+            }
+          } else if (is_broadcast) {
+            ApplyStep(steps_[i - 1], static_cast<float>(data[0]), &acc);
+          } else {
+            ApplyStep(steps_[i - 1],
+                      ConstArray<T>(data + col, len).template cast<float>(),
+                      &acc);
+          }
+        }
+        Array<T>(output_data + row * inner + col, len) =
+            acc.template cast<T>();
+      }
+    };
+
+    const Eigen::TensorOpCost cost(chunk_size * num_inputs * sizeof(T),
+                                   chunk_size * sizeof(T),
+                                   chunk_size * steps_.size());
+    context->eigen_cpu_device().parallelFor(rows * chunks_per_row, cost,
+                                            eval_chunks);
+  }
+
+ private:
+  std::vector<ChainStep> steps_;
+};
+
+#define REGISTER_FUSED_BINARY_CPU(TYPE)                                      \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("_ITEXFusedBinary").Device(DEVICE_CPU).TypeConstraint<TYPE>("T"), \
+      FusedBinaryOp<CPUDevice, TYPE>)
+// The chain is evaluated in float, so only float and bfloat16, which the
+// remapper fuses on CPU, are registered.
+TF_CALL_float(REGISTER_FUSED_BINARY_CPU);
+TF_CALL_bfloat16(REGISTER_FUSED_BINARY_CPU);
+#undef REGISTER_FUSED_BINARY_CPU
+
+}  // namespace itex
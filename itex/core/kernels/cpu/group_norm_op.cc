@@ -0,0 +1,488 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+#include "third_party/eigen3/Eigen/Core"
+
+namespace itex {
+
+namespace {
+
+// Elements of one block of rows. A block of input, plus the per channel
+// accumulators, stays in L2 while it is reduced.
+constexpr int64 kBlockElements = 16 * 1024;
+
+// NHWC sizes of a group norm, all spatial dims are flattened into `hw`.
+struct GroupNormShape {
+  int64 batch;
+  int64 hw;
+  int64 channels;
+  int64 groups;
+  int64 chans_per_group;
+  // Rows of `channels` elements per block, and blocks per image.
+  int64 block_rows;
+  int64 num_blocks;
+};
+
+using ConstFloatArray = Eigen::Map<const Eigen::ArrayXf, Eigen::Unaligned>;
+using FloatArray = Eigen::Map<Eigen::ArrayXf, Eigen::Unaligned>;
+
+template <typename T>
+using ConstArray =
+    Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>, Eigen::Unaligned>;
+template <typename T>
+using Array = Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>, Eigen::Unaligned>;
+
+Status GetGroupNormShape(const Tensor& input, int num_groups,
+                         GroupNormShape* s) {
+  if (input.dims() < 3) {
+    return errors::InvalidArgument("input must be at least 3-dimensional",
+                                   input.shape().DebugString());
+  }
+  s->batch = input.dim_size(0);
+  s->channels = input.dim_size(input.dims() - 1);
+  if (num_groups <= 0 || s->channels % num_groups != 0) {
+    return errors::InvalidArgument("Number of groups (", num_groups,
+                                   ") must divide the number of channels (",
+                                   s->channels, ")");
+  }
+  s->hw = s->batch * s->channels == 0
+              ? 0
+              : input.NumElements() / s->batch / s->channels;
+  s->groups = num_groups;
+  s->chans_per_group = s->channels / num_groups;
+  s->block_rows = std::max<int64>(1, kBlockElements / s->channels);
+  s->num_blocks = (s->hw + s->block_rows - 1) / s->block_rows;
+  return Status::OK();
+}
+
+// Returns gamma and beta as float, or the identity transform if unused.
+template <typename T>
+Status GetAffine(const Tensor& gamma, const Tensor& beta, bool use_scale,
+                 bool use_center, int64 channels, std::vector<float>* scale,
+                 std::vector<float>* offset) {
+  scale->assign(channels, 1.0f);
+  offset->assign(channels, 0.0f);
+  if (use_scale) {
+    if (gamma.dims() != 1 || gamma.NumElements() != channels) {
+      return errors::InvalidArgument("gamma must be 1-dimensional with ",
+                                     channels, " elements, got ",
+                                     gamma.shape().DebugString());
+    }
+    auto gamma_vec = gamma.vec<T>();
+    for (int64 c = 0; c < channels; ++c) {
+      (*scale)[c] = static_cast<float>(gamma_vec(c));
+    }
+  }
+  if (use_center) {
+    if (beta.dims() != 1 || beta.NumElements() != channels) {
+      return errors::InvalidArgument("beta must be 1-dimensional with ",
+                                     channels, " elements, got ",
+                                     beta.shape().DebugString());
+    }
+    auto beta_vec = beta.vec<T>();
+    for (int64 c = 0; c < channels; ++c) {
+      (*offset)[c] = static_cast<float>(beta_vec(c));
+    }
+  }
+  return Status::OK();
+}
+
+// Computes per (image, channel) `norm_scale` and `norm_shift`, so that the
+// normalized input is x * norm_scale + norm_shift. The first pass reduces
+// each block of rows into per channel sums, which vectorize over the
+// contiguous channels, then folds them into per group partial sums. The
+// second pass combines the partial sums of every (image, group).
+template <typename T>
+void ComputeGroupStats(const CPUDevice& d, const T* x, const GroupNormShape& s,
+                       float epsilon, float* partial, float* norm_scale,
+                       float* norm_shift) {
+  const int64 channels = s.channels;
+  const int64 groups = s.groups;
+  const int64 cpg = s.chans_per_group;
+  const int64 block_elements = s.block_rows * channels;
+
+  d.parallelFor(
+      s.batch * s.num_blocks,
+      Eigen::TensorOpCost(sizeof(T) * block_elements, 0, 3 * block_elements),
+      [&](Eigen::Index first, Eigen::Index last) {
+        Eigen::ArrayXf sum(channels), square_sum(channels);
+        for (Eigen::Index shard = first; shard < last; ++shard) {
+          const int64 n = shard / s.num_blocks;
+          const int64 row_begin = (shard % s.num_blocks) * s.block_rows;
+          const int64 row_end = std::min(row_begin + s.block_rows, s.hw);
+          sum.setZero();
+          square_sum.setZero();
+          for (int64 row = row_begin; row < row_end; ++row) {
+            auto v = ConstArray<T>(x + (n * s.hw + row) * channels, channels)
+                         .template cast<float>();
+            sum += v;
+            square_sum += v.square();
+          }
+          float* out = partial + shard * groups * 2;
+          for (int64 g = 0; g < groups; ++g) {
+            out[2 * g] = sum.segment(g * cpg, cpg).sum();
+            out[2 * g + 1] = square_sum.segment(g * cpg, cpg).sum();
+          }
+        }
+      });
+
+  const double count = static_cast<double>(s.hw * cpg);
+  d.parallelFor(s.batch * groups,
+                Eigen::TensorOpCost(sizeof(float) * 2 * s.num_blocks,
+                                    sizeof(float) * 2 * cpg,
+                                    2 * s.num_blocks + 2 * cpg),
+                [&](Eigen::Index first, Eigen::Index last) {
+                  for (Eigen::Index i = first; i < last; ++i) {
+                    const int64 n = i / groups;
+                    const int64 g = i % groups;
+                    double sum = 0, square_sum = 0;
+                    for (int64 b = 0; b < s.num_blocks; ++b) {
+                      const float* in =
+                          partial + ((n * s.num_blocks + b) * groups + g) * 2;
+                      sum += in[0];
+                      square_sum += in[1];
+                    }
+                    const double mean = sum / count;
+                    const double var =
+                        std::max(square_sum / count - mean * mean, 0.0);
+                    const float inv = 1.0f / std::sqrt(var + epsilon);
+                    for (int64 c = g * cpg; c < (g + 1) * cpg; ++c) {
+                      norm_scale[n * channels + c] = inv;
+                      norm_shift[n * channels + c] = -mean * inv;
+                    }
+                  }
+                });
+}
+
+}  // namespace
+
+// Group normalization of NHWC input on CPU, optionally followed by Swish.
+// Statistics take one pass over the input and normalization a second one,
+// both split among the intra-op threads by blocks of rows of all images.
+template <typename Device, typename T, bool fuse_activation = false>
+class GroupNormOp : public OpKernel {
+ public:
+  explicit GroupNormOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("num_groups", &num_groups_));
+    OP_REQUIRES_OK(context, context->GetAttr("epsilon", &epsilon_));
+    OP_REQUIRES_OK(context, context->GetAttr("use_scale", &use_scale_));
+    OP_REQUIRES_OK(context, context->GetAttr("use_center", &use_center_));
+    if (fuse_activation) {
+      string activation_mode;
+      OP_REQUIRES_OK(context,
+                     context->GetAttr("activation_mode", &activation_mode));
+      OP_REQUIRES(context, activation_mode == "Swish",
+                  errors::Unimplemented("_ITEXFusedGroupNorm activation_mode "
+                                        "only supports Swish, got ",
+                                        activation_mode));
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    const Tensor& gamma = context->input(1);
+    const Tensor& beta = context->input(2);
+
+    GroupNormShape s;
+    OP_REQUIRES_OK(context, GetGroupNormShape(input, num_groups_, &s));
+    std::vector<float> scale, offset;
+    OP_REQUIRES_OK(context,
+                   GetAffine<T>(gamma, beta, use_scale_, use_center_,
+                                s.channels, &scale, &offset));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, input.shape(), &output));
+    if (input.NumElements() == 0) return;
+
+    // Partial sums of all blocks, then per (image, channel) scale and shift.
+    const int64 partial_size = s.batch * s.num_blocks * s.groups * 2;
+    const int64 nc = s.batch * s.channels;
+    Tensor temp;
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_FLOAT,
+                                          TensorShape({partial_size + 2 * nc}),
+                                          &temp));
+    float* partial = temp.flat<float>().data();
+    float* norm_scale = partial + partial_size;
+    float* norm_shift = norm_scale + nc;
+
+    const CPUDevice& d = context->eigen_cpu_device();
+    const T* x = input.flat<T>().data();
+    T* y = output->flat<T>().data();
+    ComputeGroupStats(d, x, s, epsilon_, partial, norm_scale, norm_shift);
+
+    // Fold gamma and beta into the per channel scale and shift.
+    for (int64 i = 0; i < nc; ++i) {
+      const int64 c = i % s.channels;
+      norm_scale[i] *= scale[c];
+      norm_shift[i] = norm_shift[i] * scale[c] + offset[c];
+    }
+
+    const int64 channels = s.channels;
+    const int64 hw = s.hw;
+    d.parallelFor(
+        s.batch * hw,
+        Eigen::TensorOpCost(sizeof(T) * channels, sizeof(T) * channels,
+                            (fuse_activation ? 8 : 2) * channels),
+        [&](Eigen::Index first, Eigen::Index last) {
+          Eigen::ArrayXf v(channels);
+          for (Eigen::Index row = first; row < last; ++row) {
+            const int64 n = row / hw;
+            v = ConstArray<T>(x + row * channels, channels)
+                        .template cast<float>() *
+                    ConstFloatArray(norm_scale + n * channels, channels) +
+                ConstFloatArray(norm_shift + n * channels, channels);
+            Array<T> out(y + row * channels, channels);
+            if (fuse_activation) {
+              out = (v / (1.0f + (-v).exp())).template cast<T>();
+            } else {
+              out = v.template cast<T>();
+            }
+          }
+        });
+  }
+
+ private:
+  int num_groups_;
+  bool use_scale_;
+  bool use_center_;
+  float epsilon_;
+};
+
+// Gradient of ITEXGroupNorm. The statistics are recomputed from the input,
+// then one pass reduces the per channel sums of dy and dy * x_hat, and a last
+// pass writes
+//   dx = inv * (dy * gamma - mean(dy * gamma) -
+//               x_hat * mean(dy * gamma * x_hat))
+// with the means taken over each (image, group).
+template <typename Device, typename T>
+class GroupNormGradOp : public OpKernel {
+ public:
+  explicit GroupNormGradOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("num_groups", &num_groups_));
+    OP_REQUIRES_OK(context, context->GetAttr("epsilon", &epsilon_));
+    OP_REQUIRES_OK(context, context->GetAttr("use_scale", &use_scale_));
+    OP_REQUIRES_OK(context, context->GetAttr("use_center", &use_center_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& y_backprop = context->input(0);
+    const Tensor& input = context->input(1);
+    const Tensor& gamma = context->input(2);
+    const Tensor& beta = context->input(3);
+    OP_REQUIRES(context, y_backprop.shape() == input.shape(),
+                errors::InvalidArgument(
+                    "y_backprop and x must have the same shape, got ",
+                    y_backprop.shape().DebugString(), " and ",
+                    input.shape().DebugString()));
+
+    GroupNormShape s;
+    OP_REQUIRES_OK(context, GetGroupNormShape(input, num_groups_, &s));
+    std::vector<float> scale, offset;
+    OP_REQUIRES_OK(context,
+                   GetAffine<T>(gamma, beta, use_scale_, use_center_,
+                                s.channels, &scale, &offset));
+
+    Tensor* x_backprop = nullptr;
+    Tensor* scale_backprop = nullptr;
+    Tensor* offset_backprop = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, input.shape(), &x_backprop));
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, gamma.shape(), &scale_backprop));
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(2, beta.shape(), &offset_backprop));
+    scale_backprop->flat<T>().setZero();
+    offset_backprop->flat<T>().setZero();
+    if (input.NumElements() == 0) return;
+
+    const int64 channels = s.channels;
+    const int64 groups = s.groups;
+    const int64 cpg = s.chans_per_group;
+    const int64 hw = s.hw;
+    const int64 nc = s.batch * channels;
+    const int64 num_shards = s.batch * s.num_blocks;
+    // The statistics partial sums are dead once the channel partial sums are
+    // written, so both share the start of the buffer.
+    const int64 partial_size = std::max(num_shards * groups * 2,
+                                        num_shards * channels * 2);
+    Tensor temp;
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_FLOAT,
+                                          TensorShape({partial_size + 7 * nc}),
+                                          &temp));
+    float* partial = temp.flat<float>().data();
+    float* norm_scale = partial + partial_size;
+    float* norm_shift = norm_scale + nc;
+    float* sum_dy = norm_shift + nc;
+    float* sum_dy_x_hat = sum_dy + nc;
+    float* dy_scale = sum_dy_x_hat + nc;
+    float* x_scale = dy_scale + nc;
+    float* dx_shift = x_scale + nc;
+
+    const CPUDevice& d = context->eigen_cpu_device();
+    const T* dy = y_backprop.flat<T>().data();
+    const T* x = input.flat<T>().data();
+    ComputeGroupStats(d, x, s, epsilon_, partial, norm_scale, norm_shift);
+
+    // Per channel sums of dy and dy * x_hat of every block.
+    const int64 block_elements = s.block_rows * channels;
+    d.parallelFor(
+        num_shards,
+        Eigen::TensorOpCost(2 * sizeof(T) * block_elements, 0,
+                            5 * block_elements),
+        [&](Eigen::Index first, Eigen::Index last) {
+          for (Eigen::Index shard = first; shard < last; ++shard) {
+            const int64 n = shard / s.num_blocks;
+            const int64 row_begin = (shard % s.num_blocks) * s.block_rows;
+            const int64 row_end = std::min(row_begin + s.block_rows, hw);
+            FloatArray block_dy(partial + shard * channels * 2, channels);
+            FloatArray block_dy_x_hat(
+                partial + shard * channels * 2 + channels, channels);
+            ConstFloatArray a(norm_scale + n * channels, channels);
+            ConstFloatArray b(norm_shift + n * channels, channels);
+            block_dy.setZero();
+            block_dy_x_hat.setZero();
+            for (int64 row = row_begin; row < row_end; ++row) {
+              const int64 offset = (n * hw + row) * channels;
+              auto g =
+                  ConstArray<T>(dy + offset, channels).template cast<float>();
+              auto v =
+                  ConstArray<T>(x + offset, channels).template cast<float>();
+              block_dy += g;
+              block_dy_x_hat += g * (v * a + b);
+            }
+          }
+        });
+
+    // Combine the blocks of every image, and fold the group means into
+    // per channel coefficients, so that dx = dy * dy_scale + x * x_scale +
+    // dx_shift.
+    const float count = static_cast<float>(hw * cpg);
+    d.parallelFor(
+        s.batch * groups,
+        Eigen::TensorOpCost(sizeof(float) * 2 * s.num_blocks * cpg,
+                            sizeof(float) * 5 * cpg,
+                            2 * s.num_blocks * cpg + 10 * cpg),
+        [&](Eigen::Index first, Eigen::Index last) {
+          for (Eigen::Index i = first; i < last; ++i) {
+            const int64 n = i / groups;
+            const int64 c_begin = n * channels + (i % groups) * cpg;
+            const int64 c_end = c_begin + cpg;
+            for (int64 j = c_begin; j < c_end; ++j) {
+              sum_dy[j] = 0;
+              sum_dy_x_hat[j] = 0;
+            }
+            for (int64 b = 0; b < s.num_blocks; ++b) {
+              const float* in = partial + (n * s.num_blocks + b) * channels * 2;
+              for (int64 j = c_begin; j < c_end; ++j) {
+                const int64 c = j - n * channels;
+                sum_dy[j] += in[c];
+                sum_dy_x_hat[j] += in[channels + c];
+              }
+            }
+            float mean_dy = 0, mean_dy_x_hat = 0;
+            for (int64 j = c_begin; j < c_end; ++j) {
+              const float gamma_c = scale[j - n * channels];
+              mean_dy += gamma_c * sum_dy[j];
+              mean_dy_x_hat += gamma_c * sum_dy_x_hat[j];
+            }
+            mean_dy /= count;
+            mean_dy_x_hat /= count;
+            for (int64 j = c_begin; j < c_end; ++j) {
+              const float inv = norm_scale[j];
+              dy_scale[j] = inv * scale[j - n * channels];
+              x_scale[j] = -inv * inv * mean_dy_x_hat;
+              dx_shift[j] = -inv * (mean_dy + norm_shift[j] * mean_dy_x_hat);
+            }
+          }
+        });
+
+    if (use_scale_ || use_center_) {
+      std::vector<double> dgamma(channels, 0.0), dbeta(channels, 0.0);
+      for (int64 j = 0; j < nc; ++j) {
+        dgamma[j % channels] += sum_dy_x_hat[j];
+        dbeta[j % channels] += sum_dy[j];
+      }
+      if (use_scale_) {
+        auto scale_backprop_vec = scale_backprop->vec<T>();
+        for (int64 c = 0; c < channels; ++c) {
+          scale_backprop_vec(c) = static_cast<T>(dgamma[c]);
+        }
+      }
+      if (use_center_) {
+        auto offset_backprop_vec = offset_backprop->vec<T>();
+        for (int64 c = 0; c < channels; ++c) {
+          offset_backprop_vec(c) = static_cast<T>(dbeta[c]);
+        }
+      }
+    }
+
+    T* dx = x_backprop->flat<T>().data();
+    d.parallelFor(
+        s.batch * hw,
+        Eigen::TensorOpCost(2 * sizeof(T) * channels, sizeof(T) * channels,
+                            4 * channels),
+        [&](Eigen::Index first, Eigen::Index last) {
+          for (Eigen::Index row = first; row < last; ++row) {
+            const int64 n = row / hw;
+            auto g = ConstArray<T>(dy + row * channels, channels)
+                         .template cast<float>();
+            auto v = ConstArray<T>(x + row * channels, channels)
+                         .template cast<float>();
+            Array<T>(dx + row * channels, channels) =
+                (g * ConstFloatArray(dy_scale + n * channels, channels) +
+                 v * ConstFloatArray(x_scale + n * channels, channels) +
+                 ConstFloatArray(dx_shift + n * channels, channels))
+                    .template cast<T>();
+          }
+        });
+  }
+
+ private:
+  int num_groups_;
+  bool use_scale_;
+  bool use_center_;
+  float epsilon_;
+};
+
+#define REGISTER_CPU(T)                                                   \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("ITEXGroupNorm").Device(DEVICE_CPU).TypeConstraint<T>("T"),    \
+      GroupNormOp<CPUDevice, T>);                                         \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_ITEXFusedGroupNorm").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      GroupNormOp<CPUDevice, T, true>);                                   \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("ITEXGroupNormGrad").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      GroupNormGradOp<CPUDevice, T>);
+
+TF_CALL_CPU_NUMBER_TYPES(REGISTER_CPU);
+TF_CALL_half(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace itex
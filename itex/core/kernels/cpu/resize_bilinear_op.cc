@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "itex/core/kernels/cpu/resize_op_cpu.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
 #include "itex/core/utils/onednn/onednn_util.h"
@@ -29,6 +30,9 @@ using dnnl::primitive;
 using dnnl::prop_kind;
 
 namespace itex {
+// Bilinear resize with all align_corners and half_pixel_centers combinations.
+// The interpolation tables only depend on the input and output sizes, so they
+// are computed once and reused by later calls with the same sizes.
 template <typename Device, typename T>
 class ResizeBilinearOp : public OpKernel {
  public:
@@ -36,128 +40,37 @@ class ResizeBilinearOp : public OpKernel {
     OP_REQUIRES_OK(context, context->GetAttr("align_corners", &align_corners_));
     OP_REQUIRES_OK(
         context, context->GetAttr("half_pixel_centers", &half_pixel_centers_));
-    ITEX_CHECK_EQ(align_corners_, false);
-    ITEX_CHECK_EQ(half_pixel_centers_, true);
+    OP_REQUIRES(context, !(align_corners_ && half_pixel_centers_),
+                errors::InvalidArgument("If half_pixel_centers is True, "
+                                        "align_corners must be False."));
   }
 
   void Compute(OpKernelContext* context) override {
-    try {
-      auto onednn_engine = CreateDnnlEngine<Device>(*context);
-
-      const size_t src_index = 0;  // index of src input tensor
-      const size_t dst_index = 0;  // index of dst output tensor
-      const Tensor& src_tensor = context->input(src_index);
-      const Tensor& size_tensor = context->input(1);
-
-      TensorShape src_tf_shape = src_tensor.shape();
-
-      TensorShape dst_tf_shape;
-
-      Tensor* dst_tensor = nullptr;
-      // Nothing to compute, return.
-      if (src_tf_shape.num_elements() == 0) {
-        OP_REQUIRES_OK(context,
-                       context->forward_input_or_allocate_output(
-                           {src_index}, dst_index, src_tf_shape, &dst_tensor));
-        return;
-      }
-
-      memory::dims src_dims;
-      memory::desc src_md;
-
-      src_dims = TFShapeToOneDnnDimsInNC(src_tf_shape, FORMAT_NHWC);
-      // Create `plain` onednn memory descriptor
-      // src_md = CreatePlainMemDescWithFormatTag<T>(src_dims);
-      src_md = memory::desc(src_dims, OneDnnType<T>(),
-                            dnnl::memory::format_tag::nhwc);
-
-      auto batch_size = src_tf_shape.dim_size(0);
-      auto channel = src_tf_shape.dim_size(3);
-      auto output_height = size_tensor.vec<int32>()(0);
-      auto output_width = size_tensor.vec<int32>()(1);
-      memory::dims dst_dims = {batch_size, channel, output_height,
-                               output_width};
-      memory::desc dst_md = memory::desc(dst_dims, dnnl::memory::data_type::f32,
-                                         dnnl::memory::format_tag::nhwc);
-
-      dnnl::primitive_attr attr;
-      attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
-#ifdef ITEX_ONEDNN_3_0
-      auto fwd_pd = dnnl::resampling_forward::primitive_desc(
-          onednn_engine,
-          prop_kind::forward_training
-          /* training and inference is same*/,
-          algorithm::resampling_linear, src_md, dst_md, attr);
-#else
-      auto fwd_desc = dnnl::resampling_forward::desc(
-          prop_kind::forward_training
-          /* training and inference is same*/,
-          algorithm::resampling_linear, src_md, dst_md);
-      auto fwd_pd = dnnl::resampling_forward::primitive_desc(fwd_desc, attr,
-                                                             onednn_engine);
-#endif
-      Tensor scratchpad_tensor;
-      dnnl::memory scratchpad_mem;
-      int64 scratchpad_size = fwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      scratchpad_mem = dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
-                                    GetTensorBuffer<T>(&scratchpad_tensor));
-
-      auto fwd_primitive = dnnl::resampling_forward(fwd_pd);
-
-      dnnl::memory src_mem =
-          dnnl::memory(src_md, onednn_engine, GetTensorBuffer<T>(&src_tensor));
-
-      dnnl::memory reorder_mem;
-      Tensor src_reorder_tensor;
-      bool is_src_reordered = (src_md != fwd_pd.src_desc());
-      if (is_src_reordered) {
-        int64 src_reorder_size = fwd_pd.src_desc().get_size() / sizeof(T);
-        OP_REQUIRES_OK(context,
-                       context->allocate_temp(DataTypeToEnum<T>::v(),
-                                              TensorShape({src_reorder_size}),
-                                              &src_reorder_tensor));
-
-        reorder_mem = CreateDnnlMemory(fwd_pd.src_desc(), onednn_engine,
-                                       GetTensorBuffer<T>(&src_reorder_tensor));
-        ReorderMemory(*context, &src_mem, &reorder_mem, onednn_engine);
-      }
-
-      // By default, the output format will be the same with input (NHWC).
-      dst_tf_shape =
-          TensorShape({batch_size, output_height, output_width, channel});
-
-      OP_REQUIRES_OK(context, context->allocate_output(dst_index, dst_tf_shape,
-                                                       &dst_tensor));
-
-      // Create dst memory
-      float* dst_data = dst_tensor->flat<float>().data();
-      auto dst_mem = CreateDnnlMemory(fwd_pd.dst_desc(), onednn_engine,
-                                      static_cast<void*>(dst_data));
-
-      auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-      std::unordered_map<int, memory> fwd_primitive_args = {
-          {DNNL_ARG_SRC, is_src_reordered ? reorder_mem : src_mem},
-          {DNNL_ARG_DST, dst_mem},
-          {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
+    const Tensor& src_tensor = context->input(0);
+    resize::ResizeSizes sizes;
+    OP_REQUIRES_OK(context, resize::GetResizeSizes(
+                                src_tensor, context->input(1), &sizes));
 
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
-    } catch (dnnl::error& e) {
-      string error_msg = "Status: " + std::to_string(e.status) +
-                         ", message: " + string(e.message) + ", in file " +
-                         string(__FILE__) + ":" + std::to_string(__LINE__);
-      OP_REQUIRES_OK(
-          context,
-          errors::Aborted("Operation received an exception:", error_msg));
-    }
+    Tensor* dst_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(0,
+                                 TensorShape({sizes.batch, sizes.out_height,
+                                              sizes.out_width, sizes.channels}),
+                                 &dst_tensor));
+    // Nothing to compute, return.
+    if (dst_tensor->NumElements() == 0) return;
+
+    auto table = tables_.Get(sizes, align_corners_, half_pixel_centers_);
+    resize::ResizeBilinearNHWC<T>(
+        context->eigen_cpu_device(), src_tensor.flat<T>().data(), *table,
+        sizes, dst_tensor->flat<float>().data());
   }
 
  protected:
   bool align_corners_;
   bool half_pixel_centers_;
+  resize::ResizeTableCache<resize::BilinearTable> tables_;
 };
 
 template <typename Device, typename T>
@@ -170,9 +83,12 @@ class ResizeBilinearGradOp : public OpKernel {
     OP_REQUIRES_OK(context, context->GetAttr("align_corners", &align_corners_));
     OP_REQUIRES_OK(
         context, context->GetAttr("half_pixel_centers", &half_pixel_centers_));
-
-    ITEX_CHECK_EQ(align_corners_, false);
-    ITEX_CHECK_EQ(half_pixel_centers_, true);
+    // oneDNN linear resampling only implements the half pixel centers
+    // coordinates, the layout pass doesn't rewrite the other modes.
+    OP_REQUIRES(context, !align_corners_ && half_pixel_centers_,
+                errors::Unimplemented("_ITEXResizeBilinearGrad only supports "
+                                      "align_corners=False and "
+                                      "half_pixel_centers=True."));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -238,15 +154,10 @@ class ResizeBilinearGradOp : public OpKernel {
       auto bwd_pd = dnnl::resampling_backward::primitive_desc(
           bwd_desc, attr, onednn_engine, fwd_pd);
 #endif
-      Tensor scratchpad_tensor;
-      dnnl::memory scratchpad_mem;
-      int64 scratchpad_size = bwd_pd.scratchpad_desc().get_size() / sizeof(T);
-      OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      scratchpad_mem = dnnl::memory(bwd_pd.scratchpad_desc(), onednn_engine,
-                                    GetTensorBuffer<T>(&scratchpad_tensor));
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, bwd_pd.scratchpad_desc(),
+                                              onednn_engine));
+      dnnl::memory scratchpad_mem = scratchpad.memory();
 
       auto reorder_memory = [&](dnnl::memory& lhs, memory::desc& rhs_desc,
                                 Tensor& rhs_tensor, dnnl::memory& rhs) -> bool {
@@ -312,6 +223,8 @@ class ResizeBilinearGradOp : public OpKernel {
       ResizeBilinearOp<CPUDevice, T>);
 
 TF_CALL_CPU_NUMBER_TYPES(REGISTER_KERNEL);
+TF_CALL_int8(REGISTER_KERNEL);
+TF_CALL_uint8(REGISTER_KERNEL);
 
 #define REGISTER_GRAD_KERNEL(T)                           \
   REGISTER_KERNEL_BUILDER(Name("_ITEXResizeBilinearGrad") \
@@ -0,0 +1,76 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/kernels/cpu/resize_op_cpu.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+template <typename Device, typename T>
+class ResizeNearestNeighborOp : public OpKernel {
+ public:
+  explicit ResizeNearestNeighborOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("align_corners", &align_corners_));
+    OP_REQUIRES_OK(
+        context, context->GetAttr("half_pixel_centers", &half_pixel_centers_));
+    OP_REQUIRES(context, !(align_corners_ && half_pixel_centers_),
+                errors::InvalidArgument("If half_pixel_centers is True, "
+                                        "align_corners must be False."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& src_tensor = context->input(0);
+    resize::ResizeSizes sizes;
+    OP_REQUIRES_OK(context, resize::GetResizeSizes(
+                                src_tensor, context->input(1), &sizes));
+
+    Tensor* dst_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(0,
+                                 TensorShape({sizes.batch, sizes.out_height,
+                                              sizes.out_width, sizes.channels}),
+                                 &dst_tensor));
+    // Nothing to compute, return.
+    if (dst_tensor->NumElements() == 0) return;
+
+    auto table = tables_.Get(sizes, align_corners_, half_pixel_centers_);
+    resize::ResizeNearestNeighborNHWC<T>(
+        context->eigen_cpu_device(), src_tensor.flat<T>().data(), *table,
+        sizes, dst_tensor->flat<T>().data());
+  }
+
+ protected:
+  bool align_corners_;
+  bool half_pixel_centers_;
+  resize::ResizeTableCache<resize::NearestNeighborTable> tables_;
+};
+
+#define REGISTER_KERNEL(T)                                   \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXResizeNearestNeighbor") \
+                              .Device(DEVICE_CPU)            \
+                              .TypeConstraint<T>("T"),       \
+                          ResizeNearestNeighborOp<CPUDevice, T>);
+
+TF_CALL_CPU_NUMBER_TYPES(REGISTER_KERNEL);
+TF_CALL_int8(REGISTER_KERNEL);
+TF_CALL_uint8(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+}  // namespace itex
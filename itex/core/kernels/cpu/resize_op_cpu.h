@@ -0,0 +1,286 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_CPU_RESIZE_OP_CPU_H_
+#define ITEX_CORE_KERNELS_CPU_RESIZE_OP_CPU_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/types.h"
+#include "third_party/eigen3/Eigen/Core"
+
+namespace itex {
+namespace resize {
+
+// NHWC sizes of one resize call.
+struct ResizeSizes {
+  int64 batch;
+  int64 in_height;
+  int64 in_width;
+  int64 out_height;
+  int64 out_width;
+  int64 channels;
+};
+
+// Validates the `images` and `size` inputs of ResizeBilinear and
+// ResizeNearestNeighbor, same as TF ImageResizerState.
+inline Status GetResizeSizes(const Tensor& input, const Tensor& size,
+                             ResizeSizes* sizes) {
+  if (input.dims() != 4) {
+    return errors::InvalidArgument("input must be 4-dimensional",
+                                   input.shape().DebugString());
+  }
+  if (size.dims() != 1 || size.NumElements() != 2) {
+    return errors::InvalidArgument("shape_t must be 1-dimensional",
+                                   " with 2 elements ",
+                                   size.shape().DebugString());
+  }
+  auto size_vec = size.vec<int32>();
+  sizes->batch = input.dim_size(0);
+  sizes->in_height = input.dim_size(1);
+  sizes->in_width = input.dim_size(2);
+  sizes->channels = input.dim_size(3);
+  sizes->out_height = size_vec(0);
+  sizes->out_width = size_vec(1);
+  if (sizes->out_height <= 0 || sizes->out_width <= 0) {
+    return errors::InvalidArgument("output dimensions must be positive");
+  }
+  if (sizes->in_height <= 0 || sizes->in_width <= 0) {
+    return errors::InvalidArgument("input image must be of non-zero size");
+  }
+  if (sizes->in_height >= std::numeric_limits<int32>::max() ||
+      sizes->in_width >= std::numeric_limits<int32>::max()) {
+    return errors::InvalidArgument(
+        "input sizes must be between 0 and max int32");
+  }
+  return Status::OK();
+}
+
+inline float ComputeScale(int64 in_size, int64 out_size, bool align_corners) {
+  return (align_corners && out_size > 1)
+             ? (in_size - 1) / static_cast<float>(out_size - 1)
+             : in_size / static_cast<float>(out_size);
+}
+
+// Source rows and columns of every output row and column of a bilinear
+// resize. Column offsets are in elements, i.e. already multiplied by the
+// number of channels.
+struct BilinearTable {
+  std::vector<int64> y_lower;
+  std::vector<int64> y_upper;
+  std::vector<float> y_lerp;
+  std::vector<int64> x_lower;
+  std::vector<int64> x_upper;
+  std::vector<float> x_lerp;
+
+  static void Compute(int64 in_size, int64 out_size, int64 stride,
+                      bool align_corners, bool half_pixel_centers,
+                      std::vector<int64>* lower, std::vector<int64>* upper,
+                      std::vector<float>* lerp) {
+    const float scale = ComputeScale(in_size, out_size, align_corners);
+    lower->resize(out_size);
+    upper->resize(out_size);
+    lerp->resize(out_size);
+    for (int64 i = 0; i < out_size; ++i) {
+      const float in = half_pixel_centers
+                           ? (static_cast<float>(i) + 0.5f) * scale - 0.5f
+                           : static_cast<float>(i) * scale;
+      const float in_f = std::floor(in);
+      (*lower)[i] = std::max(static_cast<int64>(in_f), int64{0}) * stride;
+      (*upper)[i] =
+          std::min(static_cast<int64>(std::ceil(in)), in_size - 1) * stride;
+      (*lerp)[i] = in - in_f;
+    }
+  }
+
+  static BilinearTable Build(const ResizeSizes& s, bool align_corners,
+                             bool half_pixel_centers) {
+    BilinearTable table;
+    Compute(s.in_height, s.out_height, 1, align_corners, half_pixel_centers,
+            &table.y_lower, &table.y_upper, &table.y_lerp);
+    Compute(s.in_width, s.out_width, s.channels, align_corners,
+            half_pixel_centers, &table.x_lower, &table.x_upper,
+            &table.x_lerp);
+    return table;
+  }
+};
+
+// Source row and column of every output row and column of a nearest
+// neighbor resize. Column offsets are in elements.
+struct NearestNeighborTable {
+  std::vector<int64> y_index;
+  std::vector<int64> x_index;
+
+  static void Compute(int64 in_size, int64 out_size, int64 stride,
+                      bool align_corners, bool half_pixel_centers,
+                      std::vector<int64>* index) {
+    const float scale = ComputeScale(in_size, out_size, align_corners);
+    index->resize(out_size);
+    for (int64 i = 0; i < out_size; ++i) {
+      const float in = half_pixel_centers
+                           ? (static_cast<float>(i) + 0.5f) * scale
+                           : static_cast<float>(i) * scale;
+      int64 in_i = std::min(
+          static_cast<int64>(align_corners ? std::round(in) : std::floor(in)),
+          in_size - 1);
+      if (half_pixel_centers) in_i = std::max(in_i, int64{0});
+      (*index)[i] = in_i * stride;
+    }
+  }
+
+  static NearestNeighborTable Build(const ResizeSizes& s, bool align_corners,
+                                    bool half_pixel_centers) {
+    NearestNeighborTable table;
+    Compute(s.in_height, s.out_height, 1, align_corners, half_pixel_centers,
+            &table.y_index);
+    Compute(s.in_width, s.out_width, s.channels, align_corners,
+            half_pixel_centers, &table.x_index);
+    return table;
+  }
+};
+
+// Tables of one resize kernel, built once per input and output size. The
+// coordinate mode is an attribute of the kernel, so it isn't part of the key.
+// The cache is cleared once it holds kMaxEntries sizes, so models with
+// dynamic shapes don't grow it without bound.
+template <typename Table>
+class ResizeTableCache {
+ public:
+  std::shared_ptr<const Table> Get(const ResizeSizes& s, bool align_corners,
+                                   bool half_pixel_centers) {
+    const Key key = {s.in_height, s.in_width, s.out_height, s.out_width,
+                     s.channels};
+    mutex_lock lock(&mu_);
+    auto iter = tables_.find(key);
+    if (iter != tables_.end()) return iter->second;
+    if (tables_.size() >= kMaxEntries) tables_.clear();
+    auto table = std::make_shared<const Table>(
+        Table::Build(s, align_corners, half_pixel_centers));
+    tables_.emplace(key, table);
+    return table;
+  }
+
+ private:
+  using Key = std::array<int64, 5>;
+  static constexpr size_t kMaxEntries = 16;
+
+  mutex mu_;
+  std::map<Key, std::shared_ptr<const Table>> tables_ TF_GUARDED_BY(mu_);
+};
+
+// Bilinear resize of NHWC `src` into float `dst`. Output rows of all images
+// are split among the intra-op threads, each pixel is interpolated over the
+// channels with Eigen packets.
+template <typename T>
+void ResizeBilinearNHWC(const CPUDevice& d, const T* src,
+                        const BilinearTable& table, const ResizeSizes& s,
+                        float* dst) {
+  using ConstArray =
+      Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>, Eigen::Unaligned>;
+  using FloatArray = Eigen::Map<Eigen::ArrayXf, Eigen::Unaligned>;
+
+  const int64 channels = s.channels;
+  const int64 in_row_size = s.in_width * channels;
+  const int64 in_image_size = s.in_height * in_row_size;
+  const int64 out_row_size = s.out_width * channels;
+  const int64 out_height = s.out_height;
+  const int64 out_width = s.out_width;
+
+  d.parallelFor(
+      s.batch * out_height,
+      Eigen::TensorOpCost(4 * sizeof(T) * out_row_size,
+                          sizeof(float) * out_row_size, 6 * out_row_size),
+      [&](Eigen::Index first, Eigen::Index last) {
+        for (Eigen::Index row = first; row < last; ++row) {
+          const int64 b = row / out_height;
+          const int64 y = row % out_height;
+          const T* top =
+              src + b * in_image_size + table.y_lower[y] * in_row_size;
+          const T* bottom =
+              src + b * in_image_size + table.y_upper[y] * in_row_size;
+          const float y_lerp = table.y_lerp[y];
+          float* out = dst + row * out_row_size;
+          for (int64 x = 0; x < out_width; ++x) {
+            const int64 left = table.x_lower[x];
+            const int64 right = table.x_upper[x];
+            const float x_lerp = table.x_lerp[x];
+            auto top_left =
+                ConstArray(top + left, channels).template cast<float>();
+            auto top_right =
+                ConstArray(top + right, channels).template cast<float>();
+            auto bottom_left =
+                ConstArray(bottom + left, channels).template cast<float>();
+            auto bottom_right =
+                ConstArray(bottom + right, channels).template cast<float>();
+            auto top_val = top_left + (top_right - top_left) * x_lerp;
+            auto bottom_val =
+                bottom_left + (bottom_right - bottom_left) * x_lerp;
+            FloatArray(out + x * channels, channels) =
+                top_val + (bottom_val - top_val) * y_lerp;
+          }
+        }
+      });
+}
+
+// Nearest neighbor resize of NHWC `src` into `dst`, copying whole pixels.
+template <typename T>
+void ResizeNearestNeighborNHWC(const CPUDevice& d, const T* src,
+                               const NearestNeighborTable& table,
+                               const ResizeSizes& s, T* dst) {
+  const int64 channels = s.channels;
+  const int64 in_row_size = s.in_width * channels;
+  const int64 in_image_size = s.in_height * in_row_size;
+  const int64 out_row_size = s.out_width * channels;
+  const int64 out_height = s.out_height;
+  const int64 out_width = s.out_width;
+
+  d.parallelFor(
+      s.batch * out_height,
+      Eigen::TensorOpCost(sizeof(T) * out_row_size, sizeof(T) * out_row_size,
+                          out_width),
+      [&](Eigen::Index first, Eigen::Index last) {
+        for (Eigen::Index row = first; row < last; ++row) {
+          const int64 b = row / out_height;
+          const int64 y = row % out_height;
+          const T* in =
+              src + b * in_image_size + table.y_index[y] * in_row_size;
+          T* out = dst + row * out_row_size;
+          if (channels == 1) {
+            for (int64 x = 0; x < out_width; ++x) {
+              out[x] = in[table.x_index[x]];
+            }
+          } else {
+            for (int64 x = 0; x < out_width; ++x) {
+              std::copy_n(in + table.x_index[x], channels, out + x * channels);
+            }
+          }
+        }
+      });
+}
+
+}  // namespace resize
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_CPU_RESIZE_OP_CPU_H_
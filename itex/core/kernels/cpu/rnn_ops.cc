@@ -0,0 +1,789 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string.h>
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "itex/core/kernels/common/rnn_ops.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/onednn/onednn_util.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+
+using dnnl::gru_backward;
+using dnnl::gru_forward;
+using dnnl::lstm_backward;
+using dnnl::lstm_forward;
+using dnnl::memory;
+using dnnl::prop_kind;
+using dnnl::rnn_direction;
+
+namespace itex {
+
+namespace {
+
+constexpr rnn_direction kDirection = rnn_direction::unidirectional_left2right;
+
+// The CPU kernels run the whole sequence with one oneDNN LSTM or GRU
+// primitive, which has no per gate dropout masks, per sample sequence lengths
+// or projection. The Keras layers only dispatch to them without those.
+Status CheckCPUSupported(const RnnModelConfig& rmc) {
+  if (rmc.rnn_mode != RnnMode::kRnnLstm && rmc.rnn_mode != RnnMode::kRnnGru) {
+    return errors::Unimplemented(
+        "ItexRnn on CPU only supports lstm and gru mode.");
+  }
+  if (rmc.HasDpMask() || rmc.HasRecDpMask()) {
+    return errors::Unimplemented("ItexRnn on CPU doesn't support dropout.");
+  }
+  if (rmc.var_seq_length) {
+    return errors::Unimplemented(
+        "ItexRnn on CPU doesn't support variable sequence lengths.");
+  }
+  if (rmc.num_proj != 0) {
+    return errors::Unimplemented("ItexRnn on CPU doesn't support projection.");
+  }
+  return Status::OK();
+}
+
+// Data type of the bias, the LSTM cell state and all gradients. oneDNN keeps
+// them in f32 when the other tensors are bf16.
+template <typename T>
+memory::data_type AccumulationType() {
+  return std::is_same<T, Eigen::bfloat16>::value ? memory::data_type::f32
+                                                 : OneDnnType<T>();
+}
+
+// Memory descriptors of a single layer, left to right RNN. The `user_*` descs
+// describe `params`: the input weights as (gates, output, input), the
+// recurrent weights as (gates, output, output) and one bias per gate, i.e. the
+// oneDNN ldgoi and ldgo formats. The other descs are passed to the primitive.
+// They only differ from the ItexRnn tensors in the data type of the bias, the
+// cell state and the gradients, see AccumulationType.
+template <typename T>
+struct RnnDescs {
+  explicit RnnDescs(const RnnModelConfig& rmc)
+      : dims({rmc.max_seq_length, rmc.batch_size, rmc.input_size,
+              rmc.output_size}) {
+    const memory::dim t = rmc.max_seq_length;
+    const memory::dim n = rmc.batch_size;
+    const memory::dim ic = rmc.input_size;
+    const memory::dim hc = rmc.output_size;
+    const memory::dim g = rmc.num_gates;
+    const memory::data_type dt = OneDnnType<T>();
+    const memory::data_type acc_dt = AccumulationType<T>();
+    using tag = memory::format_tag;
+
+    src_layer = memory::desc({t, n, ic}, dt, tag::tnc);
+    dst_layer = memory::desc({t, n, hc}, dt, tag::tnc);
+    state = memory::desc({1, 1, n, hc}, dt, tag::ldnc);
+    user_weights_layer = memory::desc({1, 1, ic, g, hc}, dt, tag::ldgoi);
+    user_weights_iter = memory::desc({1, 1, hc, g, hc}, dt, tag::ldgoi);
+    user_bias = memory::desc({1, 1, g, hc}, dt, tag::ldgo);
+
+    // Let the primitive pick the packed weights layout.
+    weights_layer = memory::desc({1, 1, ic, g, hc}, dt, tag::any);
+    weights_iter = memory::desc({1, 1, hc, g, hc}, dt, tag::any);
+    bias = memory::desc({1, 1, g, hc}, acc_dt, tag::ldgo);
+    state_c = memory::desc({1, 1, n, hc}, acc_dt, tag::ldnc);
+    diff_src_layer = memory::desc({t, n, ic}, acc_dt, tag::tnc);
+    diff_dst_layer = memory::desc({t, n, hc}, acc_dt, tag::tnc);
+    diff_state = memory::desc({1, 1, n, hc}, acc_dt, tag::ldnc);
+    diff_weights_layer = memory::desc({1, 1, ic, g, hc}, acc_dt, tag::any);
+    diff_weights_iter = memory::desc({1, 1, hc, g, hc}, acc_dt, tag::any);
+
+    weights_iter_offset = g * hc * ic;
+    bias_offset = weights_iter_offset + g * hc * hc;
+  }
+
+  memory::dims dims;
+  memory::desc src_layer;
+  memory::desc dst_layer;
+  memory::desc state;
+  memory::desc user_weights_layer;
+  memory::desc user_weights_iter;
+  memory::desc user_bias;
+  memory::desc weights_layer;
+  memory::desc weights_iter;
+  memory::desc bias;
+  memory::desc state_c;
+  memory::desc diff_src_layer;
+  memory::desc diff_dst_layer;
+  memory::desc diff_state;
+  memory::desc diff_weights_layer;
+  memory::desc diff_weights_iter;
+  // Offsets of the recurrent weights and the bias in `params`.
+  int64 weights_iter_offset;
+  int64 bias_offset;
+};
+
+dnnl::primitive_attr ScratchpadAttr() {
+  dnnl::primitive_attr attr;
+  attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+  return attr;
+}
+
+// oneDNN primitives of the cells ItexRnn supports on CPU. The gates in
+// `params` follow the oneDNN order: i, f, c, o for LSTM and u, r, o for GRU,
+// which is also the order of the Keras kernels. The GRU applies the reset
+// gate before the recurrent matmul, as the Keras GRU with reset_after=False.
+struct LstmCell {
+  using Fwd = lstm_forward;
+  using Bwd = lstm_backward;
+  static constexpr bool kHasCellState = true;
+
+  template <typename T>
+  static Fwd::primitive_desc CreateForwardPd(const dnnl::engine& engine,
+                                             prop_kind prop,
+                                             const RnnDescs<T>& d) {
+#ifdef ITEX_ONEDNN_3_0
+    return Fwd::primitive_desc(engine, prop, kDirection, d.src_layer, d.state,
+                               d.state_c, d.weights_layer, d.weights_iter,
+                               d.bias, d.dst_layer, d.state, d.state_c,
+                               ScratchpadAttr());
+#else
+    auto desc = Fwd::desc(prop, kDirection, d.src_layer, d.state, d.state_c,
+                          d.weights_layer, d.weights_iter, d.bias,
+                          d.dst_layer, d.state, d.state_c);
+    return Fwd::primitive_desc(desc, ScratchpadAttr(), engine);
+#endif
+  }
+
+  template <typename T>
+  static Bwd::primitive_desc CreateBackwardPd(
+      const dnnl::engine& engine, const RnnDescs<T>& d,
+      const Fwd::primitive_desc& fwd_pd) {
+#ifdef ITEX_ONEDNN_3_0
+    return Bwd::primitive_desc(
+        engine, prop_kind::backward, kDirection, d.src_layer, d.state,
+        d.state_c, d.weights_layer, d.weights_iter, d.bias, d.dst_layer,
+        d.state, d.state_c, d.diff_src_layer, d.diff_state, d.diff_state,
+        d.diff_weights_layer, d.diff_weights_iter, d.bias, d.diff_dst_layer,
+        d.diff_state, d.diff_state, fwd_pd, ScratchpadAttr());
+#else
+    auto desc = Bwd::desc(
+        prop_kind::backward, kDirection, d.src_layer, d.state, d.state_c,
+        d.weights_layer, d.weights_iter, d.bias, d.dst_layer, d.state,
+        d.state_c, d.diff_src_layer, d.diff_state, d.diff_state,
+        d.diff_weights_layer, d.diff_weights_iter, d.bias, d.diff_dst_layer,
+        d.diff_state, d.diff_state);
+    return Bwd::primitive_desc(desc, ScratchpadAttr(), engine, fwd_pd);
+#endif
+  }
+};
+
+struct GruCell {
+  using Fwd = gru_forward;
+  using Bwd = gru_backward;
+  static constexpr bool kHasCellState = false;
+
+  template <typename T>
+  static Fwd::primitive_desc CreateForwardPd(const dnnl::engine& engine,
+                                             prop_kind prop,
+                                             const RnnDescs<T>& d) {
+#ifdef ITEX_ONEDNN_3_0
+    return Fwd::primitive_desc(engine, prop, kDirection, d.src_layer, d.state,
+                               d.weights_layer, d.weights_iter, d.bias,
+                               d.dst_layer, d.state, ScratchpadAttr());
+#else
+    auto desc = Fwd::desc(prop, kDirection, d.src_layer, d.state,
+                          d.weights_layer, d.weights_iter, d.bias,
+                          d.dst_layer, d.state);
+    return Fwd::primitive_desc(desc, ScratchpadAttr(), engine);
+#endif
+  }
+
+  template <typename T>
+  static Bwd::primitive_desc CreateBackwardPd(
+      const dnnl::engine& engine, const RnnDescs<T>& d,
+      const Fwd::primitive_desc& fwd_pd) {
+#ifdef ITEX_ONEDNN_3_0
+    return Bwd::primitive_desc(
+        engine, prop_kind::backward, kDirection, d.src_layer, d.state,
+        d.weights_layer, d.weights_iter, d.bias, d.dst_layer, d.state,
+        d.diff_src_layer, d.diff_state, d.diff_weights_layer,
+        d.diff_weights_iter, d.bias, d.diff_dst_layer, d.diff_state, fwd_pd,
+        ScratchpadAttr());
+#else
+    auto desc = Bwd::desc(prop_kind::backward, kDirection, d.src_layer,
+                          d.state, d.weights_layer, d.weights_iter, d.bias,
+                          d.dst_layer, d.state, d.diff_src_layer,
+                          d.diff_state, d.diff_weights_layer,
+                          d.diff_weights_iter, d.bias, d.diff_dst_layer,
+                          d.diff_state);
+    return Bwd::primitive_desc(desc, ScratchpadAttr(), engine, fwd_pd);
+#endif
+  }
+};
+
+// The primitive created for the last shape.
+template <typename Primitive>
+struct PrimitiveCache {
+  memory::dims dims;
+  typename Primitive::primitive_desc pd;
+  Primitive primitive;
+};
+
+template <typename T>
+Status AllocateScratchpad(OpKernelContext* context, const dnnl::engine& engine,
+                          const memory::desc& desc, Tensor* tensor,
+                          memory* mem) {
+  TF_RETURN_IF_ERROR(context->allocate_temp(
+      DataTypeToEnum<T>::v(),
+      TensorShape({static_cast<int64>(
+          (desc.get_size() + sizeof(T) - 1) / sizeof(T))}),
+      tensor));
+  *mem = CreateDnnlMemory(desc, engine, GetTensorBuffer<T>(tensor));
+  return Status::OK();
+}
+
+// Binds the ItexRnn tensors to the arguments of a oneDNN RNN primitive. An
+// argument whose desc differs from the one of its tensor, in layout or data
+// type, is bound to a temporary: inputs are reordered into it before the
+// execution and outputs out of it afterwards.
+template <typename T>
+class RnnArgs {
+ public:
+  RnnArgs(OpKernelContext* context, const dnnl::engine& engine)
+      : context_(context), engine_(engine) {}
+
+  void Add(int arg, const memory& mem) { args_.insert({arg, mem}); }
+
+  Status AddInput(int arg, const memory::desc& user_desc, const void* data,
+                  const memory::desc& desc) {
+    memory user_mem =
+        CreateDnnlMemory(user_desc, engine_, const_cast<void*>(data));
+    if (user_desc == desc) {
+      Add(arg, user_mem);
+      return Status::OK();
+    }
+    memory mem;
+    TF_RETURN_IF_ERROR(AllocateTemp(desc, &mem));
+    ReorderMemory(*context_, &user_mem, &mem, engine_);
+    Add(arg, mem);
+    return Status::OK();
+  }
+
+  // oneDNN accumulates into the weight gradients, which are then zeroed
+  // first with `zero_init`.
+  Status AddOutput(int arg, const memory::desc& user_desc, void* data,
+                   const memory::desc& desc, bool zero_init = false) {
+    memory user_mem = CreateDnnlMemory(user_desc, engine_, data);
+    memory mem = user_mem;
+    if (user_desc != desc) {
+      TF_RETURN_IF_ERROR(AllocateTemp(desc, &mem));
+      outputs_to_reorder_.emplace_back(mem, user_mem);
+    }
+    if (zero_init) memset(mem.get_data_handle(), 0, desc.get_size());
+    Add(arg, mem);
+    return Status::OK();
+  }
+
+  void Execute(const dnnl::primitive& primitive) {
+    auto onednn_stream = CreateDnnlStream(*context_, engine_);
+    primitive.execute(onednn_stream, args_);
+    for (auto& output : outputs_to_reorder_) {
+      ReorderMemory(*context_, &output.first, &output.second, engine_);
+    }
+  }
+
+ private:
+  Status AllocateTemp(const memory::desc& desc, memory* mem) {
+    temps_.emplace_back();
+    return AllocateScratchpad<T>(context_, engine_, desc, &temps_.back(), mem);
+  }
+
+  OpKernelContext* context_;
+  dnnl::engine engine_;
+  std::unordered_map<int, memory> args_;
+  // Pairs of (primitive memory, user memory).
+  std::vector<std::pair<memory, memory>> outputs_to_reorder_;
+  std::list<Tensor> temps_;
+};
+
+string OneDnnErrorMessage(const dnnl::error& e, const char* file, int line) {
+  return "Status: " + std::to_string(e.status) +
+         ", message: " + string(e.message) + ", in file " + string(file) +
+         ":" + std::to_string(line);
+}
+
+}  // namespace
+
+// ------------------------------------------------------------------
+// RNN OP
+// ------------------------------------------------------------------
+// Runs all timesteps with one oneDNN LSTM or GRU primitive instead of a TF
+// while loop. The weights are packed into the primitive's layout once per
+// call and reused by every timestep. Constant weights, as marked by the graph
+// optimizer with `is_filter_const`, are packed once and cached across calls.
+// The primitive is cached for the last shape.
+template <typename Device, typename T>
+class RnnOp : public RnnCommonKernel {
+ public:
+  explicit RnnOp(OpKernelConstruction* context) : RnnCommonKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("is_training", &rmc_.is_training));
+    if (context->HasAttr("is_filter_const")) {
+      OP_REQUIRES_OK(context,
+                     context->GetAttr("is_filter_const", &is_filter_const_));
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input = nullptr;
+    const Tensor* input_h = nullptr;
+    const Tensor* input_c = nullptr;
+    const Tensor* params = nullptr;
+    const Tensor* seq_lengths = nullptr;
+    const Tensor* dp_mask = nullptr;
+    const Tensor* rec_dp_mask = nullptr;
+    OP_REQUIRES_OK(context,
+                   ExtractInput(context, &input, &input_h, &input_c, &params,
+                                &seq_lengths, &dp_mask, &rec_dp_mask));
+    OP_REQUIRES_OK(context, CheckCPUSupported(rmc_));
+
+    if (rmc_.rnn_mode == RnnMode::kRnnLstm) {
+      ComputeCell<LstmCell>(context, input, input_h, input_c, params);
+    } else {
+      ComputeCell<GruCell>(context, input, input_h, input_c, params);
+    }
+  }
+
+ private:
+  template <typename Cell>
+  void ComputeCell(OpKernelContext* context, const Tensor* input,
+                   const Tensor* input_h, const Tensor* input_c,
+                   const Tensor* params) {
+    try {
+      auto onednn_engine = CreateDnnlEngine<Device>(*context);
+      RnnDescs<T> descs(rmc_);
+      const bool is_empty =
+          rmc_.max_seq_length == 0 || rmc_.batch_size == 0;
+
+      typename Cell::Fwd::primitive_desc fwd_pd;
+      typename Cell::Fwd fwd_primitive;
+      if (!is_empty) {
+        mutex_lock lock(&mu_);
+        auto& cache =
+            std::get<PrimitiveCache<typename Cell::Fwd>>(fwd_caches_);
+        if (cache.dims != descs.dims) {
+          cache.pd = Cell::CreateForwardPd(
+              onednn_engine,
+              rmc_.is_training ? prop_kind::forward_training
+                               : prop_kind::forward_inference,
+              descs);
+          cache.primitive = typename Cell::Fwd(cache.pd);
+          cache.dims = descs.dims;
+        }
+        fwd_pd = cache.pd;
+        fwd_primitive = cache.primitive;
+      }
+
+      TensorShape workspace_shape({});
+      if (rmc_.is_training) {
+        int64 workspace_size =
+            is_empty ? 0 : fwd_pd.workspace_desc().get_size();
+        workspace_shape =
+            TensorShape({(workspace_size + static_cast<int64>(sizeof(T)) - 1) /
+                         static_cast<int64>(sizeof(T))});
+      }
+
+      Tensor* output = nullptr;
+      Tensor* output_h = nullptr;
+      Tensor* output_c = nullptr;
+      Tensor* workspace = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(0, rmc_.output_shape, &output));
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  1, rmc_.hidden_state_shape, &output_h));
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  2, rmc_.cell_state_shape, &output_c));
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(3, workspace_shape, &workspace));
+      // The GRU has no cell state, output_c is a dummy scalar.
+      if (!Cell::kHasCellState) output_c->flat<T>().setZero();
+
+      if (is_empty) {
+        // No timestep to run, the states pass through.
+        std::copy_n(input_h->flat<T>().data(), input_h->NumElements(),
+                    output_h->flat<T>().data());
+        if (Cell::kHasCellState) {
+          std::copy_n(input_c->flat<T>().data(), input_c->NumElements(),
+                      output_c->flat<T>().data());
+        }
+        return;
+      }
+
+      RnnArgs<T> args(context, onednn_engine);
+      const T* params_data = params->flat<T>().data();
+      OP_REQUIRES_OK(context,
+                     AddWeights(context, onednn_engine, &args,
+                                DNNL_ARG_WEIGHTS_LAYER,
+                                descs.user_weights_layer, params_data,
+                                fwd_pd.weights_layer_desc(),
+                                &weights_layer_cache_));
+      OP_REQUIRES_OK(context,
+                     AddWeights(context, onednn_engine, &args,
+                                DNNL_ARG_WEIGHTS_ITER, descs.user_weights_iter,
+                                params_data + descs.weights_iter_offset,
+                                fwd_pd.weights_iter_desc(),
+                                &weights_iter_cache_));
+      OP_REQUIRES_OK(context,
+                     args.AddInput(DNNL_ARG_BIAS, descs.user_bias,
+                                   params_data + descs.bias_offset,
+                                   fwd_pd.bias_desc()));
+
+      OP_REQUIRES_OK(context,
+                     args.AddInput(DNNL_ARG_SRC_LAYER, descs.src_layer,
+                                   input->flat<T>().data(), descs.src_layer));
+      OP_REQUIRES_OK(context,
+                     args.AddInput(DNNL_ARG_SRC_ITER, descs.state,
+                                   input_h->flat<T>().data(), descs.state));
+      OP_REQUIRES_OK(context,
+                     args.AddOutput(DNNL_ARG_DST_LAYER, descs.dst_layer,
+                                    output->flat<T>().data(),
+                                    descs.dst_layer));
+      OP_REQUIRES_OK(context,
+                     args.AddOutput(DNNL_ARG_DST_ITER, descs.state,
+                                    output_h->flat<T>().data(), descs.state));
+      if (Cell::kHasCellState) {
+        OP_REQUIRES_OK(context,
+                       args.AddInput(DNNL_ARG_SRC_ITER_C, descs.state,
+                                     input_c->flat<T>().data(),
+                                     descs.state_c));
+        OP_REQUIRES_OK(context,
+                       args.AddOutput(DNNL_ARG_DST_ITER_C, descs.state,
+                                      output_c->flat<T>().data(),
+                                      descs.state_c));
+      }
+      if (rmc_.is_training) {
+        args.Add(DNNL_ARG_WORKSPACE,
+                 CreateDnnlMemory(fwd_pd.workspace_desc(), onednn_engine,
+                                  GetTensorBuffer<T>(workspace)));
+      }
+
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, fwd_pd.scratchpad_desc(),
+                                              onednn_engine));
+      args.Add(DNNL_ARG_SCRATCHPAD, scratchpad.memory());
+
+      args.Execute(fwd_primitive);
+    } catch (dnnl::error& e) {
+      OP_REQUIRES_OK(
+          context, errors::Aborted("Operation received an exception:",
+                                   OneDnnErrorMessage(e, __FILE__, __LINE__)));
+    }
+  }
+
+  // Binds the weights packed into `desc`. Constant weights are packed once
+  // into `cache`.
+  Status AddWeights(OpKernelContext* context, const dnnl::engine& engine,
+                    RnnArgs<T>* args, int arg, const memory::desc& user_desc,
+                    const T* data, const memory::desc& desc,
+                    WeightCacheManager<T>* cache) {
+    if (is_filter_const_ && user_desc != desc) {
+      if (cache->IsEmpty()) {
+        cache->SetCache(context, user_desc, desc, const_cast<T*>(data),
+                        engine);
+      }
+      T* cached_data = cache->GetCache(context, desc);
+      if (cached_data != nullptr) {
+        args->Add(arg, CreateDnnlMemory(desc, engine, cached_data));
+        return Status::OK();
+      }
+    }
+    return args->AddInput(arg, user_desc, data, desc);
+  }
+
+  bool is_filter_const_ = false;
+  WeightCacheManager<T> weights_layer_cache_;
+  WeightCacheManager<T> weights_iter_cache_;
+
+  mutex mu_;
+  std::tuple<PrimitiveCache<lstm_forward>, PrimitiveCache<gru_forward>>
+      fwd_caches_ TF_GUARDED_BY(mu_);
+};
+
+#define REGISTER_CPU(T)                                          \
+  REGISTER_KERNEL_BUILDER(                                       \
+      Name("ItexRnn").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      RnnOp<CPUDevice, T>);
+
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_bfloat16(REGISTER_CPU);
+#undef REGISTER_CPU
+
+// ------------------------------------------------------------------
+// RNN GRADIENT OP
+// ------------------------------------------------------------------
+template <typename Device, typename T>
+class RnnGradOp : public RnnCommonKernel {
+ public:
+  explicit RnnGradOp(OpKernelConstruction* context) : RnnCommonKernel(context) {
+    rmc_.is_training = true;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input = nullptr;
+    const Tensor* input_h = nullptr;
+    const Tensor* input_c = nullptr;
+    const Tensor* params = nullptr;
+    const Tensor* seq_lengths = nullptr;
+    const Tensor* dp_mask = nullptr;
+    const Tensor* rec_dp_mask = nullptr;
+    OP_REQUIRES_OK(context,
+                   ExtractInput(context, &input, &input_h, &input_c, &params,
+                                &seq_lengths, &dp_mask, &rec_dp_mask));
+    OP_REQUIRES_OK(context, CheckCPUSupported(rmc_));
+
+    if (rmc_.rnn_mode == RnnMode::kRnnLstm) {
+      ComputeCell<LstmCell>(context, input, input_h, input_c, params);
+    } else {
+      ComputeCell<GruCell>(context, input, input_h, input_c, params);
+    }
+  }
+
+ private:
+  template <typename Cell>
+  void ComputeCell(OpKernelContext* context, const Tensor* input,
+                   const Tensor* input_h, const Tensor* input_c,
+                   const Tensor* params) {
+    const Tensor* output = nullptr;
+    const Tensor* output_h = nullptr;
+    const Tensor* output_c = nullptr;
+    const Tensor* workspace = nullptr;
+    const Tensor* output_backprop = nullptr;
+    const Tensor* output_h_backprop = nullptr;
+    const Tensor* output_c_backprop = nullptr;
+    OP_REQUIRES_OK(context,
+                   ExtractGradInputs(context, &output, &output_h, &output_c,
+                                     &workspace, &output_backprop,
+                                     &output_h_backprop, &output_c_backprop));
+
+    Tensor* input_backprop = nullptr;
+    Tensor* input_h_backprop = nullptr;
+    Tensor* input_c_backprop = nullptr;
+    Tensor* params_backprop = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, rmc_.input_shape,
+                                                     &input_backprop));
+    OP_REQUIRES_OK(context, context->allocate_output(1, rmc_.hidden_state_shape,
+                                                     &input_h_backprop));
+    OP_REQUIRES_OK(context, context->allocate_output(2, rmc_.cell_state_shape,
+                                                     &input_c_backprop));
+    OP_REQUIRES_OK(context, context->allocate_output(3, rmc_.params_shape,
+                                                     &params_backprop));
+    if (!Cell::kHasCellState) input_c_backprop->flat<T>().setZero();
+
+    if (rmc_.max_seq_length == 0 || rmc_.batch_size == 0) {
+      // No timestep ran, the state gradients pass through.
+      std::copy_n(output_h_backprop->flat<T>().data(),
+                  output_h_backprop->NumElements(),
+                  input_h_backprop->flat<T>().data());
+      if (Cell::kHasCellState) {
+        std::copy_n(output_c_backprop->flat<T>().data(),
+                    output_c_backprop->NumElements(),
+                    input_c_backprop->flat<T>().data());
+      }
+      std::fill_n(params_backprop->flat<T>().data(),
+                  params_backprop->NumElements(), T(0));
+      return;
+    }
+
+    try {
+      auto onednn_engine = CreateDnnlEngine<Device>(*context);
+      RnnDescs<T> descs(rmc_);
+
+      typename Cell::Bwd::primitive_desc bwd_pd;
+      typename Cell::Bwd bwd_primitive;
+      {
+        mutex_lock lock(&mu_);
+        auto& cache =
+            std::get<PrimitiveCache<typename Cell::Bwd>>(bwd_caches_);
+        if (cache.dims != descs.dims) {
+          auto fwd_pd = Cell::CreateForwardPd(
+              onednn_engine, prop_kind::forward_training, descs);
+          cache.pd = Cell::CreateBackwardPd(onednn_engine, descs, fwd_pd);
+          cache.primitive = typename Cell::Bwd(cache.pd);
+          cache.dims = descs.dims;
+        }
+        bwd_pd = cache.pd;
+        bwd_primitive = cache.primitive;
+      }
+
+      OP_REQUIRES(
+          context,
+          workspace->NumElements() * sizeof(T) >=
+              bwd_pd.workspace_desc().get_size(),
+          errors::InvalidArgument("Invalid workspace shape, got ",
+                                  workspace->shape().DebugString(),
+                                  " expected at least ",
+                                  bwd_pd.workspace_desc().get_size(),
+                                  " bytes"));
+
+      RnnArgs<T> args(context, onednn_engine);
+      const T* params_data = params->flat<T>().data();
+      OP_REQUIRES_OK(context,
+                     args.AddInput(DNNL_ARG_WEIGHTS_LAYER,
+                                   descs.user_weights_layer, params_data,
+                                   bwd_pd.weights_layer_desc()));
+      OP_REQUIRES_OK(context,
+                     args.AddInput(DNNL_ARG_WEIGHTS_ITER,
+                                   descs.user_weights_iter,
+                                   params_data + descs.weights_iter_offset,
+                                   bwd_pd.weights_iter_desc()));
+      OP_REQUIRES_OK(context,
+                     args.AddInput(DNNL_ARG_BIAS, descs.user_bias,
+                                   params_data + descs.bias_offset,
+                                   bwd_pd.bias_desc()));
+
+      // Gradients of the weights are written in the primitive's layout, then
+      // reordered into `params_backprop` if it differs.
+      T* params_backprop_data = params_backprop->flat<T>().data();
+      OP_REQUIRES_OK(context,
+                     args.AddOutput(DNNL_ARG_DIFF_WEIGHTS_LAYER,
+                                    descs.user_weights_layer,
+                                    params_backprop_data,
+                                    bwd_pd.diff_weights_layer_desc(),
+                                    /*zero_init=*/true));
+      OP_REQUIRES_OK(
+          context,
+          args.AddOutput(DNNL_ARG_DIFF_WEIGHTS_ITER, descs.user_weights_iter,
+                         params_backprop_data + descs.weights_iter_offset,
+                         bwd_pd.diff_weights_iter_desc(),
+                         /*zero_init=*/true));
+      OP_REQUIRES_OK(context,
+                     args.AddOutput(DNNL_ARG_DIFF_BIAS, descs.user_bias,
+                                    params_backprop_data + descs.bias_offset,
+                                    bwd_pd.diff_bias_desc(),
+                                    /*zero_init=*/true));
+
+      auto add_input = [&](int arg, const memory::desc& user_desc,
+                           const Tensor* tensor, const memory::desc& desc) {
+        return args.AddInput(arg, user_desc, tensor->flat<T>().data(), desc);
+      };
+      auto add_output = [&](int arg, const memory::desc& user_desc,
+                            Tensor* tensor, const memory::desc& desc) {
+        return args.AddOutput(arg, user_desc, tensor->flat<T>().data(), desc);
+      };
+      OP_REQUIRES_OK(context, add_input(DNNL_ARG_SRC_LAYER, descs.src_layer,
+                                        input, descs.src_layer));
+      OP_REQUIRES_OK(context, add_input(DNNL_ARG_SRC_ITER, descs.state,
+                                        input_h, descs.state));
+      OP_REQUIRES_OK(context, add_input(DNNL_ARG_DST_LAYER, descs.dst_layer,
+                                        output, descs.dst_layer));
+      OP_REQUIRES_OK(context, add_input(DNNL_ARG_DST_ITER, descs.state,
+                                        output_h, descs.state));
+      OP_REQUIRES_OK(context,
+                     add_input(DNNL_ARG_DIFF_DST_LAYER, descs.dst_layer,
+                               output_backprop, descs.diff_dst_layer));
+      OP_REQUIRES_OK(context,
+                     add_input(DNNL_ARG_DIFF_DST_ITER, descs.state,
+                               output_h_backprop, descs.diff_state));
+      OP_REQUIRES_OK(context,
+                     add_output(DNNL_ARG_DIFF_SRC_LAYER, descs.src_layer,
+                                input_backprop, descs.diff_src_layer));
+      OP_REQUIRES_OK(context,
+                     add_output(DNNL_ARG_DIFF_SRC_ITER, descs.state,
+                                input_h_backprop, descs.diff_state));
+      if (Cell::kHasCellState) {
+        OP_REQUIRES_OK(context, add_input(DNNL_ARG_SRC_ITER_C, descs.state,
+                                          input_c, descs.state_c));
+        OP_REQUIRES_OK(context, add_input(DNNL_ARG_DST_ITER_C, descs.state,
+                                          output_c, descs.state_c));
+        OP_REQUIRES_OK(context,
+                       add_input(DNNL_ARG_DIFF_DST_ITER_C, descs.state,
+                                 output_c_backprop, descs.diff_state));
+        OP_REQUIRES_OK(context,
+                       add_output(DNNL_ARG_DIFF_SRC_ITER_C, descs.state,
+                                  input_c_backprop, descs.diff_state));
+      }
+      args.Add(DNNL_ARG_WORKSPACE,
+               CreateDnnlMemory(bwd_pd.workspace_desc(), onednn_engine,
+                                GetTensorBuffer<T>(workspace)));
+
+      OneDnnScratchpad scratchpad;
+      OP_REQUIRES_OK(context, scratchpad.Init(context, bwd_pd.scratchpad_desc(),
+                                              onednn_engine));
+      args.Add(DNNL_ARG_SCRATCHPAD, scratchpad.memory());
+
+      args.Execute(bwd_primitive);
+    } catch (dnnl::error& e) {
+      OP_REQUIRES_OK(
+          context, errors::Aborted("Operation received an exception:",
+                                   OneDnnErrorMessage(e, __FILE__, __LINE__)));
+    }
+  }
+
+  Status ExtractGradInputs(OpKernelContext* context, const Tensor** output,
+                           const Tensor** output_h, const Tensor** output_c,
+                           const Tensor** workspace,
+                           const Tensor** output_backprop,
+                           const Tensor** output_h_backprop,
+                           const Tensor** output_c_backprop) {
+    TF_RETURN_IF_ERROR(context->input("output", output));
+    TF_RETURN_IF_ERROR(context->input("output_backprop", output_backprop));
+    TF_RETURN_IF_ERROR(context->input("output_h", output_h));
+    TF_RETURN_IF_ERROR(context->input("output_h_backprop", output_h_backprop));
+    TF_RETURN_IF_ERROR(context->input("output_c", output_c));
+    TF_RETURN_IF_ERROR(context->input("output_c_backprop", output_c_backprop));
+    TF_RETURN_IF_ERROR(context->input("workspace", workspace));
+
+    for (const Tensor* tensor : {*output, *output_backprop}) {
+      if (tensor->shape() != rmc_.output_shape) {
+        return errors::InvalidArgument("Invalid output shape, got ",
+                                       tensor->shape().DebugString());
+      }
+    }
+    for (const Tensor* tensor : {*output_h, *output_h_backprop}) {
+      if (tensor->shape() != rmc_.hidden_state_shape) {
+        return errors::InvalidArgument("Invalid output_h shape, got ",
+                                       tensor->shape().DebugString());
+      }
+    }
+    if (rmc_.HasInputC()) {
+      for (const Tensor* tensor : {*output_c, *output_c_backprop}) {
+        if (tensor->shape() != rmc_.cell_state_shape) {
+          return errors::InvalidArgument("Invalid output_c shape, got ",
+                                         tensor->shape().DebugString());
+        }
+      }
+    }
+    return Status::OK();
+  }
+
+  mutex mu_;
+  std::tuple<PrimitiveCache<lstm_backward>, PrimitiveCache<gru_backward>>
+      bwd_caches_ TF_GUARDED_BY(mu_);
+};
+
+#define REGISTER_CPU(T)                                              \
+  REGISTER_KERNEL_BUILDER(                                           \
+      Name("ItexRnnGrad").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      RnnGradOp<CPUDevice, T>);
+
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_bfloat16(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace itex
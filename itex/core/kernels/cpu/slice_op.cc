@@ -94,16 +94,11 @@ class SliceOp : public OpKernel {
       dnnl::memory dst_mem = CreateDnnlMemory(dst_md, onednn_engine,
                                               GetTensorBuffer<T>(dst_tensor));
       // Create scratch pad
-      Tensor scratchpad_tensor;
-      int64 scratchpad_size =
-          reorder_pd.scratchpad_desc().get_size() / sizeof(T);
+      OneDnnScratchpad scratchpad;
       OP_REQUIRES_OK(context,
-                     context->allocate_temp(DataTypeToEnum<T>::v(),
-                                            TensorShape({scratchpad_size}),
-                                            &scratchpad_tensor));
-      auto scratchpad_mem =
-          dnnl::memory(reorder_pd.scratchpad_desc(), onednn_engine,
-                       GetTensorBuffer<T>(&scratchpad_tensor));
+                     scratchpad.Init(context, reorder_pd.scratchpad_desc(),
+                                     onednn_engine));
+      auto scratchpad_mem = scratchpad.memory();
       auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
       std::unordered_map<int, memory> reorder_primitive_args = {
           {DNNL_ARG_SRC, src_mem},
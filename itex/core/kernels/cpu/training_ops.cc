@@ -0,0 +1,556 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "itex/core/kernels/common/training_op_helpers.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+#include "third_party/eigen3/Eigen/Core"
+
+namespace itex {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+// CPU kernels of the fused optimizer ops created by the remapper. All math is
+// done in fp32: bfloat16 and half operands are widened block by block into
+// stack buffers and the updated state is rounded back once per step, so low
+// precision parameters don't accumulate rounding error inside the update.
+// float operands are used in place.
+namespace functor {
+namespace {
+
+// Elements processed per inner step, small enough to keep the fp32 copies of
+// all operands in L1.
+constexpr Eigen::Index kBlockSize = 512;
+
+using FloatArray = Eigen::Map<Eigen::ArrayXf, Eigen::Unaligned>;
+using ConstFloatArray = Eigen::Map<const Eigen::ArrayXf, Eigen::Unaligned>;
+
+template <typename T>
+inline const float* LoadInput(const T* src, Eigen::Index n, float* buf) {
+  for (Eigen::Index i = 0; i < n; ++i) buf[i] = static_cast<float>(src[i]);
+  return buf;
+}
+
+inline const float* LoadInput(const float* src, Eigen::Index n, float* buf) {
+  return src;
+}
+
+template <typename T>
+inline float* LoadVariable(T* src, Eigen::Index n, float* buf) {
+  for (Eigen::Index i = 0; i < n; ++i) buf[i] = static_cast<float>(src[i]);
+  return buf;
+}
+
+inline float* LoadVariable(float* src, Eigen::Index n, float* buf) {
+  return src;
+}
+
+// Returns where to compute a block of `dst`: `dst` itself for float, `buf`
+// otherwise.
+template <typename T>
+inline float* OutputBlock(T* dst, float* buf) {
+  return buf;
+}
+
+inline float* OutputBlock(float* dst, float* buf) { return dst; }
+
+template <typename T>
+inline void StoreBlock(const float* src, Eigen::Index n, T* dst) {
+  for (Eigen::Index i = 0; i < n; ++i) dst[i] = static_cast<T>(src[i]);
+}
+
+inline void StoreBlock(const float* src, Eigen::Index n, float* dst) {
+  if (src != dst) std::copy(src, src + n, dst);
+}
+
+// Splits [0, total) among the intra-op threads and calls `fn(begin, n)` on
+// blocks of at most kBlockSize elements. The per element bytes and cycles are
+// used by Eigen to decide the number of shards.
+template <typename Fn>
+void ParallelForBlocks(const CPUDevice& d, int64 total, int bytes_loaded,
+                       int bytes_stored, int cycles, Fn fn) {
+  d.parallelFor(
+      total, Eigen::TensorOpCost(bytes_loaded, bytes_stored, cycles),
+      [&fn](Eigen::Index first, Eigen::Index last) {
+        for (Eigen::Index i = first; i < last; i += kBlockSize) {
+          fn(i, std::min(kBlockSize, last - i));
+        }
+      });
+}
+
+}  // namespace
+
+// Adam and AdamW (decoupled weight decay) with the gradient scaled by
+// `grad_scale`, i.e. the fused Mul:
+//   m = m + (g - m) * (1 - beta1)
+//   v = v + (g * g - v) * (1 - beta2)
+//   var = (1 - weight_decay * lr) * var - m * alpha / (sqrt(v) + epsilon)
+template <typename T>
+struct ApplyAdamCPU {
+  void operator()(const CPUDevice& d, T* var, T* m, T* v, const T* grad,
+                  float grad_scale, float beta1_power, float beta2_power,
+                  float lr, float beta1, float beta2, float epsilon,
+                  float weight_decay, int64 size) {
+    const float alpha =
+        lr * std::sqrt(1.0f - beta2_power) / (1.0f - beta1_power);
+    const float beta1_sub = 1.0f - beta1;
+    const float beta2_sub = 1.0f - beta2;
+    const float var_scale = 1.0f - weight_decay * lr;
+
+    ParallelForBlocks(
+        d, size, 4 * sizeof(T), 3 * sizeof(T), 20,
+        [=](Eigen::Index begin, Eigen::Index n) {
+          alignas(64) float grad_buf[kBlockSize];
+          alignas(64) float var_buf[kBlockSize];
+          alignas(64) float m_buf[kBlockSize];
+          alignas(64) float v_buf[kBlockSize];
+
+          ConstFloatArray g(LoadInput(grad + begin, n, grad_buf), n);
+          FloatArray var_f(LoadVariable(var + begin, n, var_buf), n);
+          FloatArray m_f(LoadVariable(m + begin, n, m_buf), n);
+          FloatArray v_f(LoadVariable(v + begin, n, v_buf), n);
+
+          m_f += (g * grad_scale - m_f) * beta1_sub;
+          v_f += ((g * grad_scale).square() - v_f) * beta2_sub;
+          var_f = var_f * var_scale - m_f * alpha / (v_f.sqrt() + epsilon);
+
+          StoreBlock(m_f.data(), n, m + begin);
+          StoreBlock(v_f.data(), n, v + begin);
+          StoreBlock(var_f.data(), n, var + begin);
+        });
+  }
+};
+
+// Momentum with the gradient computed by the fused Mul + AddN:
+//   grad = mul_left * mul_scale + addn
+//   accum = accum * momentum + grad
+//   var -= lr * (grad + accum * momentum)   if use_nesterov
+//   var -= lr * accum                        otherwise
+// `mul_left` may alias `var`.
+template <typename T>
+struct FusedApplyMomentumCPU {
+  void operator()(const CPUDevice& d, T* var, T* accum, const T* mul_left,
+                  float mul_scale, const T* addn, float lr, float momentum,
+                  bool use_nesterov, int64 size) {
+    ParallelForBlocks(
+        d, size, 4 * sizeof(T), 2 * sizeof(T), 8,
+        [=](Eigen::Index begin, Eigen::Index n) {
+          alignas(64) float grad_buf[kBlockSize];
+          alignas(64) float addn_buf[kBlockSize];
+          alignas(64) float var_buf[kBlockSize];
+          alignas(64) float accum_buf[kBlockSize];
+
+          // The gradient is materialized before var is touched, as the Mul
+          // may read var.
+          FloatArray grad(grad_buf, n);
+          grad = ConstFloatArray(LoadInput(mul_left + begin, n, grad_buf), n) *
+                     mul_scale +
+                 ConstFloatArray(LoadInput(addn + begin, n, addn_buf), n);
+
+          FloatArray var_f(LoadVariable(var + begin, n, var_buf), n);
+          FloatArray accum_f(LoadVariable(accum + begin, n, accum_buf), n);
+
+          accum_f = accum_f * momentum + grad;
+          if (use_nesterov) {
+            var_f -= (grad + accum_f * momentum) * lr;
+          } else {
+            var_f -= accum_f * lr;
+          }
+
+          StoreBlock(accum_f.data(), n, accum + begin);
+          StoreBlock(var_f.data(), n, var + begin);
+        });
+  }
+};
+
+// ms + (1 - rho) * (grad * grad - ms). `out` may alias `ms`.
+template <typename T>
+struct ApplyRMSPropComputeRMSCPU {
+  void operator()(const CPUDevice& d, const T* ms, float rho, const T* grad,
+                  T* out, int64 size) {
+    const float rho_sub = 1.0f - rho;
+    ParallelForBlocks(d, size, 2 * sizeof(T), sizeof(T), 4,
+                      [=](Eigen::Index begin, Eigen::Index n) {
+                        alignas(64) float ms_buf[kBlockSize];
+                        alignas(64) float grad_buf[kBlockSize];
+                        alignas(64) float out_buf[kBlockSize];
+
+                        ConstFloatArray ms_f(
+                            LoadInput(ms + begin, n, ms_buf), n);
+                        ConstFloatArray g(
+                            LoadInput(grad + begin, n, grad_buf), n);
+                        FloatArray out_f(OutputBlock(out + begin, out_buf), n);
+
+                        out_f = ms_f + (g.square() - ms_f) * rho_sub;
+                        StoreBlock(out_f.data(), n, out + begin);
+                      });
+  }
+};
+
+// var - lr * grad / (epsilon + sqrt(ms)). `out` may alias `var`.
+template <typename T>
+struct ApplyRMSPropVarUpdateCPU {
+  void operator()(const CPUDevice& d, const T* var, const T* ms, float lr,
+                  float epsilon, const T* grad, T* out, int64 size) {
+    ParallelForBlocks(d, size, 3 * sizeof(T), sizeof(T), 16,
+                      [=](Eigen::Index begin, Eigen::Index n) {
+                        alignas(64) float var_buf[kBlockSize];
+                        alignas(64) float ms_buf[kBlockSize];
+                        alignas(64) float grad_buf[kBlockSize];
+                        alignas(64) float out_buf[kBlockSize];
+
+                        ConstFloatArray var_f(
+                            LoadInput(var + begin, n, var_buf), n);
+                        ConstFloatArray ms_f(
+                            LoadInput(ms + begin, n, ms_buf), n);
+                        ConstFloatArray g(
+                            LoadInput(grad + begin, n, grad_buf), n);
+                        FloatArray out_f(OutputBlock(out + begin, out_buf), n);
+
+                        out_f = var_f - g * lr / (ms_f.sqrt() + epsilon);
+                        StoreBlock(out_f.data(), n, out + begin);
+                      });
+  }
+};
+
+}  // namespace functor
+
+namespace {
+
+// Reads the scalar input `index` as float.
+template <typename T>
+Status GetScalarInput(OpKernelContext* ctx, int index, const char* name,
+                      float* value) {
+  const Tensor& tensor = ctx->input(index);
+  if (!TensorShapeUtils::IsScalar(tensor.shape())) {
+    return errors::InvalidArgument(name, " is not a scalar: ",
+                                   tensor.shape().DebugString());
+  }
+  *value = static_cast<float>(tensor.scalar<T>()());
+  return Status::OK();
+}
+
+// Picks the operands of a fused `Mul` whose inputs are `index` and
+// `index + 1`: the tensor operand goes to `tensor`, the scalar one to `scale`.
+template <typename T>
+Status GetMulInputs(OpKernelContext* ctx, int index, const Tensor** tensor,
+                    float* scale) {
+  const Tensor& left = ctx->input(index);
+  const Tensor& right = ctx->input(index + 1);
+  const bool left_is_scalar = TensorShapeUtils::IsScalar(left.shape());
+  const bool right_is_scalar = TensorShapeUtils::IsScalar(right.shape());
+  if (!left_is_scalar && !right_is_scalar) {
+    return errors::InvalidArgument("neither of mul's inputs is a scalar: ",
+                                   left.shape().DebugString(), " ",
+                                   right.shape().DebugString());
+  }
+  *tensor = left_is_scalar ? &right : &left;
+  *scale = static_cast<float>(
+      (left_is_scalar ? left : right).scalar<T>()());
+  return Status::OK();
+}
+
+}  // namespace
+
+// Handles ITEXApplyAdamWithWeightDecay (has_weight_decay), the fused
+// _ITEXFusedApplyAdam (fused_mul) and _ITEXFusedApplyAdamWithWeightDecay
+// (both), and their resource variants.
+template <typename T, bool has_weight_decay, bool fused_mul>
+class ApplyAdamCPUOp : public OpKernel {
+ public:
+  explicit ApplyAdamCPUOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    if (fused_mul) {
+      std::vector<std::string> fused_ops;
+      int num_addn_inputs;
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("fused_ops", &fused_ops));
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("num_addn_inputs", &num_addn_inputs));
+      OP_REQUIRES(ctx,
+                  fused_ops.size() == 1 && fused_ops[0] == "Mul" &&
+                      num_addn_inputs == 0,
+                  errors::Unimplemented("Only Mul + ApplyAdam is implemented"));
+    }
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const bool sparse = false;
+    auto locks = MaybeLockVariableInputMutexesInOrder<CPUDevice, T>(
+        ctx, use_exclusive_lock_, sparse, {0, 1, 2});
+
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, sparse, &var));
+    Tensor m;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 1, use_exclusive_lock_, sparse, &m));
+    Tensor v;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 2, use_exclusive_lock_, sparse, &v));
+    OP_REQUIRES(ctx, var.IsInitialized(),
+                errors::FailedPrecondition(
+                    "Attempting to use uninitialized variables"));
+    OP_REQUIRES(ctx, m.IsInitialized(),
+                errors::FailedPrecondition(
+                    "Attempting to use uninitialized variables"));
+    OP_REQUIRES(ctx, v.IsInitialized(),
+                errors::FailedPrecondition(
+                    "Attempting to use uninitialized variables"));
+
+    float beta1_power, beta2_power, lr, beta1, beta2, epsilon;
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 3, "beta1_power", &beta1_power));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 4, "beta2_power", &beta2_power));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 5, "lr", &lr));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 6, "beta1", &beta1));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 7, "beta2", &beta2));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 8, "epsilon", &epsilon));
+
+    float weight_decay = 0.0f;
+    int grad_index = 9;
+    if (has_weight_decay) {
+      OP_REQUIRES_OK(ctx,
+                     GetScalarInput<T>(ctx, 9, "weight_decay", &weight_decay));
+      grad_index = 10;
+    }
+
+    const Tensor* grad = &ctx->input(grad_index);
+    float grad_scale = 1.0f;
+    if (fused_mul) {
+      OP_REQUIRES_OK(ctx,
+                     GetMulInputs<T>(ctx, grad_index, &grad, &grad_scale));
+    }
+
+    OP_REQUIRES(ctx, var.shape().IsSameSize(m.shape()),
+                errors::InvalidArgument("var and m do not have the same shape",
+                                        var.shape().DebugString(), " ",
+                                        m.shape().DebugString()));
+    OP_REQUIRES(ctx, var.shape().IsSameSize(v.shape()),
+                errors::InvalidArgument("var and v do not have the same shape",
+                                        var.shape().DebugString(), " ",
+                                        v.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(grad->shape()),
+        errors::InvalidArgument("var and grad do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                grad->shape().DebugString()));
+
+    functor::ApplyAdamCPU<T>()(
+        ctx->eigen_cpu_device(), var.flat<T>().data(), m.flat<T>().data(),
+        v.flat<T>().data(), grad->flat<T>().data(), grad_scale, beta1_power,
+        beta2_power, lr, beta1, beta2, epsilon, weight_decay,
+        var.NumElements());
+    MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+};
+
+template <typename T>
+class FusedApplyMomentumCPUOp : public OpKernel {
+ public:
+  explicit FusedApplyMomentumCPUOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+
+    std::vector<std::string> fused_ops;
+    int num_addn_inputs;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES(ctx,
+                fused_ops.size() == 2 && fused_ops[0] == "Mul" &&
+                    fused_ops[1] == "AddN",
+                errors::Unimplemented(
+                    "Only Mul + AddN + ApplyMomentumOp is implemented"));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_addn_inputs", &num_addn_inputs));
+    OP_REQUIRES(
+        ctx, num_addn_inputs == 1,
+        errors::Unimplemented(
+            "Only num_addn_inputs = 1 is supported by _FusedApplyMomentumOp"));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_mul_inputs", &num_mul_inputs_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const bool sparse = false;
+    auto locks = MaybeLockVariableInputMutexesInOrder<CPUDevice, T>(
+        ctx, use_exclusive_lock_, sparse, {0, 1});
+
+    Tensor var;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 0, use_exclusive_lock_, sparse, &var));
+    Tensor accum;
+    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<CPUDevice, T>(
+                            ctx, 1, use_exclusive_lock_, sparse, &accum));
+    OP_REQUIRES(ctx, var.IsInitialized(),
+                errors::FailedPrecondition(
+                    "Attempting to use uninitialized variables"));
+    OP_REQUIRES(ctx, accum.IsInitialized(),
+                errors::FailedPrecondition(
+                    "Attempting to use uninitialized variables"));
+
+    float lr, momentum;
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 2, "lr", &lr));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 3, "momentum", &momentum));
+
+    // With a single Mul input the other operand is var itself.
+    const Tensor* mul_left = &var;
+    float mul_scale;
+    int addn_index;
+    if (num_mul_inputs_ == 1) {
+      OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 4, "mul input", &mul_scale));
+      addn_index = 5;
+    } else {
+      OP_REQUIRES_OK(ctx, GetMulInputs<T>(ctx, 4, &mul_left, &mul_scale));
+      addn_index = 6;
+    }
+    const Tensor& addn_input = ctx->input(addn_index);
+
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(accum.shape()),
+        errors::InvalidArgument("var and accum do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                accum.shape().DebugString()));
+    OP_REQUIRES(ctx, mul_left->shape().IsSameSize(addn_input.shape()),
+                errors::InvalidArgument(
+                    "mul_left and addN_input do not have the same shape",
+                    mul_left->shape().DebugString(), " ",
+                    addn_input.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(addn_input.shape()),
+        errors::InvalidArgument("var and addN_input do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                addn_input.shape().DebugString()));
+
+    functor::FusedApplyMomentumCPU<T>()(
+        ctx->eigen_cpu_device(), var.flat<T>().data(), accum.flat<T>().data(),
+        mul_left->flat<T>().data(), mul_scale, addn_input.flat<T>().data(), lr,
+        momentum, use_nesterov_, var.NumElements());
+    MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+  }
+
+ private:
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+  int num_mul_inputs_;
+};
+
+template <typename T>
+class ApplyRMSPropComputeRMSCPUOp : public OpKernel {
+ public:
+  explicit ApplyRMSPropComputeRMSCPUOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& ms = ctx->input(0);
+    const Tensor& grad = ctx->input(2);
+    float rho;
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 1, "rho", &rho));
+    OP_REQUIRES(ctx, ms.shape().IsSameSize(grad.shape()),
+                errors::InvalidArgument(
+                    "ms and grad do not have the same shape ",
+                    ms.shape().DebugString(), " ", grad.shape().DebugString()));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->forward_input_or_allocate_output(
+                            {0}, 0, ms.shape(), &output));
+
+    functor::ApplyRMSPropComputeRMSCPU<T>()(
+        ctx->eigen_cpu_device(), ms.flat<T>().data(), rho,
+        grad.flat<T>().data(), output->flat<T>().data(), ms.NumElements());
+  }
+};
+
+template <typename T>
+class ApplyRMSPropVarUpdateCPUOp : public OpKernel {
+ public:
+  explicit ApplyRMSPropVarUpdateCPUOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& var = ctx->input(0);
+    const Tensor& ms = ctx->input(1);
+    const Tensor& grad = ctx->input(4);
+    float lr, epsilon;
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 2, "lr", &lr));
+    OP_REQUIRES_OK(ctx, GetScalarInput<T>(ctx, 3, "epsilon", &epsilon));
+
+    OP_REQUIRES(ctx, var.shape().IsSameSize(ms.shape()),
+                errors::InvalidArgument(
+                    "var and ms do not have the same shape ",
+                    var.shape().DebugString(), " ", ms.shape().DebugString()));
+    OP_REQUIRES(
+        ctx, var.shape().IsSameSize(grad.shape()),
+        errors::InvalidArgument("var and grad do not have the same shape",
+                                var.shape().DebugString(), " ",
+                                grad.shape().DebugString()));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->forward_input_or_allocate_output(
+                            {0}, 0, var.shape(), &output));
+
+    functor::ApplyRMSPropVarUpdateCPU<T>()(
+        ctx->eigen_cpu_device(), var.flat<T>().data(), ms.flat<T>().data(),
+        lr, epsilon, grad.flat<T>().data(), output->flat<T>().data(),
+        var.NumElements());
+  }
+};
+
+#define REGISTER_ADAM_KERNELS(name, T, has_weight_decay, fused_mul) \
+  REGISTER_KERNEL_BUILDER(                                          \
+      Name(name).Device(DEVICE_CPU).TypeConstraint<T>("T"),         \
+      ApplyAdamCPUOp<T, has_weight_decay, fused_mul>)
+
+#define REGISTER_CPU_KERNELS(T)                                            \
+  REGISTER_ADAM_KERNELS("_ITEXFusedApplyAdam", T, false, true);            \
+  REGISTER_ADAM_KERNELS("_ITEXFusedResourceApplyAdam", T, false, true);    \
+  REGISTER_ADAM_KERNELS("ITEXApplyAdamWithWeightDecay", T, true, false);   \
+  REGISTER_ADAM_KERNELS("ITEXResourceApplyAdamWithWeightDecay", T, true,   \
+                        false);                                            \
+  REGISTER_ADAM_KERNELS("_ITEXFusedApplyAdamWithWeightDecay", T, true,     \
+                        true);                                             \
+  REGISTER_ADAM_KERNELS("_ITEXFusedResourceApplyAdamWithWeightDecay", T,   \
+                        true, true);                                       \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXFusedApplyMomentum")                  \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<T>("T"),                     \
+                          FusedApplyMomentumCPUOp<T>);                     \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXFusedResourceApplyMomentum")          \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<T>("T"),                     \
+                          FusedApplyMomentumCPUOp<T>);                     \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXApplyRMSPropComputeRMS")              \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<T>("T"),                     \
+                          ApplyRMSPropComputeRMSCPUOp<T>);                 \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXApplyRMSPropVarUpdate")               \
+                              .Device(DEVICE_CPU)                          \
+                              .TypeConstraint<T>("T"),                     \
+                          ApplyRMSPropVarUpdateCPUOp<T>);
+
+TF_CALL_half(REGISTER_CPU_KERNELS);
+TF_CALL_float(REGISTER_CPU_KERNELS);
+TF_CALL_bfloat16(REGISTER_CPU_KERNELS);
+#undef REGISTER_CPU_KERNELS
+#undef REGISTER_ADAM_KERNELS
+
+}  // namespace itex
@@ -20,10 +20,10 @@ limitations under the License.
 #include <algorithm>
 #include <limits>
 
+#include "itex/core/kernels/common/dense_update_functor.h"
 #include "itex/core/kernels/common/fill_functor.h"
-#include "itex/core/kernels/gpu/dense_update_functor.h"
+#include "itex/core/kernels/common/training_op_helpers.h"
 #include "itex/core/kernels/gpu/inplace_ops_functor.h"
-#include "itex/core/kernels/gpu/training_op_helpers.h"
 #include "itex/core/utils/bounds_check.h"
 #include "itex/core/utils/gpu_device_functions.h"
 #include "itex/core/utils/op_requires.h"
@@ -17,10 +17,10 @@ limitations under the License.
 
 #include "itex/core/kernels/gpu/strided_slice_op.h"
 
+#include "itex/core/kernels/common/training_op_helpers.h"
 #include "itex/core/kernels/gpu/inplace_ops_functor.h"
 #include "itex/core/kernels/gpu/strided_slice_op_impl.h"
 #include "itex/core/kernels/gpu/strided_slice_op_util.h"
-#include "itex/core/kernels/gpu/training_op_helpers.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/op_requires.h"
 #include "itex/core/utils/types.h"
@@ -15,7 +15,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include "itex/core/kernels/gpu/training_op_helpers.h"
+#include "itex/core/kernels/common/training_op_helpers.h"
 #include "itex/core/utils/tensor_types.h"
 #include "itex/core/utils/types.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
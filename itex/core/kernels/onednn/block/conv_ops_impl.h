@@ -211,7 +211,8 @@ class OneDnnConvOp : public OpKernel {
 #ifdef ITEX_ONEDNN_3_0
     if (this->post_op_util_.HasOutputScales()) {
       float* output_scale_ptr = output_scale_cache_.GetCachedPtr(
-          context, this->post_op_util_.GetOutputScale().data(),
+          context, output_scale_key_,
+          this->post_op_util_.GetOutputScale().data(),
           this->post_op_util_.GetOutputScale().size());
       dnnl::memory scales_mem(
           {{static_cast<dnnl_dim_t>(
@@ -612,9 +613,13 @@ class OneDnnConvOp : public OpKernel {
   bool enable_cache_ = false;
   dnnl::fpmath_mode fp32_math_mode_ = dnnl::fpmath_mode::strict;
 
+  bool is_filter_const_ = false;
+  // Inputs the output scales of INT8 kernels were computed from, set in
+  // `ExtendInt8PostOps`.
+  HostDataKey output_scale_key_;
+
  private:
   bool is_conv2d_;
-  bool is_filter_const_ = false;
   bool inplace_sum_ = false;
   std::vector<int32> dilations_;
   std::vector<int32> strides_;
@@ -826,6 +831,10 @@ class OneDnnQuantizedConvOp
     // When the output type is quint8, the output data is requantized
     // into quint8. A post_op "output_scale" is added to do the conversion.
     // Otherwise the output_scale will be 1.f
+    // The scales only change with the ranges of the inputs.
+    const HostDataKey scale_key = ScaleKey(context);
+    if (scale_key == this->output_scale_key_) return;
+
     const Tensor& min_filter_vector = context->input(kFilterMinRangeIndex);
     const Tensor& max_filter_vector = context->input(kFilterMaxRangeIndex);
     size_t depth = min_filter_vector.NumElements();
@@ -867,6 +876,7 @@ class OneDnnQuantizedConvOp
       }
     }
     this->post_op_util_.SetOutputScale(scales);
+    this->output_scale_key_ = scale_key;
   }
 
   Tbias* GetBiasHandle(OpKernelContext* context,
@@ -915,26 +925,29 @@ class OneDnnQuantizedConvOp
 
         // TODO(itex): avoid to use new memory
         size_t depth = min_filter_vector.NumElements();
-        scales_.resize(depth);
-
-        for (size_t i = 0; i < depth; ++i) {
-          float tmp_scale =
-              (std::max(std::abs(max_input), std::abs(min_input)) *
-               std::max(std::abs(max_filter[i]), std::abs(min_filter[i]))) /
-              int_const_scale_limit;
-          // TODO(itex): Check whether delete some instuctions about
-          // scales_are_valid is correct
-          scales_[i] = tmp_scale;
+        const HostDataKey scale_key = ScaleKey(context);
+        if (bias_scale_key_ != scale_key) {
+          scales_.resize(depth);
+          for (size_t i = 0; i < depth; ++i) {
+            float tmp_scale =
+                (std::max(std::abs(max_input), std::abs(min_input)) *
+                 std::max(std::abs(max_filter[i]), std::abs(min_filter[i]))) /
+                int_const_scale_limit;
+            // TODO(itex): Check whether delete some instuctions about
+            // scales_are_valid is correct
+            scales_[i] = tmp_scale;
+          }
+          bias_scale_key_ = scale_key;
         }
         if (bias_cache_manager.IsEmpty()) {
           bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
-              context, scales_.data(), scales_.size());
+              context, bias_scale_key_, scales_.data(), scales_.size());
         }
 
       } else {
         if (bias_cache_manager.IsEmpty()) {
           bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
-              context, scale.data(), scale.size());
+              context, this->output_scale_key_, scale.data(), scale.size());
         }
       }
       if (bias_cache_manager.IsEmpty()) {
@@ -983,29 +996,34 @@ class OneDnnQuantizedConvOp
 
     // TODO(itex): avoid to use new memory
     size_t depth = min_filter_vector.NumElements();
-    scales_.resize(depth);
+    // The bias scales are computed from the same ranges as the output scales.
+    const HostDataKey scale_key = ScaleKey(context);
+    if (bias_scale_key_ != scale_key) {
+      scales_.resize(depth);
 #ifdef ITEX_ONEDNN_3_0
-    const std::vector<float>& scale = this->post_op_util_.GetOutputScale();
+      const std::vector<float>& scale = this->post_op_util_.GetOutputScale();
 #endif
-    for (size_t i = 0; i < depth; ++i) {
-      float tmp_scale =
-          int_const_scale_limit /
-          (std::max(std::abs(max_input), std::abs(min_input)) *
-           std::max(std::abs(max_filter[i]), std::abs(min_filter[i])));
-      // TODO(itex): Check whether delete some instuctions about
-      // scales_are_valid is correct
+      for (size_t i = 0; i < depth; ++i) {
+        float tmp_scale =
+            int_const_scale_limit /
+            (std::max(std::abs(max_input), std::abs(min_input)) *
+             std::max(std::abs(max_filter[i]), std::abs(min_filter[i])));
+        // TODO(itex): Check whether delete some instuctions about
+        // scales_are_valid is correct
 #ifdef ITEX_ONEDNN_3_0
-      scales_[i] = tmp_scale * scale[i];
+        scales_[i] = tmp_scale * scale[i];
 #else
-      scales_[i] = tmp_scale;
+        scales_[i] = tmp_scale;
 #endif
+      }
+      bias_scale_key_ = scale_key;
     }
     // TODO(itex): is_bias_const_ is useless, delete it
     if (!is_bias_const_ || bias_cache_manager.IsEmpty()) {
       dnnl::primitive_attr bias_attr;
 #ifdef ITEX_ONEDNN_3_0
-      float* bias_scales_ptr =
-          bias_scale_cache_.GetCachedPtr(context, scales_.data(), depth);
+      float* bias_scales_ptr = bias_scale_cache_.GetCachedPtr(
+          context, bias_scale_key_, scales_.data(), depth);
       memory bias_scales_mem({{static_cast<dnnl_dim_t>(depth)},
                               memory::data_type::f32,
                               memory::format_tag::x},
@@ -1056,7 +1074,25 @@ class OneDnnQuantizedConvOp
   const int kDstMaxRangeIndex = 2;
 
  private:
+  // Identifies the ranges the output scales and the bias scales are computed
+  // from.
+  HostDataKey ScaleKey(OpKernelContext* context) {
+    HostDataKey key;
+    key.AddValue(context->input(kSrcMinRangeIndex).flat<float>()(0))
+        .AddValue(context->input(kSrcMaxRangeIndex).flat<float>()(0))
+        .AddTensor(context->input(kFilterMinRangeIndex))
+        .AddTensor(context->input(kFilterMaxRangeIndex));
+    if (std::is_same<Toutput, quint8>::value ||
+        std::is_same<Toutput, qint8>::value) {
+      key.AddValue(context->input(kMinFreezedIndex).flat<float>()(0))
+          .AddValue(context->input(kMaxFreezedIndex).flat<float>()(0));
+    }
+    return key;
+  }
+
   std::vector<float> scales_;
+  // Ranges `scales_` was computed from.
+  HostDataKey bias_scale_key_;
   // Bias cache manager
   BiasCacheManager<Tbias> bias_cache_manager;
 #ifdef ITEX_ONEDNN_3_0
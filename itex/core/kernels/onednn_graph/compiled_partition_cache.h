@@ -0,0 +1,149 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_ONEDNN_GRAPH_COMPILED_PARTITION_CACHE_H_
+#define ITEX_CORE_KERNELS_ONEDNN_GRAPH_COMPILED_PARTITION_CACHE_H_
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/onednn/onednn_graph_util.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+// Everything a OneDnnGraph kernel needs to execute a partition once it has
+// been compiled for a given set of input logical tensors.
+struct CompiledPartitionEntry {
+  dnnl::graph::compiled_partition c_partition;
+  // <output_id, input_id>
+  std::unordered_map<size_t, size_t> inplace_id_map;
+  // Output logical tensors queried from `c_partition`, which carry the
+  // inferred output shapes and layouts.
+  std::vector<dnnl::graph::logical_tensor> output_logical_tensors;
+};
+
+// Per-kernel, thread-safe LRU cache of compiled oneDNN Graph partitions keyed
+// by the input logical tensors (id, dtype, shape, layout and constant
+// property). Compiling a partition is expensive, so steady-state inference
+// with a handful of distinct input shapes should never recompile.
+//
+// The capacity can be tuned by `ITEX_ONEDNN_GRAPH_PARTITION_CACHE_CAPACITY`.
+// A value of 0 disables caching.
+class CompiledPartitionCache {
+ public:
+  using EntryPtr = std::shared_ptr<const CompiledPartitionEntry>;
+
+  CompiledPartitionCache() : hits_(0), misses_(0) {
+    int64 capacity;
+    ITEX_CHECK_OK(ReadInt64FromEnvVar(
+        "ITEX_ONEDNN_GRAPH_PARTITION_CACHE_CAPACITY", 32, &capacity));
+    capacity_ = capacity < 0 ? 0 : static_cast<size_t>(capacity);
+  }
+
+  ~CompiledPartitionCache() {
+    ITEX_VLOG(2) << "Compiled partition cache: hits " << hits_.load()
+                 << ", misses " << misses_.load() << ", entries "
+                 << lru_list_.size();
+  }
+
+  CompiledPartitionCache(const CompiledPartitionCache&) = delete;
+  CompiledPartitionCache& operator=(const CompiledPartitionCache&) = delete;
+
+  // Builds the cache key from the input logical tensors of a partition.
+  static string CreateKey(
+      const std::vector<dnnl::graph::logical_tensor>& input_lts) {
+    string key;
+    for (const auto& lt : input_lts) {
+      auto layout_type = lt.get_layout_type();
+      strings::StrAppend(&key, lt.get_id(), ":",
+                         static_cast<int>(lt.get_data_type()), ":",
+                         static_cast<int>(layout_type), ":",
+                         static_cast<int>(lt.get_property_type()), ":[");
+      for (auto dim : lt.get_dims()) strings::StrAppend(&key, dim, ",");
+      strings::StrAppend(&key, "]");
+      if (layout_type == dnnl::graph::logical_tensor::layout_type::opaque) {
+        strings::StrAppend(&key, "L", lt.get_layout_id());
+      } else if (layout_type ==
+                 dnnl::graph::logical_tensor::layout_type::strided) {
+        strings::StrAppend(&key, "S");
+        for (auto stride : lt.get_strides())
+          strings::StrAppend(&key, stride, ",");
+      }
+      strings::StrAppend(&key, ";");
+    }
+    return key;
+  }
+
+  // Returns the cached entry for `key`, or nullptr on miss. A hit moves the
+  // entry to the front of the LRU list.
+  EntryPtr Lookup(const string& key) {
+    mutex_lock lock(&mu_);
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      misses_++;
+      return nullptr;
+    }
+    hits_++;
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+    return iter->second->second;
+  }
+
+  // Inserts `entry` under `key` and returns the entry that ends up cached.
+  // If another thread compiled the same key concurrently, its entry is kept
+  // and returned so all callers share one compiled partition.
+  EntryPtr Insert(const string& key, EntryPtr entry) {
+    if (capacity_ == 0) return entry;
+    mutex_lock lock(&mu_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+      return iter->second->second;
+    }
+    lru_list_.emplace_front(key, std::move(entry));
+    index_[key] = lru_list_.begin();
+    while (lru_list_.size() > capacity_) {
+      index_.erase(lru_list_.back().first);
+      lru_list_.pop_back();
+    }
+    return lru_list_.front().second;
+  }
+
+  int64 hits() const { return hits_.load(); }
+  int64 misses() const { return misses_.load(); }
+
+ private:
+  using LRUList = std::list<std::pair<string, EntryPtr>>;
+
+  size_t capacity_;
+  mutex mu_;
+  LRUList lru_list_ TF_GUARDED_BY(mu_);
+  std::unordered_map<string, LRUList::iterator> index_ TF_GUARDED_BY(mu_);
+  std::atomic<int64> hits_;
+  std::atomic<int64> misses_;
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_ONEDNN_GRAPH_COMPILED_PARTITION_CACHE_H_
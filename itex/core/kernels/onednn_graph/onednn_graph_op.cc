@@ -18,6 +18,7 @@ limitations under the License.
 #include "itex/core/devices/gpu/gpu_pool_allocator.h"
 #include "third_party/build_option/dpcpp/runtime/itex_gpu_runtime.h"
 #endif  // INTEL_CPU_ONLY
+#include "itex/core/kernels/onednn_graph/compiled_partition_cache.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/onednn/onednn_graph_util.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
@@ -196,6 +197,31 @@ void GetInplaceIdMap(
   }
 }
 
+// Compile the partition for the given input/output logical tensors and collect
+// everything needed to execute it, so the result can be cached and reused
+// across Compute calls with the same input logical tensors.
+template <typename Engine>
+CompiledPartitionCache::EntryPtr CompilePartition(
+    int partition_id,
+    const std::vector<dnnl::graph::logical_tensor>& l_input_logical_tensor,
+    const std::vector<dnnl::graph::logical_tensor>& l_output_logical_tensor,
+    const std::vector<int64_t>& output_edge_ids,
+    const Engine& onednn_engine) {
+  auto partition = std::make_shared<dnnl::graph::partition>(
+      graph::GetOneDnnGraphPartition(partition_id));
+  auto entry = std::make_shared<CompiledPartitionEntry>();
+  entry->c_partition = partition->compile(
+      l_input_logical_tensor, l_output_logical_tensor, onednn_engine);
+  GetInplaceIdMap(entry->c_partition, l_input_logical_tensor,
+                  l_output_logical_tensor, &entry->inplace_id_map);
+  entry->output_logical_tensors.reserve(output_edge_ids.size());
+  for (auto output_edge_id : output_edge_ids) {
+    entry->output_logical_tensors.push_back(
+        entry->c_partition.query_logical_tensor(output_edge_id));
+  }
+  return entry;
+}
+
 // Currently, LLGA kernels only works with Layout pass ON. Because meta tensor
 // is required to pass the LLGA layout information
 // TODO(itex): Enable LLGA with ITEX plain format.
@@ -231,9 +257,6 @@ class OneDnnGraphOp : public OpKernel {
     dnnl::graph::stream onednn_stream =
         CreateDnnlStream<Device>(ctx, onednn_engine);
 #endif
-    auto partition = std::make_shared<dnnl::graph::partition>(
-        graph::GetOneDnnGraphPartition(partition_id_));
-
     ITEX_CHECK_EQ(input_edge_ids_.size(), is_constant_input_edge_.size());
 
     // Prepare input tensors and logical tensors
@@ -270,38 +293,44 @@ class OneDnnGraphOp : public OpKernel {
           l_input_logical_tensor[index], onednn_engine, current_src_ptr));
     }
 
-    // Prepare output logical tensors
-    for (int index = 0; index < output_edge_ids_.size(); index++) {
-      auto output_data_type =
-          graph::GetOneDnnGraphDataType(output_dt_types_[index]);
-      l_output_logical_tensor.push_back(dnnl::graph::logical_tensor(
-          output_edge_ids_[index], output_data_type,
-          -1 /* output shape unknown */,
-          dnnl::graph::logical_tensor::layout_type::strided));
+    // Only compile the partition when the input logical tensors are seen for
+    // the first time.
+    const string cache_key =
+        CompiledPartitionCache::CreateKey(l_input_logical_tensor);
+    auto entry = partition_cache_.Lookup(cache_key);
+    if (entry == nullptr) {
+      // Prepare output logical tensors
+      for (int index = 0; index < output_edge_ids_.size(); index++) {
+        auto output_data_type =
+            graph::GetOneDnnGraphDataType(output_dt_types_[index]);
+        l_output_logical_tensor.push_back(dnnl::graph::logical_tensor(
+            output_edge_ids_[index], output_data_type,
+            -1 /* output shape unknown */,
+            dnnl::graph::logical_tensor::layout_type::strided));
+      }
+      entry = partition_cache_.Insert(
+          cache_key,
+          CompilePartition(partition_id_, l_input_logical_tensor,
+                           l_output_logical_tensor, output_edge_ids_,
+                           onednn_engine));
     }
-
-    auto c_partition = partition->compile(
-        l_input_logical_tensor, l_output_logical_tensor, onednn_engine);
-
-    std::unordered_map<size_t, size_t> inplace_id_map;  // <output_id, input_id>
-    GetInplaceIdMap(c_partition, l_input_logical_tensor,
-                    l_output_logical_tensor, &inplace_id_map);
+    const auto& c_partition = entry->c_partition;
+    const auto& inplace_id_map = entry->inplace_id_map;
 
     // Prepare output tensors
     for (int index = 0; index < output_edge_ids_.size(); index++) {
       TensorShape tf_shape;
-      auto output_logical_tensor =
-          c_partition.query_logical_tensor(output_edge_ids_[index]);
+      const auto& output_logical_tensor = entry->output_logical_tensors[index];
       for (int dim : output_logical_tensor.get_dims()) {
         tf_shape.AddDim(dim);
       }
 
       if (inplace_id_map.find(index) != inplace_id_map.end() &&
-          candidate_inplace_input_edge_[inplace_id_map[index]] == true) {
+          candidate_inplace_input_edge_[inplace_id_map.at(index)] == true) {
         // TODO(itex): Check whether LLGA and TensorFlow inplace mechanism
         // are exacly the same
 
-        int input_index = inplace_id_map[index];
+        int input_index = inplace_id_map.at(index);
         const Tensor& input_tensor = ctx->input(input_index);
 
         if (input_tensor.dtype() != ctx->expected_output_dtype(index)) {
@@ -343,6 +372,7 @@ class OneDnnGraphOp : public OpKernel {
   std::vector<bool> is_constant_input_edge_;
   std::vector<bool> candidate_inplace_input_edge_;
   std::vector<string> framework_ops_;
+  CompiledPartitionCache partition_cache_;
 };
 
 #define MATCH_TYPE_AND_SIZE(TYPE) \
@@ -401,9 +431,6 @@ class OneDnnGraphWithLayoutOp : public OpKernel {
     dnnl::graph::stream onednn_stream =
         CreateDnnlStream<Device>(ctx, onednn_engine);
 #endif
-    auto partition = std::make_shared<dnnl::graph::partition>(
-        graph::GetOneDnnGraphPartition(partition_id_));
-
     ITEX_CHECK_EQ(input_edge_ids_.size(), is_constant_input_edge_.size());
 
     // Prepare input tensors and logical tensors
@@ -458,34 +485,40 @@ class OneDnnGraphWithLayoutOp : public OpKernel {
           l_input_logical_tensor[index], onednn_engine, current_src_ptr));
     }
 
-    // Prepare output logical tensors
-    for (int index = 0; index < output_edge_ids_.size(); index++) {
-      auto output_data_type =
-          graph::GetOneDnnGraphDataType(output_dt_types_[index]);
-
-      if (is_end_node_[index])
-        l_output_logical_tensor.push_back(dnnl::graph::logical_tensor(
-            output_edge_ids_[index], output_data_type,
-            -1 /* output shape unknown */,
-            dnnl::graph::logical_tensor::layout_type::strided));
-      else
-        l_output_logical_tensor.push_back(dnnl::graph::logical_tensor(
-            output_edge_ids_[index], output_data_type,
-            -1 /* output shape unknown */,
-            dnnl::graph::logical_tensor::layout_type::any));
+    // Only compile the partition when the input logical tensors are seen for
+    // the first time.
+    const string cache_key =
+        CompiledPartitionCache::CreateKey(l_input_logical_tensor);
+    auto entry = partition_cache_.Lookup(cache_key);
+    if (entry == nullptr) {
+      // Prepare output logical tensors
+      for (int index = 0; index < output_edge_ids_.size(); index++) {
+        auto output_data_type =
+            graph::GetOneDnnGraphDataType(output_dt_types_[index]);
+
+        if (is_end_node_[index])
+          l_output_logical_tensor.push_back(dnnl::graph::logical_tensor(
+              output_edge_ids_[index], output_data_type,
+              -1 /* output shape unknown */,
+              dnnl::graph::logical_tensor::layout_type::strided));
+        else
+          l_output_logical_tensor.push_back(dnnl::graph::logical_tensor(
+              output_edge_ids_[index], output_data_type,
+              -1 /* output shape unknown */,
+              dnnl::graph::logical_tensor::layout_type::any));
+      }
+      entry = partition_cache_.Insert(
+          cache_key,
+          CompilePartition(partition_id_, l_input_logical_tensor,
+                           l_output_logical_tensor, output_edge_ids_,
+                           onednn_engine));
     }
-
-    auto c_partition = partition->compile(
-        l_input_logical_tensor, l_output_logical_tensor, onednn_engine);
-
-    std::unordered_map<size_t, size_t> inplace_id_map;  // <output_id, input_id>
-    GetInplaceIdMap(c_partition, l_input_logical_tensor,
-                    l_output_logical_tensor, &inplace_id_map);
+    const auto& c_partition = entry->c_partition;
+    const auto& inplace_id_map = entry->inplace_id_map;
 
     // Prepare output tensors
     for (int index = 0; index < output_edge_ids_.size(); index++) {
-      auto output_logical_tensor =
-          c_partition.query_logical_tensor(output_edge_ids_[index]);
+      const auto& output_logical_tensor = entry->output_logical_tensors[index];
       TensorShape tf_shape;
       if (is_end_node_[index]) {
         auto sizes = output_logical_tensor.get_dims();
@@ -520,10 +553,10 @@ class OneDnnGraphWithLayoutOp : public OpKernel {
       }
 
       if (inplace_id_map.find(index) != inplace_id_map.end() &&
-          candidate_inplace_input_edge_[inplace_id_map[index]] == true) {
+          candidate_inplace_input_edge_[inplace_id_map.at(index)] == true) {
         // TODO(itex): Check whether LLGA and TensorFlow inplace mechanism
         // are exacly the same
-        int input_index = inplace_id_map[index];
+        int input_index = inplace_id_map.at(index);
         const Tensor& input_tensor = ctx->input(input_index);
 
         if (input_tensor.dtype() != ctx->expected_output_dtype(index)) {
@@ -578,6 +611,7 @@ class OneDnnGraphWithLayoutOp : public OpKernel {
   std::vector<bool> candidate_inplace_input_edge_;
   std::vector<string> framework_ops_;
   std::vector<bool> is_end_node_;
+  CompiledPartitionCache partition_cache_;
 };
 
 #ifdef INTEL_CPU_ONLY
@@ -371,6 +371,31 @@ void Register_ITEXFusedMatMulOp() {
   }
 }
 
+void Register_ITEXDynamicQuantizedMatMulOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXDynamicQuantizedMatMul");
+    TF_OpDefinitionBuilderAddInput(op_builder, "a: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "b: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "args: num_args * T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "product: T");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "transpose_b: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "num_args: int >= 0");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "fused_ops: list(string) = []");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "leakyrelu_alpha: float = 0.2");
+    TF_OpDefinitionBuilderAddAttr(
+        op_builder,
+        "quantization_mode: {'PER_TENSOR', 'PER_ROW'} = 'PER_TENSOR'");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unknown_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXDynamicQuantizedMatMul op registration failed: ";
+  }
+}
+
 void Register_QuantizedFusedMatMulOp() {
   itex::StatusUniquePtr status(TF_NewStatus());
   {
@@ -2940,8 +2965,8 @@ void Register_ITEXResizeBilinearOp() {
 
     TF_OpDefinitionBuilderAddOutput(op_builder, "resized_images: float");
 
-    TF_OpDefinitionBuilderAddAttr(op_builder,
-                                  "T: {bfloat16, half, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(
+        op_builder, "T: {int8, uint8, bfloat16, half, float} = DT_FLOAT");
     TF_OpDefinitionBuilderAddAttr(op_builder, "align_corners: bool = false");
     TF_OpDefinitionBuilderAddAttr(op_builder,
                                   "half_pixel_centers: bool = false");
@@ -2979,6 +3004,31 @@ void Register_ITEXResizeBilinearGradOp() {
   }
 }
 
+void Register_ITEXResizeNearestNeighborOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXResizeNearestNeighbor");
+    TF_OpDefinitionBuilderAddInput(op_builder, "images: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "size: int32");
+
+    TF_OpDefinitionBuilderAddOutput(op_builder, "resized_images: T");
+
+    TF_OpDefinitionBuilderAddAttr(
+        op_builder, "T: {int8, uint8, bfloat16, half, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "align_corners: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "half_pixel_centers: bool = false");
+
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unknown_shape_fn);
+
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXResizeNearestNeighbor op registration failed: ";
+  }
+}
+
 void Register_ITEXTransposeOp() {
   itex::StatusUniquePtr status(TF_NewStatus());
   {
@@ -3022,6 +3072,55 @@ void Register_ITEXGroupNormOp() {
   }
 }
 
+void Register_ITEXGroupNormGradOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("ITEXGroupNormGrad");
+    TF_OpDefinitionBuilderAddInput(op_builder, "y_backprop: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "x: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "scale: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "offset: T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "x_backprop: T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "scale_backprop: T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "offset_backprop: T");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {half, bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "num_groups: int");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "epsilon: float = 0.0001");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_scale: bool = true");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_center: bool = true");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &group_norm_grad_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "ITEXGroupNormGrad op registration failed: ";
+  }
+}
+
+void Register_ITEXFusedGroupNormOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXFusedGroupNorm");
+    TF_OpDefinitionBuilderAddInput(op_builder, "x: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "scale: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "offset: T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "y: T");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {half, bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "num_groups: int");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "epsilon: float = 0.0001");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_scale: bool = true");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_center: bool = true");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "activation_mode: string = \"Identity\"");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unchanged_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXFusedGroupNorm op registration failed: ";
+  }
+}
+
 void Register_ITEXLayerNormOp() {
   itex::StatusUniquePtr status(TF_NewStatus());
   {
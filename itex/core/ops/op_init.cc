@@ -108,6 +108,7 @@ void RegisterOps() {
   Register_ITEXConv2DBackpropInputWithSliceOp();
   Register_ITEXConv3DBackpropFilterWithBiasOp();
   Register_ITEXConv3DBackpropInputV2WithSliceOp();
+  Register_ITEXDynamicQuantizedMatMulOp();
   Register_ITEXEqualWithCastOp();
   Register_ITEXFusedAddNOp();
   Register_ITEXFusedBatchNormGradExOp();
@@ -184,6 +185,8 @@ void RegisterOps() {
   Register_ITEXLayerNormOp();
   Register_ITEXLayerNormGradOp();
   Register_ITEXGroupNormOp();
+  Register_ITEXGroupNormGradOp();
+  Register_ITEXFusedGroupNormOp();
   Register_ITEXLeakyReluGradOp();
   Register_ITEXLeakyReluOp();
   Register_ITEXMatMul();
@@ -234,6 +237,7 @@ void RegisterOps() {
   Register_ITEXReluOp();
   Register_ITEXResizeBilinearOp();
   Register_ITEXResizeBilinearGradOp();
+  Register_ITEXResizeNearestNeighborOp();
   Register_ITEXSliceOp();
   Register_ITEXSoftmaxOp();
   Register_ITEXTransposeOp();
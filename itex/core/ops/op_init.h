@@ -61,6 +61,7 @@ void Register_ITEXConv2DBackpropFilterWithBiasOp();
 void Register_ITEXConv2DBackpropInputWithSliceOp();
 void Register_ITEXConv3DBackpropFilterWithBiasOp();
 void Register_ITEXConv3DBackpropInputV2WithSliceOp();
+void Register_ITEXDynamicQuantizedMatMulOp();
 void Register_ITEXEqualWithCastOp();
 void Register_ITEXFusedAddNOp();
 void Register_ITEXFusedBatchNormGradExOp();
@@ -107,6 +108,8 @@ void Register_ITEXTensorArraySize();
 void Register_ITEXTensorArrayClose();
 void Register_LayerNormOp();
 void Register_ITEXGroupNormOp();
+void Register_ITEXGroupNormGradOp();
+void Register_ITEXFusedGroupNormOp();
 void Register_LayerNormGradOp();
 void Register_ITEXRnnOp();
 void Register_ITEXRnnGradOp();
@@ -207,6 +210,7 @@ void Register_ITEXReluGradOp();
 void Register_ITEXReluOp();
 void Register_ITEXResizeBilinearOp();
 void Register_ITEXResizeBilinearGradOp();
+void Register_ITEXResizeNearestNeighborOp();
 void Register_ITEXSliceOp();
 void Register_ITEXSoftmaxOp();
 void Register_ITEXSwishOp();
@@ -0,0 +1,149 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "itex/core/profiler/utils/parse_annotation.h"
+#include "itex/core/profiler/utils/xplane_builder.h"
+#include "itex/core/profiler/utils/xplane_schema.h"
+#include "itex/core/profiler/utils/xplane_utils.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/thread_annotations.h"
+#include "itex/core/utils/traceme.h"
+#include "itex/core/utils/traceme_recorder.h"
+#include "protos/xplane.pb.h"
+#include "tensorflow/c/experimental/pluggable_profiler/pluggable_profiler.h"
+
+// The CPU profiler collects the TraceMe events of ITEX: one event per kernel
+// from the kernel registration wrapper, and one per oneDNN primitive from
+// `ExecutePrimitive` with the kind and implementation of the primitive.
+// ITEX records them in its own TraceMeRecorder, which TF's host tracer can't
+// see, so they are converted to an XPlane of their own here.
+
+namespace {
+
+// TF's host tracer already owns "/host:CPU".
+inline std::string CpuPlaneName() {
+  return itex::strings::StrCat(itex::profiler::kCustomPlanePrefix,
+                               "ITEX_CPU");
+}
+
+itex::mutex mu;
+uint64_t start_walltime_ns TF_GUARDED_BY(mu) = 0;
+itex::TraceMeRecorder::Events events TF_GUARDED_BY(mu);
+
+void ConvertEventsToXPlane(uint64_t start_time_ns,
+                           const itex::TraceMeRecorder::Events& thread_events,
+                           itex::profiler::XPlaneBuilder* plane) {
+  for (const auto& thread : thread_events) {
+    itex::profiler::XLineBuilder line =
+        plane->GetOrCreateLine(thread.thread.tid);
+    line.SetName(thread.thread.name);
+    line.SetTimestampNs(start_time_ns);
+    line.ReserveEvents(thread.events.size());
+
+    // Events split by ActivityStart and ActivityEnd are paired by their
+    // activity id. The start carries the name.
+    absl::flat_hash_map<int64_t, const itex::TraceMeRecorder::Event*> starts;
+    for (const auto& event : thread.events) {
+      const itex::TraceMeRecorder::Event* start = &event;
+      int64_t end_time = event.end_time;
+      if (event.IsStart()) {
+        starts.emplace(event.ActivityId(), &event);
+        continue;
+      } else if (event.IsEnd()) {
+        auto it = starts.find(event.ActivityId());
+        if (it == starts.end()) continue;
+        start = it->second;
+        starts.erase(it);
+      }
+
+      itex::profiler::Annotation annotation =
+          itex::profiler::ParseAnnotation(start->name);
+      itex::profiler::XEventBuilder xevent = line.AddEvent(
+          *plane->GetOrCreateEventMetadata(annotation.name));
+      xevent.SetTimestampNs(start->start_time);
+      xevent.SetEndTimestampNs(end_time);
+      for (const auto& metadata : annotation.metadata) {
+        xevent.AddStatValue(*plane->GetOrCreateStatMetadata(metadata.key),
+                            metadata.value);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void cpu_start(const TP_Profiler* profiler, TF_Status* status) {
+  itex::mutex_lock lock(&mu);
+  events.clear();
+  start_walltime_ns = itex::EnvTime::NowNanos();
+  // kInfo also records the oneDNN primitives inside the kernels.
+  if (!itex::TraceMeRecorder::Start(itex::TraceMeLevel::kInfo)) {
+    ITEX_LOG(WARNING) << "Intel Extension For TensorFlow CPU profiler is "
+                         "already recording.";
+  }
+}
+
+void cpu_stop(const TP_Profiler* profiler, TF_Status* status) {
+  itex::mutex_lock lock(&mu);
+  events = itex::TraceMeRecorder::Stop();
+}
+
+void cpu_collect_data_xspace(const TP_Profiler* profiler, uint8_t* buffer,
+                             size_t* size_in_bytes, TF_Status* status) {
+  itex::XSpace space;
+  {
+    itex::mutex_lock lock(&mu);
+    if (!events.empty()) {
+      itex::profiler::XPlaneBuilder plane(
+          itex::profiler::FindOrAddMutablePlaneWithName(&space,
+                                                        CpuPlaneName()));
+      ConvertEventsToXPlane(start_walltime_ns, events, &plane);
+    }
+    // TF calls this twice, first without a buffer to query the size, so the
+    // events are only dropped once they are serialized.
+    if (buffer != nullptr) events.clear();
+  }
+
+  *size_in_bytes = space.ByteSizeLong();
+  if (buffer == nullptr) {
+    return;
+  }
+  space.SerializeToArray(buffer, space.ByteSizeLong());
+}
+
+void cpu_destroy_profiler(TP_Profiler* profiler) {}
+
+void cpu_destroy_profiler_fns(TP_ProfilerFns* profiler_fns) {}
+
+void TF_InitProfiler(TF_ProfilerRegistrationParams* params, TF_Status* status) {
+  params->struct_size = TF_PROFILER_REGISTRATION_PARAMS_STRUCT_SIZE;
+  params->profiler->struct_size = TP_PROFILER_STRUCT_SIZE;
+  params->profiler_fns->struct_size = TP_PROFILER_FNS_STRUCT_SIZE;
+
+  params->profiler->device_type = "CPU";
+
+  params->profiler_fns->start = cpu_start;
+  params->profiler_fns->stop = cpu_stop;
+  params->profiler_fns->collect_data_xspace = cpu_collect_data_xspace;
+  params->destroy_profiler = cpu_destroy_profiler;
+  params->destroy_profiler_fns = cpu_destroy_profiler_fns;
+}
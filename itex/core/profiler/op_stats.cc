@@ -0,0 +1,181 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/profiler/op_stats.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace itex {
+
+namespace {
+
+int BucketOf(int64_t latency_ns) {
+  if (latency_ns <= 1) return 0;
+  int bucket = 63 - __builtin_clzll(static_cast<uint64_t>(latency_ns));
+  return std::min(bucket, OpStatsRegistry::kNumBuckets - 1);
+}
+
+void SortByTotalTime(std::vector<OpStatsRegistry::Stats>* stats) {
+  std::sort(stats->begin(), stats->end(),
+            [](const OpStatsRegistry::Stats& a,
+               const OpStatsRegistry::Stats& b) {
+              return a.total_ns > b.total_ns;
+            });
+}
+
+}  // namespace
+
+class OpStatsRegistry::Shard {
+ public:
+  std::mutex mu;
+  std::unordered_map<const void*, Stats> kernels;
+  // Stats of deleted kernels whose address was reused by a new kernel.
+  std::vector<Stats> retired;
+};
+
+int64_t OpStatsRegistry::Stats::Percentile(double percent) const {
+  const double target = calls * percent / 100.0;
+  int64_t count = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    count += buckets[i];
+    if (count >= target && count > 0) {
+      return std::min(int64_t{2} << i, max_ns);
+    }
+  }
+  return max_ns;
+}
+
+void OpStatsRegistry::Stats::Merge(const Stats& other) {
+  calls += other.calls;
+  total_ns += other.total_ns;
+  max_ns = std::max(max_ns, other.max_ns);
+  allocated_bytes += other.allocated_bytes;
+  for (int i = 0; i < kNumBuckets; ++i) buckets[i] += other.buckets[i];
+}
+
+OpStatsRegistry* OpStatsRegistry::Global() {
+  static OpStatsRegistry* registry = new OpStatsRegistry();
+  return registry;
+}
+
+OpStatsRegistry::OpStatsRegistry() = default;
+OpStatsRegistry::~OpStatsRegistry() = default;
+
+OpStatsRegistry::Shard* OpStatsRegistry::GetThreadShard() {
+  thread_local Shard* shard = nullptr;
+  if (shard == nullptr) {
+    std::lock_guard<std::mutex> lock(mu_);
+    shards_.emplace_back(new Shard());
+    shard = shards_.back().get();
+  }
+  return shard;
+}
+
+void OpStatsRegistry::Record(const void* kernel, absl::string_view node_name,
+                             absl::string_view op_type, int64_t latency_ns,
+                             int64_t allocated_bytes) {
+  Shard* shard = GetThreadShard();
+  // Only contended while the stats are read.
+  std::lock_guard<std::mutex> lock(shard->mu);
+  Stats& stats = shard->kernels[kernel];
+  if (stats.node_name != node_name || stats.op_type != op_type) {
+    if (stats.calls > 0) shard->retired.push_back(std::move(stats));
+    stats = Stats();
+    stats.node_name = std::string(node_name);
+    stats.op_type = std::string(op_type);
+  }
+  ++stats.calls;
+  stats.total_ns += latency_ns;
+  stats.max_ns = std::max(stats.max_ns, latency_ns);
+  stats.allocated_bytes += allocated_bytes;
+  ++stats.buckets[BucketOf(latency_ns)];
+}
+
+void OpStatsRegistry::RegisterPrimitiveCache(std::string name,
+                                             std::function<int64_t()> hits,
+                                             std::function<int64_t()> misses) {
+  std::lock_guard<std::mutex> lock(mu_);
+  CacheEntry entry;
+  entry.base.name = std::move(name);
+  entry.hits = std::move(hits);
+  entry.misses = std::move(misses);
+  caches_.push_back(std::move(entry));
+}
+
+void OpStatsRegistry::RegisterAllocator(
+    std::function<AllocatorStats()> get_stats) {
+  std::lock_guard<std::mutex> lock(mu_);
+  allocators_.push_back(std::move(get_stats));
+}
+
+OpStatsRegistry::Snapshot OpStatsRegistry::GetSnapshot() {
+  std::map<std::pair<std::string, std::string>, Stats> nodes;
+  std::map<std::string, Stats> ops;
+  Snapshot snapshot;
+
+  std::lock_guard<std::mutex> lock(mu_);
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> shard_lock(shard->mu);
+    auto merge = [&](const Stats& stats) {
+      Stats& node = nodes[{stats.node_name, stats.op_type}];
+      if (node.calls == 0) {
+        node.node_name = stats.node_name;
+        node.op_type = stats.op_type;
+      }
+      node.Merge(stats);
+    };
+    for (const auto& kernel : shard->kernels) merge(kernel.second);
+    for (const auto& stats : shard->retired) merge(stats);
+  }
+  for (auto& node : nodes) {
+    Stats& op = ops[node.second.op_type];
+    op.op_type = node.second.op_type;
+    op.Merge(node.second);
+    snapshot.nodes.push_back(std::move(node.second));
+  }
+  for (auto& op : ops) snapshot.ops.push_back(std::move(op.second));
+  SortByTotalTime(&snapshot.ops);
+  SortByTotalTime(&snapshot.nodes);
+
+  for (const auto& cache : caches_) {
+    CacheStats stats;
+    stats.name = cache.base.name;
+    stats.hits = cache.hits() - cache.base.hits;
+    stats.misses = cache.misses() - cache.base.misses;
+    snapshot.primitive_caches.push_back(std::move(stats));
+  }
+  for (const auto& get_stats : allocators_) {
+    snapshot.allocators.push_back(get_stats());
+  }
+  return snapshot;
+}
+
+void OpStatsRegistry::Reset() {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> shard_lock(shard->mu);
+    shard->kernels.clear();
+    shard->retired.clear();
+  }
+  for (auto& cache : caches_) {
+    cache.base.hits = cache.hits();
+    cache.base.misses = cache.misses();
+  }
+}
+
+}  // namespace itex
@@ -0,0 +1,137 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_PROFILER_OP_STATS_H_
+#define ITEX_CORE_PROFILER_OP_STATS_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace itex {
+
+// Process-wide statistics of kernel executions: calls, latency histogram and
+// allocated bytes of every node, merged by op type on read, and the hit rates
+// of the oneDNN primitive caches.
+//
+// Each thread records into a shard of its own, so kernels running on
+// different threads never wait for each other. A shard is only shared with
+// readers, which merge all shards in `GetSnapshot`.
+//
+// The registry is defined in libitex_common.so, so that the kernels of the
+// plugin and the Python wrapper see the same instance. It only depends on the
+// standard library for the same reason.
+class OpStatsRegistry {
+ public:
+  // Bucket i of the latency histogram counts the calls which took
+  // [2^i, 2^(i+1)) ns, the last one also counts all longer calls.
+  static constexpr int kNumBuckets = 40;
+
+  struct Stats {
+    std::string op_type;
+    // Empty in the stats of an op type.
+    std::string node_name;
+    int64_t calls = 0;
+    int64_t total_ns = 0;
+    int64_t max_ns = 0;
+    int64_t allocated_bytes = 0;
+    std::array<int64_t, kNumBuckets> buckets{};
+
+    // Returns the latency in ns which `percent` of the calls didn't exceed,
+    // rounded up to the bucket bound.
+    int64_t Percentile(double percent) const;
+    void Merge(const Stats& other);
+  };
+
+  struct CacheStats {
+    std::string name;
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+
+  struct AllocatorStats {
+    std::string name;
+    int64_t num_allocs = 0;
+    // Allocations served from the cache, and from the system.
+    int64_t cache_hits = 0;
+    int64_t cache_misses = 0;
+    int64_t bytes_in_use = 0;
+    int64_t peak_bytes_in_use = 0;
+    int64_t largest_alloc_size = 0;
+    // Bytes of freed blocks kept for reuse.
+    int64_t bytes_cached = 0;
+  };
+
+  struct Snapshot {
+    // Both sorted by total time, descending.
+    std::vector<Stats> ops;
+    std::vector<Stats> nodes;
+    std::vector<CacheStats> primitive_caches;
+    std::vector<AllocatorStats> allocators;
+  };
+
+  static OpStatsRegistry* Global();
+
+  // Records one execution of `kernel`. The names are only copied the first
+  // time the kernel runs on the calling thread.
+  void Record(const void* kernel, absl::string_view node_name,
+              absl::string_view op_type, int64_t latency_ns,
+              int64_t allocated_bytes);
+
+  // Adds a primitive cache to the snapshots. The cache must outlive the
+  // registry, and `hits` and `misses` return its cumulative counters.
+  void RegisterPrimitiveCache(std::string name, std::function<int64_t()> hits,
+                              std::function<int64_t()> misses);
+
+  // Adds an allocator to the snapshots. The allocator must outlive the
+  // registry, and `get_stats` returns its current stats. They are not reset.
+  void RegisterAllocator(std::function<AllocatorStats()> get_stats);
+
+  Snapshot GetSnapshot();
+
+  // Drops all recorded executions and restarts the cache counters from 0.
+  void Reset();
+
+ private:
+  class Shard;
+  struct CacheEntry {
+    CacheStats base;
+    std::function<int64_t()> hits;
+    std::function<int64_t()> misses;
+  };
+
+  OpStatsRegistry();
+  ~OpStatsRegistry();
+  OpStatsRegistry(const OpStatsRegistry&) = delete;
+  OpStatsRegistry& operator=(const OpStatsRegistry&) = delete;
+
+  Shard* GetThreadShard();
+
+  std::mutex mu_;
+  // Shards are kept after their thread exits, so no stats are lost.
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<CacheEntry> caches_;
+  std::vector<std::function<AllocatorStats()>> allocators_;
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_PROFILER_OP_STATS_H_
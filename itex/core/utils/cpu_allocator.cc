@@ -0,0 +1,179 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/cpu_allocator.h"
+
+#include <utility>
+
+#include "itex/core/profiler/op_stats.h"
+#include "itex/core/utils/cpu_threadpool.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/numa.h"
+
+namespace itex {
+
+namespace {
+
+// Requests up to 256 bytes share the first bin, larger ones get one of four
+// bins per power of 2.
+constexpr int kMinBlockBits = 8;
+constexpr size_t kMinBlockSize = size_t{1} << kMinBlockBits;
+constexpr int kNumBins = (64 - kMinBlockBits) * 4 + 1;
+
+// Every block starts with a header holding its size, followed by the memory
+// returned to the caller.
+constexpr size_t kHeaderSize = CPUCachingAllocator::kAlignment;
+
+void UpdateMax(std::atomic<int64>* max, int64 value) {
+  int64 current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+CPUCachingAllocator* CPUCachingAllocator::GetInstance() {
+  static CPUCachingAllocator* instance = []() -> CPUCachingAllocator* {
+    int64 cache_mb;
+    ITEX_CHECK_OK(
+        ReadInt64FromEnvVar("ITEX_CPU_ALLOCATOR_CACHE_MB", 256, &cache_mb));
+    if (cache_mb <= 0) return nullptr;
+    return new CPUCachingAllocator(static_cast<size_t>(cache_mb) << 20);
+  }();
+  return instance;
+}
+
+CPUCachingAllocator::CPUCachingAllocator(size_t cache_limit)
+    : cache_limit_(cache_limit),
+      numa_node_(CPUThreadPool::GetInstance()->NUMANode()),
+      bins_(kNumBins),
+      num_allocs_(0),
+      cache_hits_(0),
+      bytes_in_use_(0),
+      peak_bytes_in_use_(0),
+      largest_alloc_size_(0),
+      bytes_cached_(0) {
+  OpStatsRegistry::Global()->RegisterAllocator([this]() {
+    OpStatsRegistry::AllocatorStats stats;
+    stats.name = "itex_cpu_caching";
+    stats.num_allocs = num_allocs_.load();
+    stats.cache_hits = cache_hits_.load();
+    stats.cache_misses = stats.num_allocs - stats.cache_hits;
+    stats.bytes_in_use = bytes_in_use_.load();
+    stats.peak_bytes_in_use = peak_bytes_in_use_.load();
+    stats.largest_alloc_size = largest_alloc_size_.load();
+    stats.bytes_cached = bytes_cached_.load();
+    return stats;
+  });
+  ITEX_VLOG(1) << "ITEX CPU caching allocator: cache limit " << cache_limit_
+               << " bytes, NUMA node " << numa_node_;
+}
+
+int CPUCachingAllocator::BinIndex(size_t* num_bytes) {
+  if (*num_bytes <= kMinBlockSize) {
+    *num_bytes = kMinBlockSize;
+    return 0;
+  }
+  // Rounds up to a multiple of a quarter of the largest power of 2 below.
+  const int log2 = 63 - __builtin_clzll(*num_bytes - 1);
+  const size_t step = size_t{1} << (log2 - 2);
+  const size_t steps = (*num_bytes + step - 1) / step;
+  *num_bytes = steps * step;
+  return (log2 - kMinBlockBits) * 4 + static_cast<int>(steps) - 4;
+}
+
+void* CPUCachingAllocator::SystemAllocate(size_t block_size) {
+  if (numa_node_ != port::kNUMANoAffinity) {
+    return port::NUMAMalloc(numa_node_, block_size + kHeaderSize, kAlignment);
+  }
+  return port::AlignedMalloc(block_size + kHeaderSize, kAlignment);
+}
+
+void CPUCachingAllocator::SystemFree(void* block, size_t block_size) {
+  if (numa_node_ != port::kNUMANoAffinity) {
+    port::NUMAFree(block, block_size + kHeaderSize);
+  } else {
+    port::AlignedFree(block);
+  }
+}
+
+void* CPUCachingAllocator::AllocateRaw(size_t num_bytes) {
+  size_t block_size = num_bytes;
+  Bin& bin = bins_[BinIndex(&block_size)];
+
+  char* block = nullptr;
+  {
+    mutex_lock lock(&bin.mu);
+    if (!bin.free_blocks.empty()) {
+      block = static_cast<char*>(bin.free_blocks.back());
+      bin.free_blocks.pop_back();
+    }
+  }
+
+  if (block != nullptr) {
+    cache_hits_++;
+    bytes_cached_ -= block_size;
+  } else {
+    block = static_cast<char*>(SystemAllocate(block_size));
+    if (block == nullptr) {
+      // The cached blocks of other bins may be enough to succeed.
+      ReleaseCache();
+      block = static_cast<char*>(SystemAllocate(block_size));
+      if (block == nullptr) return nullptr;
+    }
+    *reinterpret_cast<size_t*>(block) = block_size;
+  }
+
+  num_allocs_++;
+  UpdateMax(&peak_bytes_in_use_, bytes_in_use_ += block_size);
+  UpdateMax(&largest_alloc_size_, num_bytes);
+  return block + kHeaderSize;
+}
+
+void CPUCachingAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  char* block = static_cast<char*>(ptr) - kHeaderSize;
+  size_t block_size = *reinterpret_cast<size_t*>(block);
+  bytes_in_use_ -= block_size;
+
+  if ((bytes_cached_ += block_size) <= static_cast<int64>(cache_limit_)) {
+    Bin& bin = bins_[BinIndex(&block_size)];
+    mutex_lock lock(&bin.mu);
+    bin.free_blocks.push_back(block);
+    return;
+  }
+  bytes_cached_ -= block_size;
+  SystemFree(block, block_size);
+}
+
+void CPUCachingAllocator::ReleaseCache() {
+  for (Bin& bin : bins_) {
+    std::vector<void*> free_blocks;
+    {
+      mutex_lock lock(&bin.mu);
+      std::swap(free_blocks, bin.free_blocks);
+    }
+    for (void* block : free_blocks) {
+      const size_t block_size = *static_cast<size_t*>(block);
+      bytes_cached_ -= block_size;
+      SystemFree(block, block_size);
+    }
+  }
+}
+
+}  // namespace itex
@@ -0,0 +1,89 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_CPU_ALLOCATOR_H_
+#define ITEX_CORE_UTILS_CPU_ALLOCATOR_H_
+
+#include <atomic>
+#include <vector>
+
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/thread_annotations.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+// Process-wide caching allocator for the temporaries of ITEX CPU kernels, such
+// as oneDNN scratchpads and reorder buffers, which are allocated and freed on
+// every kernel call. Freed blocks are kept in size-binned free lists and
+// handed out again to requests of the same bin, so the hot path neither calls
+// malloc/free nor page-faults in fresh memory.
+//
+// Requests are rounded up to one of four sizes per power of 2, so at most 25%
+// of a block is wasted. Every bin has its own lock, so threads allocating
+// different sizes don't contend. Blocks are allocated on the NUMA node of
+// `CPUThreadPool`, if it has one.
+//
+// `ITEX_CPU_ALLOCATOR_CACHE_MB` bounds the bytes kept in the free lists. Blocks
+// freed beyond it are returned to the system. `0` disables the allocator.
+class CPUCachingAllocator {
+ public:
+  static constexpr size_t kAlignment = 64;
+
+  // Returns nullptr if the allocator is disabled.
+  static CPUCachingAllocator* GetInstance();
+
+  // Returns a block of at least `num_bytes` bytes aligned to `kAlignment`, or
+  // nullptr if out of memory.
+  void* AllocateRaw(size_t num_bytes);
+  // REQUIRES: `ptr` was returned by `AllocateRaw`.
+  void DeallocateRaw(void* ptr);
+
+  // Returns all cached blocks to the system.
+  void ReleaseCache();
+
+ private:
+  struct Bin {
+    mutex mu;
+    std::vector<void*> free_blocks TF_GUARDED_BY(mu);
+  };
+
+  explicit CPUCachingAllocator(size_t cache_limit);
+  ~CPUCachingAllocator() = default;
+
+  // Returns the bin of `num_bytes`, and rounds it up to the bin size.
+  static int BinIndex(size_t* num_bytes);
+
+  void* SystemAllocate(size_t block_size);
+  void SystemFree(void* block, size_t block_size);
+
+  const size_t cache_limit_;
+  int numa_node_;
+  std::vector<Bin> bins_;
+
+  std::atomic<int64> num_allocs_;
+  std::atomic<int64> cache_hits_;
+  std::atomic<int64> bytes_in_use_;
+  std::atomic<int64> peak_bytes_in_use_;
+  std::atomic<int64> largest_alloc_size_;
+  std::atomic<int64> bytes_cached_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CPUCachingAllocator);
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_CPU_ALLOCATOR_H_
@@ -0,0 +1,74 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/cpu_threadpool.h"
+
+#include <algorithm>
+
+#include "itex/core/utils/cpu_info.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/numa.h"
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+namespace itex {
+
+CPUThreadPool* CPUThreadPool::GetInstance() {
+  static CPUThreadPool* instance = new CPUThreadPool();
+  return instance;
+}
+
+CPUThreadPool::CPUThreadPool() {
+  int64 numa_node;
+  ITEX_CHECK_OK(ReadInt64FromEnvVar("ITEX_CPU_NUMA_NODE",
+                                    port::kNUMANoAffinity, &numa_node));
+  numa_node_ = static_cast<int>(numa_node);
+  if (numa_node_ != port::kNUMANoAffinity &&
+      (!port::NUMAEnabled() || numa_node_ < 0 ||
+       numa_node_ >= port::NUMANumNodes())) {
+    ITEX_LOG(WARNING) << "ITEX_CPU_NUMA_NODE=" << numa_node_
+                      << " is not a valid NUMA node, ignore NUMA affinity.";
+    numa_node_ = port::kNUMANoAffinity;
+  }
+
+  int num_cores = std::max(
+      1, port::NumSchedulableCPUs() / port::NumHyperthreadsPerCore());
+  if (numa_node_ != port::kNUMANoAffinity) {
+    num_cores = std::max(1, num_cores / port::NUMANumNodes());
+  }
+
+  int64 num_threads;
+  ITEX_CHECK_OK(
+      ReadInt64FromEnvVar("ITEX_CPU_INTRA_OP_THREADS", 0, &num_threads));
+  num_threads_ = num_threads > 0 ? static_cast<int>(num_threads) : num_cores;
+
+  ThreadOptions thread_options;
+  thread_options.numa_node = numa_node_;
+  threadpool_.reset(new thread::ThreadPool(Env::Default(), thread_options,
+                                           "itex_cpu_intra_op", num_threads_,
+                                           /*low_latency_hint=*/true));
+  eigen_device_.reset(new Eigen::ThreadPoolDevice(
+      threadpool_->AsEigenThreadPool(), num_threads_));
+
+  ITEX_VLOG(1) << "ITEX CPU intra-op thread pool: " << num_threads_
+               << " threads, NUMA node " << numa_node_;
+}
+
+const Eigen::ThreadPoolDevice& CPUThreadPool::eigen_device() const {
+  return *eigen_device_;
+}
+
+}  // namespace itex
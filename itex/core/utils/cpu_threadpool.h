@@ -0,0 +1,65 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_CPU_THREADPOOL_H_
+#define ITEX_CORE_UTILS_CPU_THREADPOOL_H_
+
+#include <memory>
+
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/threadpool.h"
+
+namespace Eigen {
+struct ThreadPoolDevice;
+}  // namespace Eigen
+
+namespace itex {
+
+// Process-wide CPU intra-op thread pool owned by ITEX. Eigen CPU kernels run
+// on it through `OpKernelContext::eigen_cpu_device()`, and oneDNN CPU streams
+// run on it as well when oneDNN is built with the threadpool runtime, so only
+// one set of worker threads competes for the cores.
+//
+// The pool is configured by environment variables:
+//  * `ITEX_CPU_NUMA_NODE`: NUMA node to pin the worker threads to. The default
+//    -1 means no affinity.
+//  * `ITEX_CPU_INTRA_OP_THREADS`: number of worker threads. The default 0
+//    means one thread per physical core, restricted to the NUMA node above if
+//    it is set. Serving several instances on one socket should set both.
+class CPUThreadPool {
+ public:
+  static CPUThreadPool* GetInstance();
+
+  thread::ThreadPool* threadpool() const { return threadpool_.get(); }
+  const Eigen::ThreadPoolDevice& eigen_device() const;
+
+  int NumThreads() const { return num_threads_; }
+  int NUMANode() const { return numa_node_; }
+
+ private:
+  CPUThreadPool();
+  ~CPUThreadPool() = default;
+
+  int num_threads_;
+  int numa_node_;
+  std::unique_ptr<thread::ThreadPool> threadpool_;
+  std::unique_ptr<Eigen::ThreadPoolDevice> eigen_device_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CPUThreadPool);
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_CPU_THREADPOOL_H_
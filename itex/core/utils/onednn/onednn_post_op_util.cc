@@ -164,6 +164,27 @@ void PostOpUtil::SetOutputScale(const std::vector<float>& scales) {
   }
 }
 
+void PostOpUtil::AddAsKey(OneDnnKeyCreator* key_creator) {
+  ITEX_DCHECK(key_creator);
+  key_creator->AddAsKey(static_cast<int>(postop_scale_list_.size()));
+  for (const auto& postop_data : postop_scale_list_) {
+    key_creator->AddAsKey(postop_data.first);
+    key_creator->AddAsKey(postop_data.second);
+  }
+  key_creator->AddAsKey(has_bias_);
+  key_creator->AddAsKey(leaky_relu_alpha_);
+  key_creator->AddAsKey(has_output_scales_);
+  if (has_output_scales_) {
+    key_creator->AddAsKey(output_scale_param_.mask);
+#ifdef ITEX_ONEDNN_3_0
+    // Scales are runtime arguments in oneDNN 3.0, only the count matters.
+    key_creator->AddAsKey(output_scale_param_.scales.size());
+#else
+    key_creator->AddAsKey(output_scale_param_.scales);
+#endif
+  }
+}
+
 bool PostOpUtil::IsSupportedActivation(const absl::string_view op_name) {
   const std::vector<PostOpInfo>& info_vec = PostOpUtil::GetAllPostOpInfo();
   for (PostOpInfo info : info_vec) {
@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "dnnl.h"  // NOLINT(build/include_subdir)
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 
 namespace itex {
@@ -78,6 +79,11 @@ class PostOpUtil {
   void SetPostOpAttr(dnnl::primitive_attr* attr,
                      const std::vector<dnnl::memory::desc>& md_list = {});
 
+  // Add all post op information which affects the primitive desc to
+  // `key_creator`, so the primitive can be shared by kernels with the same
+  // fusion through `OneDnnPrimitiveCache`.
+  void AddAsKey(OneDnnKeyCreator* key_creator);
+
   // Check the given elewise op is supported by oneDNN or not.
   static bool IsSupportedActivation(const absl::string_view op_name);
 
@@ -0,0 +1,210 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_ONEDNN_ONEDNN_PRIMITIVE_CACHE_H_
+#define ITEX_CORE_UTILS_ONEDNN_ONEDNN_PRIMITIVE_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dnnl.hpp"      // NOLINT(build/include_subdir)
+#include "dnnl_debug.h"  // NOLINT(build/include_subdir)
+#include "itex/core/profiler/op_stats.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+// Builds the key of a cached oneDNN primitive. Every input that may change the
+// primitive desc, such as op kind, shapes, data types, post ops, attributes and
+// engine, must be added to the key.
+class OneDnnKeyCreator {
+ public:
+  OneDnnKeyCreator() { key_.reserve(kMaxKeyLength); }
+  ~OneDnnKeyCreator() = default;
+
+  // Append a trivially copyable value, e.g. int/float/enum, as raw bytes.
+  template <typename T>
+  void AddAsKey(const T& data) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable type can be added as raw bytes.");
+    Append(&data, sizeof(T));
+  }
+
+  void AddAsKey(const string& str) {
+    AddAsKey(str.size());
+    key_.append(str);
+  }
+
+  void AddAsKey(const char* str) { AddAsKey(string(str)); }
+
+  template <typename T>
+  void AddAsKey(const std::vector<T>& vec) {
+    AddAsKey(vec.size());
+    for (const auto& v : vec) AddAsKey(v);
+  }
+
+  void AddAsKey(const dnnl::memory::desc& md) {
+#ifdef ITEX_ONEDNN_3_0
+    AddAsKey(md.get_data_type());
+    AddAsKey(md.get_format_kind());
+    AddAsKey(md.get_dims());
+    AddAsKey(md.get_padded_dims());
+    AddAsKey(md.get_padded_offsets());
+    AddAsKey(md.get_submemory_offset());
+    if (md.get_format_kind() == dnnl::memory::format_kind::blocked) {
+      AddAsKey(md.get_strides());
+      AddAsKey(md.get_inner_blks());
+      AddAsKey(md.get_inner_idxs());
+    }
+#else
+    const dnnl_memory_desc_t& data = md.data;
+    AddAsKey(data.ndims);
+    Append(data.dims, sizeof(data.dims[0]) * data.ndims);
+    Append(data.padded_dims, sizeof(data.padded_dims[0]) * data.ndims);
+    Append(data.padded_offsets, sizeof(data.padded_offsets[0]) * data.ndims);
+    AddAsKey(data.offset0);
+    AddAsKey(data.data_type);
+    AddAsKey(data.format_kind);
+    if (data.format_kind == dnnl_blocked) {
+      const dnnl_blocking_desc_t& blk = data.format_desc.blocking;
+      Append(blk.strides, sizeof(blk.strides[0]) * data.ndims);
+      AddAsKey(blk.inner_nblks);
+      Append(blk.inner_blks, sizeof(blk.inner_blks[0]) * blk.inner_nblks);
+      Append(blk.inner_idxs, sizeof(blk.inner_idxs[0]) * blk.inner_nblks);
+    }
+#endif
+  }
+
+  // Primitives are only valid on the engine they are created for.
+  void AddAsKey(const dnnl::engine& engine) {
+    AddAsKey(reinterpret_cast<uintptr_t>(engine.get()));
+  }
+
+  const string& GetKey() const { return key_; }
+
+ private:
+  void Append(const void* data, size_t size) {
+    key_.append(reinterpret_cast<const char*>(data), size);
+  }
+
+  static constexpr size_t kMaxKeyLength = 256;
+  string key_;
+};
+
+// Process-wide, thread-safe LRU cache of oneDNN primitive descs and
+// primitives. One instance exists for each (PrimitiveDesc, Primitive) pair, and
+// all kernels of the same kind share it, so a kernel which sees a shape it has
+// seen before (in any instance) skips primitive desc and primitive creation.
+//
+// The capacity of each instance can be tuned by
+// `ITEX_ONEDNN_PRIMITIVE_CACHE_CAPACITY`. A value of 0 disables caching. Each
+// instance reports its hits and misses to the `OpStatsRegistry` under the name
+// of its primitive kind once it created its first primitive.
+template <typename PrimitiveDesc, typename Primitive>
+class OneDnnPrimitiveCache {
+ public:
+  struct Entry {
+    PrimitiveDesc pd;
+    Primitive primitive;
+  };
+
+  static OneDnnPrimitiveCache* GetInstance() {
+    static OneDnnPrimitiveCache* instance = new OneDnnPrimitiveCache();
+    return instance;
+  }
+
+  // Returns the entry cached for `key`. On miss, `create_pd` is called without
+  // holding the lock to create the primitive desc, and the new entry is
+  // inserted. Concurrent misses on the same key share the first inserted
+  // entry.
+  template <typename CreatePdFn>
+  Entry FindOrCreate(const string& key, CreatePdFn create_pd) {
+    if (capacity_ != 0) {
+      mutex_lock lock(&mu_);
+      auto iter = index_.find(key);
+      if (iter != index_.end()) {
+        hits_++;
+        lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+        return iter->second->second;
+      }
+    }
+    misses_++;
+
+    Entry entry;
+    entry.pd = create_pd();
+    entry.primitive = Primitive(entry.pd);
+    std::call_once(register_flag_, [this, &entry]() {
+      OpStatsRegistry::Global()->RegisterPrimitiveCache(
+          dnnl_prim_kind2str(
+              static_cast<dnnl_primitive_kind_t>(entry.primitive.get_kind())),
+          [this]() -> int64_t { return hits(); },
+          [this]() -> int64_t { return misses(); });
+    });
+    if (capacity_ == 0) return entry;
+
+    mutex_lock lock(&mu_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+      return iter->second->second;
+    }
+    lru_list_.emplace_front(key, entry);
+    index_[key] = lru_list_.begin();
+    while (lru_list_.size() > capacity_) {
+      index_.erase(lru_list_.back().first);
+      lru_list_.pop_back();
+    }
+    return entry;
+  }
+
+  int64 hits() const { return hits_.load(); }
+  int64 misses() const { return misses_.load(); }
+
+ private:
+  using LRUList = std::list<std::pair<string, Entry>>;
+
+  OneDnnPrimitiveCache() : hits_(0), misses_(0) {
+    int64 capacity;
+    ITEX_CHECK_OK(ReadInt64FromEnvVar("ITEX_ONEDNN_PRIMITIVE_CACHE_CAPACITY",
+                                      1024, &capacity));
+    capacity_ = capacity < 0 ? 0 : static_cast<size_t>(capacity);
+  }
+
+  TF_DISALLOW_COPY_AND_ASSIGN(OneDnnPrimitiveCache);
+
+  size_t capacity_;
+  mutex mu_;
+  LRUList lru_list_ TF_GUARDED_BY(mu_);
+  std::unordered_map<string, typename LRUList::iterator> index_
+      TF_GUARDED_BY(mu_);
+  std::atomic<int64> hits_;
+  std::atomic<int64> misses_;
+  std::once_flag register_flag_;
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_ONEDNN_ONEDNN_PRIMITIVE_CACHE_H_
@@ -0,0 +1,86 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_ONEDNN_ONEDNN_THREADPOOL_H_
+#define ITEX_CORE_UTILS_ONEDNN_ONEDNN_THREADPOOL_H_
+
+#ifdef ITEX_ONEDNN_THREADPOOL
+
+#include <functional>
+
+#include "dnnl.hpp"             // NOLINT(build/include_subdir)
+#include "dnnl_threadpool.hpp"  // NOLINT(build/include_subdir)
+#include "itex/core/utils/blocking_counter.h"
+#include "itex/core/utils/cpu_threadpool.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/threadpool.h"
+
+namespace itex {
+
+// Adapts the ITEX CPU intra-op thread pool to the oneDNN threadpool runtime,
+// so oneDNN CPU primitives and Eigen kernels share the same worker threads.
+// Only available when oneDNN is built with `--define=build_with_threadpool`.
+class OneDnnThreadPool : public dnnl::threadpool_interop::threadpool_iface {
+ public:
+  static OneDnnThreadPool* GetInstance() {
+    static OneDnnThreadPool* instance =
+        new OneDnnThreadPool(CPUThreadPool::GetInstance()->threadpool());
+    return instance;
+  }
+
+  int get_num_threads() const override { return threadpool_->NumThreads(); }
+
+  bool get_in_parallel() const override {
+    return threadpool_->CurrentThreadId() != -1;
+  }
+
+  // Work is executed synchronously: parallel_for returns after all `n` jobs
+  // are done, so oneDNN doesn't need to wait on the stream.
+  uint64_t get_flags() const override { return 0; }
+
+  void parallel_for(int n, const std::function<void(int, int)>& fn) override {
+    if (n <= 0) return;
+    // Nested parallelism or a single job, run inline to avoid deadlock and
+    // scheduling overhead.
+    if (n == 1 || get_in_parallel()) {
+      for (int i = 0; i < n; ++i) fn(i, n);
+      return;
+    }
+
+    BlockingCounter counter(n - 1);
+    for (int i = 1; i < n; ++i) {
+      threadpool_->Schedule([i, n, &fn, &counter]() {
+        fn(i, n);
+        counter.DecrementCount();
+      });
+    }
+    // The caller thread takes the first job.
+    fn(0, n);
+    counter.Wait();
+  }
+
+ private:
+  explicit OneDnnThreadPool(thread::ThreadPool* threadpool)
+      : threadpool_(threadpool) {}
+
+  thread::ThreadPool* threadpool_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(OneDnnThreadPool);
+};
+
+}  // namespace itex
+
+#endif  // ITEX_ONEDNN_THREADPOOL
+#endif  // ITEX_CORE_UTILS_ONEDNN_ONEDNN_THREADPOOL_H_
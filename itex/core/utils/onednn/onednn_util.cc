@@ -16,12 +16,39 @@ limitations under the License.
 #ifndef ITEX_BUILD_JAX
 #include "itex/core/utils/onednn/onednn_util.h"
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 
+#include "dnnl_debug.h"  // NOLINT(build/include_subdir)
+#include "itex/core/profiler/op_stats.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/mem.h"
 #include "itex/core/utils/register_types.h"
+#include "itex/core/utils/traceme.h"
+#include "itex/core/utils/traceme_encode.h"
 
 namespace itex {
 
+string OneDnnPrimitiveTraceString(const dnnl::primitive& primitive) {
+  const_dnnl_primitive_desc_t pd = primitive.get_primitive_desc();
+  dnnl_primitive_kind_t kind = dnnl_undefined_primitive;
+  const char* impl = nullptr;
+  dnnl_primitive_desc_query(pd, dnnl_query_primitive_kind, 0, &kind);
+  dnnl_primitive_desc_query(pd, dnnl_query_impl_info_str, 0, &impl);
+  return TraceMeEncode(strings::StrCat("onednn::", dnnl_prim_kind2str(kind)),
+                       {{"impl", impl == nullptr ? "unknown" : impl}});
+}
+
+void ExecutePrimitive(const dnnl::primitive& primitive,
+                      const dnnl::stream& onednn_stream,
+                      const std::unordered_map<int, dnnl::memory>& args) {
+  TraceMe trace_me(
+      [&primitive] { return OneDnnPrimitiveTraceString(primitive); },
+      TraceMeLevel::kInfo);
+  primitive.execute(onednn_stream, args);
+}
+
 void ReorderMemory(const OpKernelContext& context,
                    const dnnl::memory* src_memory, dnnl::memory* reorder_memory,
                    const dnnl::engine& onednn_engine) {
@@ -29,7 +56,7 @@ void ReorderMemory(const OpKernelContext& context,
   dnnl::reorder reorder_primitive = dnnl::reorder(*src_memory, *reorder_memory);
   std::unordered_map<int, dnnl::memory> reorder_args = {
       {DNNL_ARG_SRC, *src_memory}, {DNNL_ARG_DST, *reorder_memory}};
-  reorder_primitive.execute(onednn_stream, reorder_args);
+  ExecutePrimitive(reorder_primitive, onednn_stream, reorder_args);
 }
 
 // TF datatype and shape is meaningless for some tensors, such as scratchpad
@@ -38,12 +65,128 @@ void ReorderMemory(const OpKernelContext& context,
 // short length datatype, ensure the it is divisible by allocated buffer.
 using ShortDT = uint8;
 
+#ifdef INTEL_CPU_ONLY
+namespace {
+
+// Grows the thread buffers in whole pages.
+constexpr size_t kScratchpadGranularity = 4096;
+
+// Stats of the scratchpad buffers of all threads.
+struct ScratchpadStats {
+  std::atomic<int64> num_allocs{0};
+  std::atomic<int64> num_grows{0};
+  std::atomic<int64> bytes_in_use{0};
+  std::atomic<int64> peak_bytes_in_use{0};
+  std::atomic<int64> largest_alloc_size{0};
+};
+
+ScratchpadStats* GetScratchpadStats() {
+  static ScratchpadStats* stats = [] {
+    ScratchpadStats* stats = new ScratchpadStats();
+    OpStatsRegistry::Global()->RegisterAllocator([stats]() {
+      OpStatsRegistry::AllocatorStats allocator;
+      allocator.name = "onednn_scratchpad";
+      allocator.num_allocs = stats->num_allocs.load();
+      allocator.cache_misses = stats->num_grows.load();
+      allocator.cache_hits = allocator.num_allocs - allocator.cache_misses;
+      allocator.bytes_in_use = stats->bytes_in_use.load();
+      allocator.peak_bytes_in_use = stats->peak_bytes_in_use.load();
+      allocator.largest_alloc_size = stats->largest_alloc_size.load();
+      return allocator;
+    });
+    return stats;
+  }();
+  return stats;
+}
+
+bool IsScratchpadPoolEnabled() {
+  static bool enabled = [] {
+    bool enabled;
+    ITEX_CHECK_OK(
+        ReadBoolFromEnvVar("ITEX_ONEDNN_SCRATCHPAD_POOL", true, &enabled));
+    return enabled;
+  }();
+  return enabled;
+}
+
+void UpdateMax(std::atomic<int64>* max, int64 value) {
+  int64 current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+// The scratchpad buffer of the calling thread. Scratchpads still holding it
+// keep it alive after the thread exits.
+struct ThreadScratchpad {
+  ~ThreadScratchpad() { GetScratchpadStats()->bytes_in_use -= size; }
+
+  std::shared_ptr<void> buffer;
+  size_t size = 0;
+};
+
+}  // namespace
+#endif  // INTEL_CPU_ONLY
+
+Status OneDnnScratchpad::Init(OpKernelContext* context,
+                              const dnnl::memory::desc& desc,
+                              const dnnl::engine& onednn_engine) {
+  const size_t size = desc.get_size();
+#ifdef INTEL_CPU_ONLY
+  if (onednn_engine.get_kind() == dnnl::engine::kind::cpu &&
+      IsScratchpadPoolEnabled()) {
+    ScratchpadStats* stats = GetScratchpadStats();
+    thread_local ThreadScratchpad thread_scratchpad;
+    if (size > thread_scratchpad.size) {
+      const size_t new_size = (size + kScratchpadGranularity - 1) /
+                              kScratchpadGranularity * kScratchpadGranularity;
+      void* buffer = port::AlignedMalloc(new_size, 64);
+      if (buffer == nullptr) {
+        return errors::ResourceExhausted(
+            "Failed to allocate oneDNN scratchpad of ", new_size, " bytes");
+      }
+      // Scratchpads using the old buffer share its ownership.
+      thread_scratchpad.buffer.reset(buffer, port::AlignedFree);
+      UpdateMax(&stats->peak_bytes_in_use,
+                stats->bytes_in_use += new_size - thread_scratchpad.size);
+      thread_scratchpad.size = new_size;
+      stats->num_grows++;
+    }
+    stats->num_allocs++;
+    UpdateMax(&stats->largest_alloc_size, size);
+
+    buffer_ = thread_scratchpad.buffer;
+    tensor_ = Tensor();
+    memory_ = dnnl::memory(desc, onednn_engine, buffer_.get());
+    return Status::OK();
+  }
+#endif  // INTEL_CPU_ONLY
+
+  TF_RETURN_IF_ERROR(context->allocate_temp(
+      DataTypeToEnum<ShortDT>::v(),
+      TensorShape({static_cast<int64>(size / sizeof(ShortDT))}), &tensor_));
+  buffer_.reset();
+  memory_ =
+      dnnl::memory(desc, onednn_engine, GetTensorBuffer<ShortDT>(&tensor_));
+  return Status::OK();
+}
+
+template <typename T>
+WeightCacheManager<T>::~WeightCacheManager() {
+  mutex_lock lock(&mu_);
+  if (shared_weight_ != nullptr) {
+    PrepackedWeightStore::GetInstance()->Release(shared_weight_key_,
+                                                 std::move(shared_weight_));
+  }
+}
+
 template <typename T>
 bool WeightCacheManager<T>::IsEmpty() TF_LOCKS_EXCLUDED(mu_) {
   tf_shared_lock lock(&mu_);
   // TODO(itex): investigate why weight_cached_data_.NumElements() == 1
   // instead of 0,  while weight_cached_data_.IsInitialized() == True
-  return (!weight_cached_data_.IsInitialized());
+  return (!weight_cached_data_.IsInitialized() && shared_weight_ == nullptr);
 }
 
 template <typename T>
@@ -53,7 +196,7 @@ void WeightCacheManager<T>::SetCache(
     const dnnl::engine& onednn_engine) TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock lock(&mu_);
 
-  if (weight_cached_data_.IsInitialized()) {
+  if (weight_cached_data_.IsInitialized() || shared_weight_ != nullptr) {
     return;
   }
 
@@ -61,6 +204,26 @@ void WeightCacheManager<T>::SetCache(
   dnnl::memory weight_mem =
       CreateDnnlMemory(weight_original_md, onednn_engine, weight_data);
 
+  // Weight on CPU is host memory, so it can be fingerprinted and shared with
+  // other kernels holding the same constant.
+  auto* weight_store = PrepackedWeightStore::GetInstance();
+  if (onednn_engine.get_kind() == dnnl::engine::kind::cpu &&
+      weight_store->enabled()) {
+    string key = PrepackedWeightStore::CreateKey(
+        weight_data, weight_original_md, weight_expected_md, onednn_engine);
+    shared_weight_ = weight_store->FindOrCreate(
+        key, weight_expected_md, [&](void* weight_cached_data) {
+          dnnl::memory weight_reorder_mem = CreateDnnlMemory(
+              weight_expected_md, onednn_engine, weight_cached_data);
+          ReorderMemory(*context, &weight_mem, &weight_reorder_mem,
+                        onednn_engine);
+        });
+    if (shared_weight_ != nullptr) {
+      shared_weight_key_ = std::move(key);
+      return;
+    }
+  }
+
   // Create cached weight buffer
   Tensor* weight_cached_tensor = nullptr;
   size_t weight_size = weight_expected_md.get_size();
@@ -106,6 +269,13 @@ T* WeightCacheManager<T>::GetCache(OpKernelContext* context,
                                    const dnnl::memory::desc& expected_md)
     TF_LOCKS_EXCLUDED(mu_) {
   tf_shared_lock lock(&mu_);
+  if (shared_weight_ != nullptr) {
+    if (shared_weight_->md() == expected_md) {
+      return static_cast<T*>(shared_weight_->data());
+    }
+    return nullptr;
+  }
+
   const Tensor* weight_cached_data = weight_cached_data_.AccessTensor(context);
   const Tensor* weight_cached_md = weight_cached_md_.AccessTensor(context);
 
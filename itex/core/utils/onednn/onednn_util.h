@@ -17,7 +17,9 @@ limitations under the License.
 #define ITEX_CORE_UTILS_ONEDNN_ONEDNN_UTIL_H_
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,6 +30,8 @@ limitations under the License.
 #endif                    // INTEL_CPU_ONLY
 
 #include "itex/core/utils/logging.h"
+#include "itex/core/utils/onednn/onednn_threadpool.h"
+#include "itex/core/utils/onednn/onednn_weight_store.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
 #include "itex/core/utils/status.h"
@@ -225,7 +229,14 @@ inline dnnl::stream CreateDnnlStream(const OpKernelContext& ctx,
   // Default path, always assume it's CPU engine.
   ITEX_CHECK(engine.get_kind() == dnnl::engine::kind::cpu)
       << "Create oneDNN stream for unsupported engine.";
+#ifdef ITEX_ONEDNN_THREADPOOL
+  // Run oneDNN CPU primitives on the ITEX intra-op thread pool, which is also
+  // used by Eigen kernels.
+  return dnnl::threadpool_interop::make_stream(engine,
+                                               OneDnnThreadPool::GetInstance());
+#else
   return dnnl::stream(engine);
+#endif  // ITEX_ONEDNN_THREADPOOL
 }
 #endif
 inline dnnl::memory CreateDnnlMemory(const dnnl::memory::desc& md,
@@ -500,18 +511,58 @@ inline dnnl::memory::desc CreatePlainMemDescWithFormatTag(
                               dnnl::memory::format_tag::abcdefghijkl);
 }
 
+// Name of `primitive` in profiler traces, with the implementation oneDNN
+// picked for it, e.g. "onednn::matmul#impl=brg:avx512_core_amx#".
+string OneDnnPrimitiveTraceString(const dnnl::primitive& primitive);
+
+// Executes `primitive`, and records it as a TraceMe event when the profiler
+// is active.
+void ExecutePrimitive(const dnnl::primitive& primitive,
+                      const dnnl::stream& onednn_stream,
+                      const std::unordered_map<int, dnnl::memory>& args);
+
 // Reorder src memory to expected memory
 void ReorderMemory(const OpKernelContext& context,
                    const dnnl::memory* src_memory, dnnl::memory* reorder_memory,
                    const dnnl::engine& onednn_engine);
 
+// Scratchpad of a primitive created with `dnnl::scratchpad_mode::user`. It
+// stays valid as long as this object lives.
+//
+// CPU primitives run synchronously on the calling thread, so on CPU every
+// thread keeps one grow-only buffer which all scratchpads of that thread
+// share, and a kernel call allocates nothing once the buffer is large enough.
+// The buffer is not zeroed. Scratchpads of the same thread alias each other,
+// so a scratchpad must be initialized again before each execution and can't
+// be used by a primitive still running when the thread moves on. If the buffer
+// grows, the old one is kept until no scratchpad uses it anymore. Otherwise,
+// or with `ITEX_ONEDNN_SCRATCHPAD_POOL=0`, the scratchpad is a temporary
+// tensor of the kernel.
+class OneDnnScratchpad {
+ public:
+  OneDnnScratchpad() = default;
+
+  Status Init(OpKernelContext* context, const dnnl::memory::desc& desc,
+              const dnnl::engine& onednn_engine);
+
+  const dnnl::memory& memory() const { return memory_; }
+  void* data() const { return memory_.get_data_handle(); }
+
+ private:
+  std::shared_ptr<void> buffer_;
+  Tensor tensor_;
+  dnnl::memory memory_;
+};
+
 // Weight cache is used to avoid weight reorder repetitively when target weight
-// block md is different frome original weight plain md.
+// block md is different frome original weight plain md. On CPU the reordered
+// weight is shared through PrepackedWeightStore, so kernels holding the same
+// constant reuse one copy; otherwise it is kept as a persistent tensor.
 template <typename T>
 class WeightCacheManager {
  public:
   WeightCacheManager() = default;
-  ~WeightCacheManager() = default;
+  ~WeightCacheManager();
 
   bool IsEmpty() TF_LOCKS_EXCLUDED(mu_);
 
@@ -532,6 +583,8 @@ class WeightCacheManager {
   mutex mu_;
   PersistentTensor weight_cached_data_ TF_GUARDED_BY(mu_);
   PersistentTensor weight_cached_md_ TF_GUARDED_BY(mu_);
+  PrepackedWeightStore::WeightPtr shared_weight_ TF_GUARDED_BY(mu_);
+  string shared_weight_key_ TF_GUARDED_BY(mu_);
 };
 
 // Bias cache is used to avoid scale the bias tensor repetitively in INT8 kernel
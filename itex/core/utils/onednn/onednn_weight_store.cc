@@ -0,0 +1,131 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/onednn/onednn_weight_store.h"
+
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/fingerprint.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mem.h"
+#include "itex/core/utils/onednn/onednn_primitive_cache.h"
+
+namespace itex {
+
+namespace {
+constexpr int kWeightAlignment = 64;
+}  // namespace
+
+PrepackedWeight::~PrepackedWeight() { port::AlignedFree(data_); }
+
+PrepackedWeightStore* PrepackedWeightStore::GetInstance() {
+  static PrepackedWeightStore* instance = new PrepackedWeightStore();
+  return instance;
+}
+
+PrepackedWeightStore::PrepackedWeightStore()
+    : bytes_(0), hits_(0), misses_(0) {
+  int64 budget_mb;
+  ITEX_CHECK_OK(
+      ReadInt64FromEnvVar("ITEX_PREPACKED_WEIGHT_STORE_MB", 1024, &budget_mb));
+  budget_ = budget_mb < 0 ? 0 : static_cast<size_t>(budget_mb) << 20;
+}
+
+string PrepackedWeightStore::CreateKey(const void* src_data,
+                                       const dnnl::memory::desc& src_md,
+                                       const dnnl::memory::desc& expected_md,
+                                       const dnnl::engine& engine) {
+  size_t src_size = src_md.get_size();
+  Fprint128 fingerprint = Fingerprint128(
+      StringPiece(static_cast<const char*>(src_data), src_size));
+
+  OneDnnKeyCreator key_creator;
+  key_creator.AddAsKey(fingerprint.low64);
+  key_creator.AddAsKey(fingerprint.high64);
+  key_creator.AddAsKey(src_size);
+  key_creator.AddAsKey(src_md);
+  key_creator.AddAsKey(expected_md);
+  key_creator.AddAsKey(engine);
+  return key_creator.GetKey();
+}
+
+bool PrepackedWeightStore::ReserveLocked(size_t size) {
+  if (size > budget_) return false;
+  auto iter = lru_list_.end();
+  while (bytes_ + size > budget_ && iter != lru_list_.begin()) {
+    --iter;
+    // Only the store itself holds the weight, no kernel uses it anymore.
+    if (iter->second.use_count() == 1) {
+      bytes_ -= iter->second->size();
+      index_.erase(iter->first);
+      iter = lru_list_.erase(iter);
+    }
+  }
+  return bytes_ + size <= budget_;
+}
+
+PrepackedWeightStore::WeightPtr PrepackedWeightStore::FindOrCreate(
+    const string& key, const dnnl::memory::desc& expected_md,
+    const PrepackFn& prepack) {
+  if (!enabled()) return nullptr;
+
+  {
+    mutex_lock lock(&mu_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      hits_++;
+      lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+      return iter->second->second;
+    }
+    if (!ReserveLocked(expected_md.get_size())) return nullptr;
+  }
+  misses_++;
+
+  size_t size = expected_md.get_size();
+  void* data = port::AlignedMalloc(size, kWeightAlignment);
+  if (data == nullptr) return nullptr;
+  WeightPtr weight = std::make_shared<PrepackedWeight>(expected_md, data, size);
+  prepack(data);
+
+  mutex_lock lock(&mu_);
+  auto iter = index_.find(key);
+  if (iter != index_.end()) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+    return iter->second->second;
+  }
+  // Other weights may be inserted since the reservation above.
+  if (!ReserveLocked(size)) return nullptr;
+  lru_list_.emplace_front(key, weight);
+  index_[key] = lru_list_.begin();
+  bytes_ += size;
+  ITEX_VLOG(3) << "Prepacked weight store: insert " << size << " bytes, total "
+               << bytes_ << " bytes in " << lru_list_.size() << " weights";
+  return weight;
+}
+
+void PrepackedWeightStore::Release(const string& key, WeightPtr weight) {
+  if (weight == nullptr) return;
+  mutex_lock lock(&mu_);
+  weight.reset();
+  auto iter = index_.find(key);
+  // Only the store itself holds the weight, no kernel uses it anymore.
+  if (iter == index_.end() || iter->second->second.use_count() != 1) return;
+  bytes_ -= iter->second->second->size();
+  lru_list_.erase(iter->second);
+  index_.erase(iter);
+  ITEX_VLOG(3) << "Prepacked weight store: release weight, total " << bytes_
+               << " bytes in " << lru_list_.size() << " weights";
+}
+
+}  // namespace itex
@@ -0,0 +1,122 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_ONEDNN_ONEDNN_WEIGHT_STORE_H_
+#define ITEX_CORE_UTILS_ONEDNN_ONEDNN_WEIGHT_STORE_H_
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "dnnl.hpp"  // NOLINT(build/include_subdir)
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+// A weight reordered (prepacked) to the blocked layout expected by a oneDNN
+// primitive. The buffer is read-only once created and is freed when the last
+// reference goes away.
+class PrepackedWeight {
+ public:
+  PrepackedWeight(const dnnl::memory::desc& md, void* data, size_t size)
+      : md_(md), data_(data), size_(size) {}
+  ~PrepackedWeight();
+
+  const dnnl::memory::desc& md() const { return md_; }
+  void* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  dnnl::memory::desc md_;
+  void* data_;
+  size_t size_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PrepackedWeight);
+};
+
+// Process-wide, content-addressed store of prepacked CPU weights. The key is a
+// fingerprint of the source weight buffer plus the source and expected memory
+// descs and the engine, so kernel instances of different model replicas or
+// sessions that load the same constant share one blocked copy instead of each
+// reordering and keeping its own.
+//
+// Entries are reference counted: a weight still used by a kernel is never
+// evicted, and a kernel gives its weight back with `Release` when it is
+// destroyed, so the weights of dead graphs don't stay resident. The total size
+// of cached weights is limited by `ITEX_PREPACKED_WEIGHT_STORE_MB`. When the
+// budget is exhausted, unused entries are evicted in LRU order, and if that is
+// not enough the weight is not shared and the caller keeps a private copy. A
+// value of 0 disables the store.
+class PrepackedWeightStore {
+ public:
+  using WeightPtr = std::shared_ptr<const PrepackedWeight>;
+  // Writes the prepacked weight to the given buffer, which has the size of
+  // the expected memory desc.
+  using PrepackFn = std::function<void(void*)>;
+
+  static PrepackedWeightStore* GetInstance();
+
+  bool enabled() const { return budget_ != 0; }
+
+  // Builds the key of a weight. `src_data` must be host memory described by
+  // `src_md`.
+  static string CreateKey(const void* src_data,
+                          const dnnl::memory::desc& src_md,
+                          const dnnl::memory::desc& expected_md,
+                          const dnnl::engine& engine);
+
+  // Returns the weight stored for `key`. On miss, a buffer for `expected_md`
+  // is allocated and filled by `prepack` without holding the lock, then
+  // inserted. Returns nullptr if the weight doesn't fit in the budget.
+  WeightPtr FindOrCreate(const string& key,
+                         const dnnl::memory::desc& expected_md,
+                         const PrepackFn& prepack);
+
+  // Drops the caller's reference to the weight stored for `key`, and evicts
+  // the weight if no other kernel uses it.
+  void Release(const string& key, WeightPtr weight);
+
+  int64 hits() const { return hits_.load(); }
+  int64 misses() const { return misses_.load(); }
+
+ private:
+  using LRUList = std::list<std::pair<string, WeightPtr>>;
+
+  PrepackedWeightStore();
+
+  // Evicts entries not referenced by any kernel, least recently used first,
+  // until `size` more bytes fit in the budget. Returns false if they don't.
+  bool ReserveLocked(size_t size) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PrepackedWeightStore);
+
+  size_t budget_;
+  mutex mu_;
+  size_t bytes_ TF_GUARDED_BY(mu_);
+  LRUList lru_list_ TF_GUARDED_BY(mu_);
+  std::unordered_map<string, LRUList::iterator> index_ TF_GUARDED_BY(mu_);
+  std::atomic<int64> hits_;
+  std::atomic<int64> misses_;
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_ONEDNN_ONEDNN_WEIGHT_STORE_H_
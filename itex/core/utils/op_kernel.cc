@@ -22,6 +22,8 @@ limitations under the License.
 #include <string>
 
 #include "itex/core/graph/config_util.h"
+#include "itex/core/profiler/op_stats.h"
+#include "itex/core/utils/cpu_allocator.h"
 #ifndef INTEL_CPU_ONLY
 #include "itex/core/utils/gpu_resource_mgr_pool.h"
 #endif
@@ -72,15 +74,13 @@ void EmptyCopyFunctor(TF_OpKernelContext* tf_ctx, TF_Tensor* tf_source,
   return;
 }
 
-int OpKernelContext::num_inputs() const { return TF_NumInputs(ctx_); }
-
 bool OpKernelContext::input_is_ref(int index) const {
   return TF_IsRefInput(ctx_, index, status_);
 }
 
 DataType OpKernelContext::input_dtype(int index) const {
-  if (inputs_ != nullptr && inputs_->at(index) != nullptr) {
-    return inputs_->at(index)->dtype();
+  if (inputs_.at(index).has_value()) {
+    return inputs_[index]->dtype();
   } else {
     ITEX_CHECK(false)
         << "please call ctx.input_dtype() after calling ctx.input() or "
@@ -104,12 +104,9 @@ DataType OpKernelContext::expected_output_dtype(int index) const {
 
 const Tensor& OpKernelContext::input(int index) const {
   ITEX_CHECK_GE(index, 0);
-  ITEX_CHECK_LT(index, num_inputs());
-  if (inputs_ == nullptr) {
-    inputs_ = new gtl::InlinedVector<std::shared_ptr<Tensor>, 4>(num_inputs());
-  }
-
-  if (!inputs_->at(index)) {
+  ITEX_CHECK_LT(index, num_inputs_);
+  absl::optional<Tensor>& input_slot = inputs_[index];
+  if (!input_slot.has_value()) {
     TF_Tensor* tensor = nullptr;
     TF_GetInput(ctx_, index, &tensor, status_);
     TensorShape shape;
@@ -117,12 +114,10 @@ const Tensor& OpKernelContext::input(int index) const {
     for (auto j = 0; j < dims; ++j) {
       shape.AddDim(TF_Dim(tensor, j));
     }
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
-        static_cast<DataType>(TF_TensorType(tensor)), shape, tensor);
-    inputs_->at(index) = std::move(ptr);
+    input_slot.emplace(static_cast<DataType>(TF_TensorType(tensor)), shape,
+                       tensor);
   }
-  ITEX_CHECK_NE(inputs_, nullptr);
-  return *inputs_->at(index);
+  return *input_slot;
 }
 
 #ifndef INTEL_CPU_ONLY
@@ -165,23 +160,17 @@ void* OpKernelContext::tensor_data(int index) {
   return data;
 }
 
-bool OpKernelContext::is_input_same(int index, std::vector<int64> shape) {
-  TF_Tensor* tensor = nullptr;
-  TF_GetInput(ctx_, index, &tensor, status_);
-  int dims = TF_NumDims(tensor);
-  if (dims != static_cast<int>(shape.size())) {
-    TF_DeleteTensor(tensor);
-    return false;
-  }
+bool OpKernelContext::is_input_same(int index,
+                                    const std::vector<int64>& shape) {
+  // Kernels read the input right after this check, so fetch it through the
+  // input cache instead of creating a throwaway TF_Tensor.
+  const TensorShape& input_shape = input(index).shape();
+  int dims = input_shape.dims();
+  if (dims != static_cast<int>(shape.size())) return false;
 
   for (int i = 0; i < dims; ++i) {
-    if (shape[i] != TF_Dim(tensor, i)) {
-      TF_DeleteTensor(tensor);
-      return false;
-    }
+    if (shape[i] != input_shape.dim_size(i)) return false;
   }
-
-  TF_DeleteTensor(tensor);
   return true;
 }
 
@@ -220,19 +209,23 @@ Status OpKernelContext::forward_input_or_allocate_output(
     const TensorShape& output_shape, Tensor** output, int* forwarded_input) {
   ITEX_CHECK_GE(output_index, 0);
   ITEX_CHECK_LT(output_index, num_outputs());
+  int forwarded = -1;
   TF_Tensor* tensor = TF_ForwardInputOrAllocateOutput(
       ctx_, const_cast<int*>(candidate_input_indices.data()),
       candidate_input_indices.size(), output_index,
-      output_shape.dim_sizes().data(), output_shape.dims(), forwarded_input,
+      output_shape.dim_sizes().data(), output_shape.dims(), &forwarded,
       status_);
-  if (outputs_[output_index] == nullptr) {
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
-        static_cast<DataType>(expected_output_dtype(output_index)),
-        output_shape, tensor);
-    outputs_[output_index] = std::move(ptr);
+  if (forwarded_input != nullptr) *forwarded_input = forwarded;
+  DataType out_type =
+      static_cast<DataType>(expected_output_dtype(output_index));
+  if (forwarded < 0) {
+    allocated_bytes_ += output_shape.num_elements() * DataTypeSize(out_type);
+  }
+  if (!outputs_[output_index].has_value()) {
+    outputs_[output_index].emplace(out_type, output_shape, tensor);
   }
 
-  *output = outputs_[output_index].get();
+  *output = &*outputs_[output_index];
   return StatusFromTF_Status(status_);
 }
 
@@ -246,17 +239,14 @@ Tensor* OpKernelContext::mutable_output(int index) {
   ITEX_DCHECK_GE(index, 0);
   ITEX_DCHECK_LT(index, num_outputs());
 
-  return outputs_[index].get();
+  return outputs_[index].has_value() ? &*outputs_[index] : nullptr;
 }
 
 Tensor& OpKernelContext::mutable_input(int index, bool lock_held) {
   ITEX_CHECK_GE(index, 0);
-  ITEX_CHECK_LT(index, num_inputs());
-  if (inputs_ == nullptr) {
-    inputs_ = new gtl::InlinedVector<std::shared_ptr<Tensor>, 4>(num_inputs());
-  }
-
-  if (!inputs_->at(index)) {
+  ITEX_CHECK_LT(index, num_inputs_);
+  absl::optional<Tensor>& input_slot = inputs_[index];
+  if (!input_slot.has_value()) {
     TF_Tensor* tensor = nullptr;
     TF_GetInputTensorFromVariable(
         ctx_, index, lock_held, /* isVariantType unused */ false,
@@ -269,13 +259,11 @@ Tensor& OpKernelContext::mutable_input(int index, bool lock_held) {
     for (auto j = 0; j < dims; ++j) {
       shape.AddDim(TF_Dim(tensor, j));
     }
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
-        static_cast<DataType>(TF_TensorType(tensor)), shape, tensor);
-    inputs_->at(index) = std::move(ptr);
+    input_slot.emplace(static_cast<DataType>(TF_TensorType(tensor)), shape,
+                       tensor);
   }
 
-  ITEX_CHECK_NE(inputs_, nullptr);
-  return *inputs_->at(index);
+  return *input_slot;
 }
 
 Status OpKernelContext::output_list(StringPiece name, OpOutputList* list) {
@@ -292,12 +280,12 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
   TF_Tensor* output = TF_AllocateOutput(
       ctx_, index, static_cast<TF_DataType>(out_type), shape.dim_sizes().data(),
       shape.dims(), shape.num_elements() * DataTypeSize(out_type), status_);
-  if (outputs_[index] == nullptr) {
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
-        static_cast<DataType>(expected_output_dtype(index)), shape, output);
-    outputs_[index] = std::move(ptr);
+  allocated_bytes_ += shape.num_elements() * DataTypeSize(out_type);
+  if (!outputs_[index].has_value()) {
+    outputs_[index].emplace(static_cast<DataType>(expected_output_dtype(index)),
+                            shape, output);
   }
-  *tensor = outputs_[index].get();
+  *tensor = &*outputs_[index];
 
   return StatusFromTF_Status(status_);
 }
@@ -306,6 +294,32 @@ Status OpKernelContext::allocate_temp(
     DataType type, const TensorShape& shape, Tensor* out_temp,
     AllocatorAttributes allocator_attr,
     const AllocationAttributes& allocation_attr) {
+  const int64 num_bytes = shape.num_elements() * DataTypeSize(type);
+  allocated_bytes_ += num_bytes;
+#ifdef INTEL_CPU_ONLY
+  // Temporaries of POD types are served by ITEX's caching allocator, so they
+  // don't go through TF's CPU allocator on every call. Requests with
+  // non-default attributes, e.g. on_host, are left to TF, which knows how to
+  // honour them.
+  CPUCachingAllocator* allocator = CPUCachingAllocator::GetInstance();
+  if (allocator != nullptr && num_bytes > 0 && !allocator_attr.on_host()) {
+    void* data = allocator->AllocateRaw(num_bytes);
+    if (data == nullptr) {
+      return errors::ResourceExhausted(
+          "OOM when allocating temporary tensor with shape ",
+          shape.DebugString());
+    }
+    TF_Tensor* tmp = TF_NewTensor(
+        static_cast<TF_DataType>(type), shape.dim_sizes().data(),
+        shape.dims(), data, num_bytes,
+        [](void* data, size_t len, void* arg) {
+          static_cast<CPUCachingAllocator*>(arg)->DeallocateRaw(data);
+        },
+        allocator);
+    *out_temp = Tensor(type, shape, tmp);
+    return Status::OK();
+  }
+#endif
   TF_Tensor* tmp = TF_AllocateTemp(ctx_, static_cast<TF_DataType>(type),
                                    shape.dim_sizes().data(), shape.dims(),
                                    &allocator_attr.plugin_attr(), status_);
@@ -339,9 +353,8 @@ void OpKernelContext::set_output(int index, const Tensor& tensor) {
       << " Index out of range while setting output";
   TF_SetOutput(ctx_, index, tensor.GetTFTensor(), status_);
   ITEX_CHECK_EQ(TF_OK, TF_GetCode(status_)) << " Error while setting output";
-  ITEX_CHECK_EQ(outputs_[index], nullptr);
-  std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(tensor);
-  outputs_[index] = std::move(ptr);
+  ITEX_CHECK(!outputs_[index].has_value());
+  outputs_[index].emplace(tensor);
   return;
 }
 
@@ -795,6 +808,27 @@ bool IsSyncExecEnabled() {
   return sync_exec_enabled;
 }
 
+bool IsOpStatsEnabled() {
+  static std::once_flag op_stats_flag;
+  static bool op_stats_enabled;
+  std::call_once(op_stats_flag, [&]() {
+    ITEX_CHECK_OK(
+        ReadBoolFromEnvVar("ITEX_OP_STATS", true, &op_stats_enabled));
+  });
+
+  return op_stats_enabled;
+}
+
+void RecordOpStats(OpKernelContext* context, OpKernel* op, int64 elapsed_ns) {
+  if (IsVerboseEnabled()) {
+    ITEX_VLOG(0) << op->type() << "," << op->name() << "," << elapsed_ns;
+  }
+  if (IsOpStatsEnabled()) {
+    OpStatsRegistry::Global()->Record(op, op->name(), op->type(), elapsed_ns,
+                                      context->allocated_bytes());
+  }
+}
+
 namespace {
 
 // Label defaults to empty if not found in NodeDef.
@@ -26,9 +26,11 @@ limitations under the License.
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "itex/core/utils/allocator.h"
 #include "itex/core/utils/annotated_traceme.h"
 #include "itex/core/utils/cpu_info.h"
+#include "itex/core/utils/cpu_threadpool.h"
 #include "itex/core/utils/env_var.h"
 #include "itex/core/utils/kernel_def_util.h"
 #include "itex/core/utils/logging.h"
@@ -177,6 +179,8 @@ class OpKernelContext {
 #ifndef INTEL_CPU_ONLY
   explicit OpKernelContext(TF_OpKernelContext* ctx)
       : ctx_(ctx),
+        num_inputs_(TF_NumInputs(ctx_)),
+        inputs_(num_inputs_),
         outputs_(TF_NumOutputs(ctx_)),
         status_(TF_NewStatus()),
         device_(ctx_, status_),
@@ -184,21 +188,19 @@ class OpKernelContext {
 #else
   explicit OpKernelContext(TF_OpKernelContext* ctx)
       : ctx_(ctx),
+        num_inputs_(TF_NumInputs(ctx_)),
+        inputs_(num_inputs_),
         outputs_(TF_NumOutputs(ctx_)),
         status_(TF_NewStatus()),
         device_(ctx_, status_) {}
 #endif
 
   ~OpKernelContext() {
-    if (inputs_ != nullptr) {
-      delete inputs_;
-    }
-
     TF_DeleteStatus(status_);
     status_ = nullptr;
   }
 
-  int num_inputs() const;  // { return inputs->size(); }
+  int num_inputs() const { return num_inputs_; }
 
   bool input_is_ref(int index) const;
 
@@ -216,7 +218,9 @@ class OpKernelContext {
 
   void* tensor_data(int index);
 
-  bool is_input_same(int index, std::vector<int64> shape);
+  // Returns true if the shape of input `index` equals `shape`. The input is
+  // fetched at most once per context and shared with input(index).
+  bool is_input_same(int index, const std::vector<int64>& shape);
   int64_t step_id() const;
 
   //  Status input_list(StringPiece name, OpInputList* list);
@@ -324,13 +328,9 @@ class OpKernelContext {
   // Status mutable_output(StringPiece name, Tensor** tensor);
   Tensor* mutable_output(int index);
 
+  // Eigen CPU kernels share the ITEX intra-op thread pool with oneDNN.
   static const Eigen::ThreadPoolDevice& eigen_cpu_device_singleton() {
-    static Eigen::ThreadPool threadpool(port::NumSchedulableCPUs());
-    static Eigen::ThreadPoolDevice threadpool_device(
-        &threadpool,
-        (port::NumSchedulableCPUs() + port::NumHyperthreadsPerCore() - 1) /
-            port::NumHyperthreadsPerCore());
-    return threadpool_device;
+    return CPUThreadPool::GetInstance()->eigen_device();
   }
 
   const Eigen::ThreadPoolDevice& eigen_cpu_device() const {
@@ -384,12 +384,16 @@ class OpKernelContext {
   OpKernelContext(const OpKernelContext&) = delete;
   const OpKernelContext& operator=(const OpKernelContext&) = delete;
   TF_OpKernelContext* ctx_;
+  const int num_inputs_;
   // We use single vector inputs_ to store all kinds of input tensors:
-  // normal/ref/resource
-  mutable gtl::InlinedVector<std::shared_ptr<Tensor>, 4>* inputs_ = nullptr;
-  gtl::InlinedVector<std::shared_ptr<Tensor>, 4> outputs_;
+  // normal/ref/resource. Tensors are constructed in place on first access, so
+  // ops with a few inputs and outputs don't allocate on the heap, and the
+  // vectors are never resized, so returned references stay valid.
+  mutable gtl::InlinedVector<absl::optional<Tensor>, 4> inputs_;
+  gtl::InlinedVector<absl::optional<Tensor>, 4> outputs_;
   std::map<StringPiece, std::shared_ptr<Tensor>> inputsMap_;
   TF_Status* status_;
+  int64 allocated_bytes_ = 0;
   class InternalDevice {
    public:
 #ifndef INTEL_CPU_ONLY
@@ -719,6 +723,14 @@ class Registrar {
 bool IsSyncExecEnabled();
 bool IsVerboseEnabled();
 
+// `ITEX_OP_STATS` (on by default) records the latency, calls and allocated
+// bytes of every kernel execution in the process-wide `OpStatsRegistry`.
+// Without `ITEX_SYNC_EXEC`, GPU latencies only cover the kernel submission.
+bool IsOpStatsEnabled();
+// Records one execution of `op` which took `elapsed_ns`, and logs it when
+// `ITEX_VERBOSE` is set.
+void RecordOpStats(OpKernelContext* context, OpKernel* op, int64 elapsed_ns);
+
 #ifndef INTEL_CPU_ONLY
 const char* const USES_FP64_MATH = "uses-fp64-math";
 const char* const ASPECT_FP64_IS_NOT_SUPPORTED = "aspect fp64 is not supported";
@@ -750,10 +762,12 @@ inline void RunWithSyncHandler(OpKernelContext* context, OpKernel* op) {
 #endif
 
 inline void RunOrWaitUntilFinish(OpKernelContext* context, OpKernel* op) {
+  const bool timed = IsOpStatsEnabled() || IsVerboseEnabled();
+  std::chrono::steady_clock::time_point start;
+  if (timed) start = std::chrono::steady_clock::now();
 #ifndef INTEL_CPU_ONLY
+  RunWithSyncHandler(context, op);
   if (IsSyncExecEnabled()) {
-    auto start = std::chrono::steady_clock::now();
-    RunWithSyncHandler(context, op);
     auto stream = context->GetDeviceStream();
     auto error = ITEX_GPUStreamSynchronize(stream);
     if (error != ITEX_GPU_SUCCESS) {
@@ -762,29 +776,17 @@ inline void RunOrWaitUntilFinish(OpKernelContext* context, OpKernel* op) {
           errors::Internal("Error to call the stream's wait with error ",
                            ITEX_GPUGetErrorName(error)));
     }
+  }
+#else
+  op->Compute(context);
+#endif
+  if (timed) {
     auto end = std::chrono::steady_clock::now();
     auto elapsed =
         std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
             .count();
-    if (IsVerboseEnabled()) {
-      ITEX_VLOG(0) << op->type() << "," << op->name() << "," << elapsed;
-    }
-  } else {
-    if (IsVerboseEnabled()) {
-      auto start = std::chrono::steady_clock::now();
-      RunWithSyncHandler(context, op);
-      auto end = std::chrono::steady_clock::now();
-      auto elapsed =
-          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
-              .count();
-      ITEX_VLOG(0) << op->type() << "," << op->name() << "," << elapsed;
-    } else {
-      RunWithSyncHandler(context, op);
-    }
+    RecordOpStats(context, op, elapsed);
   }
-#else
-  op->Compute(context);
-#endif
 }
 
 class OpTypeFactory {
@@ -20,6 +20,8 @@ from intel_extension_for_tensorflow.python.config import set_config  # pylint: d
 from intel_extension_for_tensorflow.python.config import get_config  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python.device import set_backend  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python.device import get_backend  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.op_stats import get_op_stats  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.op_stats import reset_op_stats  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python import ops  # pylint: disable=unused-import,line-too-long
 from intel_extension_for_tensorflow.python.version import __version__  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python import version  # pylint: disable=unused-import
@@ -18,6 +18,7 @@ limitations under the License.
 #include "Python.h"
 #include "itex/core/devices/device_backend_util.h"
 #include "itex/core/graph/config_util.h"
+#include "itex/core/profiler/op_stats.h"
 #include "pybind11/pybind11.h"
 
 namespace py = pybind11;
@@ -39,6 +40,53 @@ static py::bytes ITEX_GetConfig() {
   return py::bytes(config_str);
 }
 
+static py::dict OpStatsToDict(const OpStatsRegistry::Stats& stats) {
+  py::dict result;
+  result["op_type"] = stats.op_type;
+  if (!stats.node_name.empty()) result["node_name"] = stats.node_name;
+  result["calls"] = stats.calls;
+  result["total_ns"] = stats.total_ns;
+  result["max_ns"] = stats.max_ns;
+  result["p50_ns"] = stats.Percentile(50);
+  result["p90_ns"] = stats.Percentile(90);
+  result["p99_ns"] = stats.Percentile(99);
+  result["allocated_bytes"] = stats.allocated_bytes;
+  return result;
+}
+
+static py::dict ITEX_GetOpStats() {
+  OpStatsRegistry::Snapshot snapshot = OpStatsRegistry::Global()->GetSnapshot();
+  py::list ops, nodes, caches;
+  for (const auto& stats : snapshot.ops) ops.append(OpStatsToDict(stats));
+  for (const auto& stats : snapshot.nodes) nodes.append(OpStatsToDict(stats));
+  for (const auto& cache : snapshot.primitive_caches) {
+    py::dict stats;
+    stats["name"] = cache.name;
+    stats["hits"] = cache.hits;
+    stats["misses"] = cache.misses;
+    caches.append(stats);
+  }
+  py::list allocators;
+  for (const auto& allocator : snapshot.allocators) {
+    py::dict stats;
+    stats["name"] = allocator.name;
+    stats["num_allocs"] = allocator.num_allocs;
+    stats["cache_hits"] = allocator.cache_hits;
+    stats["cache_misses"] = allocator.cache_misses;
+    stats["bytes_in_use"] = allocator.bytes_in_use;
+    stats["peak_bytes_in_use"] = allocator.peak_bytes_in_use;
+    stats["largest_alloc_size"] = allocator.largest_alloc_size;
+    stats["bytes_cached"] = allocator.bytes_cached;
+    allocators.append(stats);
+  }
+  py::dict result;
+  result["ops"] = ops;
+  result["nodes"] = nodes;
+  result["primitive_caches"] = caches;
+  result["allocators"] = allocators;
+  return result;
+}
+
 PYBIND11_MODULE(_pywrap_itex, m) {
   m.doc() = "pybind11 front-end api for Intel ® Extension for TensorFlow*";
   m.def("ITEX_SetBackend",
@@ -57,6 +105,9 @@ PYBIND11_MODULE(_pywrap_itex, m) {
     itex_set_config(config);
   });
   m.def("ITEX_GetConfig", &itex::ITEX_GetConfig);
+
+  m.def("ITEX_GetOpStats", &itex::ITEX_GetOpStats);
+  m.def("ITEX_ResetOpStats", []() { OpStatsRegistry::Global()->Reset(); });
 }
 
 }  // namespace itex
@@ -0,0 +1,42 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""op_stats"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+from intel_extension_for_tensorflow.python._pywrap_itex import *
+
+def get_op_stats():
+  """Returns the kernel execution statistics recorded since the last reset.
+
+  The result is a dict with:
+    "ops": per op type stats, sorted by total time.
+    "nodes": per node stats, sorted by total time.
+    "primitive_caches": hits and misses of the oneDNN primitive caches.
+    "allocators": usage of the ITEX caching allocators and of the oneDNN
+      scratchpad buffers, which isn't reset.
+
+  Each op or node entry holds "op_type", "calls", "total_ns", "max_ns",
+  "p50_ns", "p90_ns", "p99_ns" and "allocated_bytes", and node entries also
+  "node_name". Percentiles are rounded up to a power of 2. Recording is
+  controlled by the environment variable ITEX_OP_STATS.
+  """
+  return ITEX_GetOpStats()
+
+def reset_op_stats():
+  """Drops all recorded statistics."""
+  ITEX_ResetOpStats()
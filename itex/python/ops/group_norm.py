@@ -110,15 +110,20 @@ class GroupNormalization(Layer):
         # Indicates whether a faster fused implementation can be used. This will be
         # set to True or False in build()"        
         self.use_fused_group_norm = None
+        self.use_fused_group_norm_grad = None
 
     def build(self, input_shape):
         tf_utils.validate_axis(self.axis, input_shape)
         rank = len(input_shape)
         self.axis = (self.axis + rank) % rank
         
-        # fused_group_norm only support GPU backend and NHWC and axis=-1 currently
+        # fused_group_norm only support NHWC and axis=-1 currently, and its
+        # gradient is only implemented on CPU.
         # TODO(itex): support channel first and rank==any
-        self.use_fused_group_norm = config.list_logical_devices('XPU') and (rank == 4) and (self.axis == rank - 1)
+        self.use_fused_group_norm = (
+            (rank == 4) and (self.axis == rank - 1) and
+            self.compute_dtype in ("float16", "bfloat16", "float32"))
+        self.use_fused_group_norm_grad = not config.list_logical_devices('XPU')
 
         dim = input_shape[self.axis]
         if dim is None:
@@ -170,8 +175,9 @@ class GroupNormalization(Layer):
 
     def call(self, inputs, training=False):
         input_shape = tf.shape(inputs)
-        # TODO(itex): support GroupNormGrad
-        if self.use_fused_group_norm and training == False:
+        # TODO(itex): support GroupNormGrad on GPU
+        if self.use_fused_group_norm and (training == False or
+                                          self.use_fused_group_norm_grad):
             normalized_inputs = load_ops_library.itex_group_norm(
                 inputs,
                 self.gamma,
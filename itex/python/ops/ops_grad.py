@@ -65,6 +65,15 @@ def _itex_layer_norm_grad(op, *grad):
       data_format=data_format)
   return dx, dscale, doffset
 
+@ops.RegisterGradient("ITEXGroupNorm")
+def _itex_group_norm_grad(op, grad):
+  """ITEXGroupNormGrad is only implemented on CPU."""
+  return load_ops_library.itex_group_norm_grad(
+      y_backprop=grad, x=op.inputs[0], scale=op.inputs[1],
+      offset=op.inputs[2], num_groups=op.get_attr("num_groups"),
+      epsilon=op.get_attr("epsilon"), use_scale=op.get_attr("use_scale"),
+      use_center=op.get_attr("use_center"))
+
 @ops.RegisterGradient("ItexRnn")
 def _itex_rnn_grad(op, *grad):
   if not op.get_attr("is_training"):
@@ -23,6 +23,7 @@ from intel_extension_for_tensorflow.python.ops.load_ops_library import load_ops_
 #from tensorflow.python.eager import context
 from tensorflow.python.framework import config
 from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
 #from tensorflow.python.framework import ops
 from tensorflow.python.ops import array_ops
 #from tensorflow.python.ops import control_flow_ops
@@ -361,7 +362,14 @@ class ItexLSTM(LSTMV1):
     can_use_gpu = ((config.list_logical_devices('XPU')) and
                    (mask is None or is_itex_supported_inputs\
                    (mask, self.time_major)))
-    if self._could_use_itex_kernel and can_use_gpu:
+    # The CPU kernel runs the whole sequence with one oneDNN LSTM primitive,
+    # which has no dropout or per sample sequence lengths.
+    can_use_cpu = ((not config.list_logical_devices('XPU')) and
+                   inputs.dtype in (dtypes.float32, dtypes.bfloat16) and
+                   mask is None and row_lengths is None and
+                   not 0 < self.cell.dropout < 1 and
+                   not 0 < self.cell.recurrent_dropout < 1)
+    if self._could_use_itex_kernel and (can_use_gpu or can_use_cpu):
       last_output, outputs, new_h, new_c = gpu_lstm(
           **gpu_lstm_kwargs)
     else:
@@ -0,0 +1,89 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+import time
+
+import numpy as np
+import tensorflow as tf
+from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import constant_op
+from tensorflow.python.ops import math_ops
+
+try:
+    from intel_extension_for_tensorflow.python.test_func import test
+except ImportError:
+    from tensorflow.python.platform import test
+
+# Tiny ops spend most of their time in kernel dispatch (OpKernelContext input
+# and output plumbing) rather than in math, so the average time per op is a
+# measure of the per-op dispatch overhead. Compare the numbers printed by this
+# benchmark before and after changes to the op kernel framework.
+NUM_OPS = 1000
+WARMUP = 10
+ITERATION = 100
+SIZES = [[1], [8, 8]]
+
+
+class OpDispatchOverheadTest(test.TestCase):
+    def _benchmark(self, name, fn, x):
+        for _ in range(WARMUP):
+            fn(x).numpy()
+        start = time.perf_counter()
+        for _ in range(ITERATION):
+            fn(x).numpy()
+        elapsed = time.perf_counter() - start
+        us_per_op = elapsed * 1e6 / (ITERATION * NUM_OPS)
+        print("%s %s: %.3f us per op" % (name, x.shape, us_per_op))
+
+    def testUnaryDispatch(self):
+        @tf.function
+        def chain(x):
+            for _ in range(NUM_OPS):
+                x = math_ops.abs(x)
+            return x
+
+        for size in SIZES:
+            x = constant_op.constant(np.random.normal(size=size),
+                                     dtype=dtypes.float32)
+            self._benchmark("Abs", chain, x)
+
+    def testBinaryDispatch(self):
+        @tf.function
+        def chain(x):
+            y = x
+            for _ in range(NUM_OPS):
+                y = math_ops.add_v2(y, x)
+            return y
+
+        for size in SIZES:
+            x = constant_op.constant(np.random.normal(size=size),
+                                     dtype=dtypes.float32)
+            self._benchmark("AddV2", chain, x)
+
+    def testMatMulDispatch(self):
+        @tf.function
+        def chain(x):
+            for _ in range(NUM_OPS):
+                x = math_ops.matmul(x, x)
+            return x
+
+        x = constant_op.constant(np.random.uniform(size=[8, 8]) / 8,
+                                 dtype=dtypes.float32)
+        self._benchmark("MatMul", chain, x)
+
+
+if __name__ == '__main__':
+    test.main()
@@ -0,0 +1,94 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""Compares the CPU Transpose backends selected by ITEX_CPU_TRANSPOSE_BACKEND.
+
+The backend is read when a kernel is created, so each backend runs in a freshly
+traced tf.function. Prints the average time of every case per backend.
+"""
+
+import os
+import time
+
+import numpy as np
+import tensorflow as tf
+from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import constant_op
+from tensorflow.python.ops import array_ops
+
+try:
+    from intel_extension_for_tensorflow.python.test_func import test
+except ImportError:
+    from tensorflow.python.platform import test
+
+BACKENDS = ["onednn", "eigen", "plan"]
+COMPUTE_TYPE = [dtypes.float32, dtypes.bfloat16, dtypes.int8]
+# (input shape, permutation)
+CASES = [
+    ([8192, 8192], [1, 0]),
+    ([32, 64, 56, 56], [0, 2, 3, 1]),     # NCHW -> NHWC
+    ([32, 56, 56, 64], [0, 3, 1, 2]),     # NHWC -> NCHW
+    ([16, 28, 28, 28, 32], [0, 4, 1, 2, 3]),  # NDHWC -> NCDHW
+    ([64, 128, 12, 64], [0, 2, 1, 3]),    # attention heads
+    ([33, 1025, 7], [2, 0, 1]),
+]
+WARMUP = 3
+ITERATION = 20
+
+
+class TransposeBackendsTest(test.TestCase):
+    def _time_backend(self, backend, in_tensor, perm):
+        os.environ["ITEX_CPU_TRANSPOSE_BACKEND"] = backend
+
+        @tf.function
+        def transpose(x):
+            return array_ops.transpose(x, perm)
+
+        result = transpose(in_tensor)
+        for _ in range(WARMUP):
+            transpose(in_tensor).numpy()
+        start = time.time()
+        for _ in range(ITERATION):
+            transpose(in_tensor).numpy()
+        return (time.time() - start) / ITERATION * 1000, result
+
+    def testTransposeBackends(self):
+        saved_backend = os.environ.get("ITEX_CPU_TRANSPOSE_BACKEND")
+        print("\n%-26s %-16s %-9s" % ("shape", "perm", "dtype") +
+              "".join("%12s" % b for b in BACKENDS) + "   (ms)")
+        try:
+            with tf.device("/cpu:0"):
+                for dtype in COMPUTE_TYPE:
+                    for shape, perm in CASES:
+                        in_array = np.random.normal(size=shape) * 10
+                        in_tensor = constant_op.constant(in_array, dtype=dtype)
+                        expected = np.transpose(in_tensor.numpy(), perm)
+                        times = []
+                        for backend in BACKENDS:
+                            elapsed, result = self._time_backend(
+                                backend, in_tensor, perm)
+                            self.assertAllEqual(result, expected)
+                            times.append(elapsed)
+                        print("%-26s %-16s %-9s" % (shape, perm, dtype.name) +
+                              "".join("%12.3f" % t for t in times))
+        finally:
+            if saved_backend is None:
+                os.environ.pop("ITEX_CPU_TRANSPOSE_BACKEND", None)
+            else:
+                os.environ["ITEX_CPU_TRANSPOSE_BACKEND"] = saved_backend
+
+
+if __name__ == "__main__":
+    test.main()
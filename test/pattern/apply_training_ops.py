@@ -45,10 +45,8 @@ class trainingOpsTest(test.TestCase):
       
     """test _FusedApplyAdam"""
     def test_apply_adam(self):
-        if not test.is_gpu_available():
-            self.skipTest("No GPU available")
         dtype = np.float32
-        use_gpu = True  # Only GPU supports this fusion.
+        use_gpu = True
         
         var = np.arange(100).astype(dtype)
         m = np.arange(1, 101).astype(dtype)
@@ -91,10 +89,8 @@ class trainingOpsTest(test.TestCase):
     
     """ test _FusedApplyMomentum """
     def test_apply_momentum(self):
-        if not test.is_gpu_available():
-            self.skipTest("No GPU available")
         dtype = np.float32
-        use_gpu = True  # Only GPU supports this fusion.
+        use_gpu = True
         
         var = np.arange(100).astype(dtype)
         accum = np.arange(1, 101).astype(dtype)
@@ -130,10 +126,8 @@ class trainingOpsTest(test.TestCase):
         
     """ test _FusedApplyAdamWithWeightDecay """
     def test_apply_adam_with_weight_decay(self):
-        if not test.is_gpu_available():
-            self.skipTest("No GPU available")
         dtype = np.float32
-        use_gpu = True  # Only GPU supports this fusion.
+        use_gpu = True
         
         var = np.arange(100).astype(dtype)
         m = np.arange(1, 101).astype(dtype)
@@ -182,8 +176,86 @@ class trainingOpsTest(test.TestCase):
                     found_fused_op = len(fused_ops) == 1 and fused_ops[0] == b'Mul'
                     break
             self.assertTrue(found_fused_op, "this pattern has fusion issue!!")
-        
-        
+
+
+    def _run_and_check_fusion(self, output, state, fused_op):
+        """Runs `output` on CPU, returns the updated `state` variables and
+        whether `fused_op` is in the optimized graph."""
+        run_options = config_pb2.RunOptions(output_partition_graphs=True)
+        metadata = config_pb2.RunMetadata()
+        with self.session(use_gpu=False) as sess:
+            sess.run(variables.global_variables_initializer())
+            sess.run(output, options=run_options, run_metadata=metadata)
+            graph = metadata.partition_graphs[0]
+            found_fused_op = any(node.op == fused_op for node in graph.node)
+            return sess.run(state), found_fused_op
+
+    def _apply_adam(self, dtype, fuse):
+        var_t = variables.RefVariable(np.linspace(-1, 1, 100).astype(dtype))
+        m_t = variables.RefVariable(np.linspace(0, 1, 100).astype(dtype))
+        v_t = variables.RefVariable(np.linspace(1, 2, 100).astype(dtype))
+        hyper = [np.array(x, dtype=dtype)
+                 for x in (0.9, 0.999, 0.01, 0.9, 0.999, 1e-8)]
+        grad = np.linspace(-0.5, 0.5, 100).astype(dtype)
+        # The unfused reference gets the gradient already scaled.
+        grad = tf.multiply(grad, 3) if fuse else tf.constant(grad * 3)
+        apply_adam = tf.raw_ops.ApplyAdam(
+            var=var_t, m=m_t, v=v_t, beta1_power=hyper[0],
+            beta2_power=hyper[1], lr=hyper[2], beta1=hyper[3],
+            beta2=hyper[4], epsilon=hyper[5], grad=grad)
+        return self._run_and_check_fusion(array_ops.identity(apply_adam),
+                                          [var_t, m_t, v_t],
+                                          '_ITEXFusedApplyAdam')
+
+    def _apply_momentum(self, dtype, fuse):
+        var_t = variables.RefVariable(np.linspace(-1, 1, 100).astype(dtype))
+        accum_t = variables.RefVariable(np.linspace(0, 1, 100).astype(dtype))
+        lr = np.array(0.01, dtype=dtype)
+        momentum = np.array(0.9, dtype=dtype)
+        grad = np.linspace(-0.5, 0.5, 100).astype(dtype)
+        tmp = np.linspace(0, 0.25, 100).astype(dtype)
+        if fuse:
+            grad = tf.add_n([tf.multiply(grad, 2), tmp])
+        else:
+            grad = tf.constant(grad * 2 + tmp)
+        apply_momentum = tf.raw_ops.ApplyMomentum(
+            var=var_t, accum=accum_t, lr=lr, grad=grad, momentum=momentum)
+        return self._run_and_check_fusion(array_ops.identity(apply_momentum),
+                                          [var_t, accum_t],
+                                          '_ITEXFusedApplyMomentum')
+
+    def _apply_adam_with_weight_decay(self, dtype, fuse):
+        var_t = variables.RefVariable(np.linspace(-1, 1, 100).astype(dtype))
+        m_t = variables.RefVariable(np.linspace(0, 1, 100).astype(dtype))
+        v_t = variables.RefVariable(np.linspace(1, 2, 100).astype(dtype))
+        hyper = [np.array(x, dtype=dtype)
+                 for x in (0.9, 0.999, 0.01, 0.9, 0.999, 1e-8, 0.02)]
+        grad = np.linspace(-0.5, 0.5, 100).astype(dtype)
+        grad = tf.multiply(grad, 2) if fuse else tf.constant(grad * 2)
+        apply_adam = load_ops_library.itex_apply_adam_with_weight_decay(
+            var_t, m_t, v_t, *hyper, grad)
+        return self._run_and_check_fusion(array_ops.identity(apply_adam),
+                                          [var_t, m_t, v_t],
+                                          '_ITEXFusedApplyAdamWithWeightDecay')
+
+    """ compare the fused ops on CPU with the unfused ops """
+    def test_fused_training_ops_match_unfused_on_cpu(self):
+        tolerance = {np.float32: 1e-5, np.float16: 2e-3,
+                     dtypes.bfloat16.as_numpy_dtype: 2e-2}
+        for apply_fn in (self._apply_adam, self._apply_momentum,
+                         self._apply_adam_with_weight_decay):
+            for dtype, tol in tolerance.items():
+                with tf.Graph().as_default():
+                    expected, _ = apply_fn(dtype, fuse=False)
+                with tf.Graph().as_default():
+                    actual, found_fused_op = apply_fn(dtype, fuse=True)
+                self.assertTrue(found_fused_op,
+                                "this pattern has fusion issue!!")
+                for e, a in zip(expected, actual):
+                    self.assertAllClose(e.astype(np.float32),
+                                        a.astype(np.float32),
+                                        rtol=tol, atol=tol)
+
 
 if __name__ == '__main__':
     test.main()
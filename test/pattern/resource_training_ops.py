@@ -45,10 +45,8 @@ class resourceTraingingOpsTest(test.TestCase):
 
     """test _FusedResourceApplyAdam"""
     def test_resource_apply_adam(self):
-        if not test.is_gpu_available():
-            self.skipTest("No GPU available")
         dtype = np.float32
-        use_gpu = True  # Only GPU supports this fusion.
+        use_gpu = True
         
         var = np.arange(100).astype(dtype)
         m = np.arange(1, 101).astype(dtype)
@@ -93,10 +91,8 @@ class resourceTraingingOpsTest(test.TestCase):
 
     """ test _FusedResourceApplyMomentum """
     def test_resource_apply_momentum(self):
-        if not test.is_gpu_available():
-            self.skipTest("No GPU available")
         dtype = np.float32
-        use_gpu = True  # Only GPU supports this fusion.
+        use_gpu = True
         
         var = np.arange(100).astype(dtype)
         accum = np.arange(1, 101).astype(dtype)
@@ -132,10 +128,8 @@ class resourceTraingingOpsTest(test.TestCase):
         
     """ test _FusedResourceApplyAdamWithWeightDecay """
     def test_resource_apply_adam_with_weight_decay(self):
-        if not test.is_gpu_available():
-            self.skipTest("No GPU available")
         dtype = np.float32
-        use_gpu = True  # Only GPU supports this fusion.
+        use_gpu = True
         
         var = np.arange(100).astype(dtype)
         m = np.arange(1, 101).astype(dtype)
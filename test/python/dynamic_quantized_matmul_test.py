@@ -0,0 +1,120 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+import os
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+from tensorflow.core.protobuf import config_pb2
+
+# The rewrite is done by the native layout pass only.
+os.environ["ITEX_LAYOUT_OPT"] = "0"
+
+# (input shape, weight shape, transpose_b)
+SIZES = [([16, 64], [64, 32], False), ([7, 100], [48, 100], True),
+         ([2, 9, 128], [128, 96], False)]
+
+QUANTIZED_OP = "_ITEXDynamicQuantizedMatMul"
+
+
+class DynamicQuantizedMatMulTest(test_util.TensorFlowTestCase):
+  """test MatMul on CPU with ITEX_DYNAMIC_QUANTIZATION"""
+
+  def setUp(self):
+    super().setUp()
+    self._saved_mode = os.environ.get("ITEX_DYNAMIC_QUANTIZATION")
+
+  def tearDown(self):
+    if self._saved_mode is None:
+      os.environ.pop("ITEX_DYNAMIC_QUANTIZATION", None)
+    else:
+      os.environ["ITEX_DYNAMIC_QUANTIZATION"] = self._saved_mode
+    super().tearDown()
+
+  def _run(self, mode, x_np, w_np, b_np=None, transpose_b=False):
+    """Returns the result and the quantization modes of the rewritten ops."""
+    os.environ["ITEX_DYNAMIC_QUANTIZATION"] = mode
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+    with tf.Graph().as_default(), tf.device("/cpu:0"):
+      x = tf.compat.v1.placeholder(tf.float32, shape=x_np.shape)
+      # The weight must be a constant of the graph to be quantized.
+      w = tf.constant(w_np)
+      y = tf.linalg.matmul(x, w, adjoint_b=transpose_b)
+      if b_np is not None:
+        y = tf.nn.relu(tf.nn.bias_add(y, tf.constant(b_np)))
+      y = tf.identity(y)
+      with tf.compat.v1.Session() as sess:
+        result = sess.run(y, feed_dict={x: x_np}, options=run_options,
+                          run_metadata=metadata)
+    modes = [node.attr["quantization_mode"].s.decode()
+             for graph in metadata.partition_graphs for node in graph.node
+             if node.op == QUANTIZED_OP]
+    return result, modes
+
+  def _test_impl(self, mode, x_shape, w_shape, transpose_b):
+    x_np = np.random.normal(size=x_shape).astype(np.float32)
+    w_np = np.random.normal(size=w_shape).astype(np.float32)
+    b_np = np.random.normal(size=w_shape[0 if transpose_b else 1]).astype(
+        np.float32)
+
+    result, modes = self._run(mode, x_np, w_np, b_np, transpose_b)
+    self.assertEqual(modes, [mode])
+
+    w_ref = w_np.T if transpose_b else w_np
+    expected = np.maximum(np.matmul(x_np, w_ref) + b_np, 0)
+    # Both operands are rounded to 8 bits.
+    tol = 2e-2 * np.abs(expected).max()
+    self.assertAllClose(result, expected, rtol=0, atol=tol)
+
+  def testDynamicQuantizedMatMul(self):
+    for mode in ["PER_TENSOR", "PER_ROW"]:
+      for x_shape, w_shape, transpose_b in SIZES:
+        self._test_impl(mode, x_shape, w_shape, transpose_b)
+
+  def testDisabled(self):
+    x_np = np.random.normal(size=[16, 64]).astype(np.float32)
+    w_np = np.random.normal(size=[64, 32]).astype(np.float32)
+    for mode in ["", "OFF"]:
+      result, modes = self._run(mode, x_np, w_np)
+      self.assertEqual(modes, [])
+      self.assertAllClose(result, np.matmul(x_np, w_np), rtol=1e-5,
+                          atol=1e-5)
+
+  def testPerRowVsPerTensor(self):
+    # The rows of the input differ in range by 1e4, so one tensor-wide scale
+    # rounds the small row to a few levels, while per-row scales keep it.
+    x_np = np.random.uniform(-1, 1, size=[2, 64]).astype(np.float32)
+    x_np[0] *= 100.0
+    x_np[1] *= 0.01
+    w_np = np.random.normal(size=[64, 32]).astype(np.float32)
+    expected = np.matmul(x_np, w_np)
+
+    def small_row_error(mode):
+      result, modes = self._run(mode, x_np, w_np)
+      self.assertEqual(modes, [mode])
+      return np.abs(result[1] - expected[1]).max() / np.abs(expected[1]).max()
+
+    per_row = small_row_error("PER_ROW")
+    per_tensor = small_row_error("PER_TENSOR")
+    self.assertLess(per_row, 2e-2)
+    self.assertGreater(per_tensor, 5 * per_row)
+
+
+if __name__ == "__main__":
+  test.main()
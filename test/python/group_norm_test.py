@@ -0,0 +1,119 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.ops import GroupNormalization
+from intel_extension_for_tensorflow.python.ops.load_ops_library import load_ops_library
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+# (input shape, num_groups)
+SIZES = [([2, 8, 8, 32], 8), ([1, 5, 7, 12], 3), ([3, 4, 4, 640], 32),
+         ([2, 64, 64, 16], 16)]
+
+
+def _group_norm_ref(x, gamma, beta, num_groups, epsilon):
+  """Decomposed GroupNorm, as Keras computes it without the fused op."""
+  shape = tf.shape(x)
+  channels = x.shape[-1]
+  grouped = tf.reshape(
+      x, [shape[0], shape[1], shape[2], num_groups, channels // num_groups])
+  mean, var = tf.nn.moments(grouped, axes=[1, 2, 4], keepdims=True)
+  normalized = (grouped - mean) * tf.math.rsqrt(var + epsilon)
+  return tf.reshape(normalized, shape) * gamma + beta
+
+
+class GroupNormTest(test_util.TensorFlowTestCase):
+  """test ITEXGroupNorm and its gradient on CPU"""
+
+  def _test_impl(self, shape, num_groups, dtype):
+    epsilon = 1e-3
+    x = tf.constant(np.random.normal(size=shape) * 3 + 1, dtype=dtype)
+    gamma = tf.constant(np.random.normal(size=shape[-1:]), dtype=dtype)
+    beta = tf.constant(np.random.normal(size=shape[-1:]), dtype=dtype)
+    dy = tf.constant(np.random.normal(size=shape), dtype=dtype)
+
+    def run(fn):
+      with tf.GradientTape() as tape:
+        tape.watch([x, gamma, beta])
+        y = fn(x, gamma, beta)
+        loss = tf.reduce_sum(y * dy)
+      return [y] + tape.gradient(loss, [x, gamma, beta])
+
+    def itex_group_norm(x, gamma, beta):
+      return load_ops_library.itex_group_norm(
+          x, gamma, beta, num_groups=num_groups, epsilon=epsilon)
+
+    def ref_group_norm(x, gamma, beta):
+      x, gamma, beta = [tf.cast(t, tf.float32) for t in (x, gamma, beta)]
+      return _group_norm_ref(x, gamma, beta, num_groups, epsilon)
+
+    with tf.device("/cpu:0"):
+      results = tf.function(lambda: run(itex_group_norm))()
+      expected = tf.function(lambda: run(ref_group_norm))()
+
+    tol = {tf.bfloat16: 5e-2, tf.float16: 1e-2}.get(dtype, 1e-3)
+    for result, ref in zip(results, expected):
+      # Gradients of gamma and beta sum over the whole batch.
+      scale = max(1.0, float(tf.reduce_max(tf.abs(ref))))
+      self.assertAllClose(tf.cast(result, tf.float32) / scale, ref / scale,
+                          rtol=tol, atol=tol)
+
+  def testGroupNorm(self):
+    for dtype in [tf.float32, tf.bfloat16, tf.float16]:
+      for shape, num_groups in SIZES:
+        self._test_impl(shape, num_groups, dtype)
+
+  def testGroupNormalizationLayerFloat16(self):
+    shape, num_groups = [2, 8, 8, 32], 8
+    x = tf.constant(np.random.normal(size=shape), dtype=tf.float16)
+    layer = GroupNormalization(groups=num_groups, dtype="float16")
+    with tf.device("/cpu:0"):
+      with tf.GradientTape() as tape:
+        tape.watch(x)
+        y = layer(x, training=True)
+        loss = tf.reduce_sum(y)
+      dx = tape.gradient(loss, x)
+      ref = _group_norm_ref(tf.cast(x, tf.float32), 1.0, 0.0, num_groups,
+                            layer.epsilon)
+    self.assertTrue(layer.use_fused_group_norm)
+    self.assertEqual(y.dtype, tf.float16)
+    self.assertAllClose(tf.cast(y, tf.float32), ref, rtol=1e-2, atol=1e-2)
+    # The normalized output sums to beta * size per group, whatever x is.
+    self.assertAllClose(tf.cast(dx, tf.float32), tf.zeros(shape),
+                        rtol=1e-2, atol=1e-2)
+
+  def testGroupNormSwishFusion(self):
+    shape, num_groups = [2, 16, 16, 64], 32
+    x = tf.constant(np.random.normal(size=shape), dtype=tf.float32)
+    gamma = tf.constant(np.random.normal(size=shape[-1:]), dtype=tf.float32)
+    beta = tf.constant(np.random.normal(size=shape[-1:]), dtype=tf.float32)
+
+    @tf.function
+    def fused(x):
+      y = load_ops_library.itex_group_norm(
+          x, gamma, beta, num_groups=num_groups, epsilon=1e-5)
+      return y * tf.sigmoid(y)
+
+    with tf.device("/cpu:0"):
+      result = fused(x)
+      ref = _group_norm_ref(x, gamma, beta, num_groups, 1e-5)
+    self.assertAllClose(result, tf.nn.silu(ref), rtol=1e-4, atol=1e-4)
+
+
+if __name__ == "__main__":
+  test.main()
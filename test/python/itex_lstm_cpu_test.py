@@ -0,0 +1,170 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+import numpy as np
+import tensorflow as tf
+
+import intel_extension_for_tensorflow as itex
+from intel_extension_for_tensorflow.python.ops.load_ops_library import load_ops_library
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+# (batch, time, input_size, units)
+SIZES = [(4, 7, 5, 3), (1, 16, 32, 32), (3, 1, 8, 16)]
+
+
+class ItexLSTMCPUTest(test_util.TensorFlowTestCase):
+  """test ItexLSTM on CPU against the Keras LSTM"""
+
+  def _test_impl(self, batch, time, input_size, units, go_backwards):
+    inputs = tf.constant(
+        np.random.normal(size=(batch, time, input_size)), dtype=tf.float32)
+    itex_lstm = itex.ops.ItexLSTM(units, return_sequences=True,
+                                  return_state=True,
+                                  go_backwards=go_backwards)
+    keras_lstm = tf.keras.layers.LSTM(units, return_sequences=True,
+                                      return_state=True,
+                                      go_backwards=go_backwards)
+    itex_lstm.build(inputs.shape)
+    keras_lstm.build(inputs.shape)
+    keras_lstm.set_weights(itex_lstm.get_weights())
+
+    def run(layer):
+      with tf.GradientTape() as tape:
+        tape.watch(inputs)
+        outputs = layer(inputs, training=True)
+        loss = tf.add_n([tf.reduce_sum(out * out) for out in outputs])
+      grads = tape.gradient(loss, [inputs] + layer.trainable_weights)
+      return outputs, grads
+
+    with tf.device("/cpu:0"):
+      itex_outputs, itex_grads = tf.function(lambda: run(itex_lstm))()
+      keras_outputs, keras_grads = tf.function(lambda: run(keras_lstm))()
+
+    for itex_out, keras_out in zip(itex_outputs, keras_outputs):
+      self.assertAllClose(itex_out, keras_out, rtol=1e-4, atol=1e-4)
+    for itex_grad, keras_grad in zip(itex_grads, keras_grads):
+      self.assertAllClose(itex_grad, keras_grad, rtol=1e-3, atol=1e-3)
+
+  def testForwardAndBackward(self):
+    for batch, time, input_size, units in SIZES:
+      for go_backwards in [False, True]:
+        self._test_impl(batch, time, input_size, units, go_backwards)
+
+  def testBFloat16(self):
+    batch, time, input_size, units = SIZES[0]
+    inputs = tf.constant(
+        np.random.normal(size=(batch, time, input_size)), dtype=tf.float32)
+    itex_lstm = itex.ops.ItexLSTM(units, return_sequences=True,
+                                  dtype="mixed_bfloat16")
+    keras_lstm = tf.keras.layers.LSTM(units, return_sequences=True)
+    itex_lstm.build(inputs.shape)
+    keras_lstm.build(inputs.shape)
+    keras_lstm.set_weights(itex_lstm.get_weights())
+
+    def run(layer):
+      with tf.GradientTape() as tape:
+        tape.watch(inputs)
+        outputs = tf.cast(layer(inputs, training=True), tf.float32)
+        loss = tf.reduce_sum(outputs * outputs)
+      return outputs, tape.gradient(loss, [inputs] + layer.trainable_weights)
+
+    with tf.device("/cpu:0"):
+      itex_outputs, itex_grads = tf.function(lambda: run(itex_lstm))()
+      keras_outputs, keras_grads = tf.function(lambda: run(keras_lstm))()
+
+    self.assertAllClose(itex_outputs, keras_outputs, rtol=5e-2, atol=5e-2)
+    for itex_grad, keras_grad in zip(itex_grads, keras_grads):
+      self.assertAllClose(tf.cast(itex_grad, tf.float32), keras_grad,
+                          rtol=1e-1, atol=1e-1)
+
+
+def _gru_reference(inputs, init_h, params, input_size, units):
+  """GRU with the oneDNN gate order u, r, o and the reset gate applied before
+  the recurrent matmul, on time major inputs."""
+  gates = 3
+  w_size = gates * units * input_size
+  u_size = gates * units * units
+  w = tf.reshape(params[:w_size], [gates, units, input_size])
+  u = tf.reshape(params[w_size:w_size + u_size], [gates, units, units])
+  b = tf.reshape(params[w_size + u_size:], [gates, units])
+  h = init_h
+  outputs = []
+  for x in tf.unstack(inputs):
+    update = tf.sigmoid(
+        tf.matmul(x, w[0], transpose_b=True) +
+        tf.matmul(h, u[0], transpose_b=True) + b[0])
+    reset = tf.sigmoid(
+        tf.matmul(x, w[1], transpose_b=True) +
+        tf.matmul(h, u[1], transpose_b=True) + b[1])
+    candidate = tf.tanh(
+        tf.matmul(x, w[2], transpose_b=True) +
+        tf.matmul(reset * h, u[2], transpose_b=True) + b[2])
+    h = update * h + (1 - update) * candidate
+    outputs.append(h)
+  return tf.stack(outputs), h
+
+
+class ItexGRUCPUTest(test_util.TensorFlowTestCase):
+  """test ItexRnn in gru mode on CPU against a reference GRU"""
+
+  def _test_impl(self, batch, time, input_size, units):
+    gates = 3
+    inputs = tf.constant(
+        np.random.normal(size=(time, batch, input_size)), dtype=tf.float32)
+    init_h = tf.constant(
+        np.random.normal(size=(batch, units)), dtype=tf.float32)
+    params = tf.constant(
+        np.random.normal(
+            scale=0.5, size=gates * units * (input_size + units + 1)),
+        dtype=tf.float32)
+    empty = tf.zeros([0], tf.float32)
+
+    def run_itex():
+      with tf.GradientTape() as tape:
+        tape.watch([inputs, init_h, params])
+        outputs, h, _, _ = load_ops_library.itex_rnn(
+            input=inputs, input_h=init_h, input_c=empty, params=params,
+            dropout_mask=empty, recurrent_dropout_mask=empty,
+            sequence_lengths=0, rnn_mode="gru", is_training=True)
+        outputs = tf.reshape(outputs, [time, batch, units])
+        h = tf.reshape(h, [batch, units])
+        loss = tf.reduce_sum(outputs * outputs) + tf.reduce_sum(h)
+      return outputs, h, tape.gradient(loss, [inputs, init_h, params])
+
+    def run_reference():
+      with tf.GradientTape() as tape:
+        tape.watch([inputs, init_h, params])
+        outputs, h = _gru_reference(inputs, init_h, params, input_size,
+                                    units)
+        loss = tf.reduce_sum(outputs * outputs) + tf.reduce_sum(h)
+      return outputs, h, tape.gradient(loss, [inputs, init_h, params])
+
+    with tf.device("/cpu:0"):
+      itex_outputs, itex_h, itex_grads = tf.function(run_itex)()
+      ref_outputs, ref_h, ref_grads = tf.function(run_reference)()
+
+    self.assertAllClose(itex_outputs, ref_outputs, rtol=1e-4, atol=1e-4)
+    self.assertAllClose(itex_h, ref_h, rtol=1e-4, atol=1e-4)
+    for itex_grad, ref_grad in zip(itex_grads, ref_grads):
+      self.assertAllClose(itex_grad, ref_grad, rtol=1e-3, atol=1e-3)
+
+  def testForwardAndBackward(self):
+    for batch, time, input_size, units in SIZES:
+      self._test_impl(batch, time, input_size, units)
+
+
+if __name__ == "__main__":
+  test.main()
@@ -0,0 +1,81 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.op_stats import get_op_stats
+from intel_extension_for_tensorflow.python.op_stats import reset_op_stats
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+
+class OpStatsTest(test_util.TensorFlowTestCase):
+  """test the kernel execution statistics of ITEX_OP_STATS"""
+
+  def _run_matmul(self, times):
+    x = tf.constant(np.random.normal(size=[8, 16]).astype(np.float32))
+    w = tf.constant(np.random.normal(size=[16, 4]).astype(np.float32))
+
+    @tf.function
+    def matmul(x, w):
+      return tf.matmul(x, w)
+
+    with tf.device("/cpu:0"):
+      for _ in range(times):
+        matmul(x, w)
+
+  def testRecordAndReset(self):
+    reset_op_stats()
+    self._run_matmul(5)
+    stats = get_op_stats()
+
+    # The graph optimizer may rewrite MatMul to one of the ITEX MatMul ops.
+    matmul = [op for op in stats["ops"] if "MatMul" in op["op_type"]]
+    self.assertEqual(sum(op["calls"] for op in matmul), 5)
+    for op in matmul:
+      self.assertGreater(op["total_ns"], 0)
+      self.assertLessEqual(op["p50_ns"], op["p99_ns"])
+      self.assertLessEqual(op["p99_ns"], op["max_ns"])
+    # At least the [8, 4] float output of every call.
+    self.assertGreaterEqual(sum(op["allocated_bytes"] for op in matmul),
+                            5 * 8 * 4 * 4)
+
+    nodes = [node for node in stats["nodes"] if "MatMul" in node["op_type"]]
+    self.assertEqual(sum(node["calls"] for node in nodes), 5)
+    for node in nodes:
+      self.assertNotEmpty(node["node_name"])
+
+    reset_op_stats()
+    stats = get_op_stats()
+    self.assertEmpty(stats["ops"])
+    for cache in stats["primitive_caches"]:
+      self.assertEqual(cache["hits"], 0)
+      self.assertEqual(cache["misses"], 0)
+
+  def testAllocatorStats(self):
+    self._run_matmul(5)
+    # Only the CPU build has a caching allocator.
+    for allocator in get_op_stats()["allocators"]:
+      self.assertNotEmpty(allocator["name"])
+      self.assertEqual(allocator["cache_hits"] + allocator["cache_misses"],
+                       allocator["num_allocs"])
+      self.assertLessEqual(allocator["bytes_in_use"],
+                           allocator["peak_bytes_in_use"])
+      self.assertGreaterEqual(allocator["bytes_cached"], 0)
+
+
+if __name__ == '__main__':
+  test.main()
@@ -0,0 +1,118 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
+from tensorflow.python.ops import gen_image_ops
+
+# (align_corners, half_pixel_centers)
+MODES = [(False, False), (True, False), (False, True)]
+IMAGE_DTYPE = [dtypes.float32, dtypes.bfloat16, dtypes.int8, dtypes.uint8]
+SIZES = [([2, 7, 9, 3], [14, 5]), ([1, 16, 16, 32], [9, 23]),
+         ([3, 5, 4, 1], [5, 4])]
+
+
+def _scale(in_size, out_size, align_corners):
+  if align_corners and out_size > 1:
+    return (in_size - 1) / np.float32(out_size - 1)
+  return in_size / np.float32(out_size)
+
+
+def _bilinear_ref(image, out_size, align_corners, half_pixel_centers):
+  def coords(in_size, out_size):
+    scale = np.float32(_scale(in_size, out_size, align_corners))
+    pos = np.arange(out_size, dtype=np.float32)
+    pos = (pos + 0.5) * scale - 0.5 if half_pixel_centers else pos * scale
+    lower = np.maximum(np.floor(pos), 0).astype(np.int64)
+    upper = np.minimum(np.ceil(pos), in_size - 1).astype(np.int64)
+    return lower, upper, pos - np.floor(pos)
+
+  image = image.astype(np.float32)
+  y0, y1, ly = coords(image.shape[1], out_size[0])
+  x0, x1, lx = coords(image.shape[2], out_size[1])
+  ly = ly[None, :, None, None]
+  lx = lx[None, None, :, None]
+  top = image[:, y0][:, :, x0] + (
+      image[:, y0][:, :, x1] - image[:, y0][:, :, x0]) * lx
+  bottom = image[:, y1][:, :, x0] + (
+      image[:, y1][:, :, x1] - image[:, y1][:, :, x0]) * lx
+  return top + (bottom - top) * ly
+
+
+def _nearest_ref(image, out_size, align_corners, half_pixel_centers):
+  def coords(in_size, out_size):
+    scale = np.float32(_scale(in_size, out_size, align_corners))
+    pos = np.arange(out_size, dtype=np.float32)
+    pos = (pos + 0.5) * scale if half_pixel_centers else pos * scale
+    pos = np.round(pos) if align_corners else np.floor(pos)
+    index = np.minimum(pos, in_size - 1)
+    if half_pixel_centers:
+      index = np.maximum(index, 0)
+    return index.astype(np.int64)
+
+  return image[:, coords(image.shape[1], out_size[0])][
+      :, :, coords(image.shape[2], out_size[1])]
+
+
+class ResizeModesTest(test_util.TensorFlowTestCase):
+  """test ResizeBilinear and ResizeNearestNeighbor in all coordinate modes"""
+
+  def _random_image(self, shape, dtype):
+    if dtype.is_integer:
+      data = np.random.randint(dtype.min, dtype.max, size=shape)
+    else:
+      data = np.random.normal(size=shape) * 10
+    return constant_op.constant(data, dtype=dtype)
+
+  def _test_impl(self, resize_fn, ref_fn, in_size, out_size, dtype,
+                 align_corners, half_pixel_centers):
+    image = self._random_image(in_size, dtype)
+
+    @tf.function
+    def resize(x):
+      return resize_fn(x, out_size, align_corners=align_corners,
+                       half_pixel_centers=half_pixel_centers)
+
+    with tf.device("/cpu:0"):
+      out = resize(image)
+    ref = ref_fn(image.numpy(), out_size, align_corners, half_pixel_centers)
+    tol = 1e-2 if dtype == dtypes.bfloat16 else 1e-4
+    self.assertAllClose(np.asarray(out, dtype=np.float32),
+                        ref.astype(np.float32), rtol=tol, atol=tol)
+
+  def testResizeBilinear(self):
+    for dtype in IMAGE_DTYPE:
+      for align_corners, half_pixel_centers in MODES:
+        for in_size, out_size in SIZES:
+          self._test_impl(gen_image_ops.resize_bilinear, _bilinear_ref,
+                          in_size, out_size, dtype, align_corners,
+                          half_pixel_centers)
+
+  def testResizeNearestNeighbor(self):
+    for dtype in IMAGE_DTYPE:
+      for align_corners, half_pixel_centers in MODES:
+        for in_size, out_size in SIZES:
+          self._test_impl(gen_image_ops.resize_nearest_neighbor, _nearest_ref,
+                          in_size, out_size, dtype, align_corners,
+                          half_pixel_centers)
+
+
+if __name__ == "__main__":
+  test.main()
@@ -123,6 +123,89 @@ class FusedBinaryTest(test_lib.TestCase):
       y = y.reshape((-1))
       self.assertAllClose(output_val, y, atol=y_atol)
 
+  def _testChainOnCpu(self, build, reference, num_fused_ops):
+    """Runs `build` on CPU and checks it's fused into one _ITEXFusedBinary."""
+    if test_lib.is_gpu_available():
+      self.skipTest("Skip on GPU due to the pattern not supported")
+
+    # oneDNN Graph would take the chain, and the remapper only runs on graphs
+    # without MatMul/Conv in test mode.
+    env = {"ITEX_ONEDNN_GRAPH": "0", "_ITEX_TEST_MODE": "1"}
+    saved_env = {name: os.environ.get(name) for name in env}
+    os.environ.update(env)
+    try:
+      shape = (4, 24, 40)
+      run_options = config_pb2.RunOptions(output_partition_graphs=True)
+      metadata = config_pb2.RunMetadata()
+
+      arrays = [np.random.normal(size=shape).astype(np.float32),
+                np.random.normal(size=(4, 24, 1)).astype(np.float32),
+                np.random.uniform(1, 2, size=shape[-1]).astype(np.float32),
+                np.random.normal(size=shape[-1]).astype(np.float32),
+                np.random.normal(size=shape).astype(np.float32)]
+      inputs = [tf.placeholder(tf.float32, shape=a.shape) for a in arrays]
+
+      for dtype in [tf.float32, tf.bfloat16]:
+        y = build(*[tf.cast(t, dtype=dtype) for t in inputs])
+        y = array_ops.identity(y)
+
+        with self.session(use_gpu=False) as sess:
+          output_val = sess.run(y, options=run_options, run_metadata=metadata,
+                                feed_dict=dict(zip(inputs, arrays)))
+          graph = metadata.partition_graphs[0]
+
+        fused_ops = [node for node in graph.node
+                     if 'ITEXFusedBinary' in node.op]
+        self.assertEqual(len(fused_ops), 1)
+        self.assertEqual(len(fused_ops[0].attr['fused_ops'].list.s),
+                         num_fused_ops)
+
+        tol = 1e-6 if dtype is tf.float32 else 2e-2
+        self.assertAllClose(output_val, reference(*arrays), rtol=tol,
+                            atol=tol)
+    finally:
+      for name, value in saved_env.items():
+        if value is None:
+          os.environ.pop(name, None)
+        else:
+          os.environ[name] = value
+
+  @test_util.run_deprecated_v1
+  @test_util.disable_xla('This test does not pass with XLA')
+  def testBroadcastChainOnCpu(self):
+    def build(x, mean, scale, shift, _):
+      y = (x - mean) / scale * 2.0 + shift
+      return tf.math.minimum(tf.math.maximum(y, -1.0), 1.0)
+
+    def reference(x, mean, scale, shift, _):
+      return np.clip((x - mean) / scale * 2.0 + shift, -1.0, 1.0)
+
+    self._testChainOnCpu(build, reference, 6)
+
+  @test_util.run_deprecated_v1
+  @test_util.disable_xla('This test does not pass with XLA')
+  def testChainAsSubtrahendOnCpu(self):
+    # The running result is the second operand of the last op.
+    def build(x, mean, scale, shift, c):
+      return c - ((x - mean) * scale + shift)
+
+    def reference(x, mean, scale, shift, c):
+      return c - ((x - mean) * scale + shift)
+
+    self._testChainOnCpu(build, reference, 4)
+
+  @test_util.run_deprecated_v1
+  @test_util.disable_xla('This test does not pass with XLA')
+  def testChainAsDivisorOnCpu(self):
+    # The divisor is at least 1.
+    def build(x, mean, scale, _, c):
+      return c / (tf.math.maximum((x - mean) * scale, 0.0) + 1.0)
+
+    def reference(x, mean, scale, _, c):
+      return c / (np.maximum((x - mean) * scale, 0.0) + 1.0)
+
+    self._testChainOnCpu(build, reference, 5)
+
   @test_util.run_deprecated_v1
   @test_util.disable_xla('This test does not pass with XLA')
   def testShape(self):
@@ -22,7 +22,10 @@ import os
 
 from tensorflow.core.protobuf import config_pb2
 from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import ops
 from tensorflow.python.ops import array_ops
+from tensorflow.python.ops import control_flow_ops
+from tensorflow.python.ops import control_flow_util
 from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import nn_ops
 
@@ -109,6 +112,122 @@ class InplaceTest(test.TestCase):
 
     self.assertFalse(inplace_flag)
 
+  @test_util.run_deprecated_v1
+  def testRefCountGreaterThanOneAndRunSoftmaxLast(self):
+    if test.is_gpu_available():
+      self.skipTest("Softmax in-place is temporarily unavailable on GPU")
+
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+
+    phl_in = GetRandomNormalInput([3, 4], np.float32)
+    phr_in = GetRandomNormalInput([4, 5], np.float32)
+
+    tgt_name = "arbitrary"
+
+    with self.cached_session() as sess:
+      phl = array_ops.placeholder(np.float32)
+      phr = array_ops.placeholder(np.float32)
+
+      mm = math_ops.matmul(phl, phr)
+      reduce_sum = math_ops.reduce_sum(mm)
+      # The other consumer of `mm` must finish before Softmax.
+      with ops.control_dependencies([reduce_sum]):
+        tf_softmax = array_ops.identity(nn_ops.softmax(mm, name=tgt_name))
+
+      sess.run([tf_softmax, reduce_sum],
+               feed_dict={phl: phl_in, phr: phr_in},
+               options=run_options, run_metadata=metadata)
+
+    graph = metadata.partition_graphs[0]
+    inplace_flag = GetInplaceFlagByName(graph, tgt_name, "is_inplace")
+
+    self.assertTrue(inplace_flag)
+
+  @test_util.run_deprecated_v1
+  def testAliasingConsumerReadAfterSoftmax(self):
+    if test.is_gpu_available():
+      self.skipTest("Softmax in-place is temporarily unavailable on GPU")
+
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+
+    phl_in = GetRandomNormalInput([3, 4], np.float32)
+    phr_in = GetRandomNormalInput([4, 5], np.float32)
+
+    tgt_name = "arbitrary"
+
+    with self.cached_session() as sess:
+      phl = array_ops.placeholder(np.float32)
+      phr = array_ops.placeholder(np.float32)
+
+      mm = math_ops.matmul(phl, phr)
+      # Reshape shares the buffer of `mm`, and its own consumer has no
+      # dependence on Softmax.
+      view = array_ops.reshape(mm, [-1])
+      with ops.control_dependencies([view]):
+        tf_softmax = array_ops.identity(nn_ops.softmax(mm, name=tgt_name))
+      reduce_sum = math_ops.reduce_sum(view)
+
+      sess.run([tf_softmax, reduce_sum],
+               feed_dict={phl: phl_in, phr: phr_in},
+               options=run_options, run_metadata=metadata)
+
+    graph = metadata.partition_graphs[0]
+    inplace_flag = GetInplaceFlagByName(graph, tgt_name, "is_inplace")
+
+    self.assertFalse(inplace_flag)
+
+  @test_util.run_deprecated_v1
+  def testLoopInvariantInWhileLoop(self):
+    if test.is_gpu_available():
+      self.skipTest("Softmax in-place is temporarily unavailable on GPU")
+
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+
+    phl_in = GetRandomNormalInput([3, 4], np.float32)
+    phr_in = GetRandomNormalInput([4, 5], np.float32)
+
+    tgt_name = "arbitrary"
+
+    # Build a v1 while loop, so `mm` reaches the body through a constant
+    # Enter and is read again by every iteration.
+    enable_control_flow_v2 = control_flow_util.ENABLE_CONTROL_FLOW_V2
+    control_flow_util.ENABLE_CONTROL_FLOW_V2 = False
+    try:
+      with self.cached_session() as sess:
+        phl = array_ops.placeholder(np.float32, [3, 4])
+        phr = array_ops.placeholder(np.float32, [4, 5])
+
+        mm = math_ops.matmul(phl, phr)
+
+        def body(i, acc):
+          return i + 1, acc + nn_ops.softmax(mm, name=tgt_name)
+
+        _, acc = control_flow_ops.while_loop(
+            lambda i, _: i < 3, body,
+            [constant_op.constant(0), array_ops.zeros([3, 5])])
+
+        out = sess.run(array_ops.identity(acc),
+                       feed_dict={phl: phl_in, phr: phr_in},
+                       options=run_options, run_metadata=metadata)
+    finally:
+      control_flow_util.ENABLE_CONTROL_FLOW_V2 = enable_control_flow_v2
+
+    inplace_flag = False
+    for graph in metadata.partition_graphs:
+      for node in graph.node:
+        if node.name.endswith("/" + tgt_name):
+          inplace_flag |= node.attr["is_inplace"].b
+
+    self.assertFalse(inplace_flag)
+
+    mm_ref = np.matmul(phl_in, phr_in)
+    softmax_ref = np.exp(mm_ref - mm_ref.max(axis=1, keepdims=True))
+    softmax_ref /= softmax_ref.sum(axis=1, keepdims=True)
+    self.assertAllClose(out, 3 * softmax_ref, rtol=1e-5, atol=1e-5)
+
 
 class InplaceSumTest(test.TestCase):
 
@@ -184,6 +303,43 @@ class InplaceSumTest(test.TestCase):
 
     self.assertTrue(inplace_flag)
 
+  # Tests tensor forwarding of a fused Conv2D+BiasAdd+Add op when the input to
+  # Add has refcount 2, and its other consumer is far up the input chain of
+  # the fused op.
+  @test_util.run_deprecated_v1
+  def testAddWithRefCountTwoAndLongInputChain(self):
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+
+    phl_in = GetRandomNormalInput([3, 3], np.float32)
+    phr_in = GetRandomNormalInput([3, 3], np.float32)
+    bias_in = GetRandomNormalInput([3], np.float32)
+
+    tgt_name = "arbitrary"
+
+    with self.cached_session() as sess:
+      phl = array_ops.placeholder(np.float32, [3, 3])
+      phr = array_ops.placeholder(np.float32, [3, 3])
+      bias = array_ops.placeholder(np.float32, [3])
+
+      # AddInput
+      relu = nn_ops.relu(phl)
+      x = relu
+      for _ in range(16):
+        x = math_ops.tanh(x)
+
+      mm = math_ops.matmul(x, phr)
+      bias_add = nn_ops.bias_add(mm, bias)
+      add = array_ops.identity(math_ops.add_n([bias_add, relu], name=tgt_name))
+
+      sess.run([add], feed_dict={phl: phl_in, phr: phr_in, bias: bias_in},
+               options=run_options, run_metadata=metadata)
+
+    graph = metadata.partition_graphs[0]
+    inplace_flag = GetInplaceFlagByName(graph, tgt_name, "inplace_sum")
+
+    self.assertTrue(inplace_flag)
+
   # Tests tensor forwarding of a fused Conv2D+BiasAdd+Add op when the input to
   # Add has refcount 2, and there is no dependency between its two consumers.
   @test_util.run_deprecated_v1
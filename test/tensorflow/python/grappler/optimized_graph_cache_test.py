@@ -0,0 +1,85 @@
+# Copyright (c) 2022 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+import os
+import tempfile
+
+# The cache is configured once per process, so it is enabled before ITEX is
+# loaded. Graphs rewritten by oneDNN Graph are never cached.
+os.environ['ITEX_GRAPH_OPT_CACHE'] = "1"
+os.environ['ITEX_ONEDNN_GRAPH'] = "0"
+os.environ['ITEX_GRAPH_OPT_CACHE_DIR'] = tempfile.mkdtemp()
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+import numpy as np
+
+from tensorflow.core.protobuf import config_pb2
+from tensorflow.python.client import session
+from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import ops
+from tensorflow.python.ops import array_ops
+from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import nn_ops
+
+
+def NumCacheEntries():
+  cache_dir = os.environ['ITEX_GRAPH_OPT_CACHE_DIR']
+  return len([f for f in os.listdir(cache_dir) if f.endswith(".graph")])
+
+
+class OptimizedGraphCacheTest(test.TestCase):
+
+  def _RunMatMulBiasAddRelu(self, x_in, w_in, b_in):
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+
+    # Build the same graph in a fresh session, so TF optimizes it again.
+    with ops.Graph().as_default(), session.Session() as sess:
+      x = array_ops.placeholder(np.float32, [4, 8])
+      w = constant_op.constant(w_in)
+      b = constant_op.constant(b_in)
+      mm = math_ops.matmul(x, w)
+      relu = array_ops.identity(nn_ops.relu(nn_ops.bias_add(mm, b)))
+      out = sess.run(relu, feed_dict={x: x_in}, options=run_options,
+                     run_metadata=metadata)
+
+    ops_in_graph = sorted(node.op for node in metadata.partition_graphs[0].node)
+    return out, ops_in_graph
+
+  @test_util.run_deprecated_v1
+  def testCacheHit(self):
+    x_in = np.random.normal(size=[4, 8]).astype(np.float32)
+    w_in = np.random.normal(size=[8, 3]).astype(np.float32)
+    b_in = np.random.normal(size=[3]).astype(np.float32)
+    expected = np.maximum(np.matmul(x_in, w_in) + b_in, 0)
+
+    out_miss, ops_miss = self._RunMatMulBiasAddRelu(x_in, w_in, b_in)
+    num_entries = NumCacheEntries()
+    self.assertGreater(num_entries, 0)
+
+    # The identical graph is served from the cache, so no entry is added.
+    out_hit, ops_hit = self._RunMatMulBiasAddRelu(x_in, w_in, b_in)
+    self.assertEqual(num_entries, NumCacheEntries())
+
+    self.assertEqual(ops_miss, ops_hit)
+    self.assertAllClose(expected, out_miss, rtol=1e-5, atol=1e-5)
+    self.assertAllClose(expected, out_hit, rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+  test.main()